@@ -0,0 +1,148 @@
+#/////////////////////////////////////////////////////////////////////////////
+# Author: Matthias Gerstl 
+# Email: matthias.gerstl@acib.at 
+# Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+# Web: http://www.acib.at Copyright
+# (C) 2015 Published unter GNU Public License V3
+#/////////////////////////////////////////////////////////////////////////////
+#Basic Permissions.
+# 
+# All rights granted under this License are granted for the term of copyright
+# on the Program, and are irrevocable provided the stated conditions are met.
+# This License explicitly affirms your unlimited permission to run the
+# unmodified Program. The output from running a covered work is covered by
+# this License only if the output, given its content, constitutes a covered
+# work. This License acknowledges your rights of fair use or other equivalent,
+# as provided by copyright law.
+# 
+# You may make, run and propagate covered works that you do not convey,
+# without conditions so long as your license otherwise remains in force. You
+# may convey covered works to others for the sole purpose of having them make
+# modifications exclusively for you, or provide you with facilities for
+# running those works, provided that you comply with the terms of this License
+# in conveying all material for which you do not control copyright. Those thus
+# making or running the covered works for you must do so exclusively on your
+# behalf, under your direction and control, on terms that prohibit them from
+# making any copies of your copyrighted material outside their relationship
+# with you.
+# 
+# Disclaimer of Warranty.
+# 
+# THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+# LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+# OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+# EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+# ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+# SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+# SERVICING, REPAIR OR CORRECTION.
+# 
+# Limitation of Liability.
+# 
+# IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+# ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+# PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+# GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+# OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+# OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+# PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+# EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGES.
+#/////////////////////////////////////////////////////////////////////////////
+
+# checkpoint of findAllSolutions of ltcstool_clever.pl and
+# ltcstool_hotstart_clever.pl (option -w): a header with the MD5 fingerprint
+# of the base lp file (without solutions) and the number of EFMs, followed by
+# appended records of the objective window ('W', minimum, maximum, intervall)
+# and of the solutions ('S', cardinality, lambda values l1 ... ln as packed
+# bits); it does not need CPLEX, so it is tested on its own
+# (tests/testCheckpoint.sh)
+package LtcsCheckpoint;
+
+use strict;
+use warnings;
+use Digest::MD5;
+use Exporter qw(import);
+
+our @EXPORT = qw(createCheckpoint appendCheckpoint checkpointWindow
+    checkpointSolution readCheckpoint);
+
+use constant CHECKPOINT_MAGIC => 'LTCSCKP1';
+
+sub getFingerprint {
+    my ($f) = @_;
+    open(my $fh, "<", $f) or die ("Could not open $f: $!\n");
+    binmode($fh);
+    my $fingerprint = Digest::MD5->new->addfile($fh)->digest;
+    close($fh);
+    return $fingerprint;
+}
+
+sub createCheckpoint {
+    my ($f, $base, $efm_nr) = @_;
+    open(my $fh, ">", $f) or die ("Could not open $f: $!\n");
+    binmode($fh);
+    print $fh pack("a8 a16 V", CHECKPOINT_MAGIC, getFingerprint($base),
+        $efm_nr);
+    close($fh) or die ("Could not write $f: $!\n");
+}
+
+sub appendCheckpoint {
+    my ($f, $record) = @_;
+    open(my $fh, ">>", $f) or die ("Could not open $f: $!\n");
+    binmode($fh);
+    print $fh $record;
+    close($fh) or die ("Could not write $f: $!\n");
+}
+
+sub checkpointWindow {
+    my ($min, $max, $intervall) = @_;
+    return pack("a1 V3", 'W', $min, $max, $intervall);
+}
+
+sub checkpointSolution {
+    my ($cardinality, $bits) = @_;
+    return pack("a1 V", 'S', $cardinality).pack("b*", $bits);
+}
+
+# read the solutions (strings of 0 and 1) and the last objective window of a
+# checkpoint; a record cut off by an interrupted run is removed
+sub readCheckpoint {
+    my ($f, $base, $efm_nr) = @_;
+    open(my $fh, "<", $f) or die ("Could not open $f: $!\n");
+    binmode($fh);
+    my $header;
+    my ($magic, $fingerprint, $count) = ('', '', 0);
+    if (read($fh, $header, 28) == 28) {
+        ($magic, $fingerprint, $count) = unpack("a8 a16 V", $header);
+    }
+    die ("$f is not a checkpoint file\n") unless $magic eq CHECKPOINT_MAGIC;
+    die ("Checkpoint $f does not belong to $base\n")
+        unless $fingerprint eq getFingerprint($base) and $count == $efm_nr;
+    my $bytes = int(($efm_nr + 7) / 8);
+    my @solutions;
+    my $window;
+    my $good = 28;
+    my $type;
+    while (read($fh, $type, 1) == 1) {
+        my $record;
+        if ($type eq 'W') {
+            last unless read($fh, $record, 12) == 12;
+            $window = [unpack("V3", $record)];
+        } elsif ($type eq 'S') {
+            last unless read($fh, $record, 4 + $bytes) == 4 + $bytes;
+            push(@solutions, substr(unpack("b*", substr($record, 4)), 0,
+                    $efm_nr));
+        } else {
+            die ("Error in checkpoint $f\n");
+        }
+        $good = tell($fh);
+    }
+    close($fh);
+    if ($good < -s $f) {
+        truncate($f, $good) or die ("Could not truncate $f: $!\n");
+    }
+    return (\@solutions, $window);
+}
+
+1;
@@ -59,6 +59,9 @@ use Math::CPLEX::OP;
 use Math::CPLEX::Env;
 use Getopt::Std;
 use Data::Dumper;
+use FindBin;
+use lib $FindBin::Bin;
+use LtcsCheckpoint;
 
 # constants
 ##################################################
@@ -74,7 +77,7 @@ use constant TIME_LIMIT_UNLIM => 31536000; # 1 year
 
 # parameters
 ##################################################
-my $opt_string = 'hs:r:e:c:g:k:p:i:t:l:f:o:x:n:y:bd';
+my $opt_string = 'hs:r:e:c:g:k:p:i:t:l:f:o:x:n:y:w:bd';
 my %opt;
 getopts( "$opt_string", \%opt ) or usage();
 if ( $opt{h} or !$opt{s} or !$opt{r} or !$opt{e} or !$opt{c} or !$opt{g} ){
@@ -97,6 +100,7 @@ my $tightbounds    = $opt{b} ? 1 : 0;
 my $debug          = $opt{d} ? 1 : 0;
 my $time_limit     = $opt{x} ? $opt{x} : 600; # ten minutes
 my $max_intervall  = $opt{n} ? $opt{n} : 0;
+my $checkpoint     = $opt{w} ? $opt{w} : undef;
 
 # print log
 ##################################################
@@ -118,6 +122,13 @@ print "pH-value:              $ph\n";
 print "proton:                $proton\n";
 print "lp outputfile:         $lpfile\n";
 print "lp solution file:      $solfile\n";
+print "checkpoint:            ";
+if (defined($checkpoint)) {
+    print "$checkpoint\n";
+}
+else {
+    print "not used\n";
+}
 print "threads:               $threads\n";
 print "intervall:             clever\n";
 print "max intervall:         ";
@@ -169,14 +180,15 @@ if (defined($yield_file))
 my $lp_info = createLpProblem($reac, $spec, $cHash, $rt, $dfgs, $modes_file,
 		$useRx, $tightbounds, $proton, $yields); 
 
-findAllSolutions($lp_info, $lpfile, $solfile, $max_intervall, $debug);
+findAllSolutions($lp_info, $lpfile, $solfile, $max_intervall, $debug,
+    $checkpoint);
 
 ##################################################
 # FUNCTIONS
 ##################################################
 
 sub findAllSolutions {
-	my ($lp_info, $lpfile, $solfile, $max_intervall, $debug) = @_;
+	my ($lp_info, $lpfile, $solfile, $max_intervall, $debug, $checkpoint) = @_;
 	my $nr_efms       = $lp_info->{'info'}{'nr_efms'};
 	my $lda_col_start = $lp_info->{'info'}{'lda_col_start'};
 	my $obj_ix        = $lp_info->{'info'}{'objective_index'};
@@ -193,6 +205,10 @@ sub findAllSolutions {
 	# write lp file without solutions
 	#################################
 	$lp->writeprob($lpfile.$sol_count.".lp", "LP");
+    if (defined($checkpoint)) {
+        # the lp file without solutions is the base of the checkpoint
+        createCheckpoint($checkpoint, $lpfile.$sol_count.".lp", $nr_efms);
+    }
 
     my $obj_col = $lp_info->{'info'}{'objective_col'};
     my $min = 1;
@@ -210,6 +226,10 @@ sub findAllSolutions {
     $lp_info->{'info'}{'obj_max'} = $nr_efms;
     die "ERROR: addrows() failed for setting bounds of objective
     intervall\n" unless $lp->addrows($temp_rows);
+    if (defined($checkpoint)) {
+        appendCheckpoint($checkpoint, checkpointWindow($min, $nr_efms,
+                $intervall));
+    }
 
 	while (1){
         printDebug($debug, $intervall, $lp_info);
@@ -244,6 +264,12 @@ sub findAllSolutions {
                 printSolution2file($solution_file, \@vals, $first, $last);
                 addSolution2lp($lp_info, $sol_count, \@vals, $first, $last);
                 $mip_obj_val = int($mip_obj_val + 0.5);
+                if (defined($checkpoint)) {
+                    my $bits = join('', map { $vals[$_] > 0.5 ? 1 : 0 }
+                        ($first .. $last - 1));
+                    appendCheckpoint($checkpoint,
+                        checkpointSolution($mip_obj_val, $bits));
+                }
                 print "Cardinality: $mip_obj_val \t saved in $solution_file \n";
                 $max = $mip_obj_val;
                 $intervall = getIntervall($max, $max_intervall);
@@ -276,7 +302,12 @@ sub findAllSolutions {
         }
         changeBounds($lp_info, $max, $intervall);
         setTimeLimit($intervall);
-        if ($printProblem)
+        if (defined($checkpoint))
+        {
+            appendCheckpoint($checkpoint, checkpointWindow(
+                    $lp_info->{'info'}{'obj_min'}, $max, $intervall));
+        }
+        elsif ($printProblem)
         {
             $lp->writeprob($lpfile.$sol_count.".lp", "LP");
         }
@@ -1202,6 +1233,9 @@ Usage: $0 [OPTIONS]
          this option was implemented for testing, but it slows down the solver 
          dramatically and therefore it is recommended not be used
    -x    time out intervall in seconds [default: 600]
+   -w    checkpoint file [optional]: solutions and objective windows are
+         appended to it instead of writing a lp file after every solution;
+         continue with ltcstool_hotstart_clever.pl -i <lp prefix>0.lp -w <file>
    -y    yield file [optional]
          format:
            R_BIOMASS > 0.009528785
@@ -59,6 +59,9 @@ use Math::CPLEX::OP;
 use Math::CPLEX::Env;
 use Getopt::Std;
 use Data::Dumper;
+use FindBin;
+use lib $FindBin::Bin;
+use LtcsCheckpoint;
 
 # constants
 ##################################################
@@ -71,7 +74,7 @@ use constant TIME_LIMIT_UNLIM => 31536000; # 1 year
 
 # parameters
 ##################################################
-my $opt_string = 'hi:s:t:l:f:n:x:d';
+my $opt_string = 'hi:s:t:l:f:n:x:w:d';
 my %opt;
 getopts( "$opt_string", \%opt ) or usage();
 if ( $opt{h} or !$opt{i} ){
@@ -86,18 +89,35 @@ my $debug          = $opt{d} ? 1 : 0;
 my $start_val      = $opt{s} ? $opt{s} : 0;
 my $time_limit     = $opt{x} ? $opt{x} : 600; # ten minutes
 my $max_intervall  = $opt{n} ? $opt{n} : 0;
+my $checkpoint     = $opt{w} ? $opt{w} : undef;
 
+my $efm_nr         = getEfmNr($input_lp);
+my $has_window     = `grep -c OBJ_MIN $input_lp`;
+chomp($has_window);
 if (!$start_val) {
-    $start_val = `grep OBJ_MAX $input_lp | awk -F '<= ' '{print \$2}'`;
-    chomp($start_val);
+    if ($input_lp =~ /\.mps$/ or !$has_window) {
+        # MPS files of ltcsDecompose: OBJ_MAX is the number of EFMs
+        $start_val = $efm_nr;
+    } else {
+        $start_val = `grep OBJ_MAX $input_lp | awk -F '<= ' '{print \$2}'`;
+        chomp($start_val);
+    }
 }
-my $efm_nr         = getEfmNr($input_lp);
 
 # print log
 ##################################################
 print "input lp file:         $input_lp\n";
 print "lp outputfile:         $lpfile\n";
 print "lp solution file:      $solfile\n";
+print "checkpoint:            ";
+if (defined($checkpoint))
+{
+    print "$checkpoint\n";
+}
+else
+{
+    print "not used\n";
+}
 print "threads:               $threads\n";
 print "intervall:             clever\n";
 print "max intervall:         ";
@@ -133,9 +153,37 @@ my $lp = $cplex_env->createOP();
 $lp->readcopyprob($input_lp);
 
 my $sol_count = `grep -c SOL_ $input_lp`;
+chomp($sol_count);
+my @match;
+for (my $i=1; $i <= $efm_nr; $i++) {
+    $match[$i-1] = $lp->getcolindex("l".$i);
+}
+if (!$has_window) {
+    addObjectiveRows($lp, $start_val);
+}
+
+# Rebuild solutions of the checkpoint
+#####################################
+my $start_intervall;
+if (defined($checkpoint) and -e $checkpoint) {
+    my ($solutions, $window) = readCheckpoint($checkpoint, $input_lp,
+        $efm_nr);
+    foreach my $bits (@{$solutions}) {
+        $sol_count++;
+        my @lambda = split(//, $bits);
+        addSolution2lp($lp, $sol_count, \@lambda, \@match);
+    }
+    if (defined($window) and !$opt{s}) {
+        $start_val = $window->[1];
+        $start_intervall = $window->[2];
+    }
+    print "checkpoint solutions:  ".scalar(@{$solutions})."\n";
+} elsif (defined($checkpoint)) {
+    createCheckpoint($checkpoint, $input_lp, $efm_nr);
+}
 
 findAllSolutions($lp, $start_val, $lpfile, $solfile, $sol_count,
-    $efm_nr, $max_intervall, $debug);
+    $efm_nr, $max_intervall, $debug, \@match, $start_intervall, $checkpoint);
 
 ##################################################
 # FUNCTIONS
@@ -149,7 +197,12 @@ sub getEfmNr {
     my $inBound = 0;
     my $efm_nr = 0;
     for (my $i = 0; $i < @in; $i++) {
-        if ($inBound){
+        if ($in[$i] =~ /^ BV bnd\s+l(\d+)\s*$/) {
+            # binary lambda column of a MPS file
+            if ($1 > $efm_nr){
+                $efm_nr = $1;
+            }
+        } elsif ($inBound){
             if ($in[$i] =~ /^Binaries/){
                 $i = @in;
             } elsif ($in[$i] =~ /0 <= l\d+ <= 1/) {
@@ -172,32 +225,21 @@ sub getEfmNr {
 
 sub findAllSolutions {
     my ($lp, $start_val, $lpfile, $solfile, $sol_count, $efm_nr,
-        $max_intervall, $debug) = @_;
+        $max_intervall, $debug, $match, $start_intervall, $checkpoint) = @_;
 
 	my $sol_status;
     my $mip_obj_val;
 	my @vals;
 
-    my $obj_min_ix = $lp->getrowindex("OBJ_MIN");
-
-    my @match;
-
-    my $first = 0;
-    my $last = 0;
-    for (my $i=1; $i <= $efm_nr; $i++) {
-        my $temp = $lp->getcolindex("l".$i);
-        $match[$i-1] = $temp;
-        if ($temp < $first or $first < 1){
-            $first = $temp;
-        }
-        if ($temp > $last) {
-            $last = $temp;
-        }
-    }
-
     my $max = $start_val;
-    my $intervall = getIntervall($max, $max_intervall);
+    my $intervall = defined($start_intervall) ? $start_intervall :
+        getIntervall($max, $max_intervall);
     my $min = changeBounds($lp, $max, $intervall);
+    setTimeLimit($intervall);
+    if (defined($checkpoint)) {
+        appendCheckpoint($checkpoint, checkpointWindow($min, $max,
+                $intervall));
+    }
 
 	while (1){
         printDebug($debug, $intervall, $min, $max);
@@ -227,9 +269,14 @@ sub findAllSolutions {
                 $sol_count++;
                 ($sol_status, $mip_obj_val, @vals) = $lp->solution();
                 my $solution_file = $solfile.$sol_count.'.csv';
-                printSolution2file($solution_file, \@vals, \@match);
-                addSolution2lp($lp, $sol_count, \@vals, $first, $last);
+                printSolution2file($solution_file, \@vals, $match);
+                my @lambda = map { $vals[$_] > 0.5 ? 1 : 0 } @{$match};
+                addSolution2lp($lp, $sol_count, \@lambda, $match);
                 $mip_obj_val = int($mip_obj_val + 0.5);
+                if (defined($checkpoint)) {
+                    appendCheckpoint($checkpoint, checkpointSolution(
+                            $mip_obj_val, join('', @lambda)));
+                }
                 print "Cardinality: $mip_obj_val \t saved in $solution_file \n";
                 $max = $mip_obj_val;
                 $intervall = getIntervall($max, $max_intervall);
@@ -262,7 +309,12 @@ sub findAllSolutions {
         }
         $min = changeBounds($lp, $max, $intervall);
         setTimeLimit($intervall);
-        if ($printProblem)
+        if (defined($checkpoint))
+        {
+            appendCheckpoint($checkpoint, checkpointWindow($min, $max,
+                    $intervall));
+        }
+        elsif ($printProblem)
         {
             $lp->writeprob($lpfile.$sol_count.".lp", "LP");
         }
@@ -301,14 +353,32 @@ sub changeBounds {
     return $min;
 }
 
+sub addObjectiveRows {
+    my ($lp, $max) = @_;
+    # objective window: rows of findAllSolutions of ltcstool_clever.pl
+    my $obj_col = $lp->getcolindex("obj_col");
+    my $newRows;
+    $newRows->[0][$obj_col] = 1;
+    $newRows->[1][$obj_col] = 1;
+    my $temp_rows = {
+        num_rows => 2,
+        rhs => [1, $max],
+        sense => ['G', 'L'],
+        row_names => ['OBJ_MIN', 'OBJ_MAX'],
+        row_coefs => $newRows
+    };
+    die "ERROR: addrows() failed for setting bounds of objective
+    intervall\n" unless $lp->addrows($temp_rows);
+}
+
 sub addSolution2lp {
-	my ($lp, $count, $vals, $start, $end) = @_;
+	my ($lp, $count, $lambda, $match) = @_;
 	my $new_row_coef;
 	my $new_row_name  = ['SOL_'.$count];
 	my $new_row_rhs   = [1];
 	my $new_row_sense = ['G'];
-	for (my $i = $start; $i < $end; $i++) {
-		$new_row_coef->[0][$i] = $vals->[$i] ? 0 : 1;
+	for (my $i = 0; $i < @{$match}; $i++) {
+		$new_row_coef->[0][$match->[$i]] = $lambda->[$i] ? 0 : 1;
 	}
 	my $new_row = {
 		num_rows  => 1,
@@ -358,7 +428,8 @@ Usage: $0 [OPTIONS]
 
 
    -h    show this help
-   -i    input LP file, created by ltcstool.pl
+   -i    input LP file, created by ltcstool.pl, or MPS file of a LTCS written
+         by ltcsDecompose
    -s    start maximum value [optional]
    -l    output prefix of lp files (default: temp_)
    -f    output prefix of solution files (default: sol_)
@@ -367,11 +438,17 @@ Usage: $0 [OPTIONS]
          increases efficiency of the solver for bigger problems and therfore it
          is recommended to use an appropriate interval 
    -x    time out intervall in seconds [default: 600]
+   -w    checkpoint file [optional]: if it exists, its solutions are added to
+         the input file (the base lp file of ltcstool_clever.pl -w, e.g.
+         temp_0.lp) and the search continues in its last objective window;
+         new solutions and windows are appended to it instead of writing a lp
+         file after every solution
    -d    debug output
 
    Examples:
    $0 -i step3.lp -s 32000 -l lp_ -f sol_ -t 8 -n 1000 -d
    $0 -i step3.lp -s 32000 -l lp_ -f sol_ -t 8 -n 1000 -x 60
+   $0 -i temp_0.lp -w run.ckp -f sol_ -t 8 -n 1000
 
 END_TEXT
 
@@ -0,0 +1,124 @@
+#!/usr/bin/env perl 
+#/////////////////////////////////////////////////////////////////////////////
+# Author: Matthias Gerstl 
+# Email: matthias.gerstl@acib.at 
+# Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+# Web: http://www.acib.at Copyright
+# (C) 2015 Published unter GNU Public License V3
+#/////////////////////////////////////////////////////////////////////////////
+#Basic Permissions.
+# 
+# All rights granted under this License are granted for the term of copyright
+# on the Program, and are irrevocable provided the stated conditions are met.
+# This License explicitly affirms your unlimited permission to run the
+# unmodified Program. The output from running a covered work is covered by
+# this License only if the output, given its content, constitutes a covered
+# work. This License acknowledges your rights of fair use or other equivalent,
+# as provided by copyright law.
+# 
+# You may make, run and propagate covered works that you do not convey,
+# without conditions so long as your license otherwise remains in force. You
+# may convey covered works to others for the sole purpose of having them make
+# modifications exclusively for you, or provide you with facilities for
+# running those works, provided that you comply with the terms of this License
+# in conveying all material for which you do not control copyright. Those thus
+# making or running the covered works for you must do so exclusively on your
+# behalf, under your direction and control, on terms that prohibit them from
+# making any copies of your copyrighted material outside their relationship
+# with you.
+# 
+# Disclaimer of Warranty.
+# 
+# THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+# LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+# OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+# EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+# ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+# SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+# SERVICING, REPAIR OR CORRECTION.
+# 
+# Limitation of Liability.
+# 
+# IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+# ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+# PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+# GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+# OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+# OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+# PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+# EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGES.
+
+use strict;
+use warnings;
+use utf8;
+use Getopt::Std;
+
+# parameters
+##################################################
+my $opt_string = 'hi:s:f:';
+my %opt;
+getopts( "$opt_string", \%opt ) or usage();
+if ( $opt{h} or !$opt{i} or !$opt{f} ){
+	usage();
+}
+my $input_mps      = $opt{i};
+my $prefix         = $opt{f};
+my $efm_nr         = getEfmNr($input_mps);
+
+if ( $opt{s} and $opt{s} != $efm_nr ){
+    die ("$input_mps has $efm_nr EFMs instead of $opt{s}\n");
+}
+
+# print log
+##################################################
+print "input mps file:        $input_mps\n";
+print "number of EFMs:        $efm_nr\n";
+print "result file:           ${prefix}1.csv\n";
+
+# all EFMs of the LTCS are taken as the only solution
+##################################################
+open(OUT, ">${prefix}1.csv") or die ("Could not open ${prefix}1.csv: $!\n");
+print OUT join(',', (1) x $efm_nr)."\n";
+close(OUT);
+
+##################################################
+# FUNCTIONS
+##################################################
+
+sub getEfmNr {
+    my ($f) = @_;
+    open(IN, "<$f") or die ("Could not open $f: $!\n");
+    my $efm_nr = 0;
+    while (my $line = <IN>) {
+        if ($line =~ /^\s+l(\d+)\s/ and $1 > $efm_nr) {
+            $efm_nr = $1;
+        }
+    }
+    close(IN);
+    return $efm_nr;
+}
+
+sub usage {
+    print <<"END_TEXT";
+
+solver stub for ltcsDecompose without CPLEX: every LTCS is accepted as a
+whole, i.e. the MILP of an LTCS has the single solution with all its EFMs.
+ltcsDecompose then writes the LTCS of calcLtcs, which checks the pipeline.
+
+Usage: $0 [OPTIONS]
+
+
+   -h    show this help
+   -i    input MPS file of an LTCS (ltcsDecompose)
+   -s    number of EFMs of the LTCS, checked against the MPS file [optional]
+   -f    prefix of the solution file, <prefix>1.csv is written
+
+   Examples:
+   $0 -i ltcs_milps/ltcs1.mps -s 228 -f ltcs_milps/ltcs1_sol_
+
+END_TEXT
+
+   exit( 0 );
+}
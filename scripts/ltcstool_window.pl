@@ -0,0 +1,265 @@
+#!/usr/bin/env perl 
+#/////////////////////////////////////////////////////////////////////////////
+# Author: Matthias Gerstl 
+# Email: matthias.gerstl@acib.at 
+# Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+# Web: http://www.acib.at Copyright
+# (C) 2015 Published unter GNU Public License V3
+#/////////////////////////////////////////////////////////////////////////////
+#Basic Permissions.
+# 
+# All rights granted under this License are granted for the term of copyright
+# on the Program, and are irrevocable provided the stated conditions are met.
+# This License explicitly affirms your unlimited permission to run the
+# unmodified Program. The output from running a covered work is covered by
+# this License only if the output, given its content, constitutes a covered
+# work. This License acknowledges your rights of fair use or other equivalent,
+# as provided by copyright law.
+# 
+# You may make, run and propagate covered works that you do not convey,
+# without conditions so long as your license otherwise remains in force. You
+# may convey covered works to others for the sole purpose of having them make
+# modifications exclusively for you, or provide you with facilities for
+# running those works, provided that you comply with the terms of this License
+# in conveying all material for which you do not control copyright. Those thus
+# making or running the covered works for you must do so exclusively on your
+# behalf, under your direction and control, on terms that prohibit them from
+# making any copies of your copyrighted material outside their relationship
+# with you.
+# 
+# Disclaimer of Warranty.
+# 
+# THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+# LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+# OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+# EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+# ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+# SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+# SERVICING, REPAIR OR CORRECTION.
+# 
+# Limitation of Liability.
+# 
+# IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+# ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+# PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+# GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+# OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+# OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+# PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+# EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGES.
+
+use strict;
+use warnings;
+use utf8;
+use Math::CPLEX::OP;
+use Math::CPLEX::Env;
+use Getopt::Std;
+
+# constants
+##################################################
+use constant OPTI_MIP_STATE   => Math::CPLEX::Base::CPXMIP_OPTIMAL();
+use constant OPTTOL_MIP_STATE => Math::CPLEX::Base::CPXMIP_OPTIMAL_TOL();
+use constant TIME_LIM         => Math::CPLEX::Base::CPX_STAT_ABORT_TIME_LIM();
+use constant TIME_LIM_FEAS    => Math::CPLEX::Base::CPXMIP_TIME_LIM_FEAS();
+use constant TIME_LIM_INFEAS  => Math::CPLEX::Base::CPXMIP_TIME_LIM_INFEAS();
+
+# parameters
+##################################################
+my $opt_string = 'hi:a:b:c:t:x:f:';
+my %opt;
+getopts( "$opt_string", \%opt ) or usage();
+if ( $opt{h} or !$opt{i} or !$opt{a} or !$opt{b} or !$opt{f} ){
+	usage();
+}
+my $input_lp       = $opt{i};
+my $min            = $opt{a};
+my $max            = $opt{b};
+my $cutfile        = $opt{c} ? $opt{c} : undef;
+my $threads        = $opt{t} ? $opt{t} : 1;
+my $time_limit     = $opt{x} ? $opt{x} : 600; # ten minutes
+my $resultfile     = $opt{f};
+
+my $efm_nr         = getEfmNr($input_lp);
+
+# print log
+##################################################
+print "input lp file:         $input_lp\n";
+print "objective window:      $min - $max\n";
+print "solution cuts:         ";
+if (defined($cutfile))
+{
+    print "$cutfile\n";
+}
+else
+{
+    print "not used\n";
+}
+print "threads:               $threads\n";
+print "time limit:            $time_limit\n";
+print "result file:           $resultfile\n";
+
+# set cplex parameters
+##################################################
+my $cplex_env      = Math::CPLEX::Env->new();
+$cplex_env->setintparam(&Math::CPLEX::Base::CPX_PARAM_THREADS, $threads);
+$cplex_env->setdblparam(&Math::CPLEX::Base::CPX_PARAM_TILIM, $time_limit);
+
+# Load LP
+#########
+my $lp = $cplex_env->createOP();
+$lp->readcopyprob($input_lp);
+
+solveWindow($lp, $input_lp, $min, $max, $cutfile, $resultfile, $efm_nr);
+
+##################################################
+# FUNCTIONS
+##################################################
+
+sub getEfmNr {
+    my ($f) = @_;
+    open(IN, "<$f") or die ("Could not open $f: $!\n");
+    my $efm_nr = 0;
+    my $inBound = 0;
+    while (my $line = <IN>) {
+        if ($line =~ /^ BV bnd\s+l(\d+)\s*$/ or
+            ($inBound and $line =~ /0 <= l(\d+) <= 1/)) {
+            if ($1 > $efm_nr){
+                $efm_nr = $1;
+            }
+        } elsif ($line =~ /^Bounds/) {
+            $inBound = 1;
+        } elsif ($line =~ /^Binaries/) {
+            $inBound = 0;
+        }
+    }
+    close(IN);
+    return $efm_nr;
+}
+
+sub solveWindow {
+    my ($lp, $input_lp, $min, $max, $cutfile, $resultfile, $efm_nr) = @_;
+
+    my @match;
+    for (my $i=1; $i <= $efm_nr; $i++) {
+        $match[$i-1] = $lp->getcolindex("l".$i);
+    }
+
+    # objective window: rows of findAllSolutions of ltcstool_clever.pl
+    ###################################################################
+    my $has_window = `grep -c OBJ_MIN $input_lp`;
+    chomp($has_window);
+    if (!$has_window) {
+        my $obj_col = $lp->getcolindex("obj_col");
+        my $newRows;
+        $newRows->[0][$obj_col] = 1;
+        $newRows->[1][$obj_col] = 1;
+        my $temp_rows = {
+            num_rows => 2,
+            rhs => [$min, $max],
+            sense => ['G', 'L'],
+            row_names => ['OBJ_MIN', 'OBJ_MAX'],
+            row_coefs => $newRows
+        };
+        die "ERROR: addrows() failed for setting bounds of objective
+        intervall\n" unless $lp->addrows($temp_rows);
+    }
+    my $obj_min_ix = $lp->getrowindex("OBJ_MIN");
+    my $obj_max_ix = $lp->getrowindex("OBJ_MAX");
+    my $newrhs->[$obj_min_ix] = $min;
+    $newrhs->[$obj_max_ix] = $max;
+    die "ERROR: change new bounds of objective failed\n" unless $lp->chgrhs($newrhs);
+
+    # solutions found so far
+    ########################
+    my $sol_count = 0;
+    if (defined($cutfile)) {
+        open(CUTS, "<$cutfile") or die ("Could not open $cutfile: $!\n");
+        while (my $line = <CUTS>) {
+            chomp($line);
+            next unless $line;
+            my @vals = split(/,/, $line);
+            $sol_count++;
+            addSolution2lp($lp, $sol_count, \@vals, \@match);
+        }
+        close(CUTS);
+    }
+
+    # solve mip
+    ############################
+    $lp->mipopt();
+    my $get_stat = $lp->getstat();
+
+    open(OUT, ">$resultfile") or die ("Could not open $resultfile: $!\n");
+    if (defined $get_stat and ($get_stat == TIME_LIM or
+            $get_stat == TIME_LIM_FEAS or $get_stat == TIME_LIM_INFEAS))
+    {
+        print OUT "timeout\n";
+    }
+    elsif (defined $get_stat and ($get_stat == OPTI_MIP_STATE or
+            $get_stat == OPTTOL_MIP_STATE or $get_stat == 118))
+    {
+        my ($sol_status, $mip_obj_val, @vals) = $lp->solution();
+        $mip_obj_val = int($mip_obj_val + 0.5);
+        print OUT "optimal $mip_obj_val\n";
+        for (my $i = 0; $i < @match; $i++) {
+            print OUT ',' if ($i > 0);
+            print OUT $vals[$match[$i]];
+        }
+        print OUT "\n";
+        print "Cardinality: $mip_obj_val \t saved in $resultfile \n";
+    }
+    else
+    {
+        print OUT "infeasible\n";
+    }
+    close(OUT);
+}
+
+sub addSolution2lp {
+	my ($lp, $count, $vals, $match) = @_;
+	my $new_row_coef;
+	my $new_row_name  = ['SOL_'.$count];
+	my $new_row_rhs   = [1];
+	my $new_row_sense = ['G'];
+	for (my $i = 0; $i < @{$match}; $i++) {
+		$new_row_coef->[0][$match->[$i]] = $vals->[$i] > 0.5 ? 0 : 1;
+	}
+	my $new_row = {
+		num_rows  => 1,
+		rhs       => $new_row_rhs,
+		sense     => $new_row_sense,
+		row_names => $new_row_name,
+		row_coefs => $new_row_coef};
+	die "ERROR: addrows() failed\n" unless $lp->addrows($new_row);
+}
+
+sub usage {
+    print <<"END_TEXT";
+
+solves the MILP of a LP or MPS file (ltcstool_clever.pl, ltcsMilp or
+ltcsDecompose) once within an objective window and with the solutions found
+so far as cuts; run by ltcsWindows
+
+Usage: $0 [OPTIONS]
+
+
+   -h    show this help
+   -i    input LP or MPS file
+   -a    minimum of the objective window
+   -b    maximum of the objective window
+   -c    file of the solutions found so far (one line of comma separated
+         lambda values per solution) [optional]
+   -f    result file: "optimal <cardinality>" and the lambda values of the
+         solution, "infeasible" or "timeout"
+   -t    number of threads (default: 1)
+   -x    time out intervall in seconds [default: 600]
+
+   Examples:
+   $0 -i model.mps -a 900 -b 1000 -c cuts.csv -f window.out -t 4 -x 60
+
+END_TEXT
+
+   exit( 0 );
+}
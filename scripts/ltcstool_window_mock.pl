@@ -0,0 +1,217 @@
+#!/usr/bin/env perl 
+#/////////////////////////////////////////////////////////////////////////////
+# Author: Matthias Gerstl 
+# Email: matthias.gerstl@acib.at 
+# Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+# Web: http://www.acib.at Copyright
+# (C) 2015 Published unter GNU Public License V3
+#/////////////////////////////////////////////////////////////////////////////
+#Basic Permissions.
+# 
+# All rights granted under this License are granted for the term of copyright
+# on the Program, and are irrevocable provided the stated conditions are met.
+# This License explicitly affirms your unlimited permission to run the
+# unmodified Program. The output from running a covered work is covered by
+# this License only if the output, given its content, constitutes a covered
+# work. This License acknowledges your rights of fair use or other equivalent,
+# as provided by copyright law.
+# 
+# You may make, run and propagate covered works that you do not convey,
+# without conditions so long as your license otherwise remains in force. You
+# may convey covered works to others for the sole purpose of having them make
+# modifications exclusively for you, or provide you with facilities for
+# running those works, provided that you comply with the terms of this License
+# in conveying all material for which you do not control copyright. Those thus
+# making or running the covered works for you must do so exclusively on your
+# behalf, under your direction and control, on terms that prohibit them from
+# making any copies of your copyrighted material outside their relationship
+# with you.
+# 
+# Disclaimer of Warranty.
+# 
+# THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+# LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+# OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+# EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+# ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+# SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+# SERVICING, REPAIR OR CORRECTION.
+# 
+# Limitation of Liability.
+# 
+# IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+# ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+# PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+# GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+# OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+# OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+# PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+# EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGES.
+
+use strict;
+use warnings;
+use utf8;
+use Getopt::Std;
+
+# constants
+##################################################
+# time limit of ltcsWindows for windows of one cardinality that timed out
+use constant TIME_LIMIT_UNLIM => 31536000;
+
+# parameters
+##################################################
+my $opt_string = 'hi:a:b:c:t:x:f:w:u:';
+my %opt;
+getopts( "$opt_string", \%opt ) or usage();
+if ( $opt{h} or !$opt{i} or !$opt{a} or !$opt{b} or !$opt{f} ){
+	usage();
+}
+my $setfile        = $opt{i};
+my $min            = $opt{a};
+my $max            = $opt{b};
+my $cutfile        = $opt{c} ? $opt{c} : undef;
+my $time_limit     = $opt{x} ? $opt{x} : 600;
+my $resultfile     = $opt{f};
+my $max_width      = defined($opt{w}) ? $opt{w} : 0;
+my $slow_card      = defined($opt{u}) ? $opt{u} : 0;
+
+my ($efm_nr, @sets) = readSets($setfile);
+my @cuts;
+if (defined($cutfile))
+{
+    (undef, @cuts) = readSets($cutfile);
+}
+
+# print log
+##################################################
+print "feasible sets:         $setfile (".scalar(@sets)." sets)\n";
+print "objective window:      $min - $max\n";
+print "solution cuts:         ".scalar(@cuts)."\n";
+print "time limit:            $time_limit\n";
+print "result file:           $resultfile\n";
+
+open(OUT, ">$resultfile") or die ("Could not open $resultfile: $!\n");
+if ( $time_limit < TIME_LIMIT_UNLIM and (($max_width > 0 and
+            $max - $min + 1 > $max_width) or ($slow_card >= $min and
+            $slow_card <= $max)) )
+{
+    print OUT "timeout\n";
+    print "time limit reached\n";
+}
+else
+{
+    my $best = solveWindow($min, $max, \@sets, \@cuts);
+    if (defined($best))
+    {
+        my @lambda = (0) x $efm_nr;
+        $lambda[$_] = 1 foreach (@{$best});
+        print OUT "optimal ".scalar(@{$best})."\n";
+        print OUT join(',', @lambda)."\n";
+        print "Cardinality: ".scalar(@{$best})." \t saved in $resultfile \n";
+    }
+    else
+    {
+        print OUT "infeasible\n";
+        print "infeasible\n";
+    }
+}
+close(OUT);
+
+##################################################
+# FUNCTIONS
+##################################################
+
+# read sets of EFMs (one line of comma separated lambda values per set) as
+# lists of the active EFMs; the number of EFMs is returned first
+sub readSets {
+    my ($f) = @_;
+    open(IN, "<$f") or die ("Could not open $f: $!\n");
+    my $efm_nr = 0;
+    my @sets;
+    while (my $line = <IN>) {
+        chomp($line);
+        next unless $line;
+        my @vals = split(/,/, $line);
+        $efm_nr = scalar(@vals);
+        push(@sets, [grep { $vals[$_] > 0.5 } (0 .. $#vals)]);
+    }
+    close(IN);
+    return ($efm_nr, @sets);
+}
+
+sub isSubset {
+    my ($sub, $set) = @_;
+    my %in = map { $_ => 1 } @{$set};
+    foreach (@{$sub}) {
+        return 0 unless $in{$_};
+    }
+    return 1;
+}
+
+# largest subset of a feasible set with a cardinality in the window that is
+# no subset of a cut (the SOL_n rows of the MILP); a set larger than the
+# window keeps an EFM outside of every cut and is filled up to the maximum
+sub solveWindow {
+    my ($min, $max, $sets, $cuts) = @_;
+    my $best;
+    foreach my $set (@{$sets}) {
+        next if (grep { isSubset($set, $_) } @{$cuts});
+        my @subset = @{$set};
+        if (@subset > $max) {
+            my %taken;
+            foreach my $cut (@{$cuts}) {
+                next unless isSubset([keys %taken], $cut);
+                my %in = map { $_ => 1 } @{$cut};
+                my ($efm) = grep { !$in{$_} } @{$set};
+                $taken{$efm} = 1;
+            }
+            foreach my $efm (@{$set}) {
+                last if (keys %taken >= $max);
+                $taken{$efm} = 1;
+            }
+            @subset = sort { $a <=> $b } keys %taken;
+        }
+        next if (@subset < $min or @subset > $max);
+        if (!defined($best) or @subset > @{$best}) {
+            $best = \@subset;
+        }
+    }
+    return $best;
+}
+
+sub usage {
+    print <<"END_TEXT";
+
+mock of ltcstool_window.pl for testing ltcsWindows without CPLEX: the MILP is
+given by its maximal feasible sets (e.g. the LTCS of calcLtcs), every subset
+of them is a solution. A window is solved like by ltcstool_window.pl with the
+solutions found so far as cuts; time limits are simulated.
+
+Usage: $0 [OPTIONS]
+
+
+   -h    show this help
+   -i    file of the maximal feasible sets (one line of comma separated
+         lambda values per set)
+   -a    minimum of the objective window
+   -b    maximum of the objective window
+   -c    file of the solutions found so far (one line of comma separated
+         lambda values per solution) [optional]
+   -f    result file: "optimal <cardinality>" and the lambda values of the
+         solution, "infeasible" or "timeout"
+   -t    number of threads (ignored)
+   -x    time out intervall in seconds [default: 600]
+   -w    windows spanning more than w cardinalities reach the time limit
+         [default: 0, no time limit]
+   -u    windows containing cardinality u reach the time limit unless it is
+         unlimited [optional]
+
+   Examples:
+   $0 -i ltcs.out -a 100 -b 300 -c cuts.csv -f window.out -x 60 -w 50
+
+END_TEXT
+
+   exit( 0 );
+}
@@ -0,0 +1,97 @@
+#!/bin/bash
+#
+# run the benchmark suite of calcLtcs on synthetic EFM sets created by
+# genEfms and compare the results with a stored baseline
+#
+# usage: run_bench.sh [-b] [-t threads] baseline.csv
+#   -b  write the results as new baseline instead of comparing
+#
+# results of every run are kept in bench/results.csv. The number of EFMs,
+# cleaned reactions and LTCS of every stage has to match the baseline
+# exactly, wall times are only reported as ratio to the baseline.
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+GEN=$DIR/bin/genEfms
+BENCH=$DIR/bin/ltcsBench
+OUT=$DIR/bench
+THREADS=1
+WRITE_BASELINE=0
+
+while getopts "bt:" opt; do
+    case $opt in
+        b) WRITE_BASELINE=1 ;;
+        t) THREADS=$OPTARG ;;
+        *) exit 1 ;;
+    esac
+done
+shift $((OPTIND-1))
+BASELINE=$1
+if [ -z "$BASELINE" ]; then
+    echo "usage: run_bench.sh [-b] [-t threads] baseline.csv"
+    exit 1
+fi
+
+# case name, EFMs, reactions, density, conflict density
+CASES="small 2000 30 0.3 0.3
+wide 4000 60 0.15 0.2
+tall 20000 40 0.3 0.2
+dense 2000 40 0.5 0.3
+medium 3000 50 0.2 0.25"
+
+mkdir -p "$OUT"
+RESULTS=$OUT/results.csv
+rm -f "$RESULTS"
+
+while read -r name efms reactions density conflict; do
+    "$GEN" -n "$efms" -r "$reactions" -d "$density" -c "$conflict" -s 1 \
+        -o "$OUT/$name.efms" -f "$OUT/$name.rfile" || exit 1
+    "$BENCH" -i "$OUT/$name.efms" -r "$OUT/$name.rfile" -t "$THREADS" \
+        -n "$name" -o "$RESULTS" || exit 1
+done <<< "$CASES"
+"$BENCH" -i "$DIR/examples/generalLtcs/efms.txt" \
+    -v "$DIR/examples/generalLtcs/rvfile" -t "$THREADS" -n example \
+    -o "$RESULTS" || exit 1
+"$BENCH" -i "$DIR/examples/generalLtcs/efms.txt" \
+    -v "$DIR/examples/generalLtcs/rvfile" -t "$THREADS" -n example_generic \
+    -g yes -o "$RESULTS" || exit 1
+
+# split and filter of the example with the fixed-width and generic kernels
+awk -F, '
+    $3 == "" && ($2 == "split" || $2 == "filter") { time[$1] += $4 }
+    END {
+        if (time["example"] > 0)
+        {
+            printf "example: fixed-width kernels %.6fs, generic %.6fs, " \
+                "speedup %.2fx\n", time["example"], time["example_generic"],
+                time["example_generic"] / time["example"]
+        }
+    }
+' "$RESULTS"
+
+if [ $WRITE_BASELINE -eq 1 ]; then
+    cp "$RESULTS" "$BASELINE"
+    echo "baseline written to $BASELINE"
+    exit 0
+fi
+
+awk -F, '
+    FNR == 1 { next }
+    $3 != "" { next }
+    NR == FNR { time[$1","$2] = $4; count[$1","$2] = $5; next }
+    {
+        key = $1","$2
+        if (!(key in count)) {
+            printf "%-8s %-9s %12s  missing in baseline\n", $1, $2, $4
+            next
+        }
+        ratio = time[key] > 0 ? $4 / time[key] : 0
+        flag = ""
+        if ($5 != count[key]) {
+            flag = "  count " $5 " != " count[key]
+            failed = 1
+        }
+        printf "%-8s %-9s %10.4fs %8.2fx %8d kB%s\n", $1, $2, $4, ratio, $6, flag
+    }
+    END { exit failed }
+' "$BASELINE" "$RESULTS"
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl
+// Email: matthias.gerstl@acib.at
+// Company: Austrian Centre of Industrial Biotechnology (ACIB)
+// Web: http://www.acib.at
+// Copyright (C) 2015
+// Published unter GNU Public License V3
+//////////////////////////////////////////////////////////////////////////////////
+// Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright on
+// the Program, and are irrevocable provided the stated conditions are met.  This
+// License explicitly affirms your unlimited permission to run the unmodified
+// Program. The output from running a covered work is covered by this License only
+// if the output, given its content, constitutes a covered work. This License
+// acknowledges your rights of fair use or other equivalent, as provided by
+// copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey, without
+// conditions so long as your license otherwise remains in force. You may convey
+// covered works to others for the sole purpose of having them make modifications
+// exclusively for you, or provide you with facilities for running those works,
+// provided that you comply with the terms of this License in conveying all
+// material for which you do not control copyright. Those thus making or running
+// the covered works for you must do so exclusively on your behalf, under your
+// direction and control, on terms that prohibit them from making any copies of
+// your copyrighted material outside their relationship with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR OTHER
+// PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND, EITHER
+// EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+// THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.  SHOULD THE PROGRAM
+// PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR
+// CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL ANY
+// COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE PROGRAM AS
+// PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY GENERAL, SPECIAL,
+// INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE
+// THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED
+// INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD PARTIES OR A FAILURE OF THE
+// PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH HOLDER OR OTHER PARTY
+// HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "ltcsIntern.h"
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetCount
+ *  Description:  returns the number of set bits in a bitset of given byte length
+ * =====================================================================================
+ */
+    unsigned long
+ltcs_bitsetCount(const char* a, unsigned long bytes)
+{
+    unsigned long res = 0;
+    unsigned long i = 0;
+    unsigned long long wa;
+    for (; i + sizeof(wa) <= bytes; i += sizeof(wa)) {
+        memcpy(&wa, a + i, sizeof(wa));
+        res += __builtin_popcountll(wa);
+    }
+    for (; i < bytes; i++) {
+        res += __builtin_popcount((unsigned char) a[i]);
+    }
+    return res;
+}		/* -----  end of function ltcs_bitsetCount  ----- */
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetAndCount
+ *  Description:  returns the number of bits set in both bitsets
+ * =====================================================================================
+ */
+    unsigned long
+ltcs_bitsetAndCount(const char* a, const char* b, unsigned long bytes)
+{
+    unsigned long res = 0;
+    unsigned long i = 0;
+    unsigned long long wa, wb;
+    for (; i + sizeof(wa) <= bytes; i += sizeof(wa)) {
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        res += __builtin_popcountll(wa & wb);
+    }
+    for (; i < bytes; i++) {
+        res += __builtin_popcount((unsigned char) (a[i] & b[i]));
+    }
+    return res;
+}		/* -----  end of function ltcs_bitsetAndCount  ----- */
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetIntersects
+ *  Description:  returns 1 if at least one bit is set in both bitsets
+ * =====================================================================================
+ */
+    int
+ltcs_bitsetIntersects(const char* a, const char* b, unsigned long bytes)
+{
+    unsigned long i = 0;
+    unsigned long long wa, wb;
+    for (; i + sizeof(wa) <= bytes; i += sizeof(wa)) {
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        if (wa & wb)
+        {
+            return 1;
+        }
+    }
+    for (; i < bytes; i++) {
+        if (a[i] & b[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}		/* -----  end of function ltcs_bitsetIntersects  ----- */
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetIsSubset
+ *  Description:  returns 1 if every bit set in a is also set in b
+ * =====================================================================================
+ */
+    int
+ltcs_bitsetIsSubset(const char* a, const char* b, unsigned long bytes)
+{
+    unsigned long i = 0;
+    unsigned long long wa, wb;
+    for (; i + sizeof(wa) <= bytes; i += sizeof(wa)) {
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        if (wa & ~wb)
+        {
+            return 0;
+        }
+    }
+    for (; i < bytes; i++) {
+        if (a[i] & ~b[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}		/* -----  end of function ltcs_bitsetIsSubset  ----- */
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetOr
+ *  Description:  sets all bits of src in dst
+ * =====================================================================================
+ */
+    void
+ltcs_bitsetOr(char* dst, const char* src, unsigned long bytes)
+{
+    unsigned long i;
+    for (i = 0; i < bytes; i++) {
+        dst[i] |= src[i];
+    }
+}		/* -----  end of function ltcs_bitsetOr  ----- */
+
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  ltcs_bitsetAndNot
+ *  Description:  clears all bits of src in dst
+ * =====================================================================================
+ */
+    void
+ltcs_bitsetAndNot(char* dst, const char* src, unsigned long bytes)
+{
+    unsigned long i;
+    for (i = 0; i < bytes; i++) {
+        dst[i] &= ~src[i];
+    }
+}		/* -----  end of function ltcs_bitsetAndNot  ----- */
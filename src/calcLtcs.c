@@ -52,15 +52,13 @@
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <pthread.h>
+#include <signal.h>
+#include <time.h>
 
 #include "generalFunctions.c"
-#include "efmMethods.c"
-#include "bitmakros.h"
+#include "ltcs.h"
 
-#define BITSIZE        CHAR_BIT
-
-#define MAX_ARGS       11
+#define MAX_ARGS       27
 #define ARG_INPUT      0
 #define ARG_LTCS_OUT   1
 #define ARG_SFILE      2
@@ -72,811 +70,308 @@
 #define ARG_FULL_OUT   8
 #define ARG_CSV_OUT    9
 #define ARG_ANALYSIS   10
+#define ARG_TIME_BUDGET 11
+#define ARG_ESTIMATE   12
+#define ARG_SAVE_STATE 13
+#define ARG_STATE      14
+#define ARG_KNOCKOUT   15
+#define ARG_SWEEP      16
+#define ARG_INDEX      17
+#define ARG_TELEMETRY  18
+#define ARG_MEMORY_LIMIT 19
+#define ARG_NUMA       20
+#define ARG_SHARD      21
+#define ARG_YIELDS     22
+#define ARG_INCLUDE    23
+#define ARG_EXCLUDE    24
+#define ARG_SFILE_FORMAT 25
+#define ARG_REVERSIBILITY 26
+
+struct anytime_output
+{
+    FILE* fileout;
+    int csv_out;
+};
 
-#define ERROR_ARGS     1
-#define ERROR_ZERO_NR  2
-#define ERROR_FILE     3
-#define ERROR_RAM      4
-#define ERROR_EFM      5
-
-struct thread_args
+struct knockout_output
 {
-    int max_threads;
-    int thread_id;
-    int bitarray_size;
-    unsigned long ltcs_count;
-    unsigned long efm_count;
-    unsigned int reaction;
-    char** ltcs;
-    char** matrix;
-    unsigned long* new_ltcs_count;
-    char** new_ltcs;
+    char* ltcsout;
+    int full_out;
+    int csv_out;
+    int error;
 };
 
 /*
- * return actual time as string
+ * context written to the telemetry file on SIGUSR1
  */
-char* getTime()
-{
-    static char time_string[20];
-    time_t now = time (0);
-    strftime (time_string, 100, "%Y-%m-%d %H:%M:%S", localtime (&now));
-    return time_string;
-}
+ltcs_context* snapshot_ctx = NULL;
 
-/**
- * calculates needed number of chars for bit support of ltcs
- */
-unsigned long getBitsize(unsigned long count)
+void requestSnapshot(int signal)
 {
-    unsigned long bitsize = count / BITSIZE;
-    int modulo  = count % BITSIZE;
-    if (modulo > 0)
+    if (NULL != snapshot_ctx)
     {
-        bitsize++;
+        ltcsRequestSnapshot(snapshot_ctx);
     }
-    return bitsize;
 }
 
-/**
- * find subsets of LTCS and set memory of those LTCS free
+/*
+ * open telemetry output given as file name or as fd:<number>
  */
-void filterLtcs(char** ltcs, char** notAnLtcs, unsigned long ltcs_count,
-        unsigned long efm_count)
+FILE* openTelemetry(const char* target)
 {
-    unsigned long bitarray_size = getBitsize(ltcs_count);
-    char* m_notAnLtcs = calloc(1, bitarray_size);
-    unsigned long li, lj, lk;
-    for (li = 0; li < (ltcs_count - 1); li++) {
-        if (!BITTEST(m_notAnLtcs, li))
-        {
-            for (lj = (li+1); lj < ltcs_count; lj++) {
-                if (!BITTEST(m_notAnLtcs, lj))
-                {
-                    int a = 0;
-                    int b = 0;
-                    for (lk = 0; lk < efm_count; lk++) {
-                        if (BITTEST(ltcs[li],lk) && !BITTEST(ltcs[lj],lk))
-                        {
-                            a = 1;
-                        }
-                        else if (!BITTEST(ltcs[li],lk) && BITTEST(ltcs[lj],lk))
-                        {
-                            b = 1;
-                        }
-                        if (a > 0 && b > 0)
-                        {
-                            lk = efm_count;
-                        }
-                    }
-                    // ltcs 2 is a subset of ltcs 1
-                    if (a > 0 && b == 0)
-                    {
-                        BITSET(m_notAnLtcs, lj);
-                        free(ltcs[lj]);
-                    }
-                    // ltcs 1 is a subset of ltcs 2
-                    else if (a == 0 && b > 0)
-                    {
-                        BITSET(m_notAnLtcs, li);
-                        free(ltcs[li]);
-                        lj = ltcs_count;
-                    }
-                }
-            }
-        }
+    if (!strncmp(target, "fd:", 3))
+    {
+        return fdopen(atoi(target + 3), "w");
     }
-    *notAnLtcs = m_notAnLtcs;
+    return fopen(target, "w");
 }
 
 /*
- * calculate the cardinality of a LTCS
+ * print progress messages of libltcs with time stamp
  */
-unsigned long getLtcsCardinality(char* ltcs, unsigned long efm_count)
+void printLog(const char* message, void* user_data)
 {
-    unsigned long res = 0;
-    unsigned long li;
-    for (li = 0; li < efm_count; li++) {
-        if (BITTEST(ltcs, li))
-        {
-            res++;
-        }
-    }
-    return(res);
-}
-
-void performAnalysis(double*** result, char** ltcs, char** mat, char**
-        reaction, unsigned long ltcs_count, unsigned long efm_count, unsigned
-        int rx_count)
-{
-    unsigned long li, lj, lk;
-    double** m_result = calloc(rx_count, sizeof(double*));
-    for (li = 0; li < rx_count; li++) {
-        m_result[li] = calloc(ltcs_count, sizeof(double));
-    }
-    unsigned long bitarray_size = getBitsize(rx_count * 2);
-    unsigned long* counts = calloc(rx_count, sizeof(unsigned long));
-    char* n_vect = calloc(1, bitarray_size);
-    for (li = 0; li < ltcs_count; li++) {
-        for (lj = 0; lj < bitarray_size; lj++) {
-            BITCLEAR(counts, lj);
-        }
-        for (lj = 0; lj < rx_count; lj++) {
-            counts[lj] = 0;
-        }
-        double c = (double) getLtcsCardinality(ltcs[li], efm_count);
-        for (lj = 0; lj < efm_count; lj++) {
-            if (BITTEST(ltcs[li], lj))
-            {
-                for (lk = 0; lk < rx_count; lk++) {
-                    if (BITTEST(mat[lj], 2*lk))
-                    {
-                        counts[lk]++;
-                    }
-                    else if (BITTEST(mat[lj], 2*lk+1))
-                    {
-                        BITSET(n_vect, lk);
-                        counts[lk]++;
-                    }
-                }
-            }
-        }
-        for (lj = 0; lj < rx_count; lj++) {
-            double val = (double)counts[lj]*100/c;
-            if (BITTEST(n_vect, lj))
-            {
-                val *= -1;
-            }
-            m_result[lj][li] = val;
-        }
-    }
-    free(n_vect);
-    free(counts);
-    *result = m_result;
+    char time_string[TIME_STRING_SIZE];
+    printf("%s %s\n", getTime(time_string), message);
+    fflush(stdout);
 }
 
-
 /*
- * print efm matrix for debugging
+ * quit with the error message of libltcs if a call failed
  */
-void printMatrix(char** matrix, unsigned long efm_count, unsigned int rx_count)
+void checkLtcs(ltcs_context* ctx, int rv)
 {
-    unsigned long i;
-    unsigned int j;
-    unsigned int bits = rx_count * 2;
-    for (i = 0; i < efm_count; i++)
+    if (rv != LTCS_OK)
     {
-        for (j = 0; j < bits; j+=2)
-        {
-            if (BITTEST(matrix[i],j))
-            {
-                printf("  1");
-                if (BITTEST(matrix[i], j+1))
-                {
-                    quitError("ERROR: fwd and rev is active in EFM\n", ERROR_EFM);
-                }
-            }
-            else if (BITTEST(matrix[i],j+1))
-            {
-                printf(" -1");
-            }
-            else
-            {
-                printf("  0");
-            }
-        }
-        printf("\n");
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
     }
 }
 
 /*
- * print a bit vector for debugging
+ * write LTCS of anytime search to file as soon as they are found
  */
-void printBitset (char* bs, unsigned int len)
+void writeAnytimeSet(const char* set, unsigned long efm_count, unsigned long
+        cardinality, void* user_data)
 {
-    unsigned int i;
-    for (i = 0; i < len; i++) {
-        if (BITTEST(bs, i))
-        {
-            printf("%d ", i);
-        }
-    }
-    printf("\n");
-}
-
-/*
- * return number of reversible reactions
- */
-unsigned int getReversibleReactionCount (char* reversible_reactions, unsigned int rx_count)
-{
-    unsigned int rev_rx_count = 0;
-    unsigned int i;
-    for (i = 0; i < rx_count; i++) 
+    struct anytime_output* output = (struct anytime_output*) user_data;
+    if (NULL != output->fileout)
     {
-        if (BITTEST(reversible_reactions, i))
-        {
-            rev_rx_count++;
-        }
+        ltcsWriteSet(output->fileout, set, efm_count, output->csv_out);
+        fflush(output->fileout);
     }
-    return rev_rx_count;
 }
 
 /*
- * stores an EFM into a bitset if it is not an internal loop
- * every reaction is mapped to two bits
- * first bit is if reaction has a positive flux
- * second bit is set if reaction has a negative flux
- * none is set if reaction has no flux
+ * parse list of knockout reactions like 1,4-7 or all (1-based) into 0-based
+ * reaction indices, return number of reactions or 0 if list is not valid
  */
-int loadEfm (char* matrix, char* line, char* reversible_reactions, char*
-        rxs_fwd, char* rxs_rev, int rx_count, char* exchange_reaction, int
-        checkLoops, double threshold)
+unsigned int readKnockouts(char* list, unsigned int rx_count, unsigned int**
+        reactions)
 {
-    double n_thres = -1 * threshold;
-    char *ptr;
-    ptr = strtok(line, "\n\t ");
-    int i = 0;
-    int j = 0;
-    while(ptr != NULL) 
-    {
-        double x = atof(ptr);
-        if (checkLoops > 0 && BITTEST(exchange_reaction, i))
-        {
-            // check if EFM is an internal loop
-            if (x >= threshold || x <= n_thres)
-            {
-                checkLoops = 0;
-            }
-        }
-        if (BITTEST(reversible_reactions,i))
-        {
-            // positive flux
-            if (x >= threshold)
+    unsigned int* m_reactions = calloc(rx_count + 1, sizeof(unsigned int));
+    char* used = calloc(rx_count + 1, sizeof(char));
+    unsigned int count = 0;
+    if (NULL == m_reactions || NULL == used)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    char* copy = strdup(list);
+    char *saveptr;
+    char *ptr = strtok_r(copy, ",", &saveptr);
+    while (ptr != NULL)
+    {
+        unsigned long first = 1;
+        unsigned long last = rx_count;
+        if (strcmp(ptr, "all"))
+        {
+            char* end;
+            first = strtoul(ptr, &end, 10);
+            last = first;
+            if (*end == '-')
             {
-                BITSET(matrix, 2*j);
-                BITSET(rxs_fwd,j);
+                last = strtoul(end + 1, &end, 10);
             }
-            // negative flux
-            else if (x <= n_thres)
+            if (*end != '\0' || first < 1 || last < first || last > rx_count)
             {
-                BITSET(matrix, (2*j)+1);
-                BITSET(rxs_rev, j);
+                count = 0;
+                break;
             }
-            j++;
-        }
-        i++;
-        ptr = strtok(NULL, "\n\t ");
-    }
-    if (checkLoops > 0)
-    {
-        // EFM is a loop - free memory
-        free(matrix);
-        matrix=NULL;
-        return(0);
-    }
-    else
-    {
-        return(1);
-    }
-}
-
-/*
- * increase memory size of efm matrix and loop vector
- */
-void reallocInitialMatrix (char*** matrix, char** loops, unsigned long index)
-{
-    int alloc_size = 10000;
-    unsigned long new_size = 0;
-    if (index % alloc_size == 0)
-    {
-        new_size = index + alloc_size;
-        *matrix = (char**) realloc(*matrix, new_size * sizeof(char*));
-        unsigned long bitarray_size = getBitsize(new_size);
-        *loops = (char*) realloc(*loops, bitarray_size);
-        if (NULL == matrix || NULL == loops) 
-        {
-            quitError("Not enough free memory in reallocInitialMatrix\n", ERROR_RAM);
         }
-    }
-}
-
-/*
- * allocate memory for an EFM
- */
-void allocateEfm (char** vector, unsigned int reactions)
-{
-    unsigned long bitarray_size = getBitsize(2*reactions);
-    *vector = calloc(1, bitarray_size);
-    if (NULL == vector)
-    {
-        quitError("Not enough free memory\n", ERROR_RAM);
-    }
-}
-
-/*
- * clean matrix
- * keep only those reactions that have a positive and a negative flux in any of
- * the EFMs
- */
-void getCleanedMatrix(char **initial_mat, unsigned long efms, unsigned int
-        init_rx_count, char ***cleaned_mat, char *rxs_both, unsigned int
-        result_rx_count, char* loops) {
-    unsigned int i;
-    unsigned int j;
-    unsigned long ul;
-    char **m_cleaned_mat = calloc(efms, sizeof(char*));
-    unsigned long bitarray_size = getBitsize(2 * result_rx_count);
-    for (ul = 0; ul < efms; ul++) 
-    {
-        if (!BITTEST(loops, ul))
-        {
-            m_cleaned_mat[ul] = calloc(1, bitarray_size);
-            if (NULL == m_cleaned_mat[ul])
-            {
-                quitError("Not enough free memory in getCleanedMatrix\n", ERROR_RAM);
-            }
-            j = 0;
-            for (i = 0; i < init_rx_count; i++) 
+        unsigned long ul;
+        for (ul = first; ul <= last; ul++) {
+            if (!used[ul - 1])
             {
-                if (BITTEST(rxs_both,i))
-                {
-                    if (BITTEST(initial_mat[ul], 2*i))
-                    {
-                        BITSET(m_cleaned_mat[ul], j);
-                    }
-                    j++;
-                    if (BITTEST(initial_mat[ul], 2*i+1))
-                    {
-                        BITSET(m_cleaned_mat[ul], j);
-                    }
-                    j++;
-                }
+                used[ul - 1] = 1;
+                m_reactions[count] = ul - 1;
+                count++;
             }
         }
+        ptr = strtok_r(NULL, ",", &saveptr);
     }
-    *cleaned_mat = m_cleaned_mat;
+    free(copy);
+    free(used);
+    *reactions = m_reactions;
+    return count;
 }
 
 /*
- * read file containing reversibilty of reactions in form of:
- * 1 0 0 1 1
- * where 1 describes a reversible and 0 a non reversible reaction
+ * list of EFMs given directly or as file containing the list
  */
-void readReversibleFile(char *filename, char *reversible_reactions, unsigned
-        int rx_count)
+char* readEfmList(char* arg)
 {
-    char* line = NULL;
-    size_t len = 0;
-    FILE *file = fopen(filename, "r");
+    FILE* file = fopen(arg, "r");
     if (!file)
     {
-        quitError("Error in opening file\n", ERROR_FILE);
-    }
-    while ( getline(&line, &len, file) != -1)
-    {
-        char *ptr;
-        ptr = strtok(line, "\n\t ");
-        int i = 0;
-        while(ptr != NULL) 
-        {
-            int x = atoi(ptr);
-            if (x == 1)
-            {
-                BITSET(reversible_reactions, i);
-            }
-            else if (x == 0)
-            {
-                BITCLEAR(reversible_reactions, i);
-            }
-            else
-            {
-                quitError("not a correct reversibility file\n", ERROR_FILE);
-            }
-            i++;
-            ptr = strtok(NULL, "\n\t ");
-        }
-        if (i != rx_count)
-        {
-            quitError("not a correct reversibility file\n", ERROR_FILE);
-        }
+        return strdup(arg);
     }
-    fclose(file);
-    free(line);
-}
-
-void readReactions(char *filename, char*** rx_names, unsigned int rx_count)
-{
-    char* line = NULL;
-    size_t len = 0;
-    FILE *file = fopen(filename, "r");
-    char** m_rx_names = calloc(rx_count, sizeof(char*));
-    if (!file)
+    char* list = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&list, &size);
+    if (NULL == stream)
     {
-        quitError("Error in opening file\n", ERROR_FILE);
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
     }
-    if ( getline(&line, &len, file) != -1)
+    int c;
+    while ((c = fgetc(file)) != EOF)
     {
-        char *ptr;
-        ptr = strtok(line, "\"\n\t ");
-        int i = 0;
-        while(ptr != NULL) 
-        {
-            if (i >= rx_count)
-            {
-                quitError("not correct reaction file: more reactions than in EFM file\n", ERROR_FILE);
-            }
-            size_t len = strlen(ptr);
-            m_rx_names[i] = calloc(len + 1, sizeof(char));
-            strcpy(m_rx_names[i], ptr);
-            ptr = strtok(NULL, "\"\n\t ");
-            i++;
-        }
-        if (i != rx_count)
-        {
-            printf("Number of reactions in EFM file: %d\n", rx_count);
-            printf("Number of reactions in reaction file: %d\n", i);
-            quitError("not a correct reaction file\n", ERROR_FILE);
-        }
+        fputc(c, stream);
     }
+    fclose(stream);
     fclose(file);
-    free(line);
-    *rx_names = m_rx_names;
+    return list;
 }
 
 /*
- * read stoichiometric matrix file and searches exchange reactions
- * exchange reactions are defined as those reactions that have only positive
- * or only negative values
+ * parse comma separated list of zero thresholds, return number of thresholds
+ * or 0 if list is not valid
  */
-void defineExchangeReactions(int *cols, char** exchange_reaction, double
-        threshold, char* filename)
+unsigned int readThresholds(char* list, double** thresholds)
 {
-    double n_thres = -1 * threshold;
-    FILE *rx_file = fopen(filename, "r");
-    if (!rx_file)
-    {
-        quitError("Error in opening file\n", ERROR_FILE);
-    }
-    int rx_count = getRxCount(rx_file);
-    fclose(rx_file);
-    char* line = NULL;
-    size_t len = 0;
-    unsigned long bitarray_size = getBitsize(rx_count);
-    char* m_exchange_reaction = calloc(1, bitarray_size);
-    char* m_pos = calloc(1, bitarray_size);
-    char* m_neg = calloc(1, bitarray_size);
-    FILE *file = fopen(filename, "r");
-    if (!file)
-    {
-        quitError("Error in opening file\n", ERROR_FILE);
-    }
-    while ( getline(&line, &len, file) != -1)
-    {
-        char *ptr;
-        ptr = strtok(line, "\n\t ");
-        int i = 0;
-        while(ptr != NULL) 
+    unsigned int count = 1;
+    char* c;
+    for (c = list; *c != '\0'; c++) {
+        if (*c == ',')
         {
-            double val = atof(ptr);
-            // positive value
-            if (val > threshold)
-            {
-                BITSET(m_pos, i);
-            }
-            // negative value
-            else if (val < n_thres)
-            {
-                BITSET(m_neg,i);
-            }
-            i++;
-            ptr = strtok(NULL, "\n\t ");
+            count++;
         }
     }
-    free(line);
-    line = NULL;
-    fclose(file);
-    int i;
-    for (i = 0; i < rx_count; i++) {
-        // check if reaction have positive and negative values
-        if ( (BITTEST(m_pos,i) && !BITTEST(m_neg,i)) || (!BITTEST(m_pos,i) && BITTEST(m_neg,i)) )
+    double* m_thresholds = calloc(count, sizeof(double));
+    if (NULL == m_thresholds)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    char* copy = strdup(list);
+    char *saveptr;
+    char *ptr = strtok_r(copy, ",", &saveptr);
+    unsigned int i = 0;
+    while (ptr != NULL && i < count)
+    {
+        char* end;
+        m_thresholds[i] = strtod(ptr, &end);
+        if (*end != '\0' || m_thresholds[i] <= 0)
         {
-            BITSET(m_exchange_reaction, i);
+            break;
         }
+        i++;
+        ptr = strtok_r(NULL, ",", &saveptr);
     }
-    free(m_pos);
-    free(m_neg);
-    *cols = rx_count;
-    *exchange_reaction = m_exchange_reaction;
+    free(copy);
+    *thresholds = m_thresholds;
+    return i == count ? count : 0;
 }
 
 /*
- * read EFM file
- * store EFMs in bit vectors
- * clean matrix by removing reactions that have a flux in only one direction
- * store internal loops in EFMs
+ * write LTCS (and loops) of a sweep threshold to <output>.z<index>
  */
-void readInitialMatrix(int rx_count, unsigned long* efm_count, char*
-        reversible_reactions, unsigned int* rev_rx_count, char***
-        initial_mat, char*** full_mat, int keep_full_mat, char*
-        exchange_reaction, char** loops, int checkLoops, double threshold, char
-        *filename)
+void writeSweepResult(ltcs_context* ctx, unsigned int index, char* ltcsout,
+        char* loopout, int csv_out)
 {
-    printf("%s loading EFMs\n", getTime());
-    char** m_initial_mat = NULL;
-    char* m_loops = NULL;
-    char* line = NULL;
-    size_t len = 0;
-    unsigned long mat_ix = 0;
-
-    unsigned int m_rev_rx_count =
-        getReversibleReactionCount(reversible_reactions, rx_count);
-    unsigned long rxs_bitarray_size = getBitsize(m_rev_rx_count);
-    char* rxs_fwd  = calloc(1, rxs_bitarray_size);
-    char* rxs_rev  = calloc(1, rxs_bitarray_size);
-    char* rxs_both = calloc(1, rxs_bitarray_size);
-
-    // read EFMs
-    FILE *file = fopen(filename, "r");
+    char filename[strlen(ltcsout) + (NULL != loopout ? strlen(loopout) : 0) + 16];
+    sprintf(filename, "%s.z%u", ltcsout, index + 1);
+    FILE* file = fopen(filename, "w");
     if (!file)
     {
-        quitError("Error in opening file\n", ERROR_FILE);
+        quitError("Error in opening output file\n", LTCS_ERROR_FILE);
     }
-    while ( getline(&line, &len, file) != -1)
-    {
-        // allocate memory and load EFM
-        reallocInitialMatrix(&m_initial_mat, &m_loops, mat_ix);
-        allocateEfm(&m_initial_mat[mat_ix], m_rev_rx_count);
-        int loaded = loadEfm(m_initial_mat[mat_ix], line, reversible_reactions,
-                rxs_fwd, rxs_rev, rx_count, exchange_reaction, checkLoops,
-                threshold);
-        // check if EFM is an internal loop
-        if (loaded > 0)
-        {
-            BITCLEAR(m_loops, mat_ix);
-        }
-        else
-        {
-            BITSET(m_loops, mat_ix);
-        }
-        mat_ix++;
-    }
-    free(line);
-    line = NULL;
+    checkLtcs(ctx, ltcsWriteResults(ctx, file, csv_out));
     fclose(file);
-    unsigned long bitarray_size = getBitsize(mat_ix);
-    m_loops = (char*) realloc(m_loops, bitarray_size);
-
-    // define reactions that have a flux in both directions
-    unsigned int i = 0;
-    unsigned int result_rx_count = 0;
-    for (i = 0; i < m_rev_rx_count; i++) 
+    if (NULL != loopout)
     {
-        if (BITTEST(rxs_fwd,i) && BITTEST(rxs_rev,i))
+        sprintf(filename, "%s.z%u", loopout, index + 1);
+        file = fopen(filename, "w");
+        if (!file)
         {
-            BITSET(rxs_both,i);
-            result_rx_count++;
+            quitError("Error in opening loop outputfile\n", LTCS_ERROR_FILE);
         }
+        checkLtcs(ctx, ltcsWriteLoops(ctx, file, csv_out));
+        fclose(file);
     }
-    free(rxs_fwd);
-    free(rxs_rev);
-    rxs_fwd = NULL;
-    rxs_rev = NULL;
-
-    // clean matrix by removing reactions that are active in only one direction
-    printf("%s optimizating EFM matrix\n", getTime());
-    getCleanedMatrix(m_initial_mat, mat_ix, m_rev_rx_count, initial_mat,
-            rxs_both, result_rx_count, m_loops);
-    if (keep_full_mat < 1)
-    {
-        unsigned long ul;
-        for (ul = 0; ul < mat_ix; ul++) 
-        {
-            if (!BITTEST(m_loops,ul))
-            {
-                free(m_initial_mat[ul]);
-            }
-        }
-        free(m_initial_mat);
-        m_initial_mat = NULL;
-    }
-    free(rxs_both);
-    rxs_both = NULL;
-
-    // set return pointer
-    *efm_count = mat_ix;
-    *rev_rx_count = result_rx_count;
-    *loops = m_loops;
-    *full_mat = m_initial_mat;
 }
 
 /*
- * thread function to find new ltcs
- * splits an ltcs into two ltcs based on positive and negative flux values in
- * EFMs at given reaction index
+ * write LTCS of a knockout to <output>.ko<reaction>
  */
-void* findLtcsThread(void *pointer_thread_args)
+int writeKnockout(unsigned int reaction, ltcs_context* ctx, void* user_data)
 {
-    // unpack given arguments
-    struct thread_args* thread_args = (struct thread_args*) pointer_thread_args;
-    int thread_id                 = thread_args->thread_id;
-    int max_threads               = thread_args->max_threads;
-    int bitarray_size             = thread_args->bitarray_size;
-    unsigned long ltcs_count      = thread_args->ltcs_count;
-    unsigned long efm_count       = thread_args->efm_count;
-    unsigned int reaction         = thread_args->reaction;
-    char** ltcs                   = thread_args->ltcs;
-    char** matrix                 = thread_args->matrix;
-    unsigned long* t_ltcs_count   = thread_args->new_ltcs_count;
-    char** t_ltcs                 = thread_args->new_ltcs;
-
-    t_ltcs_count[0] = 0;
-    if (NULL == t_ltcs)
-    {
-        quitError("Not enough free memory in findLtcs", ERROR_RAM);
-    }
-    unsigned long ui, uj;
-    for (ui = 0; ui < ltcs_count; ui++) 
+    struct knockout_output* output = (struct knockout_output*) user_data;
+    if (output->full_out > 0)
     {
-        // check if thread is responsible
-        if (ui%max_threads == thread_id)
+        char filename[strlen(output->ltcsout) + 16];
+        sprintf(filename, "%s.ko%u", output->ltcsout, reaction + 1);
+        FILE* file = fopen(filename, "w");
+        if (!file)
         {
-            int pos = 0;
-            int neg = 0;
-            char *p_vect = (char *)calloc(1, bitarray_size);
-            char *n_vect = (char *)calloc(1, bitarray_size);
-            for (uj = 0; uj < efm_count; uj++) 
-            {
-                // if efm is in ltcs
-                if (BITTEST(ltcs[ui],uj))
-                {
-                    // efms with positive flux to new ltcs 1
-                    if (BITTEST(matrix[uj],2*reaction))
-                    {
-                        BITSET(p_vect, uj);
-                        pos = 1;
-                    } 
-                    // efms with negative flux to new ltcs 2
-                    else if (BITTEST(matrix[uj], 2*reaction+1))
-                    {
-                        BITSET(n_vect, uj);
-                        neg = 1;
-                    } 
-                    // efms with zero flux to both new ltcs
-                    else
-                    {
-                        BITSET(p_vect, uj);
-                        BITSET(n_vect, uj);
-                    }
-                }
-            }
-            // create new ltcs 1 if EFMs with positive fluxes were found, else
-            // set memory free
-            if (pos > 0)
-            {
-                t_ltcs[t_ltcs_count[0]] = p_vect;
-                t_ltcs_count[0]++;
-            }
-            else
-            {
-                free(p_vect);
-            }
-            // create new ltcs 2 if EFMs with negative fluxes were found, else
-            // set memory free
-            if (neg > 0)
-            {
-                t_ltcs[t_ltcs_count[0]] = n_vect;
-                t_ltcs_count[0]++;
-            }
-            else
-            {
-                free(n_vect);
-            }
+            output->error = 1;
+            return 1;
         }
+        ltcsWriteResults(ctx, file, output->csv_out);
+        fclose(file);
     }
-    return((void*)NULL);
+    return 0;
 }
 
 /*
- * find ltcs
- * for each reaction start threads to find new ltcs
- * merge ltcs found by threads to new set of ltcs until all reactions are
- * processed
+ * print estimated frontier of each iteration to STDOUT and in csv format to
+ * file (if given)
  */
-void findLtcs(unsigned int rx_count, unsigned long efm_count, char **mat, char*
-        loops, char ***ltcs, unsigned long *ltcs_count, int max_threads)
+void printEstimate(struct ltcs_estimate* estimate, double seconds, FILE*
+        fileout)
 {
     unsigned int i;
-    unsigned long ui;
-    unsigned long bitarray_size = getBitsize(efm_count);
-    // initialize ltcs with 1 ltcs containing all EFMs that are not internal
-    // loops
-    unsigned long m_ltcs_count = 1;
-    char **m_ltcs = (char**) calloc(1, sizeof(char*));
-    m_ltcs[0] = calloc(1, bitarray_size);
-    for (ui = 0; ui < efm_count; ui++) {
-        if (!BITTEST(loops, ui))
-        {
-            BITSET(m_ltcs[0], ui);
-        }
-    }
-    if (NULL == m_ltcs)
+    if (NULL != fileout)
     {
-        quitError("Not enough free memory in findLtcs", ERROR_RAM);
+        fprintf(fileout, "iteration,frontier,ci_low,ci_high\n");
     }
-
-    // process each single reaction
-    for (i = 0; i < rx_count; i++) 
-    {
-        printf("%s ", getTime());
-        printf("iteration %d/%d: ", i+1, rx_count);
-
-        // prepare threads
-        int num_threads = (m_ltcs_count > max_threads) ? max_threads : m_ltcs_count;
-        pthread_t thread[num_threads];
-        struct thread_args thread_args[num_threads];
-        int ti;
-        for (ti = 0; ti < num_threads; ti++) {
-            thread_args[ti].thread_id = ti;
-            thread_args[ti].max_threads = num_threads;
-            thread_args[ti].bitarray_size = bitarray_size;
-            thread_args[ti].ltcs_count = m_ltcs_count;
-            thread_args[ti].efm_count = efm_count;
-            thread_args[ti].reaction = i;
-            thread_args[ti].ltcs = m_ltcs;
-            thread_args[ti].matrix = mat;
-            thread_args[ti].new_ltcs_count = calloc(1, sizeof(unsigned long));
-            unsigned long size = m_ltcs_count * 2 / num_threads + num_threads;
-            char** new_ltcs = (char**) calloc(size, sizeof(char*));
-            thread_args[ti].new_ltcs = new_ltcs;
-        }
-
-        // start threads
-        for (ti = 0; ti < num_threads; ti++) {
-            pthread_create(&thread[ti], NULL, findLtcsThread,
-                    (void*)&thread_args[ti]);
-        }
-
-        // join threads
-        unsigned long new_ltcs_count = 0;
-        for (ti = 0; ti < num_threads; ti++) {
-            pthread_join(thread[ti], NULL);
-            new_ltcs_count += *thread_args[ti].new_ltcs_count;
-        }
-
-        // prepare memory for new ltcs sets
-        for (ui = 0; ui < m_ltcs_count; ui++) {
-            free(m_ltcs[ui]);
-        }
-        free(m_ltcs);
-        m_ltcs = NULL;
-        m_ltcs = calloc(new_ltcs_count, sizeof(char*));
-        unsigned long index = 0;
-        unsigned long tj;
-        // merge ltcs found by threads to new set
-        for (ti = 0; ti < num_threads; ti++) {
-            for (tj = 0; tj < *thread_args[ti].new_ltcs_count; tj++) {
-                m_ltcs[index] = thread_args[ti].new_ltcs[tj];
-                index++;
-            }
-            free(thread_args[ti].new_ltcs);
-            free(thread_args[ti].new_ltcs_count);
+    printf("\n%10s %16s %16s %16s\n", "iteration", "frontier", "95% ci low", "95% ci high");
+    for (i = 0; i < estimate->iterations; i++) {
+        printf("%10u %16.0f %16.0f %16.0f\n", i+1, estimate->frontier[i],
+                estimate->frontier_low[i], estimate->frontier_high[i]);
+        if (NULL != fileout)
+        {
+            fprintf(fileout, "%u,%.0f,%.0f,%.0f\n", i+1, estimate->frontier[i],
+                    estimate->frontier_low[i], estimate->frontier_high[i]);
         }
-        m_ltcs_count = new_ltcs_count;
-        printf("%lu ltcs\n", m_ltcs_count);
     }
-    *ltcs = m_ltcs;
-    *ltcs_count = m_ltcs_count;
+    printf("\n");
+    printf("Estimated leaves:        %.0f\n", estimate->leaves);
+    printf("Estimated LTCS:          %.0f (95%% ci %.0f - %.0f)\n",
+            estimate->ltcs, estimate->ltcs_low, estimate->ltcs_high);
+    printf("Estimated split nodes:   %.0f\n", estimate->nodes);
+    printf("Estimated peak frontier: %.0f (%.1f MB for old and new frontier)\n",
+            estimate->peak_frontier, estimate->peak_bytes / (1024.0 * 1024.0));
+    printf("Estimation time:         %.2f s\n", seconds);
 }
 
 
 int main (int argc, char *argv[])
 {
-    printf("Start: %s\n", getTime());
+    char time_string[TIME_STRING_SIZE];
+    printf("Start: %s\n", getTime(time_string));
 
     //================================================== 
     // define arguments and usage
-    char *optv[MAX_ARGS] = { "-i", "-o", "-s", "-r", "-v", "-l", "-z", "-t", "-f", "-c", "-a" };
-    char *optd[MAX_ARGS] = {"efm file  (tab separated like:  0.4\t0\t-0.24)",
+    char *optv[MAX_ARGS] = { "-i", "-o", "-s", "-r", "-v", "-l", "-z", "-t", "-f", "-c", "-a", "--time-budget", "--estimate", "--save-state", "--state", "--knockout", "--sweep", "--index", "--telemetry", "--memory-limit", "--numa", "--shard", "--yields", "--include-efms", "--exclude-efms", "--sfile-format", "--reversibility" };
+    char *optd[MAX_ARGS] = {"efm file  (tab separated like:  0.4\t0\t-0.24 or binary efm file, see src/ltcs.h)",
                             "output file [default: ltcs.out]",
                             "stoichiometric matrix file [optional, needed to find internal loops]",
                             "reaction file [optional, but necessary if option -a is set]",
@@ -886,23 +381,40 @@ int main (int argc, char *argv[])
                             "number of threads [default: 1]",
                             "full output [yes/no; default: yes] if set to no only summary is printed and ltcs are not saved",
                             "print ltcs in csv format [yes/no; default: yes] if set to no ltcs output will be e.g. 10011 instead of 1,0,0,1,1",
-                            "analysis output file - needs option -r"};
+                            "analysis output file - needs option -r",
+                            "anytime search [seconds; optional] writes LTCS as they are found instead of calculating all LTCS, the list is not complete",
+                            "estimate number of LTCS and frontier size per iteration by given number of random descents [optional] estimates are written in csv format to output file",
+                            "save state file [optional] keeps EFMs and LTCS to update them later with option --state",
+                            "state file [optional] LTCS of the state are updated by the EFMs of the input file instead of calculating them from scratch",
+                            "knockout scan [optional; e.g. 1,4-7 or all] LTCS of each single reaction knockout are derived from the LTCS of all EFMs and saved to <output>.ko<reaction>",
+                            "threshold sweep [optional; e.g. 1e-10,1e-8,1e-6] reads the efm file once and saves LTCS of each threshold (ascending) to <output>.z<n>",
+                            "index file [optional] writes an index of the LTCS for queries with ltcsQuery",
+                            "telemetry output [optional; file or fd:<number>] writes JSON lines of stage timings and iterations, SIGUSR1 writes a snapshot of the running stage",
+                            "memory limit [MB; optional] if the next iteration would exceed it, subsets are removed from the intermediate sets or the calculation is stopped",
+                            "NUMA aware threads [yes/no; default: no] pins threads to the cpus of the NUMA nodes and keeps a copy of the EFM matrix on every node",
+                            "shard [optional; e.g. 2/8] calculates only the LTCS of the given shard and saves them for the merge of ltcsCoordinator to the output file",
+                            "yields file [optional, needs option -r] lines like 'R_EX_glc < -5' (<, = or >) as for ltcstool.pl, only EFMs fulfilling all yields are loaded",
+                            "EFMs to load [optional; e.g. 1,4-7 or a file of such indices] only these EFMs of the input are loaded",
+                            "EFMs to skip [optional; e.g. 1,4-7 or a file of such indices] these EFMs of the input are not loaded",
+                            "format of the stoichiometric matrix file [dense, mtx or triplets; default: mtx if the file starts with the MatrixMarket banner, otherwise dense] mtx is a MatrixMarket coordinate file, triplets are lines like 'row column value' (1-based)",
+                            "changed reversibility file [optional, needs option --state] LTCS of the state are merged where reactions are no longer reversible and split where reactions became reversible; option -i is optional then"};
     char *optr[MAX_ARGS];
     char *description = "Calculate largest thermodynamically consistent sets of "
         "EFMs\nbased only on the reversibility of the reactions";
-    char *usg = "\n   calcLtcs -i efms.txt -o ltcs.out\n   calcLtcs -i efms.txt -o ltcs.out -s sfile -v rvfile -z 1e-6 -t 8 -a yes -r rfile";
+    char *usg = "\n   calcLtcs -i efms.txt -o ltcs.out\n   calcLtcs -i efms.txt -o ltcs.out -s sfile -v rvfile -z 1e-6 -t 8 -a yes -r rfile\n   calcLtcs -i efms.txt -o ltcs.out -s sfile -t 8 --time-budget 3600\n   calcLtcs -i efms.txt -o estimate.csv -s sfile -t 8 --estimate 1000\n   calcLtcs -i new_efms.txt -o ltcs.out -s sfile -t 8 --state old.state --save-state new.state\n   calcLtcs -o ltcs.out -t 8 --state old.state --reversibility new_rvfile\n   calcLtcs -i efms.txt -o ltcs.out -s sfile -t 8 --knockout all\n   calcLtcs -i efms.txt -o ltcs.out -s sfile -t 8 --sweep 1e-10,1e-8,1e-6";
     // end define arguments and usage
     //================================================== 
 
     //================================================== 
     // read arguments
     readArgs(argc, argv, MAX_ARGS, optv, optr);
-    if ( !optr[ARG_INPUT] )
+    if ( !optr[ARG_INPUT] && !(optr[ARG_STATE] && optr[ARG_REVERSIBILITY]) )
     {
         usage(description, usg, MAX_ARGS, optv, optd);
-        quitError("Missing argument\n", ERROR_ARGS);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
     }
     char* ltcsout = optr[ARG_LTCS_OUT] ? optr[ARG_LTCS_OUT] : "ltcs.out";
+    char* arg_input = optr[ARG_INPUT] ? optr[ARG_INPUT] : "not available";
     char* arg_rvfile = optr[ARG_RVFILE] ? optr[ARG_RVFILE] : "not available";
     char* arg_sfile = optr[ARG_SFILE] ? optr[ARG_SFILE] : "not available";
     char* arg_rfile = optr[ARG_RFILE] ? optr[ARG_RFILE] : "not available";
@@ -913,19 +425,114 @@ int main (int argc, char *argv[])
     int csv_out = optr[ARG_CSV_OUT] ? (!strcmp(optr[ARG_CSV_OUT], "no") ? 0 : 1) : 1;
     int arg_analysis = optr[ARG_ANALYSIS] ? (optr[ARG_RFILE] ? 1 : 0) : 0;
     char* arg_analysisfile = optr[ARG_ANALYSIS] ? optr[ARG_ANALYSIS] : "not available";
+    double time_budget = optr[ARG_TIME_BUDGET] ? atof(optr[ARG_TIME_BUDGET]) : 0;
+    if (optr[ARG_TIME_BUDGET] && time_budget <= 0)
+    {
+        quitError("time budget must be greater than 0\n", LTCS_ERROR_ARGS);
+    }
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    long estimate_samples = optr[ARG_ESTIMATE] ? atol(optr[ARG_ESTIMATE]) : 0;
+    if (optr[ARG_ESTIMATE] && estimate_samples < 1)
+    {
+        quitError("number of random descents must be greater than 0\n", LTCS_ERROR_ARGS);
+    }
+    if (time_budget > 0 && estimate_samples > 0)
+    {
+        quitError("options --time-budget and --estimate cannot be combined\n", LTCS_ERROR_ARGS);
+    }
+    if ((optr[ARG_SAVE_STATE] || optr[ARG_STATE] || optr[ARG_KNOCKOUT] || optr[ARG_INDEX]) && (time_budget > 0 || estimate_samples > 0))
+    {
+        quitError("options --save-state, --state, --knockout and --index cannot be combined with --time-budget or --estimate\n", LTCS_ERROR_ARGS);
+    }
+    if (time_budget > 0 || estimate_samples > 0)
+    {
+        arg_analysis = 0;
+    }
+    int numa = optr[ARG_NUMA] ? (!strcmp(optr[ARG_NUMA], "yes") ? 1 : 0) : 0;
+    double memory_limit = optr[ARG_MEMORY_LIMIT] ? atof(optr[ARG_MEMORY_LIMIT]) : 0;
+    if (optr[ARG_MEMORY_LIMIT] && memory_limit <= 0)
+    {
+        quitError("memory limit must be greater than 0\n", LTCS_ERROR_ARGS);
+    }
+    double* sweep_thresholds = NULL;
+    unsigned int sweep_count = 0;
+    if (optr[ARG_SWEEP])
+    {
+        sweep_count = readThresholds(optr[ARG_SWEEP], &sweep_thresholds);
+        if (sweep_count == 0)
+        {
+            quitError("not a correct list of sweep thresholds\n", LTCS_ERROR_ARGS);
+        }
+        if (time_budget > 0 || estimate_samples > 0 || arg_analysis > 0 || optr[ARG_SAVE_STATE] || optr[ARG_STATE] || optr[ARG_KNOCKOUT] || optr[ARG_INDEX])
+        {
+            quitError("option --sweep cannot be combined with -a, --time-budget, --estimate, --save-state, --state, --knockout or --index\n", LTCS_ERROR_ARGS);
+        }
+    }
+    if (optr[ARG_REVERSIBILITY] && !optr[ARG_STATE])
+    {
+        quitError("option --reversibility needs option --state\n", LTCS_ERROR_ARGS);
+    }
+    if (optr[ARG_YIELDS] && !optr[ARG_RFILE])
+    {
+        quitError("option --yields needs option -r\n", LTCS_ERROR_ARGS);
+    }
+    unsigned int shard = 0;
+    unsigned int shard_count = 0;
+    if (optr[ARG_SHARD])
+    {
+        if (sscanf(optr[ARG_SHARD], "%u/%u", &shard, &shard_count) != 2 ||
+                shard < 1 || shard > shard_count)
+        {
+            quitError("shard must be given as i/N with 1 <= i <= N\n", LTCS_ERROR_ARGS);
+        }
+        if (full_out == 0 || time_budget > 0 || estimate_samples > 0 || arg_analysis > 0 || optr[ARG_SAVE_STATE] || optr[ARG_STATE] || optr[ARG_KNOCKOUT] || optr[ARG_INDEX] || sweep_count > 0)
+        {
+            quitError("option --shard cannot be combined with -f no, -a, --time-budget, --estimate, --save-state, --state, --knockout, --sweep or --index\n", LTCS_ERROR_ARGS);
+        }
+    }
+    int sfile_format = LTCS_SFILE_AUTO;
+    if (optr[ARG_SFILE_FORMAT])
+    {
+        if (!strcmp(optr[ARG_SFILE_FORMAT], "dense"))
+        {
+            sfile_format = LTCS_SFILE_DENSE;
+        }
+        else if (!strcmp(optr[ARG_SFILE_FORMAT], "mtx"))
+        {
+            sfile_format = LTCS_SFILE_MATRIX_MARKET;
+        }
+        else if (!strcmp(optr[ARG_SFILE_FORMAT], "triplets"))
+        {
+            sfile_format = LTCS_SFILE_TRIPLETS;
+        }
+        else
+        {
+            quitError("format of the stoichiometric matrix file must be dense, mtx or triplets\n", LTCS_ERROR_ARGS);
+        }
+    }
     // end read arguments
     //================================================== 
 
     //================================================== 
     // print arguments summary
     printf("\n");
-    printf("Input:            %s\n", optr[ARG_INPUT]);
+    printf("Input:            %s\n", arg_input);
     printf("Output:           %s\n", ltcsout);
     printf("sfile:            %s\n", arg_sfile);
     printf("rvfile:           %s\n", arg_rvfile);
     printf("rfile:            %s\n", arg_rfile);
-    printf("Zero threshold:   %.2e\n", threshold);
-    printf("Threads:          %d\n", threads);
+    if (sweep_count > 0)
+    {
+        printf("Zero thresholds:  %s (sweep)\n", optr[ARG_SWEEP]);
+    }
+    else
+    {
+        printf("Zero threshold:   %.2e\n", threshold);
+    }
+    printf("Threads:          %d%s\n", threads, numa > 0 ? " (NUMA aware)" : "");
     printf("Loops output:     %s\n", full_out > 0 ? loopout : "no");
     printf("Full output:      %s\n", full_out > 0 ? "yes" : "no");
     if (full_out > 0)
@@ -933,37 +540,94 @@ int main (int argc, char *argv[])
         printf("csv output:       %s\n", csv_out > 0 ? "yes (1,0,1,1)" : "no (1011)");
     }
     printf("Perform analysis: %s\n", arg_analysis > 0 ? "yes" : "no");
+    if (time_budget > 0)
+    {
+        printf("Time budget:      %.1f s (anytime search)\n", time_budget);
+    }
+    if (estimate_samples > 0)
+    {
+        printf("Estimation:       %ld random descents\n", estimate_samples);
+    }
     if (arg_analysis > 0)
     {
         printf("analysis file:    %s\n", arg_analysisfile);
     }
+    if (optr[ARG_STATE])
+    {
+        printf("State:            %s\n", optr[ARG_STATE]);
+    }
+    if (optr[ARG_REVERSIBILITY])
+    {
+        printf("Reversibility:    %s (changed)\n", optr[ARG_REVERSIBILITY]);
+    }
+    if (optr[ARG_SAVE_STATE])
+    {
+        printf("Save state:       %s\n", optr[ARG_SAVE_STATE]);
+    }
+    if (optr[ARG_KNOCKOUT])
+    {
+        printf("Knockouts:        %s\n", optr[ARG_KNOCKOUT]);
+    }
+    if (optr[ARG_INDEX])
+    {
+        printf("Index:            %s\n", optr[ARG_INDEX]);
+    }
+    if (optr[ARG_TELEMETRY])
+    {
+        printf("Telemetry:        %s\n", optr[ARG_TELEMETRY]);
+    }
+    if (memory_limit > 0)
+    {
+        printf("Memory limit:     %.1f MB\n", memory_limit);
+    }
+    if (shard_count > 0)
+    {
+        printf("Shard:            %u/%u\n", shard, shard_count);
+    }
+    if (optr[ARG_YIELDS])
+    {
+        printf("Yields:           %s\n", optr[ARG_YIELDS]);
+    }
+    if (optr[ARG_INCLUDE])
+    {
+        printf("Include EFMs:     %s\n", optr[ARG_INCLUDE]);
+    }
+    if (optr[ARG_EXCLUDE])
+    {
+        printf("Exclude EFMs:     %s\n", optr[ARG_EXCLUDE]);
+    }
     printf("\n");
     // end print arguments summary
     //================================================== 
 
     //================================================== 
     // check files
-    FILE *file = fopen(optr[ARG_INPUT], "r");
     FILE *fileout = NULL;
     FILE *fileloops = NULL;
     FILE *fileanalysis = NULL;
-    if (!file)
+    if (optr[ARG_INPUT])
     {
-        quitError("Error in opening input file\n", ERROR_FILE);
+        FILE *file = fopen(optr[ARG_INPUT], "r");
+        if (!file)
+        {
+            quitError("Error in opening input file\n", LTCS_ERROR_FILE);
+        }
+        fclose(file);
     }
-    if (full_out > 0)
+    if (full_out > 0 && sweep_count == 0)
     {
-        fileout = fopen(ltcsout, "w");
+        // a shard file is written by ltcsWriteShard
+        fileout = fopen(ltcsout, shard_count > 0 ? "wb" : "w");
         if (!fileout)
         {
-            quitError("Error in opening output file\n", ERROR_FILE);
+            quitError("Error in opening output file\n", LTCS_ERROR_FILE);
         }
         if (optr[ARG_SFILE])
         {
             fileloops = fopen(loopout, "w");
             if (!fileloops)
             {
-                quitError("Error in opening loop outputfile\n", ERROR_FILE);
+                quitError("Error in opening loop outputfile\n", LTCS_ERROR_FILE);
             }
         }
     }
@@ -972,143 +636,206 @@ int main (int argc, char *argv[])
         fileanalysis = fopen(arg_analysisfile, "w");
         if (!fileanalysis)
         {
-            quitError("Error in opening analysis file\n", ERROR_FILE);
+            quitError("Error in opening analysis file\n", LTCS_ERROR_FILE);
         }
     }
-    // end check files
-    //================================================== 
-    
-    //================================================== 
-    // read number of reactions
-    int rx_count = getRxCount(file);
-    fclose(file);
-    if (rx_count < 1)
+    FILE *filetelemetry = NULL;
+    if (optr[ARG_TELEMETRY])
     {
-        quitError("Error in EFM file format; number of reactions < 1\n",
-                ERROR_FILE);
-    }
-    // end read number of reactions
-    //================================================== 
-
-    //================================================== 
-    // define exchange reactions
-    char* exchange_reaction = NULL;
-    int s_cols = 0;
-    if (optr[ARG_SFILE])
-    {
-        defineExchangeReactions(&s_cols, &exchange_reaction, threshold,
-                optr[ARG_SFILE]);
-        if (s_cols != rx_count)
+        filetelemetry = openTelemetry(optr[ARG_TELEMETRY]);
+        if (!filetelemetry)
         {
-            quitError("Error in EFM of stoichiometric file format. Number of reactions is not equal\n", ERROR_FILE);
+            quitError("Error in opening telemetry output\n", LTCS_ERROR_FILE);
         }
     }
-    // end define exchange reactions
+    // end check files
     //================================================== 
 
     //================================================== 
-    // define reversible reactions
-    unsigned int   rev_rx_count  = 0;
-    unsigned long rev_rx_bitsize = getBitsize(rx_count);
-    char* reversible_reactions = calloc(1, rev_rx_bitsize);
-    int i;
-    for (i = 0; i < rx_count; i++) 
+    // read model information
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, printLog, NULL);
+    ltcsSetThreshold(ctx, threshold);
+    ltcsSetMemoryLimit(ctx, (unsigned long) (memory_limit * 1024 * 1024));
+    ltcsSetNuma(ctx, numa);
+    if (shard_count > 0)
     {
-        BITSET(reversible_reactions, i);
+        ltcsSetShard(ctx, shard - 1, shard_count);
+    }
+    if (NULL != filetelemetry)
+    {
+        ltcsSetTelemetryFile(ctx, filetelemetry);
+        snapshot_ctx = ctx;
+        signal(SIGUSR1, requestSnapshot);
+    }
+    if (optr[ARG_SFILE])
+    {
+        checkLtcs(ctx, ltcsReadStoichiometricFileFormat(ctx, optr[ARG_SFILE], sfile_format, threads));
     }
     if (optr[ARG_RVFILE])
     {
-        readReversibleFile(optr[ARG_RVFILE], reversible_reactions, rx_count);
+        checkLtcs(ctx, ltcsReadReversibleFile(ctx, optr[ARG_RVFILE]));
     }
-    else
+    if (arg_analysis > 0 || optr[ARG_YIELDS])
     {
-        for (i = 0; i < rx_count; i++) 
+        checkLtcs(ctx, ltcsReadReactionFile(ctx, optr[ARG_RFILE]));
+    }
+    if (optr[ARG_YIELDS])
+    {
+        checkLtcs(ctx, ltcsReadYieldsFile(ctx, optr[ARG_YIELDS]));
+    }
+    int ai;
+    for (ai = ARG_INCLUDE; ai <= ARG_EXCLUDE; ai++) {
+        if (optr[ai])
         {
-            BITSET(reversible_reactions, i);
+            char* list = readEfmList(optr[ai]);
+            checkLtcs(ctx, ltcsSetEfmSelection(ctx, list, ai == ARG_EXCLUDE));
+            free(list);
         }
     }
-    // end define reversible reactions
+    // end read model information
     //================================================== 
-    
+
     //================================================== 
-    // read reaction names
-    char** reaction_names = NULL;
-    if (arg_analysis > 0)
+    // threshold sweep
+    if (sweep_count > 0)
     {
-        readReactions(optr[ARG_RFILE], &reaction_names, rx_count);
+        checkLtcs(ctx, ltcsLoadEfmSweep(ctx, optr[ARG_INPUT], sweep_thresholds, sweep_count));
+        unsigned long sweep_ltcs[sweep_count];
+        unsigned long sweep_loops[sweep_count];
+        int sweep_changed[sweep_count];
+        unsigned int si;
+        for (si = 0; si < sweep_count; si++) {
+            printf("%s zero threshold %.2e\n", getTime(time_string), ltcsGetSweepThreshold(ctx, si));
+            checkLtcs(ctx, ltcsSelectSweepThreshold(ctx, si, &sweep_changed[si]));
+            if (sweep_changed[si] > 0)
+            {
+                checkLtcs(ctx, ltcsCompute(ctx, threads, LTCS_COMPUTE_DEFAULT));
+            }
+            if (full_out > 0)
+            {
+                writeSweepResult(ctx, si, ltcsout, optr[ARG_SFILE] ? loopout : NULL, csv_out);
+            }
+            sweep_ltcs[si] = ltcsGetResultCount(ctx);
+            sweep_loops[si] = ltcsGetLoopCount(ctx);
+        }
+        printf("\n");
+        printf("Nr of EFMS:           %lu\n", ltcsGetEfmCount(ctx));
+        if (ltcsGetFilteredEfmCount(ctx) > 0)
+        {
+            printf("Nr of filtered EFMs:  %lu\n", ltcsGetFilteredEfmCount(ctx));
+        }
+        printf("\n%4s %12s %14s %14s %10s\n", "nr", "threshold", "LTCS", "loops", "reused");
+        for (si = 0; si < sweep_count; si++) {
+            printf("%4u %12.2e %14lu %14lu %10s\n", si + 1, ltcsGetSweepThreshold(ctx, si),
+                    sweep_ltcs[si], sweep_loops[si], sweep_changed[si] > 0 ? "no" : "yes");
+        }
+        printf("\n");
+        printf("End: %s\n", getTime(time_string));
+        free(sweep_thresholds);
+        snapshot_ctx = NULL;
+        ltcsFreeContext(ctx);
+        if (NULL != filetelemetry)
+        {
+            fclose(filetelemetry);
+        }
+        return EXIT_SUCCESS;
     }
-    //
+    // end threshold sweep
     //================================================== 
 
     //================================================== 
     // read efm matrix
-    char* loops = NULL;
-    char** initial_mat = NULL;
-    char** full_mat = NULL;
-    unsigned long efm_count = 0;
-    int checkLoops = optr[ARG_SFILE] ? 1 : 0;
-    readInitialMatrix(rx_count, &efm_count, reversible_reactions,
-            &rev_rx_count, &initial_mat, &full_mat, arg_analysis,
-            exchange_reaction, &loops, checkLoops, 1e-8, optr[ARG_INPUT]);
+    ltcsSetKeepFullMatrix(ctx, arg_analysis || optr[ARG_SAVE_STATE] || optr[ARG_STATE] || optr[ARG_KNOCKOUT]);
+    if (optr[ARG_STATE])
+    {
+        // the reversibility is changed and EFMs of the input file are appended
+        // to the state in find ltcs
+        checkLtcs(ctx, ltcsLoadState(ctx, optr[ARG_STATE]));
+    }
+    else if (ltcsIsBinaryEfmFile(optr[ARG_INPUT]))
+    {
+        checkLtcs(ctx, ltcsLoadBinaryEfmFile(ctx, optr[ARG_INPUT]));
+    }
+    else
+    {
+        checkLtcs(ctx, ltcsLoadEfmFile(ctx, optr[ARG_INPUT]));
+    }
     // end read efm matrix
     //================================================== 
 
     //================================================== 
     // find ltcs
-    unsigned long ltcs_count = 0;
-    char** ltcs = NULL;
-    findLtcs(rev_rx_count, efm_count, initial_mat, loops, &ltcs, &ltcs_count, threads);
+    unsigned long anytime_set_count = 0;
+    unsigned long anytime_best = 0;
+    if (time_budget > 0)
+    {
+        struct anytime_output output;
+        output.fileout = fileout;
+        output.csv_out = csv_out;
+        checkLtcs(ctx, ltcsComputeAnytime(ctx, threads, time_budget,
+                    writeAnytimeSet, &output, &anytime_set_count,
+                    &anytime_best));
+    }
+    else if (estimate_samples > 0)
+    {
+        struct timespec start, end;
+        struct ltcs_estimate estimate;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        checkLtcs(ctx, ltcsEstimate(ctx, threads, estimate_samples, &estimate));
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printEstimate(&estimate, (end.tv_sec - start.tv_sec) + (end.tv_nsec -
+                    start.tv_nsec) / 1e9, fileout);
+        ltcsFreeEstimate(&estimate);
+    }
+    else if (optr[ARG_STATE])
+    {
+        if (optr[ARG_REVERSIBILITY])
+        {
+            checkLtcs(ctx, ltcsUpdateReversibleFile(ctx, optr[ARG_REVERSIBILITY], threads));
+        }
+        if (optr[ARG_INPUT])
+        {
+            checkLtcs(ctx, ltcsAppendEfmFile(ctx, optr[ARG_INPUT], threads));
+        }
+    }
+    else
+    {
+        checkLtcs(ctx, ltcsCompute(ctx, threads, LTCS_COMPUTE_DEFAULT));
+    }
+    unsigned long efm_count = ltcsGetEfmCount(ctx);
+    if (optr[ARG_SAVE_STATE])
+    {
+        checkLtcs(ctx, ltcsSaveState(ctx, optr[ARG_SAVE_STATE]));
+    }
     // end find ltcs
     //================================================== 
-    
-    //================================================== 
-    // filter ltcs to remove subsets
-    printf("%s filter LTCS to remove subsets\n", getTime());
-    char* notAnLtcs = NULL;
-    filterLtcs(ltcs, &notAnLtcs, ltcs_count, efm_count);
-    // end filter ltcs to remove subsets
-    //================================================== 
 
     //================================================== 
     // print ltcs to file
-    if (full_out > 0)
+    if (full_out > 0 && time_budget <= 0 && estimate_samples == 0 && shard_count == 0)
     {
-        printf("%s save ltcs\n", getTime());
-    }
-    unsigned long li;
-    unsigned long ul;
-    unsigned long result_ltcs_count = 0;
-    int makeSep = 0;
-    for (li = 0; li < ltcs_count; li++) {
-        if (!BITTEST(notAnLtcs, li))
-        {
-            makeSep = 0;
-            result_ltcs_count++;
-            if (full_out > 0)
-            {
-                for (ul = 0; ul < efm_count; ul++) {
-                    if (makeSep > 0 && csv_out > 0)
-                    {
-                        fprintf(fileout, ",");
-                    }
-                    makeSep = 1;
-                    if (BITTEST(ltcs[li],ul))
-                    {
-                        fprintf(fileout, "1");
-                    }
-                    else
-                    {
-                        fprintf(fileout, "0");
-                    }
-                }
-                fprintf(fileout, "\n");
-            }
-        }
+        printf("%s save ltcs\n", getTime(time_string));
+        checkLtcs(ctx, ltcsWriteResults(ctx, fileout, csv_out));
     }
     if (full_out > 0)
     {
         fclose(fileout);
     }
+    if (shard_count > 0)
+    {
+        printf("%s save ltcs of shard\n", getTime(time_string));
+        checkLtcs(ctx, ltcsWriteShard(ctx, ltcsout));
+    }
+    if (optr[ARG_INDEX])
+    {
+        printf("%s save index\n", getTime(time_string));
+        checkLtcs(ctx, ltcsWriteIndex(ctx, optr[ARG_INDEX]));
+    }
     // end print ltcs to file
     //================================================== 
 
@@ -1116,135 +843,107 @@ int main (int argc, char *argv[])
     // perform analysis
     if (arg_analysis > 0)
     {
-        printf("%s perform and save analysis of LTCS\n", getTime());
-        double** analysis_values = NULL;
-        performAnalysis(&analysis_values, ltcs, full_mat, reaction_names,
-                ltcs_count, efm_count, rx_count);
-        unsigned long lj;
-        for (li = 0; li < rx_count; li++) {
-            fprintf(fileanalysis, "%s", reaction_names[li]);
-            for (lj = 0; lj < ltcs_count; lj++) {
-                fprintf(fileanalysis, ",%.2f", analysis_values[li][lj]);
-            }
-            fprintf(fileanalysis, "\n");
-        }
+        printf("%s perform and save analysis of LTCS\n", getTime(time_string));
+        checkLtcs(ctx, ltcsWriteAnalysis(ctx, fileanalysis, threads));
         fclose(fileanalysis);
-
-        for (li = 0; li < rx_count; li++) {
-            free(analysis_values[li]);
-            free(reaction_names[li]);
-        }
-        free(analysis_values);
-        free(reaction_names);
     }
     // end perform analysis
     //================================================== 
-    
+
     //================================================== 
-    // set initial_mat memory free
-    for (li=0; li<efm_count; li++)
-    {
-        if (!BITTEST(loops, li))
-        {
-            free(initial_mat[li]);
-        }
-    }
-    free(initial_mat);
-    initial_mat = NULL;
-    if (arg_analysis > 0)
+    // count and print loops to file
+    unsigned long loop_count = 0;
+    if (optr[ARG_SFILE])
     {
-        for (li=0; li<efm_count; li++)
+        if (full_out > 0)
         {
-            if (!BITTEST(loops, li))
-            {
-                free(full_mat[li]);
-            }
+            printf("%s save internal loops\n", getTime(time_string));
+            checkLtcs(ctx, ltcsWriteLoops(ctx, fileloops, csv_out));
+            fclose(fileloops);
         }
-        free(full_mat);
-        full_mat = NULL;
+        loop_count = ltcsGetLoopCount(ctx);
     }
-    // end set initial_mat memory free
+    // end count and print loops to file
     //================================================== 
 
     //================================================== 
-    // count and print loops to file
-    unsigned long loop_count = 0;
-    if (optr[ARG_SFILE])
+    // knockout scan
+    unsigned int knockout_count = 0;
+    if (optr[ARG_KNOCKOUT])
     {
-        if (full_out > 0)
+        unsigned int* knockouts = NULL;
+        knockout_count = readKnockouts(optr[ARG_KNOCKOUT], ltcsGetReactionCount(ctx), &knockouts);
+        if (knockout_count == 0)
         {
-            printf("%s save internal loops\n", getTime());
-            for (ul = 0; ul < efm_count; ul++) {
-                if (ul > 0 && csv_out > 0)
-                {
-                    fprintf(fileloops, ",");
-                }
-                if (BITTEST(loops, ul))
-                {
-                    fprintf(fileloops, "1");
-                    loop_count++;
-                }
-                else
-                {
-                    fprintf(fileloops, "0");
-                }
-            }
-            fclose(fileloops);
+            quitError("not a correct list of knockout reactions\n", LTCS_ERROR_ARGS);
         }
-        else
+        struct knockout_output output;
+        output.ltcsout = ltcsout;
+        output.full_out = full_out;
+        output.csv_out = csv_out;
+        output.error = 0;
+        checkLtcs(ctx, ltcsKnockoutScan(ctx, knockouts, knockout_count, threads, writeKnockout, &output));
+        if (output.error > 0)
         {
-            for (ul = 0; ul < efm_count; ul++) {
-                if (BITTEST(loops, ul))
-                {
-                    loop_count++;
-                }
-            }
+            quitError("Error in opening knockout output file\n", LTCS_ERROR_FILE);
         }
+        free(knockouts);
     }
-    // end count and print loops to file
+    // end knockout scan
     //================================================== 
 
     //================================================== 
     // print summary
     printf("\n");
     printf("Nr of EFMS:           %lu\n", efm_count);
-    printf("Nr of LTCS:           %lu\n", result_ltcs_count);
+    if (ltcsGetFilteredEfmCount(ctx) > 0)
+    {
+        printf("Nr of filtered EFMs:  %lu\n", ltcsGetFilteredEfmCount(ctx));
+    }
+    if (time_budget > 0)
+    {
+        printf("Nr of sets:           %lu\n", anytime_set_count);
+        printf("Largest set:          %lu\n", anytime_best);
+    }
+    else if (estimate_samples == 0)
+    {
+        printf("Nr of LTCS:           %lu\n", ltcsGetResultCount(ctx));
+    }
     if (optr[ARG_SFILE])
     {
         printf("Nr of internal loops: %lu\n", loop_count);
     }
-    printf("\nSizes of LTCS:\n");
-    for (li = 0; li < ltcs_count; li++) {
-        if (!BITTEST(notAnLtcs, li))
-        {
+    if (knockout_count > 0)
+    {
+        printf("Nr of knockouts:      %u\n", knockout_count);
+    }
+    printf("Peak memory:          %.1f MB\n", ltcsGetMemoryPeak(ctx) / (1024.0 * 1024.0));
+    if (time_budget <= 0 && estimate_samples == 0)
+    {
+        printf("\nSizes of LTCS:\n");
+        unsigned long li;
+        for (li = 0; li < ltcsGetResultCount(ctx); li++) {
             if (li > 0)
             {
                 printf(",");
             }
-            printf("%lu", getLtcsCardinality(ltcs[li], efm_count));
+            printf("%lu", ltcsGetResultCardinality(ctx, li));
         }
+        printf("\n");
     }
-    printf("\n\n");
-    printf("End: %s\n", getTime());
+    printf("\n");
+    printf("End: %s\n", getTime(time_string));
     // end print summary
     //================================================== 
 
     //================================================== 
     // set memory free
-    free(loops);
-    free(exchange_reaction);
-    loops = NULL;
-    for (li = 0; li < ltcs_count; li++) {
-        if (!BITTEST(notAnLtcs, li))
-        {
-            free(ltcs[li]);
-        }
+    snapshot_ctx = NULL;
+    ltcsFreeContext(ctx);
+    if (NULL != filetelemetry)
+    {
+        fclose(filetelemetry);
     }
-    free(ltcs);
-    free(notAnLtcs);
-    ltcs = NULL;
-    free(reversible_reactions);
-    reversible_reactions = NULL;
     // end set memory free
     //================================================== 
 
@@ -49,16 +49,16 @@
 // HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 ///////////////////////////////////////////////////////////////////////////////////
 
-int getRxCount(FILE* file);
+int ltcs_getRxCount(FILE* file);
 
 /* 
  * ===  FUNCTION  ======================================================================
- *         Name:  getRxCount
+ *         Name:  ltcs_getRxCount
  *  Description:  returns number of reactions found in first line of EFM file
  * =====================================================================================
  */
     int 
-getRxCount(FILE* file)
+ltcs_getRxCount(FILE* file)
 {
     char*  line = NULL;
     size_t len  = 0;
@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "generalFunctions.c"
+
+#define MAX_ARGS       10
+#define ARG_EFMS       0
+#define ARG_REACTIONS  1
+#define ARG_DENSITY    2
+#define ARG_CONFLICT   3
+#define ARG_SEED       4
+#define ARG_OUTPUT     5
+#define ARG_RFILE      6
+#define ARG_RVFILE     7
+#define ARG_TEMPLATES  8
+#define ARG_NOISE      9
+
+/*
+ * xorshift64* generator; the same seed gives the same EFMs on every platform
+ */
+uint64_t nextRandom(uint64_t* state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+/*
+ * uniform random number in [0,1)
+ */
+double nextUniform(uint64_t* state)
+{
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * generate a synthetic EFM file
+ * every entry has a flux with probability density; reactions marked as
+ * conflicting (a share of conflict of all reactions) get positive and
+ * negative fluxes, all others only positive ones
+ * like EFMs of a real network, which share pathways, the EFMs are correlated:
+ * every EFM follows one of a few sign templates (drawn like an EFM) and every
+ * entry is drawn independently only with probability noise; without templates
+ * all entries are independent
+ */
+int main (int argc, char *argv[])
+{
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-n", "-r", "-d", "-c", "-s", "-o", "-f", "-v", "-p", "-e" };
+    char *optd[MAX_ARGS] = {"number of EFMs [default: 1000]",
+                            "number of reactions [default: 30]",
+                            "density: probability of a flux in an entry [default: 0.3]",
+                            "conflict density: share of reactions used in both directions [default: 0.3]",
+                            "seed [default: 1]",
+                            "EFM output file [default: STDOUT]",
+                            "reaction file output [optional]",
+                            "reversibility file output [optional] reactions used in both directions are reversible",
+                            "number of sign templates the EFMs follow [default: 4] 0 for independent entries",
+                            "noise: probability that an entry is drawn independently of the template of the EFM [default: 0.1]"};
+    char *optr[MAX_ARGS];
+    char *description = "Generate a deterministic synthetic EFM file for benchmarks";
+    char *usg = "\n   genEfms -n 2000 -r 40 -d 0.2 -c 0.4 -s 7 -o efms.txt -f rfile -v rvfile -p 4 -e 0.1";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if (argc < 2)
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", 1);
+    }
+    unsigned long efm_count = optr[ARG_EFMS] ? strtoul(optr[ARG_EFMS], NULL, 10) : 1000;
+    unsigned int rx_count = optr[ARG_REACTIONS] ? atoi(optr[ARG_REACTIONS]) : 30;
+    double density = optr[ARG_DENSITY] ? atof(optr[ARG_DENSITY]) : 0.3;
+    double conflict = optr[ARG_CONFLICT] ? atof(optr[ARG_CONFLICT]) : 0.3;
+    uint64_t seed = optr[ARG_SEED] ? strtoull(optr[ARG_SEED], NULL, 10) : 1;
+    int template_count = optr[ARG_TEMPLATES] ? atoi(optr[ARG_TEMPLATES]) : 4;
+    double noise = optr[ARG_NOISE] ? atof(optr[ARG_NOISE]) : 0.1;
+    if (efm_count < 1 || rx_count < 1 || density <= 0 || density > 1 ||
+            conflict < 0 || conflict > 1 || template_count < 0 || noise < 0 ||
+            noise > 1)
+    {
+        quitError("number of EFMs and reactions must be greater than 0, "
+                "number of templates not negative, densities and noise "
+                "between 0 and 1\n", 1);
+    }
+    // end read arguments
+    //================================================== 
+
+    //================================================== 
+    // choose conflicting reactions and write model files
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    char* both = calloc(rx_count, sizeof(char));
+    if (NULL == both)
+    {
+        quitError("Not enough free memory\n", 2);
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        both[i] = nextUniform(&state) < conflict ? 1 : 0;
+    }
+    // sign of every reaction in every template (0 no flux, 1 positive and 2
+    // negative flux)
+    char* templates = calloc((unsigned long) template_count * rx_count + 1,
+            sizeof(char));
+    if (NULL == templates)
+    {
+        quitError("Not enough free memory\n", 2);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < (unsigned long) template_count * rx_count; ul++) {
+        if (nextUniform(&state) < density)
+        {
+            templates[ul] = both[ul % rx_count] && nextUniform(&state) < 0.5 ?
+                2 : 1;
+        }
+    }
+    FILE* file;
+    if (optr[ARG_RFILE])
+    {
+        file = fopen(optr[ARG_RFILE], "w");
+        if (!file)
+        {
+            quitError("Error in opening reaction file\n", 3);
+        }
+        for (i = 0; i < rx_count; i++) {
+            fprintf(file, i > 0 ? " \"R%u\"" : "\"R%u\"", i + 1);
+        }
+        fprintf(file, "\n");
+        fclose(file);
+    }
+    if (optr[ARG_RVFILE])
+    {
+        file = fopen(optr[ARG_RVFILE], "w");
+        if (!file)
+        {
+            quitError("Error in opening reversibility file\n", 3);
+        }
+        for (i = 0; i < rx_count; i++) {
+            fprintf(file, i > 0 ? " %d" : "%d", both[i]);
+        }
+        fprintf(file, "\n");
+        fclose(file);
+    }
+    // end choose conflicting reactions and write model files
+    //================================================== 
+
+    //================================================== 
+    // write EFMs
+    file = stdout;
+    if (optr[ARG_OUTPUT])
+    {
+        file = fopen(optr[ARG_OUTPUT], "w");
+        if (!file)
+        {
+            quitError("Error in opening output file\n", 3);
+        }
+    }
+    for (ul = 0; ul < efm_count; ul++) {
+        const char* template = template_count > 0 ? templates + (nextRandom(
+                    &state) % template_count) * rx_count : NULL;
+        for (i = 0; i < rx_count; i++) {
+            double x = 0;
+            if (NULL != template && nextUniform(&state) >= noise)
+            {
+                if (template[i] > 0)
+                {
+                    x = 0.1 + 9.9 * nextUniform(&state);
+                    x = template[i] == 2 ? -x : x;
+                }
+            }
+            else if (nextUniform(&state) < density)
+            {
+                x = 0.1 + 9.9 * nextUniform(&state);
+                if (both[i] && nextUniform(&state) < 0.5)
+                {
+                    x = -x;
+                }
+            }
+            fprintf(file, i > 0 ? "\t%.4g" : "%.4g", x);
+        }
+        fprintf(file, "\n");
+    }
+    if (file != stdout)
+    {
+        fclose(file);
+    }
+    free(both);
+    free(templates);
+    // end write EFMs
+    //================================================== 
+    return EXIT_SUCCESS;
+}
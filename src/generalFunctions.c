@@ -50,7 +50,12 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <string.h>
+#include <time.h>
 
+// size of the time stamps of getTime ("2015-01-31 12:00:00")
+#define TIME_STRING_SIZE 20
+
+char* getTime ( char* time_string );
 char* getArg ( int argc, char *argv[], char *opt );
 void readArgs ( int argc, char *argv[], int optc, char *optv[], char *optr[] );
 void usage ( char* description, char* usage, int optc, char* optv[], char *optd[] );
@@ -58,6 +63,24 @@ void quitError( char* message, int rv );
 void printLine(char c, int length);
 void fprintLine(FILE *file, char c, int length);
 
+/* 
+ * ===  FUNCTION  ======================================================================
+ *         Name:  getTime
+ *  Description:  writes the actual time to time_string (TIME_STRING_SIZE chars)
+ *                and returns it; can be called by several threads
+ * =====================================================================================
+ */
+    char*
+getTime ( char* time_string )
+{
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    strftime(time_string, TIME_STRING_SIZE, "%Y-%m-%d %H:%M:%S", &local);
+    return time_string;
+}		/* -----  end of function getTime  ----- */
+
+
 /* 
  * ===  FUNCTION  ======================================================================
  *         Name:  usage
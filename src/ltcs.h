@@ -0,0 +1,353 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl
+// Email: matthias.gerstl@acib.at
+// Company: Austrian Centre of Industrial Biotechnology (ACIB)
+// Web: http://www.acib.at
+// Copyright (C) 2015
+// Published unter GNU Public License V3
+//////////////////////////////////////////////////////////////////////////////////
+// Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright on
+// the Program, and are irrevocable provided the stated conditions are met.  This
+// License explicitly affirms your unlimited permission to run the unmodified
+// Program. The output from running a covered work is covered by this License only
+// if the output, given its content, constitutes a covered work. This License
+// acknowledges your rights of fair use or other equivalent, as provided by
+// copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey, without
+// conditions so long as your license otherwise remains in force. You may convey
+// covered works to others for the sole purpose of having them make modifications
+// exclusively for you, or provide you with facilities for running those works,
+// provided that you comply with the terms of this License in conveying all
+// material for which you do not control copyright. Those thus making or running
+// the covered works for you must do so exclusively on your behalf, under your
+// direction and control, on terms that prohibit them from making any copies of
+// your copyrighted material outside their relationship with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR OTHER
+// PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND, EITHER
+// EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+// THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.  SHOULD THE PROGRAM
+// PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR
+// CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL ANY
+// COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE PROGRAM AS
+// PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY GENERAL, SPECIAL,
+// INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE
+// THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED
+// INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD PARTIES OR A FAILURE OF THE
+// PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH HOLDER OR OTHER PARTY
+// HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LTCS_H
+#define LTCS_H
+
+#include <stdio.h>
+
+/*
+ * libltcs - calculation of largest thermodynamically consistent sets (LTCS)
+ * of EFMs based on the reversibility of the reactions
+ *
+ * usage:
+ *   ltcs_context* ctx = ltcsCreateContext();
+ *   ltcsReadReversibleFile(ctx, "rvfile");          optional
+ *   ltcsReadStoichiometricFile(ctx, "sfile");       optional, finds loops
+ *   ltcsLoadEfmFile(ctx, "efms.txt");
+ *   ltcsCompute(ctx, 8, LTCS_COMPUTE_DEFAULT);
+ *   ltcsForEachResult(ctx, callback, user_data);
+ *   ltcsFreeContext(ctx);
+ *
+ * all functions returning int return LTCS_OK on success or one of the error
+ * codes below; ltcsGetErrorMessage returns a description of the last error
+ *
+ * LTCS and loops are handed out as packed bitsets over all EFMs in the order
+ * of the input: EFM i is part of the set if bit (i % 8) of byte (i / 8) is
+ * set
+ */
+
+#define LTCS_OK                0
+#define LTCS_ERROR_ARGS        1
+#define LTCS_ERROR_ZERO_NR     2
+#define LTCS_ERROR_FILE        3
+#define LTCS_ERROR_RAM         4
+#define LTCS_ERROR_EFM         5
+#define LTCS_ERROR_CANCELED    6
+
+// options of ltcsCompute
+#define LTCS_COMPUTE_DEFAULT   0
+#define LTCS_COMPUTE_NO_FILTER 1
+#define LTCS_COMPUTE_GENERIC   2
+
+// options of ltcsWriteMilp (OBJ_MIN/OBJ_MAX rows of obj_col as added by
+// findAllSolutions of ltcstool_clever.pl)
+#define LTCS_MILP_DEFAULT      0
+#define LTCS_MILP_TIGHT_BOUNDS 1
+#define LTCS_MILP_OBJ_ROWS     2
+
+// formats of the stoichiometric file (LTCS_SFILE_AUTO detects a MatrixMarket
+// file by its banner, otherwise the file is dense)
+#define LTCS_SFILE_AUTO        0
+#define LTCS_SFILE_DENSE       1
+#define LTCS_SFILE_MATRIX_MARKET 2
+#define LTCS_SFILE_TRIPLETS    3
+
+// categories of memory accounting
+#define LTCS_MEMORY_MATRIX     0
+#define LTCS_MEMORY_FRONTIER   1
+#define LTCS_MEMORY_FILTER     2
+#define LTCS_MEMORY_OUTPUT     3
+#define LTCS_MEMORY_ALL        4
+
+// binary EFM file: magic, uint64 efm count, uint32 reaction count, uint32
+// reserved, followed by efm count * reaction count doubles (row by row)
+#define LTCS_BINARY_MAGIC      "LTCSEFM1"
+#define LTCS_STATE_MAGIC       "LTCSSTA1"
+#define LTCS_INDEX_MAGIC       "LTCSIDX1"
+#define LTCS_SHARD_MAGIC       "LTCSSHD1"
+
+// libltcs.so is built with hidden visibility, only the functions declared
+// here are exported
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LTCS_API __attribute__((visibility("default")))
+#else
+#define LTCS_API
+#endif
+
+typedef struct ltcs_context ltcs_context;
+
+// receives progress messages
+typedef void (*ltcs_log_callback)(const char* message, void* user_data);
+
+// receives a LTCS; return non-zero to stop the iteration
+typedef int (*ltcs_result_callback)(const char* ltcs, unsigned long efm_count,
+        void* user_data);
+
+// receives a LTCS found by anytime search (checked to be consistent and
+// maximal)
+typedef void (*ltcs_anytime_callback)(const char* set, unsigned long
+        efm_count, unsigned long cardinality, void* user_data);
+
+// receives the context of a knockout calculated by ltcsKnockoutScan (calls
+// are serialized, the context is freed afterwards); return non-zero to stop
+typedef int (*ltcs_knockout_callback)(unsigned int reaction, ltcs_context*
+        ctx, void* user_data);
+
+struct ltcs_estimate
+{
+    unsigned int iterations;
+    double* frontier;
+    double* frontier_low;
+    double* frontier_high;
+    double leaves;
+    double ltcs;
+    double ltcs_low;
+    double ltcs_high;
+    double nodes;
+    double peak_frontier;
+    double peak_bytes;
+};
+
+// context
+LTCS_API ltcs_context* ltcsCreateContext(void);
+LTCS_API void ltcsFreeContext(ltcs_context* ctx);
+LTCS_API const char* ltcsGetErrorMessage(ltcs_context* ctx);
+LTCS_API void ltcsSetLogCallback(ltcs_context* ctx, ltcs_log_callback callback,
+        void* user_data);
+LTCS_API void ltcsSetThreshold(ltcs_context* ctx, double threshold);
+LTCS_API void ltcsSetKeepFullMatrix(ltcs_context* ctx, int keep);
+// stop a running ltcsCompute of ctx from another thread
+LTCS_API void ltcsCancel(ltcs_context* ctx);
+// pin worker threads to the cpus of NUMA nodes (read from sysfs), keep a
+// copy of the EFM matrix on every node and split sets on the node that
+// created them before taking sets of other nodes
+LTCS_API void ltcsSetNuma(ltcs_context* ctx, int enable);
+// limit of accounted bytes (0: no limit); before each iteration the frontier
+// is predicted and, if it would exceed the limit, subsets are removed from it
+// or ltcsCompute stops with LTCS_ERROR_RAM
+LTCS_API void ltcsSetMemoryLimit(ltcs_context* ctx, unsigned long bytes);
+LTCS_API unsigned long ltcsGetMemoryUsage(ltcs_context* ctx, int category);
+LTCS_API unsigned long ltcsGetMemoryPeak(ltcs_context* ctx);
+// write JSON lines of stage timings and iterations to file (NULL disables)
+LTCS_API void ltcsSetTelemetryFile(ltcs_context* ctx, FILE* file);
+// write a snapshot of the running stage at the next progress point; only sets
+// a flag and can be called from a signal handler
+LTCS_API void ltcsRequestSnapshot(ltcs_context* ctx);
+
+// model information, must be given before loading EFMs
+LTCS_API int ltcsReadReversibleFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsSetReversibility(ltcs_context* ctx, const int* reversible,
+        unsigned int rx_count);
+LTCS_API int ltcsReadStoichiometricFile(ltcs_context* ctx, const char*
+        filename);
+// dense (one line per metabolite), MatrixMarket coordinate or triplet list
+// ('row column value' per line, 1-based) parsed by the given number of threads
+LTCS_API int ltcsReadStoichiometricFileFormat(ltcs_context* ctx, const char*
+        filename, int format, int threads);
+LTCS_API int ltcsReadReactionFile(ltcs_context* ctx, const char* filename);
+
+// EFM filters, applied by the loaders to every EFM read from a file or memory
+// (not to EFMs of a state or of a base context) before the matrix is
+// cleaned; EFM indices of the results refer to the remaining EFMs
+// yields file and comparisons ('l': <=, 'g': >=, 'e': ==) as in ltcstool.pl,
+// the yields file needs the reaction file
+LTCS_API int ltcsReadYieldsFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsAddYieldFilter(ltcs_context* ctx, unsigned int reaction, char
+        comparison, double value);
+// list of 1-based EFMs and ranges of the input like "1,4-7 12" to load or,
+// with exclude, to skip; NULL removes the list
+LTCS_API int ltcsSetEfmSelection(ltcs_context* ctx, const char* list, int
+        exclude);
+LTCS_API void ltcsClearEfmFilters(ltcs_context* ctx);
+LTCS_API unsigned long ltcsGetFilteredEfmCount(ltcs_context* ctx);
+
+// loaders
+LTCS_API int ltcsLoadEfmFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsLoadBinaryEfmFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsLoadEfmMatrix(ltcs_context* ctx, const double* values, unsigned
+        long efm_count, unsigned int rx_count);
+LTCS_API int ltcsLoadFromContext(ltcs_context* ctx, ltcs_context* base, const
+        char* subset);
+LTCS_API int ltcsIsBinaryEfmFile(const char* filename);
+LTCS_API int ltcsConvertEfmFile(const char* text_file, const char* binary_file);
+
+// information about loaded EFMs
+LTCS_API unsigned int ltcsGetReactionCount(ltcs_context* ctx);
+LTCS_API unsigned int ltcsGetCleanedReactionCount(ltcs_context* ctx);
+LTCS_API unsigned long ltcsGetEfmCount(ltcs_context* ctx);
+LTCS_API unsigned long ltcsGetLoopCount(ltcs_context* ctx);
+LTCS_API const char* ltcsGetLoops(ltcs_context* ctx);
+
+// calculation and results
+LTCS_API int ltcsCompute(ltcs_context* ctx, int threads, unsigned int options);
+LTCS_API unsigned long ltcsGetResultCount(ltcs_context* ctx);
+LTCS_API const char* ltcsGetResult(ltcs_context* ctx, unsigned long index);
+LTCS_API unsigned long ltcsGetResultCardinality(ltcs_context* ctx, unsigned long
+        index);
+LTCS_API int ltcsForEachResult(ltcs_context* ctx, ltcs_result_callback callback,
+        void* user_data);
+LTCS_API int ltcsWriteResults(ltcs_context* ctx, FILE* file, int csv);
+LTCS_API void ltcsWriteSet(FILE* file, const char* set, unsigned long efm_count,
+        int csv);
+LTCS_API int ltcsWriteLoops(ltcs_context* ctx, FILE* file, int csv);
+LTCS_API int ltcsWriteAnalysis(ltcs_context* ctx, FILE* file, int threads);
+
+// index of calculated LTCS and queries
+// sets are bitsets of EFMs, results of ltcsQueryContaining are bitsets of LTCS
+// (in order of the results); queries only need a built or loaded index
+LTCS_API int ltcsBuildIndex(ltcs_context* ctx);
+LTCS_API int ltcsWriteIndex(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsLoadIndex(ltcs_context* ctx, const char* filename);
+LTCS_API unsigned long ltcsGetIndexEfmCount(ltcs_context* ctx);
+LTCS_API unsigned long ltcsGetIndexLtcsCount(ltcs_context* ctx);
+LTCS_API unsigned long ltcsGetIndexCardinality(ltcs_context* ctx, unsigned long
+        index);
+LTCS_API int ltcsQueryConsistent(ltcs_context* ctx, const char* set);
+LTCS_API unsigned long ltcsQueryContaining(ltcs_context* ctx, const char* set,
+        char* result);
+LTCS_API long ltcsQueryExtension(ltcs_context* ctx, const char* set, char*
+        extension);
+
+// threshold sweep
+// the EFM file is read once for all thresholds; selecting a threshold builds
+// its EFM matrix (and frees results) unless no entry lies between the actual
+// and the selected threshold (changed = 0, matrix and results are kept)
+LTCS_API int ltcsLoadEfmSweep(ltcs_context* ctx, const char* filename, const
+        double* thresholds, unsigned int count);
+LTCS_API unsigned int ltcsGetSweepCount(ltcs_context* ctx);
+LTCS_API double ltcsGetSweepThreshold(ltcs_context* ctx, unsigned int index);
+LTCS_API int ltcsSelectSweepThreshold(ltcs_context* ctx, unsigned int index,
+        int* changed);
+
+// incremental update
+// a state file holds the full matrix, loops, reversibility and LTCS of a
+// context together with a fingerprint of the cleaned matrix
+LTCS_API int ltcsSaveState(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsLoadState(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsAppendEfmFile(ltcs_context* ctx, const char* filename, int
+        threads);
+LTCS_API int ltcsAppendEfmMatrix(ltcs_context* ctx, const double* values,
+        unsigned long efm_count, unsigned int rx_count, int threads);
+// reversibility (see ltcsSetReversibility) changed after LTCS were calculated
+// with the full matrix or loaded by ltcsLoadState; LTCS are merged where a
+// reaction is no longer reversible and split where a reaction became
+// reversible
+LTCS_API int ltcsUpdateReversibility(ltcs_context* ctx, const int* reversible,
+        unsigned int rx_count, int threads);
+LTCS_API int ltcsUpdateReversibleFile(ltcs_context* ctx, const char* filename,
+        int threads);
+
+// reaction knockouts (reactions are 0-based)
+// LTCS of a knockout are derived from the calculated LTCS of base, which
+// needs to keep the full matrix; EFM indices refer to the remaining EFMs
+LTCS_API int ltcsComputeKnockout(ltcs_context* ctx, ltcs_context* base, unsigned
+        int reaction);
+LTCS_API int ltcsKnockoutScan(ltcs_context* base, const unsigned int* reactions,
+        unsigned int count, int threads, ltcs_knockout_callback callback,
+        void* user_data);
+
+// sharded calculation (shards are 0-based)
+// ltcsCompute only splits the sets of its shard once the frontier is large
+// enough; a shard file holds its LTCS sorted by descending cardinality and
+// ltcsMergeShard removes the LTCS of file index that are subsets of LTCS of
+// the other files (equal LTCS are kept by the lowest shard)
+LTCS_API void ltcsSetShard(ltcs_context* ctx, unsigned int shard, unsigned int
+        shards);
+LTCS_API int ltcsWriteShard(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsMergeShard(ltcs_context* ctx, const char* const* filenames,
+        unsigned int count, unsigned int index);
+
+// thermodynamic MILP of ltcstool_clever.pl
+// the reactions of the SBML file are ordered by the reaction file if it was
+// read before, otherwise the SBML file defines the reaction names; conditions
+// default to 310.15 K, pH 7, ionic strength 0.15 and no proton
+LTCS_API int ltcsReadSbmlFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsReadGibbsFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsReadConcentrationFile(ltcs_context* ctx, const char* filename);
+LTCS_API int ltcsSetConditions(ltcs_context* ctx, double temperature, double ph,
+        double ionic_strength, const char* proton);
+// reversibility of the EFM reactions (see ltcsSetReversibility) by the model
+LTCS_API int ltcsSetModelReversibility(ltcs_context* ctx);
+// write the model for calcLtcs: stoichiometric matrix (-s, internal species
+// in the order of the SBML file as rows), reversibility (-v), reaction names
+// (-r) and the species of the rows; external species have a boundary
+// condition or are in one of the comma separated compartments of external
+// (NULL: none); NULL file names are skipped
+LTCS_API int ltcsWriteModelFiles(ltcs_context* ctx, const char* external, const
+        char* sfile, const char* rvfile, const char* rfile, const char* mfile);
+// stream the EFMs of a text or binary file into the MILP and write it in MPS
+// format with CPLEX indicator constraints; yields of ltcsReadYieldsFile are
+// constraints of the MILP (at least one EFM fulfils each yield) instead of
+// filters; a subset (bitset of EFM file rows, e.g. an LTCS) restricts the
+// MILP to its EFMs and their reactions
+LTCS_API int ltcsWriteMilp(ltcs_context* ctx, const char* efm_file, const char*
+        filename, unsigned int options);
+LTCS_API int ltcsWriteMilpSubset(ltcs_context* ctx, const char* efm_file, const
+        char* efms, const char* filename, unsigned int options);
+// check the LTCS with an LP over the concentration ranges (DrG <= 0 for every
+// used reaction direction as in the MILP) before any MILP is built: feasible
+// LTCS are kept, infeasible ones are split by minimal conflicts into their
+// maximal feasible subsets; an LTCS needing more than max_splits splits (0:
+// unlimited) is kept for the MILP; needs the SBML model and the full EFM
+// matrix (ltcsSetKeepFullMatrix before loading), yields are not checked
+LTCS_API int ltcsCheckFeasibility(ltcs_context* ctx, int threads, unsigned long
+        max_splits);
+
+// heuristics
+LTCS_API int ltcsComputeAnytime(ltcs_context* ctx, int threads, double
+        time_budget, ltcs_anytime_callback callback, void* user_data, unsigned
+        long* set_count, unsigned long* best_cardinality);
+LTCS_API int ltcsEstimate(ltcs_context* ctx, int threads, unsigned long samples,
+        struct ltcs_estimate* estimate);
+LTCS_API void ltcsFreeEstimate(struct ltcs_estimate* estimate);
+
+#endif
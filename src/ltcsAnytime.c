@@ -0,0 +1,511 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ltcsIntern.h"
+
+/*
+ * add an EFM to a set and mark all EFMs that conflict with it
+ */
+static void addEfmToSet(char* set, char* forbidden, unsigned long efm, struct
+        anytime_shared* shared)
+{
+    unsigned int i;
+    BITSET(set, efm);
+    for (i = 0; i < shared->rx_count; i++) {
+        if (BITTEST(shared->matrix[efm], 2*i))
+        {
+            ltcs_bitsetOr(forbidden, shared->neg_mask[i],
+                    shared->bitarray_size);
+        }
+        else if (BITTEST(shared->matrix[efm], 2*i+1))
+        {
+            ltcs_bitsetOr(forbidden, shared->pos_mask[i],
+                    shared->bitarray_size);
+        }
+    }
+}
+
+/*
+ * greedily add all EFMs that do not conflict with the set
+ * EFMs of preferred (if given) are tried first, afterwards the EFMs are tried
+ * in the given order; the resulting set is always maximal
+ */
+static unsigned long extendSet(char* set, char* forbidden, unsigned long* order,
+        unsigned long order_count, char* preferred, struct anytime_shared*
+        shared)
+{
+    unsigned long ul;
+    if (NULL != preferred)
+    {
+        for (ul = 0; ul < order_count; ul++) {
+            unsigned long efm = order[ul];
+            if (BITTEST(preferred, efm) && !BITTEST(set, efm) &&
+                    !BITTEST(forbidden, efm))
+            {
+                addEfmToSet(set, forbidden, efm, shared);
+            }
+        }
+    }
+    for (ul = 0; ul < order_count; ul++) {
+        unsigned long efm = order[ul];
+        if (!BITTEST(set, efm) && !BITTEST(forbidden, efm))
+        {
+            addEfmToSet(set, forbidden, efm, shared);
+        }
+    }
+    return ltcs_bitsetCount(set, shared->bitarray_size);
+}
+
+/*
+ * swap move: remove all EFMs of a set that use reaction in given direction and
+ * extend the remaining set, preferring EFMs using the opposite direction
+ */
+static unsigned long flipReaction(char* set, char* new_set, char* forbidden,
+        unsigned int reaction, int negative, unsigned long* order, unsigned long
+        order_count, struct anytime_shared* shared)
+{
+    char* remove = negative ? shared->neg_mask[reaction] : shared->pos_mask[reaction];
+    char* prefer = negative ? shared->pos_mask[reaction] : shared->neg_mask[reaction];
+    memcpy(new_set, set, shared->bitarray_size);
+    ltcs_bitsetAndNot(new_set, remove, shared->bitarray_size);
+    ltcs_getForbiddenEfms(new_set, forbidden, shared->pos_mask,
+            shared->neg_mask, shared->rx_count, shared->bitarray_size);
+    return extendSet(new_set, forbidden, order, order_count, prefer, shared);
+}
+
+/*
+ * improve a set by swap moves until no move increases its cardinality
+ */
+static unsigned long improveSet(char* set, char* trial, char* forbidden,
+        unsigned long cardinality, unsigned long* order, unsigned long
+        order_count, unsigned int* rx_order, unsigned int* seed, struct
+        anytime_shared* shared)
+{
+    unsigned int i;
+    int improved = 1;
+    while (improved > 0 && ltcs_getElapsedTime(&shared->start) <
+            shared->time_budget)
+    {
+        improved = 0;
+        for (i = shared->rx_count; i > 1; i--) {
+            unsigned int j = rand_r(seed) % i;
+            unsigned int t = rx_order[i-1];
+            rx_order[i-1] = rx_order[j];
+            rx_order[j] = t;
+        }
+        for (i = 0; i < shared->rx_count && improved == 0; i++) {
+            unsigned int r = rx_order[i];
+            int negative = ltcs_bitsetIntersects(set, shared->neg_mask[r],
+                    shared->bitarray_size);
+            if (!negative && !ltcs_bitsetIntersects(set, shared->pos_mask[r],
+                        shared->bitarray_size))
+            {
+                continue;
+            }
+            unsigned long card = flipReaction(set, trial, forbidden, r,
+                    negative, order, order_count, shared);
+            if (card > cardinality)
+            {
+                memcpy(set, trial, shared->bitarray_size);
+                cardinality = card;
+                improved = 1;
+            }
+        }
+    }
+    return cardinality;
+}
+
+/*
+ * insert a copy of set into the hash set of reported sets, which is doubled
+ * when it is half full; return 0 if the set was reported before, 1 if it was
+ * inserted and -1 if there is not enough memory
+ */
+static int insertFoundSet(const char* set, struct anytime_shared* shared)
+{
+    unsigned long bitarray_size = shared->bitarray_size;
+    unsigned long ul;
+    if (2 * (shared->found_count + 1) > shared->table_size)
+    {
+        unsigned long table_size = shared->table_size > 0 ?
+            2 * shared->table_size : 64;
+        char** table = calloc(table_size, sizeof(char*));
+        if (NULL == table)
+        {
+            return -1;
+        }
+        for (ul = 0; ul < shared->table_size; ul++) {
+            if (NULL != shared->found[ul])
+            {
+                unsigned long slot = ltcs_getFingerprint(shared->found[ul],
+                        bitarray_size, 14695981039346656037ULL) &
+                    (table_size - 1);
+                while (NULL != table[slot])
+                {
+                    slot = (slot + 1) & (table_size - 1);
+                }
+                table[slot] = shared->found[ul];
+            }
+        }
+        free(shared->found);
+        shared->found = table;
+        shared->table_size = table_size;
+    }
+    unsigned long slot = ltcs_getFingerprint(set, bitarray_size,
+            14695981039346656037ULL) & (shared->table_size - 1);
+    while (NULL != shared->found[slot])
+    {
+        if (!memcmp(shared->found[slot], set, bitarray_size))
+        {
+            return 0;
+        }
+        slot = (slot + 1) & (shared->table_size - 1);
+    }
+    char* copy = malloc(bitarray_size);
+    if (NULL == copy)
+    {
+        return -1;
+    }
+    memcpy(copy, set, bitarray_size);
+    shared->found[slot] = copy;
+    shared->found_count++;
+    return 1;
+}
+
+/*
+ * hand a set to the callback if it is at least as large as the best set
+ * found so far and was not reported before
+ * every reported set is checked for consistency and maximality, so it is an
+ * LTCS; sets of equal cardinality are reported as well, as they are further
+ * LTCS
+ */
+static void reportAnytimeSet(char* set, unsigned long cardinality, int
+        thread_id, struct anytime_shared* shared)
+{
+    pthread_mutex_lock(&shared->lock);
+    if (cardinality >= shared->best_cardinality)
+    {
+        if (!ltcs_isConsistentSet(set, shared->pos_mask, shared->neg_mask,
+                    shared->rx_count, shared->bitarray_size) ||
+                !ltcs_isMaximalSet(set, shared->forbidden, shared->loops,
+                    shared->pos_mask, shared->neg_mask, shared->rx_count,
+                    shared->efm_count))
+        {
+            shared->error = LTCS_ERROR_EFM;
+            pthread_mutex_unlock(&shared->lock);
+            return;
+        }
+        int inserted = insertFoundSet(set, shared);
+        if (inserted < 0)
+        {
+            shared->error = LTCS_ERROR_RAM;
+        }
+        else if (inserted > 0)
+        {
+            shared->best_cardinality = cardinality;
+            if (NULL != shared->callback)
+            {
+                shared->callback(set, shared->efm_count, cardinality,
+                        shared->user_data);
+            }
+            ltcs_log(shared->ctx, "anytime set %lu: cardinality %lu "
+                    "(thread %d, %.1fs)", shared->found_count, cardinality,
+                    thread_id, ltcs_getElapsedTime(&shared->start));
+        }
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/*
+ * thread function of anytime search
+ * constructs a set greedily from EFMs ordered by the number of reactions they
+ * use (random tie breaking), improves it by local search and perturbs the
+ * local optimum by random swap moves until the time budget is exhausted
+ */
+static void* anytimeThread(void *pointer_anytime_args)
+{
+    struct anytime_args* anytime_args = (struct anytime_args*) pointer_anytime_args;
+    struct anytime_shared* shared = anytime_args->shared;
+    int thread_id = anytime_args->thread_id;
+    unsigned int seed = 12345 + 7919 * thread_id;
+    unsigned long bitarray_size = shared->bitarray_size;
+    unsigned long efm_count = shared->efm_count;
+    unsigned int rx_count = shared->rx_count;
+    unsigned long rx_bitarray_size = ltcs_getBitsize(2 * rx_count);
+
+    // EFMs that are not internal loops and number of their used reactions
+    unsigned long order_count = 0;
+    unsigned long* order = calloc(efm_count + 1, sizeof(unsigned long));
+    unsigned long* sorted = calloc(efm_count + 1, sizeof(unsigned long));
+    unsigned int* score = calloc(efm_count + 1, sizeof(unsigned int));
+    unsigned int* key = calloc(efm_count + 1, sizeof(unsigned int));
+    unsigned long* bucket = calloc(rx_count + 2, sizeof(unsigned long));
+    unsigned int* rx_order = calloc(rx_count + 1, sizeof(unsigned int));
+    char* set = calloc(1, bitarray_size);
+    char* current = calloc(1, bitarray_size);
+    char* trial = calloc(1, bitarray_size);
+    char* forbidden = calloc(1, bitarray_size);
+    if (NULL == order || NULL == sorted || NULL == score || NULL == key ||
+            NULL == bucket ||
+            NULL == rx_order || NULL == set || NULL == current || NULL == trial
+            || NULL == forbidden)
+    {
+        pthread_mutex_lock(&shared->lock);
+        shared->error = LTCS_ERROR_RAM;
+        pthread_mutex_unlock(&shared->lock);
+        order_count = 0;
+    }
+    unsigned long ul;
+    unsigned int i;
+    for (ul = 0; ul < efm_count && shared->error == LTCS_OK; ul++) {
+        if (!BITTEST(shared->loops, ul))
+        {
+            order[order_count] = ul;
+            order_count++;
+            score[ul] = ltcs_bitsetCount(shared->matrix[ul], rx_bitarray_size);
+        }
+    }
+    for (i = 0; i < rx_count && NULL != rx_order; i++) {
+        rx_order[i] = i;
+    }
+
+    int restart = 0;
+    while (order_count > 0 && shared->error == LTCS_OK &&
+            ltcs_getElapsedTime(&shared->start) < shared->time_budget)
+    {
+        // random order of EFMs, stable sorted by (perturbed) score
+        for (ul = order_count; ul > 1; ul--) {
+            // rand_r is limited to 31 bits, combine two for large EFM sets
+            unsigned long j = (((unsigned long) rand_r(&seed) << 31) ^
+                    (unsigned long) rand_r(&seed)) % ul;
+            unsigned long t = order[ul-1];
+            order[ul-1] = order[j];
+            order[j] = t;
+        }
+        memset(bucket, 0, (rx_count + 2) * sizeof(unsigned long));
+        for (ul = 0; ul < order_count; ul++) {
+            key[ul] = score[order[ul]];
+            if (restart > 0 && key[ul] > 0)
+            {
+                key[ul] -= rand_r(&seed) % 2;
+            }
+            bucket[key[ul]+1]++;
+        }
+        for (i = 1; i < rx_count + 2; i++) {
+            bucket[i] += bucket[i-1];
+        }
+        for (ul = 0; ul < order_count; ul++) {
+            sorted[bucket[key[ul]]] = order[ul];
+            bucket[key[ul]]++;
+        }
+
+        // greedy construction and local search
+        memset(set, 0, bitarray_size);
+        memset(forbidden, 0, bitarray_size);
+        unsigned long cardinality = extendSet(set, forbidden, sorted,
+                order_count, NULL, shared);
+        cardinality = improveSet(set, trial, forbidden, cardinality, sorted,
+                order_count, rx_order, &seed, shared);
+        reportAnytimeSet(set, cardinality, thread_id, shared);
+
+        // perturb local optimum by random swap moves
+        int fails = 0;
+        while (fails < 20 && ltcs_getElapsedTime(&shared->start) < shared->time_budget)
+        {
+            unsigned int r = rand_r(&seed) % rx_count;
+            int negative = ltcs_bitsetIntersects(set, shared->neg_mask[r], bitarray_size);
+            if (!negative && !ltcs_bitsetIntersects(set, shared->pos_mask[r], bitarray_size))
+            {
+                fails++;
+                continue;
+            }
+            unsigned long card = flipReaction(set, current, forbidden, r,
+                    negative, sorted, order_count, shared);
+            card = improveSet(current, trial, forbidden, card, sorted,
+                    order_count, rx_order, &seed, shared);
+            if (card >= cardinality)
+            {
+                fails = card > cardinality ? 0 : fails + 1;
+                memcpy(set, current, bitarray_size);
+                cardinality = card;
+                reportAnytimeSet(set, cardinality, thread_id, shared);
+            }
+            else
+            {
+                fails++;
+            }
+        }
+        restart++;
+    }
+    free(order);
+    free(sorted);
+    free(score);
+    free(key);
+    free(bucket);
+    free(rx_order);
+    free(set);
+    free(current);
+    free(trial);
+    free(forbidden);
+    return((void*)NULL);
+}
+
+/*
+ * anytime search for large consistent sets
+ * runs local search in parallel until the time budget (in seconds) is
+ * exhausted; LTCS at least as large as the largest one found before are
+ * handed to callback as soon as they are found
+ */
+int ltcsComputeAnytime(ltcs_context* ctx, int threads, double time_budget,
+        ltcs_anytime_callback callback, void* user_data, unsigned long*
+        set_count, unsigned long* best_cardinality)
+{
+    if (NULL == ctx->matrix)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "no EFMs loaded\n");
+    }
+    if (time_budget <= 0)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "time budget must be greater than 0\n");
+    }
+    int max_threads = threads < 1 ? 1 : threads;
+    unsigned int rx_count = ctx->clean_rx_count;
+    unsigned long efm_count = ctx->efm_count;
+    struct anytime_shared shared;
+    clock_gettime(CLOCK_MONOTONIC, &shared.start);
+    shared.ctx = ctx;
+    shared.time_budget = time_budget;
+    shared.efm_count = efm_count;
+    shared.rx_count = rx_count;
+    shared.bitarray_size = ltcs_getBitsize(efm_count);
+    shared.matrix = ctx->matrix;
+    shared.loops = ctx->loops;
+    shared.callback = callback;
+    shared.user_data = user_data;
+    shared.best_cardinality = 0;
+    shared.found_count = 0;
+    shared.table_size = 0;
+    shared.found = NULL;
+    shared.error = LTCS_OK;
+    ltcs_log(ctx, "anytime search for %.1f seconds", time_budget);
+    shared.forbidden = calloc(1, shared.bitarray_size + 1);
+    if (NULL == shared.forbidden || ltcs_getColumnMasks(ctx->matrix, efm_count,
+                rx_count, ctx->loops, &shared.pos_mask, &shared.neg_mask) !=
+            LTCS_OK)
+    {
+        free(shared.forbidden);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in getColumnMasks\n");
+    }
+    pthread_mutex_init(&shared.lock, NULL);
+
+    if (rx_count < 1)
+    {
+        // no reaction is used in both directions: all EFMs form one set
+        char* set = calloc(1, shared.bitarray_size + 1);
+        if (NULL == set)
+        {
+            shared.error = LTCS_ERROR_RAM;
+        }
+        else
+        {
+            unsigned long ul;
+            for (ul = 0; ul < efm_count; ul++) {
+                if (!BITTEST(ctx->loops, ul))
+                {
+                    BITSET(set, ul);
+                }
+            }
+            reportAnytimeSet(set, ltcs_bitsetCount(set, shared.bitarray_size),
+                    0, &shared);
+            free(set);
+        }
+    }
+    else
+    {
+        pthread_t thread[max_threads];
+        struct anytime_args anytime_args[max_threads];
+        int ti;
+        for (ti = 0; ti < max_threads; ti++) {
+            anytime_args[ti].thread_id = ti;
+            anytime_args[ti].shared = &shared;
+            pthread_create(&thread[ti], NULL, anytimeThread,
+                    (void*)&anytime_args[ti]);
+        }
+        for (ti = 0; ti < max_threads; ti++) {
+            pthread_join(thread[ti], NULL);
+        }
+    }
+
+    unsigned long ul;
+    for (ul = 0; ul < shared.table_size; ul++) {
+        free(shared.found[ul]);
+    }
+    free(shared.found);
+    free(shared.forbidden);
+    ltcs_freeColumnMasks(shared.pos_mask, shared.neg_mask, rx_count);
+    pthread_mutex_destroy(&shared.lock);
+    *set_count = shared.found_count;
+    *best_cardinality = shared.best_cardinality;
+    if (shared.error == LTCS_ERROR_EFM)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_EFM,
+                "ERROR: anytime search produced an inconsistent or not maximal "
+                "set\n");
+    }
+    if (shared.error != LTCS_OK)
+    {
+        return ltcs_setError(ctx, shared.error,
+                "Not enough free memory in anytime search\n");
+    }
+    return LTCS_OK;
+}
@@ -0,0 +1,287 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+
+#define MAX_ARGS       7
+#define ARG_INPUT      0
+#define ARG_RFILE      1
+#define ARG_RVFILE     2
+#define ARG_THREADS    3
+#define ARG_NAME       4
+#define ARG_OUTPUT     5
+#define ARG_GENERIC    6
+
+struct bench_state
+{
+    FILE* out;
+    char* name;
+    struct timespec start;
+    double clean_start;
+    double compute_start;
+    double filter_start;
+    unsigned long frontier;
+};
+
+/*
+ * seconds since start of benchmark
+ */
+double getSeconds(struct bench_state* state)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - state->start.tv_sec) + (now.tv_nsec -
+            state->start.tv_nsec) / 1e9;
+}
+
+/*
+ * peak resident set size in kB
+ */
+long getPeakRss()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+ * write a result row: case, stage, iteration, seconds, count, peak rss
+ */
+void writeRow(struct bench_state* state, const char* stage, int iteration,
+        double seconds, unsigned long count)
+{
+    if (iteration > 0)
+    {
+        fprintf(state->out, "%s,%s,%d,%.6f,%lu,%ld\n", state->name, stage,
+                iteration, seconds, count, getPeakRss());
+    }
+    else
+    {
+        fprintf(state->out, "%s,%s,,%.6f,%lu,%ld\n", state->name, stage,
+                seconds, count, getPeakRss());
+    }
+}
+
+/*
+ * stages are separated by the progress messages of libltcs
+ */
+void benchLog(const char* message, void* user_data)
+{
+    struct bench_state* state = (struct bench_state*) user_data;
+    int iteration, iterations;
+    unsigned long count;
+    if (!strcmp(message, "optimizating EFM matrix"))
+    {
+        state->clean_start = getSeconds(state);
+    }
+    else if (!strcmp(message, "filter LTCS to remove subsets"))
+    {
+        state->filter_start = getSeconds(state);
+    }
+    else if (sscanf(message, "iteration %d/%d: %lu ltcs", &iteration,
+                &iterations, &count) == 3)
+    {
+        state->frontier = count;
+        writeRow(state, "split", iteration, getSeconds(state) -
+                state->compute_start, count);
+    }
+}
+
+/*
+ * quit with the error message of libltcs if a call failed
+ */
+void checkLtcs(ltcs_context* ctx, int rv)
+{
+    if (rv != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
+    }
+}
+
+/*
+ * run loading, splitting, filtering, analysis and output of libltcs
+ * separately and write wall time, frontier size of every iteration and peak
+ * RSS in csv format
+ */
+int main (int argc, char *argv[])
+{
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-i", "-r", "-v", "-t", "-n", "-o", "-g" };
+    char *optd[MAX_ARGS] = {"efm file",
+                            "reaction file [optional, analysis is only run if given]",
+                            "reversibility file [optional]",
+                            "number of threads [default: 1]",
+                            "name of benchmark case [default: efm file]",
+                            "csv output file [default: STDOUT] rows are appended",
+                            "use the generic kernel also for up to 512 EFMs (yes|no) [default: no]"};
+    char *optr[MAX_ARGS];
+    char *description = "Benchmark the stages of the LTCS calculation\n"
+        "output: case,stage,iteration,seconds,count,peak_rss_kb";
+    char *usg = "\n   ltcsBench -i efms.txt -r rfile -t 4 -n medium -o bench.csv";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_INPUT] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    int threads = optr[ARG_THREADS] ? atoi(optr[ARG_THREADS]) : 1;
+    unsigned int options = LTCS_COMPUTE_DEFAULT;
+    if (optr[ARG_GENERIC] && !strcmp(optr[ARG_GENERIC], "yes"))
+    {
+        options |= LTCS_COMPUTE_GENERIC;
+    }
+    struct bench_state state;
+    memset(&state, 0, sizeof(struct bench_state));
+    state.name = optr[ARG_NAME] ? optr[ARG_NAME] : optr[ARG_INPUT];
+    state.out = stdout;
+    if (optr[ARG_OUTPUT])
+    {
+        state.out = fopen(optr[ARG_OUTPUT], "a");
+        if (!state.out)
+        {
+            quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+        }
+    }
+    if (ftell(state.out) <= 0)
+    {
+        fprintf(state.out, "case,stage,iteration,seconds,count,peak_rss_kb\n");
+    }
+    // end read arguments
+    //================================================== 
+
+    //================================================== 
+    // run stages
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, benchLog, &state);
+    if (optr[ARG_RVFILE])
+    {
+        checkLtcs(ctx, ltcsReadReversibleFile(ctx, optr[ARG_RVFILE]));
+    }
+    if (optr[ARG_RFILE])
+    {
+        checkLtcs(ctx, ltcsReadReactionFile(ctx, optr[ARG_RFILE]));
+        ltcsSetKeepFullMatrix(ctx, 1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &state.start);
+
+    // parse and clean
+    checkLtcs(ctx, ltcsLoadEfmFile(ctx, optr[ARG_INPUT]));
+    double t = getSeconds(&state);
+    writeRow(&state, "parse", 0, state.clean_start, ltcsGetEfmCount(ctx));
+    writeRow(&state, "clean", 0, t - state.clean_start,
+            ltcsGetCleanedReactionCount(ctx));
+
+    // split and filter
+    state.compute_start = getSeconds(&state);
+    state.filter_start = -1;
+    checkLtcs(ctx, ltcsCompute(ctx, threads, options));
+    t = getSeconds(&state);
+    if (state.filter_start < 0)
+    {
+        state.filter_start = t;
+    }
+    writeRow(&state, "split", 0, state.filter_start - state.compute_start,
+            state.frontier);
+    writeRow(&state, "filter", 0, t - state.filter_start,
+            ltcsGetResultCount(ctx));
+
+    // analysis
+    FILE* file;
+    if (optr[ARG_RFILE])
+    {
+        file = tmpfile();
+        t = getSeconds(&state);
+        checkLtcs(ctx, ltcsWriteAnalysis(ctx, file, threads));
+        writeRow(&state, "analysis", 0, getSeconds(&state) - t,
+                ltcsGetReactionCount(ctx));
+        fclose(file);
+    }
+
+    // output
+    file = tmpfile();
+    if (!file)
+    {
+        quitError("Error in opening temporary file\n", LTCS_ERROR_FILE);
+    }
+    t = getSeconds(&state);
+    checkLtcs(ctx, ltcsWriteResults(ctx, file, 1));
+    fflush(file);
+    writeRow(&state, "write", 0, getSeconds(&state) - t, ftell(file));
+    fclose(file);
+    writeRow(&state, "total", 0, getSeconds(&state), ltcsGetResultCount(ctx));
+    // end run stages
+    //================================================== 
+
+    if (state.out != stdout)
+    {
+        fclose(state.out);
+    }
+    ltcsFreeContext(ctx);
+    return EXIT_SUCCESS;
+}
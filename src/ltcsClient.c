@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "generalFunctions.c"
+
+#define LINE_SIZE      4096
+
+/*
+ * send a request to ltcsDaemon and print its answer
+ * the request is built from all arguments after the socket, e.g.
+ *   ltcsClient /tmp/ltcs.sock compute efm=efms.txt rvfile=rv output=-
+ */
+int main (int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("\nSend a request to ltcsDaemon and print the answer\n");
+        printf("\nusage:\n");
+        printf("   ltcsClient socket load efm=FILE [sfile=FILE] [threshold=1e-10]\n");
+        printf("   ltcsClient socket compute efm=FILE output=FILE|- [sfile=FILE]\n");
+        printf("              [threshold=1e-10] [rvfile=FILE] [subset=FILE]\n");
+        printf("              [csv=yes|no] [threads=1] [wait=yes]\n");
+        printf("   ltcsClient socket status [job]\n");
+        printf("   ltcsClient socket cancel job\n");
+        printf("   ltcsClient socket shutdown\n\n");
+        quitError("Missing argument\n", 1);
+    }
+
+    // build request
+    char request[LINE_SIZE];
+    request[0] = '\0';
+    int i;
+    for (i = 2; i < argc; i++) {
+        if (strlen(request) + strlen(argv[i]) + 2 >= LINE_SIZE)
+        {
+            quitError("request is too long\n", 1);
+        }
+        strcat(request, argv[i]);
+        strcat(request, i + 1 < argc ? " " : "\n");
+    }
+
+    // connect to daemon
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(addr.sun_path))
+    {
+        quitError("socket path is too long\n", 1);
+    }
+    strcpy(addr.sun_path, argv[1]);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || connect(server, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+    {
+        quitError("Error in connecting to daemon\n", 3);
+    }
+    if (write(server, request, strlen(request)) != strlen(request))
+    {
+        quitError("Error in sending request\n", 3);
+    }
+
+    // print answer until daemon closes connection
+    int rv = EXIT_SUCCESS;
+    FILE* answer = fdopen(server, "r");
+    char* line = NULL;
+    size_t len = 0;
+    while ( getline(&line, &len, answer) != -1)
+    {
+        if (!strncmp(line, "error", 5) || !strncmp(line, "failed", 6) ||
+                !strncmp(line, "canceled", 8))
+        {
+            rv = 1;
+        }
+        printf("%s", line);
+    }
+    free(line);
+    fclose(answer);
+    return rv;
+}
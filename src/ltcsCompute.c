@@ -0,0 +1,1149 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ltcsIntern.h"
+
+/*
+ * set memory of results free
+ */
+void ltcs_freeResults(ltcs_context* ctx)
+{
+    unsigned long li;
+    for (li = 0; li < ctx->ltcs_count; li++) {
+        if (NULL == ctx->not_an_ltcs || !BITTEST(ctx->not_an_ltcs, li))
+        {
+            free(ctx->ltcs[li]);
+        }
+    }
+    free(ctx->ltcs);
+    free(ctx->not_an_ltcs);
+    free(ctx->result_index);
+    ctx->ltcs = NULL;
+    ctx->not_an_ltcs = NULL;
+    ctx->result_index = NULL;
+    ctx->ltcs_count = 0;
+    ctx->result_count = 0;
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, 0);
+    ltcs_memorySet(ctx, LTCS_MEMORY_FILTER, 0);
+    ltcs_memorySet(ctx, LTCS_MEMORY_OUTPUT, 0);
+    ltcs_freeIndex(ctx);
+}
+
+/**
+ * find subsets and duplicates of LTCS and set memory of those LTCS free
+ * splitting different sets can give equal sets, of those only the first one
+ * is kept, otherwise the LTCS would be written more than once
+ */
+static int filterLtcs(ltcs_context* ctx, char** ltcs, char** notAnLtcs, unsigned
+        long ltcs_count, unsigned long efm_count, unsigned long* duplicates,
+        unsigned long* dominated)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(ltcs_count);
+    char* m_notAnLtcs = calloc(1, bitarray_size);
+    if (NULL == m_notAnLtcs)
+    {
+        return LTCS_ERROR_RAM;
+    }
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_FILTER, bitarray_size);
+    long set_bytes = ltcs_getBitsize(efm_count);
+    unsigned long li, lj, lk;
+    *notAnLtcs = m_notAnLtcs;
+    *duplicates = 0;
+    *dominated = 0;
+    ltcs_telemetryProgress(ctx, 1, ltcs_count * (ltcs_count - 1) / 2);
+    for (li = 0; li < (ltcs_count - 1); li++) {
+        if (ltcs_isCanceled(ctx))
+        {
+            return LTCS_ERROR_CANCELED;
+        }
+        ltcs_telemetryAdvance(ctx, ltcs_count - 1 - li);
+        if (!BITTEST(m_notAnLtcs, li))
+        {
+            for (lj = (li+1); lj < ltcs_count; lj++) {
+                if (!BITTEST(m_notAnLtcs, lj))
+                {
+                    int a = 0;
+                    int b = 0;
+                    for (lk = 0; lk < efm_count; lk++) {
+                        if (BITTEST(ltcs[li],lk) && !BITTEST(ltcs[lj],lk))
+                        {
+                            a = 1;
+                        }
+                        else if (!BITTEST(ltcs[li],lk) && BITTEST(ltcs[lj],lk))
+                        {
+                            b = 1;
+                        }
+                        if (a > 0 && b > 0)
+                        {
+                            lk = efm_count;
+                        }
+                    }
+                    // ltcs 2 is equal to ltcs 1
+                    if (a == 0 && b == 0)
+                    {
+                        BITSET(m_notAnLtcs, lj);
+                        free(ltcs[lj]);
+                        ltcs_memoryAdd(ctx, LTCS_MEMORY_FRONTIER, -set_bytes);
+                        (*duplicates)++;
+                    }
+                    // ltcs 2 is a subset of ltcs 1
+                    else if (a > 0 && b == 0)
+                    {
+                        BITSET(m_notAnLtcs, lj);
+                        free(ltcs[lj]);
+                        ltcs_memoryAdd(ctx, LTCS_MEMORY_FRONTIER, -set_bytes);
+                        (*dominated)++;
+                    }
+                    // ltcs 1 is a subset of ltcs 2
+                    else if (a == 0 && b > 0)
+                    {
+                        BITSET(m_notAnLtcs, li);
+                        free(ltcs[li]);
+                        ltcs_memoryAdd(ctx, LTCS_MEMORY_FRONTIER, -set_bytes);
+                        (*dominated)++;
+                        lj = ltcs_count;
+                    }
+                }
+            }
+        }
+    }
+    return LTCS_OK;
+}
+
+/*
+ * calculate the cardinality of a LTCS
+ */
+static unsigned long getLtcsCardinality(const char* ltcs, unsigned long
+        efm_count)
+{
+    unsigned long res = 0;
+    unsigned long li;
+    for (li = 0; li < efm_count; li++) {
+        if (BITTEST(ltcs, li))
+        {
+            res++;
+        }
+    }
+    return(res);
+}
+
+/*
+ * thread function of the analysis
+ * for a block of reactions the share of EFMs of a LTCS using the reaction is
+ * calculated by popcounts of the LTCS and the column masks of the full matrix
+ * (negative if any EFM of the LTCS uses the reaction in negative direction)
+ */
+static void* analysisThread(void *pointer_analysis_args)
+{
+    struct analysis_args* args = (struct analysis_args*) pointer_analysis_args;
+    ltcs_context* ctx = args->ctx;
+    unsigned long result_count = ctx->result_count;
+    unsigned long bytes = ltcs_getBitsize(ctx->efm_count);
+    unsigned long chunk = result_count / args->max_threads + 1;
+    unsigned long first = args->thread_id * chunk;
+    unsigned long last = first + chunk < result_count ? first + chunk :
+        result_count;
+    unsigned long li;
+    unsigned int i;
+    for (li = first; li < last; li++) {
+        const char* ltcs = ctx->ltcs[ctx->result_index[li]];
+        double c = (double) args->cardinality[li];
+        for (i = 0; i < args->block_rx; i++) {
+            unsigned int rx = args->first_rx + i;
+            unsigned long pos = ltcs_bitsetAndCount(ltcs, args->pos_mask[rx],
+                    bytes);
+            unsigned long neg = ltcs_bitsetAndCount(ltcs, args->neg_mask[rx],
+                    bytes);
+            double val = c > 0 ? (double)(pos + neg) * 100 / c : 0;
+            args->values[i * result_count + li] = neg > 0 ? -val : val;
+        }
+    }
+    return((void*)NULL);
+}
+
+/*
+ * splits an ltcs into two ltcs based on positive and negative flux values in
+ * EFMs at given reaction index and appends them to the ltcs of the thread
+ */
+static int splitLtcs(struct thread_args* thread_args, const char* ltcs)
+{
+    unsigned long bitarray_size   = thread_args->bitarray_size;
+    unsigned long efm_count       = thread_args->efm_count;
+    unsigned int reaction         = thread_args->reaction;
+    char** matrix                 = thread_args->matrix;
+    unsigned long* t_ltcs_count   = thread_args->new_ltcs_count;
+
+    if (__atomic_load_n(thread_args->canceled, __ATOMIC_RELAXED))
+    {
+        return LTCS_ERROR_CANCELED;
+    }
+    ltcs_telemetryAdvance(thread_args->ctx, 1);
+    // sets taken from other nodes can exceed the share of the thread
+    if (t_ltcs_count[0] + 2 > thread_args->new_ltcs_size)
+    {
+        unsigned long size = 2 * thread_args->new_ltcs_size + 2;
+        char** t_ltcs = realloc(thread_args->new_ltcs, size * sizeof(char*));
+        if (NULL == t_ltcs)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        thread_args->new_ltcs = t_ltcs;
+        thread_args->new_ltcs_size = size;
+    }
+    char** t_ltcs = thread_args->new_ltcs;
+    unsigned long uj;
+    int pos = 0;
+    int neg = 0;
+    char *p_vect = (char *)calloc(1, bitarray_size);
+    char *n_vect = (char *)calloc(1, bitarray_size);
+    if (NULL == p_vect || NULL == n_vect)
+    {
+        free(p_vect);
+        free(n_vect);
+        return LTCS_ERROR_RAM;
+    }
+    ltcs_memoryAdd(thread_args->ctx, LTCS_MEMORY_FRONTIER, 2 * bitarray_size);
+    for (uj = 0; uj < efm_count; uj++) 
+    {
+        // if efm is in ltcs
+        if (BITTEST(ltcs,uj))
+        {
+            // efms with positive flux to new ltcs 1
+            if (BITTEST(matrix[uj],2*reaction))
+            {
+                BITSET(p_vect, uj);
+                pos = 1;
+            } 
+            // efms with negative flux to new ltcs 2
+            else if (BITTEST(matrix[uj], 2*reaction+1))
+            {
+                BITSET(n_vect, uj);
+                neg = 1;
+            } 
+            // efms with zero flux to both new ltcs
+            else
+            {
+                BITSET(p_vect, uj);
+                BITSET(n_vect, uj);
+            }
+        }
+    }
+    // create new ltcs 1 if EFMs with positive fluxes were found or
+    // if no EFM of the ltcs carries a flux at this reaction, else
+    // set memory free
+    if (pos > 0 || neg == 0)
+    {
+        t_ltcs[t_ltcs_count[0]] = p_vect;
+        t_ltcs_count[0]++;
+    }
+    else
+    {
+        free(p_vect);
+        ltcs_memoryAdd(thread_args->ctx, LTCS_MEMORY_FRONTIER, -(long) bitarray_size);
+    }
+    // create new ltcs 2 if EFMs with negative fluxes were found, else
+    // set memory free
+    if (neg > 0)
+    {
+        t_ltcs[t_ltcs_count[0]] = n_vect;
+        t_ltcs_count[0]++;
+    }
+    else
+    {
+        free(n_vect);
+        ltcs_memoryAdd(thread_args->ctx, LTCS_MEMORY_FRONTIER, -(long) bitarray_size);
+    }
+    return LTCS_OK;
+}
+
+/*
+ * thread function to find new ltcs
+ * without NUMA every thread splits every max_threads-th ltcs; with NUMA the
+ * thread is pinned to a cpu of its node, takes chunks of the ltcs created on
+ * its node and steals chunks of other nodes after its node is done
+ */
+static void* findLtcsThread(void *pointer_thread_args)
+{
+    // unpack given arguments
+    struct thread_args* thread_args = (struct thread_args*) pointer_thread_args;
+    int thread_id                 = thread_args->thread_id;
+    int max_threads               = thread_args->max_threads;
+    unsigned long ltcs_count      = thread_args->ltcs_count;
+    char** ltcs                   = thread_args->ltcs;
+    struct numa_shared* numa      = thread_args->numa;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    thread_args->new_ltcs_count[0] = 0;
+    unsigned long ui;
+    int rv = LTCS_OK;
+    if (NULL == numa)
+    {
+        for (ui = thread_id; ui < ltcs_count && rv == LTCS_OK; ui +=
+                max_threads) {
+            rv = splitLtcs(thread_args, ltcs[ui]);
+        }
+    }
+    else
+    {
+        ltcs_pinThread(thread_args->cpu);
+        int i;
+        for (i = 0; i < numa->node_count && rv == LTCS_OK; i++) {
+            int node = (thread_args->node + i) % numa->node_count;
+            unsigned long first;
+            while (rv == LTCS_OK && (first = __atomic_fetch_add(
+                            &numa->node_next[node], NUMA_CHUNK,
+                            __ATOMIC_RELAXED)) < numa->node_first[node + 1])
+            {
+                unsigned long last = first + NUMA_CHUNK <
+                    numa->node_first[node + 1] ? first + NUMA_CHUNK :
+                    numa->node_first[node + 1];
+                for (ui = first; ui < last && rv == LTCS_OK; ui++) {
+                    rv = splitLtcs(thread_args, ltcs[ui]);
+                }
+                if (i == 0)
+                {
+                    thread_args->local += last - first;
+                }
+                else
+                {
+                    thread_args->stolen += last - first;
+                }
+            }
+        }
+    }
+    thread_args->error = rv;
+    thread_args->busy = ltcs_getElapsedTime(&start);
+    return((void*)NULL);
+}
+
+/*
+ * predict the memory needed to split the frontier at a reaction; if it
+ * exceeds the memory limit, sets that are subsets of other sets are removed
+ * (their LTCS would be removed by filterLtcs anyway) and if it still exceeds
+ * the limit the calculation is stopped
+ */
+static int checkMemoryLimit(ltcs_context* ctx, char*** ltcs, unsigned long*
+        ltcs_count, unsigned long efm_count, unsigned int reaction, unsigned
+        int rx_count, char** pos_mask, char** neg_mask)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    unsigned long next = ltcs_predictFrontier(*ltcs, *ltcs_count,
+            pos_mask[reaction], neg_mask[reaction], bitarray_size);
+    // new sets and pointer arrays of threads and merged frontier
+    unsigned long needed = ltcsGetMemoryUsage(ctx, LTCS_MEMORY_ALL) + next *
+        ltcs_getSetBytes(efm_count) + 2 * *ltcs_count * sizeof(char*);
+    if (needed <= ctx->memory_limit)
+    {
+        return LTCS_OK;
+    }
+    ltcs_log(ctx, "iteration %u/%u: %lu ltcs need %.1f MB, memory limit "
+            "%.1f MB, removing subsets", reaction + 1, rx_count, next,
+            needed / 1048576.0, ctx->memory_limit / 1048576.0);
+    char* not_an_ltcs = NULL;
+    unsigned long duplicates, dominated;
+    int rv = filterLtcs(ctx, *ltcs, &not_an_ltcs, *ltcs_count, efm_count,
+            &duplicates, &dominated);
+    if (rv == LTCS_ERROR_CANCELED)
+    {
+        // sets marked in not_an_ltcs are already freed
+        unsigned long ul, kept = 0;
+        for (ul = 0; ul < *ltcs_count; ul++) {
+            if (!BITTEST(not_an_ltcs, ul))
+            {
+                (*ltcs)[kept++] = (*ltcs)[ul];
+            }
+        }
+        *ltcs_count = kept;
+        free(not_an_ltcs);
+        return ltcs_setError(ctx, rv, "calculation canceled\n");
+    }
+    else if (rv != LTCS_OK)
+    {
+        return ltcs_setError(ctx, rv, "Not enough free memory in filterLtcs\n");
+    }
+    unsigned long ul, kept = 0;
+    for (ul = 0; ul < *ltcs_count; ul++) {
+        if (!BITTEST(not_an_ltcs, ul))
+        {
+            (*ltcs)[kept++] = (*ltcs)[ul];
+        }
+    }
+    free(not_an_ltcs);
+    ltcs_memorySet(ctx, LTCS_MEMORY_FILTER, 0);
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, kept *
+            ltcs_getSetBytes(efm_count));
+    *ltcs_count = kept;
+    ltcs_telemetryProgress(ctx, reaction + 1, kept);
+    ctx->frontier = kept;
+
+    next = ltcs_predictFrontier(*ltcs, kept, pos_mask[reaction],
+            neg_mask[reaction], bitarray_size);
+    needed = ltcsGetMemoryUsage(ctx, LTCS_MEMORY_ALL) + next *
+        ltcs_getSetBytes(efm_count) + 2 * kept * sizeof(char*);
+    ltcs_log(ctx, "iteration %u/%u: %lu subsets removed, %lu ltcs need %.1f MB",
+            reaction + 1, rx_count, duplicates + dominated, next, needed /
+            1048576.0);
+    if (needed > ctx->memory_limit)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "memory limit of %.1f MB "
+                "exceeded: iteration %u/%u needs %.1f MB for %lu ltcs\n",
+                ctx->memory_limit / 1048576.0, reaction + 1, rx_count, needed /
+                1048576.0, next);
+    }
+    return LTCS_OK;
+}
+
+/*
+ * find ltcs
+ * for each reaction start threads to find new ltcs
+ * merge ltcs found by threads to new set of ltcs until all reactions are
+ * processed
+ */
+static int findLtcs(ltcs_context* ctx, unsigned int rx_count, unsigned long
+        efm_count, char **mat, char* loops, char ***ltcs, unsigned long
+        *ltcs_count, int max_threads)
+{
+    unsigned int i;
+    unsigned long ui;
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    // initialize ltcs with 1 ltcs containing all EFMs that are not internal
+    // loops
+    unsigned long m_ltcs_count = 1;
+    char **m_ltcs = (char**) calloc(1, sizeof(char*));
+    if (NULL == m_ltcs)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in findLtcs\n");
+    }
+    m_ltcs[0] = calloc(1, bitarray_size + 1);
+    if (NULL == m_ltcs[0])
+    {
+        free(m_ltcs);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in findLtcs\n");
+    }
+    for (ui = 0; ui < efm_count; ui++) {
+        if (!BITTEST(loops, ui))
+        {
+            BITSET(m_ltcs[0], ui);
+        }
+    }
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, ltcs_getSetBytes(efm_count) + 1);
+    double* busy = calloc(2 * max_threads, sizeof(double));
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    if (NULL == busy || (ctx->memory_limit > 0 && ltcs_getColumnMasks(mat,
+                    efm_count, rx_count, loops, &pos_mask, &neg_mask) !=
+                LTCS_OK))
+    {
+        free(busy);
+        free(m_ltcs[0]);
+        free(m_ltcs);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in findLtcs\n");
+    }
+    unsigned long mask_bytes = NULL != pos_mask ? 2 * rx_count *
+        bitarray_size : 0;
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, mask_bytes);
+    double* iteration_busy = busy + max_threads;
+    struct numa_shared numa_shared;
+    struct numa_shared* numa = NULL;
+    if (ctx->numa > 0)
+    {
+        if (ltcs_startNuma(ctx, &numa_shared, mat, efm_count, rx_count, loops)
+                != LTCS_OK)
+        {
+            free(busy);
+            free(m_ltcs[0]);
+            free(m_ltcs);
+            ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+            ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -mask_bytes);
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory in findLtcs\n");
+        }
+        numa = &numa_shared;
+    }
+    int sharded = 0;
+    ltcs_telemetryBegin(ctx, "split");
+    ctx->iterations = rx_count;
+    ctx->frontier = m_ltcs_count;
+
+    // process each single reaction
+    for (i = 0; i < rx_count; i++) 
+    {
+        ltcs_telemetryProgress(ctx, i + 1, m_ltcs_count);
+        if (ctx->shard_count > 1 && !sharded && m_ltcs_count >= SHARD_FACTOR *
+                ctx->shard_count)
+        {
+            ltcs_selectShard(ctx, m_ltcs, &m_ltcs_count, efm_count, i);
+            sharded = 1;
+            if (0 == m_ltcs_count)
+            {
+                break;
+            }
+        }
+        if (ctx->memory_limit > 0)
+        {
+            int rv = checkMemoryLimit(ctx, &m_ltcs, &m_ltcs_count, efm_count,
+                    i, rx_count, pos_mask, neg_mask);
+            if (rv != LTCS_OK)
+            {
+                for (ui = 0; ui < m_ltcs_count; ui++) {
+                    free(m_ltcs[ui]);
+                }
+                free(m_ltcs);
+                free(busy);
+                ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+                ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -mask_bytes);
+                ltcs_stopNuma(ctx, numa, efm_count);
+                return rv;
+            }
+        }
+        if (NULL != numa && numa->node_first[numa->node_count] != m_ltcs_count)
+        {
+            // removed subsets or sets of other shards moved the sets, all
+            // sets are taken as sets of the first node
+            int n;
+            for (n = 1; n <= numa->node_count; n++) {
+                numa->node_first[n] = m_ltcs_count;
+            }
+        }
+        // prepare threads
+        int num_threads = (m_ltcs_count > max_threads) ? max_threads : m_ltcs_count;
+        pthread_t thread[num_threads];
+        struct thread_args thread_args[num_threads];
+        int ti;
+        int error = LTCS_OK;
+        for (ti = 0; ti < num_threads; ti++) {
+            thread_args[ti].thread_id = ti;
+            thread_args[ti].max_threads = num_threads;
+            thread_args[ti].bitarray_size = bitarray_size;
+            thread_args[ti].ltcs_count = m_ltcs_count;
+            thread_args[ti].efm_count = efm_count;
+            thread_args[ti].reaction = i;
+            thread_args[ti].ltcs = m_ltcs;
+            thread_args[ti].matrix = mat;
+            thread_args[ti].error = LTCS_OK;
+            thread_args[ti].canceled = &ctx->canceled;
+            thread_args[ti].ctx = ctx;
+            thread_args[ti].busy = 0;
+            thread_args[ti].numa = NULL;
+            thread_args[ti].local = 0;
+            thread_args[ti].stolen = 0;
+            if (NULL != numa)
+            {
+                ltcs_assignNumaThread(numa, &thread_args[ti], ti, num_threads);
+            }
+            thread_args[ti].new_ltcs_count = calloc(1, sizeof(unsigned long));
+            unsigned long size = m_ltcs_count * 2 / num_threads + num_threads;
+            char** new_ltcs = (char**) calloc(size, sizeof(char*));
+            thread_args[ti].new_ltcs = new_ltcs;
+            thread_args[ti].new_ltcs_size = size;
+            if (NULL == new_ltcs || NULL == thread_args[ti].new_ltcs_count)
+            {
+                error = LTCS_ERROR_RAM;
+            }
+        }
+
+        // start threads
+        if (NULL != numa)
+        {
+            memcpy(numa->node_next, numa->node_first, numa->node_count *
+                    sizeof(unsigned long));
+        }
+        if (error == LTCS_OK)
+        {
+            for (ti = 0; ti < num_threads; ti++) {
+                pthread_create(&thread[ti], NULL, findLtcsThread,
+                        (void*)&thread_args[ti]);
+            }
+        }
+
+        // join threads
+        unsigned long new_ltcs_count = 0;
+        memset(iteration_busy, 0, max_threads * sizeof(double));
+        for (ti = 0; ti < num_threads && error == LTCS_OK; ti++) {
+            pthread_join(thread[ti], NULL);
+            new_ltcs_count += *thread_args[ti].new_ltcs_count;
+            iteration_busy[ti] = thread_args[ti].busy;
+            busy[ti] += thread_args[ti].busy;
+        }
+        for (ti = 0; ti < num_threads && error == LTCS_OK; ti++) {
+            error = thread_args[ti].error;
+        }
+        if (error == LTCS_OK && ltcs_isCanceled(ctx))
+        {
+            error = LTCS_ERROR_CANCELED;
+        }
+
+        // prepare memory for new ltcs sets
+        for (ui = 0; ui < m_ltcs_count; ui++) {
+            free(m_ltcs[ui]);
+        }
+        free(m_ltcs);
+        m_ltcs = NULL;
+        if (error == LTCS_OK)
+        {
+            m_ltcs = calloc(new_ltcs_count, sizeof(char*));
+            if (NULL == m_ltcs)
+            {
+                error = LTCS_ERROR_RAM;
+            }
+        }
+        unsigned long index = 0;
+        unsigned long tj;
+        // merge ltcs found by threads to new set; with NUMA the threads of a
+        // node are consecutive and so are the ltcs created on a node
+        if (NULL != numa)
+        {
+            memset(numa->node_first, 0, (numa->node_count + 1) *
+                    sizeof(unsigned long));
+        }
+        for (ti = 0; ti < num_threads; ti++) {
+            if (NULL != thread_args[ti].new_ltcs_count)
+            {
+                for (tj = 0; tj < *thread_args[ti].new_ltcs_count; tj++) {
+                    if (error == LTCS_OK)
+                    {
+                        m_ltcs[index] = thread_args[ti].new_ltcs[tj];
+                        index++;
+                    }
+                    else
+                    {
+                        free(thread_args[ti].new_ltcs[tj]);
+                    }
+                }
+            }
+            free(thread_args[ti].new_ltcs);
+            free(thread_args[ti].new_ltcs_count);
+            if (NULL != numa)
+            {
+                numa->node_first[thread_args[ti].node + 1] = index;
+                numa->local += thread_args[ti].local;
+                numa->stolen += thread_args[ti].stolen;
+            }
+        }
+        if (NULL != numa)
+        {
+            int n;
+            for (n = 1; n <= numa->node_count; n++) {
+                if (numa->node_first[n] < numa->node_first[n - 1])
+                {
+                    numa->node_first[n] = numa->node_first[n - 1];
+                }
+            }
+        }
+        if (error != LTCS_OK)
+        {
+            free(m_ltcs);
+            free(busy);
+            ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+            ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -mask_bytes);
+            ltcs_stopNuma(ctx, numa, efm_count);
+        }
+        if (error == LTCS_ERROR_CANCELED)
+        {
+            return ltcs_setError(ctx, error, "calculation canceled\n");
+        }
+        else if (error != LTCS_OK)
+        {
+            return ltcs_setError(ctx, error,
+                    "Not enough free memory in findLtcs\n");
+        }
+        m_ltcs_count = new_ltcs_count;
+        ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, m_ltcs_count *
+                ltcs_getSetBytes(efm_count));
+        ltcs_log(ctx, "iteration %d/%d: %lu ltcs", i+1, rx_count, m_ltcs_count);
+        ltcs_telemetryIteration(ctx, i + 1, rx_count, m_ltcs_count,
+                ltcs_getElapsedTime(&ctx->iteration_start), iteration_busy,
+                max_threads);
+    }
+    if (ctx->shard_count > 1 && !sharded)
+    {
+        ltcs_selectShard(ctx, m_ltcs, &m_ltcs_count, efm_count, rx_count);
+    }
+    *ltcs = m_ltcs;
+    *ltcs_count = m_ltcs_count;
+
+    // busy time of every thread over all iterations
+    char busy_list[ERROR_SIZE];
+    int len = 0;
+    int ti;
+    for (ti = 0; ti < max_threads && len < ERROR_SIZE - 32; ti++) {
+        len += sprintf(busy_list + len, "%s%.6f", ti > 0 ? "," : "", busy[ti]);
+    }
+    busy_list[len] = '\0';
+    ltcs_telemetryEnd(ctx, "\"frontier\":%lu,\"threads\":%d,\"busy\":[%s]",
+            m_ltcs_count, max_threads, busy_list);
+    free(busy);
+    ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -mask_bytes);
+    ltcs_stopNuma(ctx, numa, efm_count);
+    return LTCS_OK;
+}
+
+/*
+ * calculate all LTCS of the loaded EFMs
+ * unless LTCS_COMPUTE_NO_FILTER is given, subsets are removed afterwards;
+ * LTCS_COMPUTE_GENERIC uses the generic kernel also for up to 512 EFMs
+ */
+int ltcsCompute(ltcs_context* ctx, int threads, unsigned int options)
+{
+    if (NULL == ctx->matrix)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "no EFMs loaded\n");
+    }
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    ltcs_freeResults(ctx);
+    // up to 512 EFMs the kernels for fixed-width sets are used, they filter
+    // the sets themselves
+    int words = ltcs_getFixedWords(ctx, options);
+    int rv;
+    if (words > 0)
+    {
+        rv = ltcs_computeFixed(ctx, words, threads, options);
+    }
+    else
+    {
+        rv = findLtcs(ctx, ctx->clean_rx_count, ctx->efm_count, ctx->matrix,
+                ctx->loops, &ctx->ltcs, &ctx->ltcs_count, threads);
+    }
+    if (rv == LTCS_ERROR_CANCELED)
+    {
+        // a canceled context can be used again
+        __atomic_store_n(&ctx->canceled, 0, __ATOMIC_RELAXED);
+    }
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    if (0 == words && ctx->ltcs_count > 0 && !(options &
+                LTCS_COMPUTE_NO_FILTER))
+    {
+        ltcs_log(ctx, "filter LTCS to remove subsets");
+        ltcs_telemetryBegin(ctx, "filter");
+        ctx->frontier = ctx->ltcs_count;
+        unsigned long duplicates = 0;
+        unsigned long dominated = 0;
+        rv = filterLtcs(ctx, ctx->ltcs, &ctx->not_an_ltcs, ctx->ltcs_count,
+                ctx->efm_count, &duplicates, &dominated);
+        if (rv == LTCS_ERROR_CANCELED)
+        {
+            __atomic_store_n(&ctx->canceled, 0, __ATOMIC_RELAXED);
+            return ltcs_setError(ctx, rv, "calculation canceled\n");
+        }
+        else if (rv != LTCS_OK)
+        {
+            return ltcs_setError(ctx, rv,
+                    "Not enough free memory in filterLtcs\n");
+        }
+        ltcs_telemetryEnd(ctx, "\"candidates\":%lu,\"duplicates\":%lu,"
+                "\"dominated\":%lu,\"results\":%lu", ctx->ltcs_count,
+                duplicates, dominated, ctx->ltcs_count - duplicates -
+                dominated);
+    }
+
+    // index of results that are not subsets of other results
+    ctx->result_index = calloc(ctx->ltcs_count + 1, sizeof(unsigned long));
+    if (NULL == ctx->result_index)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    ltcs_memorySet(ctx, LTCS_MEMORY_OUTPUT, (ctx->ltcs_count + 1) *
+                sizeof(unsigned long));
+    unsigned long li;
+    for (li = 0; li < ctx->ltcs_count; li++) {
+        if (NULL == ctx->not_an_ltcs || !BITTEST(ctx->not_an_ltcs, li))
+        {
+            ctx->result_index[ctx->result_count] = li;
+            ctx->result_count++;
+        }
+    }
+    return LTCS_OK;
+}
+
+unsigned long ltcsGetResultCount(ltcs_context* ctx)
+{
+    return ctx->result_count;
+}
+
+const char* ltcsGetResult(ltcs_context* ctx, unsigned long index)
+{
+    if (index >= ctx->result_count)
+    {
+        return NULL;
+    }
+    return ctx->ltcs[ctx->result_index[index]];
+}
+
+unsigned long ltcsGetResultCardinality(ltcs_context* ctx, unsigned long index)
+{
+    if (index >= ctx->result_count)
+    {
+        return 0;
+    }
+    return getLtcsCardinality(ctx->ltcs[ctx->result_index[index]],
+            ctx->efm_count);
+}
+
+/*
+ * hand every LTCS to callback until it returns non-zero
+ */
+int ltcsForEachResult(ltcs_context* ctx, ltcs_result_callback callback, void*
+        user_data)
+{
+    unsigned long li;
+    for (li = 0; li < ctx->result_count; li++) {
+        if (callback(ctx->ltcs[ctx->result_index[li]], ctx->efm_count,
+                    user_data))
+        {
+            break;
+        }
+    }
+    return LTCS_OK;
+}
+
+/*
+ * print a single ltcs to file
+ */
+static void printLtcs(FILE* file, const char* ltcs, unsigned long efm_count, int csv_out)
+{
+    unsigned long ul;
+    for (ul = 0; ul < efm_count; ul++) {
+        if (ul > 0 && csv_out > 0)
+        {
+            fprintf(file, ",");
+        }
+        if (BITTEST(ltcs,ul))
+        {
+            fprintf(file, "1");
+        }
+        else
+        {
+            fprintf(file, "0");
+        }
+    }
+    fprintf(file, "\n");
+}
+
+void ltcsWriteSet(FILE* file, const char* set, unsigned long efm_count, int
+        csv)
+{
+    printLtcs(file, set, efm_count, csv);
+}
+
+int ltcsWriteResults(ltcs_context* ctx, FILE* file, int csv)
+{
+    unsigned long li;
+    ltcs_telemetryBegin(ctx, "write");
+    ctx->frontier = ctx->result_count;
+    ltcs_telemetryProgress(ctx, 1, ctx->result_count);
+    for (li = 0; li < ctx->result_count; li++) {
+        printLtcs(file, ctx->ltcs[ctx->result_index[li]], ctx->efm_count, csv);
+        ltcs_telemetryAdvance(ctx, 1);
+    }
+    ltcs_telemetryEnd(ctx, "\"ltcs\":%lu", ctx->result_count);
+    return ferror(file) ? ltcs_setError(ctx, LTCS_ERROR_FILE,
+            "Error in writing output file\n") : LTCS_OK;
+}
+
+/*
+ * print loop vector to file (without newline)
+ */
+int ltcsWriteLoops(ltcs_context* ctx, FILE* file, int csv)
+{
+    unsigned long ul;
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (ul > 0 && csv > 0)
+        {
+            fprintf(file, ",");
+        }
+        if (BITTEST(ctx->loops, ul))
+        {
+            fprintf(file, "1");
+        }
+        else
+        {
+            fprintf(file, "0");
+        }
+    }
+    return ferror(file) ? ltcs_setError(ctx, LTCS_ERROR_FILE,
+            "Error in writing loop outputfile\n") : LTCS_OK;
+}
+
+/*
+ * print percentage of EFMs of every LTCS using a reaction (negative if a
+ * reaction is used in backward direction)
+ * needs reaction names and the full matrix (see ltcsSetKeepFullMatrix)
+ */
+int ltcsWriteAnalysis(ltcs_context* ctx, FILE* file, int threads)
+{
+    if (NULL == ctx->full_mat || NULL == ctx->reaction_names)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "analysis needs reaction "
+                "names and full matrix\n");
+    }
+    ltcs_telemetryBegin(ctx, "analysis");
+    ctx->frontier = ctx->result_count;
+    unsigned long result_count = ctx->result_count;
+    unsigned int rx_count = ctx->rx_count;
+    unsigned int block_size = rx_count < ANALYSIS_BLOCK ? rx_count :
+        ANALYSIS_BLOCK;
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    unsigned long* cardinality = calloc(result_count + 1, sizeof(unsigned long));
+    double* values = calloc((unsigned long) block_size * result_count + 1,
+            sizeof(double));
+    if (NULL == cardinality || NULL == values ||
+                ltcs_getColumnMasks(ctx->full_mat, ctx->efm_count, rx_count,
+                ctx->loops, &pos_mask, &neg_mask) != LTCS_OK)
+    {
+        free(cardinality);
+        free(values);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in ltcsWriteAnalysis\n");
+    }
+    long buffer_bytes = (result_count + 1) * sizeof(unsigned long) +
+        ((unsigned long) block_size * result_count + 1) * sizeof(double) + 2 *
+        rx_count * ltcs_getBitsize(ctx->efm_count);
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_OUTPUT, buffer_bytes);
+    unsigned long li;
+    for (li = 0; li < result_count; li++) {
+        cardinality[li] = ltcs_bitsetCount(ctx->ltcs[ctx->result_index[li]],
+                ltcs_getBitsize(ctx->efm_count));
+    }
+
+    // calculate blocks of reactions in parallel and write their rows
+    int num_threads = threads < 1 ? 1 : threads;
+    pthread_t thread[num_threads];
+    struct analysis_args analysis_args[num_threads];
+    unsigned int first_rx, i;
+    int ti;
+    ltcs_telemetryProgress(ctx, 1, rx_count);
+    for (first_rx = 0; first_rx < rx_count; first_rx += block_size) {
+        unsigned int block_rx = first_rx + block_size < rx_count ? block_size :
+            rx_count - first_rx;
+        for (ti = 0; ti < num_threads; ti++) {
+            analysis_args[ti].thread_id = ti;
+            analysis_args[ti].max_threads = num_threads;
+            analysis_args[ti].ctx = ctx;
+            analysis_args[ti].pos_mask = pos_mask;
+            analysis_args[ti].neg_mask = neg_mask;
+            analysis_args[ti].cardinality = cardinality;
+            analysis_args[ti].first_rx = first_rx;
+            analysis_args[ti].block_rx = block_rx;
+            analysis_args[ti].values = values;
+            pthread_create(&thread[ti], NULL, analysisThread,
+                    (void*)&analysis_args[ti]);
+        }
+        for (ti = 0; ti < num_threads; ti++) {
+            pthread_join(thread[ti], NULL);
+        }
+        for (i = 0; i < block_rx; i++) {
+            fprintf(file, "%s", ctx->reaction_names[first_rx + i]);
+            for (li = 0; li < result_count; li++) {
+                fprintf(file, ",%.2f", values[i * result_count + li]);
+            }
+            fprintf(file, "\n");
+        }
+        ltcs_telemetryAdvance(ctx, block_rx);
+    }
+    ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+    free(cardinality);
+    free(values);
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_OUTPUT, -buffer_bytes);
+    ltcs_telemetryEnd(ctx, "\"reactions\":%u,\"ltcs\":%lu", rx_count,
+            result_count);
+    return ferror(file) ? ltcs_setError(ctx, LTCS_ERROR_FILE,
+            "Error in writing analysis file\n") : LTCS_OK;
+}
+
+/*
+ * build column masks of the cleaned matrix
+ * for every reaction one bitset over all EFMs with a positive flux and one
+ * bitset over all EFMs with a negative flux is created
+ */
+int ltcs_getColumnMasks(char** mat, unsigned long efm_count, unsigned int
+        rx_count, char* loops, char*** pos_mask, char*** neg_mask)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    char** m_pos = calloc(rx_count + 1, sizeof(char*));
+    char** m_neg = calloc(rx_count + 1, sizeof(char*));
+    if (NULL == m_pos || NULL == m_neg)
+    {
+        free(m_pos);
+        free(m_neg);
+        return LTCS_ERROR_RAM;
+    }
+    unsigned int i;
+    unsigned long ul;
+    for (i = 0; i < rx_count; i++) {
+        m_pos[i] = calloc(1, bitarray_size);
+        m_neg[i] = calloc(1, bitarray_size);
+        if (NULL == m_pos[i] || NULL == m_neg[i])
+        {
+            ltcs_freeColumnMasks(m_pos, m_neg, i + 1);
+            return LTCS_ERROR_RAM;
+        }
+    }
+    for (ul = 0; ul < efm_count; ul++) {
+        if (!BITTEST(loops, ul))
+        {
+            for (i = 0; i < rx_count; i++) {
+                if (BITTEST(mat[ul], 2*i))
+                {
+                    BITSET(m_pos[i], ul);
+                }
+                else if (BITTEST(mat[ul], 2*i+1))
+                {
+                    BITSET(m_neg[i], ul);
+                }
+            }
+        }
+    }
+    *pos_mask = m_pos;
+    *neg_mask = m_neg;
+    return LTCS_OK;
+}
+
+/*
+ * set column masks memory free
+ */
+void ltcs_freeColumnMasks(char** pos_mask, char** neg_mask, unsigned int
+        rx_count)
+{
+    if (NULL == pos_mask)
+    {
+        return;
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        free(pos_mask[i]);
+        free(neg_mask[i]);
+    }
+    free(pos_mask);
+    free(neg_mask);
+}
+
+/*
+ * a set of EFMs is consistent if no reaction is used in both directions
+ */
+int ltcs_isConsistentSet(const char* set, char** pos_mask, char** neg_mask,
+        unsigned int rx_count, unsigned long bitarray_size)
+{
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        if (ltcs_bitsetIntersects(set, pos_mask[i], bitarray_size) &&
+                ltcs_bitsetIntersects(set, neg_mask[i], bitarray_size))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * define all EFMs that cannot be added to a set because they use a reaction
+ * in the opposite direction as an EFM of the set
+ */
+void ltcs_getForbiddenEfms(const char* set, char* forbidden, char** pos_mask,
+        char** neg_mask, unsigned int rx_count, unsigned long bitarray_size)
+{
+    unsigned int i;
+    memset(forbidden, 0, bitarray_size);
+    for (i = 0; i < rx_count; i++) {
+        if (ltcs_bitsetIntersects(set, pos_mask[i], bitarray_size))
+        {
+            ltcs_bitsetOr(forbidden, neg_mask[i], bitarray_size);
+        }
+        else if (ltcs_bitsetIntersects(set, neg_mask[i], bitarray_size))
+        {
+            ltcs_bitsetOr(forbidden, pos_mask[i], bitarray_size);
+        }
+    }
+}
+
+/*
+ * a consistent set is maximal if every EFM that is neither an internal loop
+ * nor part of the set conflicts with the set
+ * forbidden is used as buffer and has to be of size ltcs_getBitsize(efm_count)
+ */
+int ltcs_isMaximalSet(const char* set, char* forbidden, char* loops, char**
+        pos_mask, char** neg_mask, unsigned int rx_count, unsigned long
+        efm_count)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    ltcs_getForbiddenEfms(set, forbidden, pos_mask, neg_mask, rx_count,
+            bitarray_size);
+    unsigned long ul;
+    for (ul = 0; ul < efm_count; ul++) {
+        if (!BITTEST(loops, ul) && !BITTEST(set, ul) && !BITTEST(forbidden, ul))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * return seconds since start
+ */
+double ltcs_getElapsedTime(struct timespec* start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
@@ -0,0 +1,538 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+
+#define MAX_ARGS       12
+#define ARG_INPUT      0
+#define ARG_SHARDS     1
+#define ARG_LTCS_OUT   2
+#define ARG_SFILE      3
+#define ARG_RVFILE     4
+#define ARG_LOOPS      5
+#define ARG_ZERO       6
+#define ARG_THREADS    7
+#define ARG_CSV_OUT    8
+#define ARG_DIR        9
+#define ARG_TEMPLATE   10
+#define ARG_MERGE      11
+
+struct command
+{
+    char* text;
+    size_t length;
+    size_t size;
+};
+
+/*
+ * print progress messages of libltcs with time stamp
+ */
+void printLog(const char* message, void* user_data)
+{
+    char time_string[TIME_STRING_SIZE];
+    printf("%s %s\n", getTime(time_string), message);
+    fflush(stdout);
+}
+
+/*
+ * quit with the error message of libltcs if a call failed
+ */
+void checkLtcs(ltcs_context* ctx, int rv)
+{
+    if (rv != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
+    }
+}
+
+/*
+ * append text to a command
+ */
+void appendText(struct command* cmd, const char* text, size_t length)
+{
+    if (cmd->length + length + 1 > cmd->size)
+    {
+        cmd->size = 2 * (cmd->length + length + 1);
+        cmd->text = realloc(cmd->text, cmd->size);
+        if (NULL == cmd->text)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    memcpy(cmd->text + cmd->length, text, length);
+    cmd->length += length;
+    cmd->text[cmd->length] = '\0';
+}
+
+/*
+ * append an argument to a shell command, quoted if it contains characters
+ * the shell would interpret
+ */
+void appendArg(struct command* cmd, const char* arg)
+{
+    if (cmd->length > 0)
+    {
+        appendText(cmd, " ", 1);
+    }
+    if (*arg != '\0' && strspn(arg, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN"
+                "OPQRSTUVWXYZ0123456789_./:=,+-") == strlen(arg))
+    {
+        appendText(cmd, arg, strlen(arg));
+        return;
+    }
+    appendText(cmd, "'", 1);
+    const char* c;
+    for (c = arg; *c != '\0'; c++) {
+        if (*c == '\'')
+        {
+            appendText(cmd, "'\\''", 4);
+        }
+        else
+        {
+            appendText(cmd, c, 1);
+        }
+    }
+    appendText(cmd, "'", 1);
+}
+
+/*
+ * replace {cmd} of the template by the command and {i} by the shard
+ */
+char* applyTemplate(const char* template, const char* command, unsigned int
+        shard)
+{
+    struct command cmd = {NULL, 0, 0};
+    char number[16];
+    sprintf(number, "%u", shard);
+    appendText(&cmd, "", 0);
+    const char* c = template;
+    while (*c != '\0')
+    {
+        if (!strncmp(c, "{cmd}", 5))
+        {
+            appendText(&cmd, command, strlen(command));
+            c += 5;
+        }
+        else if (!strncmp(c, "{i}", 3))
+        {
+            appendText(&cmd, number, strlen(number));
+            c += 3;
+        }
+        else
+        {
+            appendText(&cmd, c, 1);
+            c++;
+        }
+    }
+    return cmd.text;
+}
+
+/*
+ * run a command by the shell with stdout and stderr written to logfile
+ */
+pid_t launch(const char* command, const char* logfile)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int fd = open(logfile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execl("/bin/sh", "sh", "-c", command, (char*) NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+/*
+ * wait for the commands of all shards, quit if one of them failed
+ */
+void waitShards(pid_t* pids, unsigned int shards, const char* dir, const
+        char* step)
+{
+    unsigned int i;
+    int failed = 0;
+    for (i = 0; i < shards; i++) {
+        int status;
+        if (pids[i] < 0 || waitpid(pids[i], &status, 0) < 0 ||
+                !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "%s of shard %u failed, see %s/%s%u.log\n", step,
+                    i + 1, dir, step, i + 1);
+            failed = 1;
+        }
+    }
+    if (failed > 0)
+    {
+        quitError("Error in shard calculation\n", LTCS_ERROR_ARGS);
+    }
+}
+
+/*
+ * path of a program in the directory of this program
+ */
+char* getProgram(const char* self, const char* name)
+{
+    const char* slash = strrchr(self, '/');
+    if (NULL == slash)
+    {
+        return strdup(name);
+    }
+    char* dir = slash > self ? strndup(self, slash - self) : strdup("/");
+    char* path = malloc(PATH_MAX + strlen(name) + 2);
+    if (NULL == dir || NULL == path)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    if (NULL == realpath(dir, path))
+    {
+        strcpy(path, dir);
+    }
+    free(dir);
+    if (strcmp(path, "/"))
+    {
+        strcat(path, "/");
+    }
+    strcat(path, name);
+    return path;
+}
+
+/*
+ * append the contents of file to out, return number of lines
+ */
+unsigned long appendFile(FILE* out, const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        quitError("Error in opening shard output\n", LTCS_ERROR_FILE);
+    }
+    char buffer[65536];
+    size_t length;
+    unsigned long lines = 0;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        size_t l;
+        for (l = 0; l < length; l++) {
+            if (buffer[l] == '\n')
+            {
+                lines++;
+            }
+        }
+        fwrite(buffer, 1, length, out);
+    }
+    fclose(file);
+    return lines;
+}
+
+/*
+ * merge step: remove LTCS of a shard that are not maximal with respect to
+ * the LTCS of all other shards
+ */
+int mergeShard(unsigned int shard, unsigned int shards, const char* dir,
+        const char* ltcsout, int csv_out)
+{
+    char time_string[TIME_STRING_SIZE];
+    char* filenames[shards];
+    unsigned int i;
+    for (i = 0; i < shards; i++) {
+        filenames[i] = malloc(strlen(dir) + 32);
+        if (NULL == filenames[i])
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+        sprintf(filenames[i], "%s/shard%u.bin", dir, i + 1);
+    }
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, printLog, NULL);
+    checkLtcs(ctx, ltcsMergeShard(ctx, (const char* const*) filenames,
+                shards, shard - 1));
+    FILE* fileout = fopen(ltcsout, "w");
+    if (!fileout)
+    {
+        quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+    }
+    checkLtcs(ctx, ltcsWriteResults(ctx, fileout, csv_out));
+    fclose(fileout);
+    printf("%s merged shard %u/%u: %lu LTCS\n", getTime(time_string), shard, shards,
+            ltcsGetResultCount(ctx));
+    ltcsFreeContext(ctx);
+    for (i = 0; i < shards; i++) {
+        free(filenames[i]);
+    }
+    return EXIT_SUCCESS;
+}
+
+/*
+ * calculate LTCS in shards: every shard is calculated by its own calcLtcs
+ * process, then every shard removes its LTCS that are subsets of LTCS of
+ * other shards and the remaining LTCS of all shards are concatenated
+ */
+int main (int argc, char *argv[])
+{
+    char time_string[TIME_STRING_SIZE];
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-i", "-n", "-o", "-s", "-v", "-l", "-z", "-t", "-c", "-d", "-x", "-m" };
+    char *optd[MAX_ARGS] = {"efm file (text or binary, see calcLtcs)",
+                            "number of shards",
+                            "output file [default: ltcs.out]",
+                            "stoichiometric matrix file [optional, needed to find internal loops]",
+                            "reversibility file [optional, but saves memory!]",
+                            "loops output [only if stoichiometric matrix is given, default: loops.out]",
+                            "zero threshold [default: 1e-10]",
+                            "number of threads of every shard [default: 1]",
+                            "print ltcs in csv format [yes/no; default: yes]",
+                            "working directory for shard files and logs [default: ltcs_shards]; has to be shared by all hosts",
+                            "command template [default: {cmd}] {cmd} is replaced by the command of a shard and {i} by its number, e.g. \"ssh node{i} {cmd}\"",
+                            "merge step of shard [internal; e.g. 2] run by the template"};
+    char *optr[MAX_ARGS];
+    char *description = "Calculate largest thermodynamically consistent sets of "
+        "EFMs\nwith several calcLtcs processes (shards) and merge their results";
+    char *usg = "\n   ltcsCoordinator -i efms.txt -n 4 -o ltcs.out -t 2\n   ltcsCoordinator -i efms.txt -n 8 -o ltcs.out -s sfile -d /shared/shards -x \"ssh node{i} {cmd}\"";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if (!optr[ARG_SHARDS] || (!optr[ARG_INPUT] && !optr[ARG_MERGE]))
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    int shards = atoi(optr[ARG_SHARDS]);
+    if (shards < 1)
+    {
+        quitError("number of shards must be greater than 0\n", LTCS_ERROR_ARGS);
+    }
+    char* ltcsout = optr[ARG_LTCS_OUT] ? optr[ARG_LTCS_OUT] : "ltcs.out";
+    char* loopout = optr[ARG_LOOPS] ? optr[ARG_LOOPS] : "loops.out";
+    char* dir = optr[ARG_DIR] ? optr[ARG_DIR] : "ltcs_shards";
+    char* template = optr[ARG_TEMPLATE] ? optr[ARG_TEMPLATE] : "{cmd}";
+    char* csv = optr[ARG_CSV_OUT] ? optr[ARG_CSV_OUT] : "yes";
+    int csv_out = !strcmp(csv, "no") ? 0 : 1;
+    if (optr[ARG_MERGE])
+    {
+        int shard = atoi(optr[ARG_MERGE]);
+        if (shard < 1 || shard > shards)
+        {
+            quitError("merge shard must be between 1 and the number of shards\n", LTCS_ERROR_ARGS);
+        }
+        return mergeShard(shard, shards, dir, ltcsout, csv_out);
+    }
+    if (mkdir(dir, 0755) != 0 && access(dir, W_OK) != 0)
+    {
+        quitError("Error in creating working directory\n", LTCS_ERROR_FILE);
+    }
+    char* calc = getProgram(argv[0], "calcLtcs");
+    char* self = getProgram(argv[0], "ltcsCoordinator");
+    // end read arguments
+    //================================================== 
+
+    printf("Start: %s\n", getTime(time_string));
+    printf("\n");
+    printf("Input:            %s\n", optr[ARG_INPUT]);
+    printf("Output:           %s\n", ltcsout);
+    printf("Shards:           %d\n", shards);
+    printf("Directory:        %s\n", dir);
+    printf("Template:         %s\n", template);
+    printf("\n");
+    fflush(stdout);
+
+    //================================================== 
+    // calculate shards
+    pid_t pids[shards];
+    char filename[strlen(dir) + 32];
+    char shard_arg[32];
+    int i;
+    for (i = 0; i < shards; i++) {
+        struct command cmd = {NULL, 0, 0};
+        appendArg(&cmd, calc);
+        appendArg(&cmd, "-i");
+        appendArg(&cmd, optr[ARG_INPUT]);
+        sprintf(filename, "%s/shard%d.bin", dir, i + 1);
+        appendArg(&cmd, "-o");
+        appendArg(&cmd, filename);
+        sprintf(shard_arg, "%d/%d", i + 1, shards);
+        appendArg(&cmd, "--shard");
+        appendArg(&cmd, shard_arg);
+        if (optr[ARG_SFILE])
+        {
+            appendArg(&cmd, "-s");
+            appendArg(&cmd, optr[ARG_SFILE]);
+            sprintf(filename, "%s/loops%d.out", dir, i + 1);
+            appendArg(&cmd, "-l");
+            appendArg(&cmd, filename);
+            appendArg(&cmd, "-c");
+            appendArg(&cmd, csv);
+        }
+        if (optr[ARG_RVFILE])
+        {
+            appendArg(&cmd, "-v");
+            appendArg(&cmd, optr[ARG_RVFILE]);
+        }
+        if (optr[ARG_ZERO])
+        {
+            appendArg(&cmd, "-z");
+            appendArg(&cmd, optr[ARG_ZERO]);
+        }
+        if (optr[ARG_THREADS])
+        {
+            appendArg(&cmd, "-t");
+            appendArg(&cmd, optr[ARG_THREADS]);
+        }
+        char* command = applyTemplate(template, cmd.text, i + 1);
+        sprintf(filename, "%s/shard%d.log", dir, i + 1);
+        printf("%s shard %d: %s\n", getTime(time_string), i + 1, command);
+        fflush(stdout);
+        pids[i] = launch(command, filename);
+        free(command);
+        free(cmd.text);
+    }
+    waitShards(pids, shards, dir, "shard");
+    printf("%s all shards calculated\n", getTime(time_string));
+    // end calculate shards
+    //================================================== 
+
+    //================================================== 
+    // merge shards
+    for (i = 0; i < shards; i++) {
+        struct command cmd = {NULL, 0, 0};
+        appendArg(&cmd, self);
+        sprintf(shard_arg, "%d", i + 1);
+        appendArg(&cmd, "-m");
+        appendArg(&cmd, shard_arg);
+        sprintf(shard_arg, "%d", shards);
+        appendArg(&cmd, "-n");
+        appendArg(&cmd, shard_arg);
+        appendArg(&cmd, "-d");
+        appendArg(&cmd, dir);
+        sprintf(filename, "%s/ltcs%d.out", dir, i + 1);
+        appendArg(&cmd, "-o");
+        appendArg(&cmd, filename);
+        appendArg(&cmd, "-c");
+        appendArg(&cmd, csv);
+        char* command = applyTemplate(template, cmd.text, i + 1);
+        sprintf(filename, "%s/merge%d.log", dir, i + 1);
+        pids[i] = launch(command, filename);
+        free(command);
+        free(cmd.text);
+    }
+    waitShards(pids, shards, dir, "merge");
+    printf("%s all shards merged\n", getTime(time_string));
+    // end merge shards
+    //================================================== 
+
+    //================================================== 
+    // concatenate results
+    FILE* fileout = fopen(ltcsout, "w");
+    if (!fileout)
+    {
+        quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+    }
+    unsigned long shard_ltcs[shards];
+    unsigned long ltcs_count = 0;
+    for (i = 0; i < shards; i++) {
+        sprintf(filename, "%s/ltcs%d.out", dir, i + 1);
+        shard_ltcs[i] = appendFile(fileout, filename);
+        ltcs_count += shard_ltcs[i];
+    }
+    fclose(fileout);
+    if (optr[ARG_SFILE])
+    {
+        // every shard finds all internal loops
+        fileout = fopen(loopout, "w");
+        if (!fileout)
+        {
+            quitError("Error in opening loop outputfile\n", LTCS_ERROR_FILE);
+        }
+        sprintf(filename, "%s/loops1.out", dir);
+        appendFile(fileout, filename);
+        fclose(fileout);
+    }
+    // end concatenate results
+    //================================================== 
+
+    printf("\n%6s %14s\n", "shard", "LTCS");
+    for (i = 0; i < shards; i++) {
+        printf("%6d %14lu\n", i + 1, shard_ltcs[i]);
+    }
+    printf("\n");
+    printf("Nr of LTCS:           %lu\n", ltcs_count);
+    printf("\n");
+    printf("End: %s\n", getTime(time_string));
+    free(calc);
+    free(self);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1151 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+#include "bitmakros.h"
+
+#define MAX_ARGS       5
+#define ARG_SOCKET     0
+#define ARG_THREADS    1
+#define ARG_CACHE      2
+#define ARG_CPUS       3
+#define ARG_TIMEOUT    4
+
+#define LINE_SIZE      4096
+#define MESSAGE_SIZE   512
+// connections whose request is read at the same time
+#define MAX_REQUESTS   64
+
+#define JOB_LOAD       0
+#define JOB_COMPUTE    1
+
+#define STATE_QUEUED   0
+#define STATE_RUNNING  1
+#define STATE_DONE     2
+#define STATE_FAILED   3
+#define STATE_CANCELED 4
+
+#define MATRIX_LOADING 0
+#define MATRIX_READY   1
+#define MATRIX_FAILED  2
+
+/*
+ * parsed EFM matrix kept in memory, identified by EFM file, stoichiometric
+ * file and threshold; all reactions are loaded as reversible and the full
+ * matrix is kept, so requests with any reversibility or subset can be
+ * derived from it without reading the EFM file again
+ */
+struct matrix_entry
+{
+    char* efm_file;
+    char* sfile;
+    double threshold;
+    ltcs_context* ctx;
+    int state;
+    int users;
+    time_t last_used;
+    char message[MESSAGE_SIZE];
+    struct matrix_entry* next;
+};
+
+struct request_args
+{
+    struct daemon_state* d;
+    int client;
+};
+
+struct job
+{
+    unsigned long id;
+    int type;
+    int state;
+    int cancel;
+    char* efm_file;
+    char* sfile;
+    char* rvfile;
+    char* subset_file;
+    char* output;
+    double threshold;
+    int csv;
+    int threads;
+    int client;
+    ltcs_context* ctx;
+    unsigned long result_count;
+    char message[MESSAGE_SIZE];
+    struct job* next;
+};
+
+struct daemon_state
+{
+    pthread_mutex_t lock;
+    pthread_cond_t job_ready;
+    pthread_cond_t matrix_ready;
+    pthread_cond_t threads_free;
+    // calculation threads of all running jobs are taken from this budget
+    int max_threads;
+    int free_threads;
+    // seconds a client may take to send its request
+    int request_timeout;
+    // requests are read and handled by a thread per connection, the accept
+    // loop stops once a shutdown request sets closing
+    int server;
+    int requests;
+    int closing;
+    pthread_cond_t requests_done;
+    struct job** jobs;
+    unsigned long job_count;
+    struct job* queue_head;
+    struct job* queue_tail;
+    struct matrix_entry* matrices;
+    unsigned int matrix_count;
+    unsigned int max_matrices;
+    int shutdown;
+};
+
+static const char* state_names[] = {"queued", "running", "done", "failed", "canceled"};
+
+/*
+ * print progress messages of a job
+ */
+void printJobLog(const char* message, void* user_data)
+{
+    char time_string[TIME_STRING_SIZE];
+    struct job* job = (struct job*) user_data;
+    printf("%s job %lu: %s\n", getTime(time_string), job->id, message);
+    fflush(stdout);
+}
+
+/*
+ * write a string to a client
+ */
+void sendLine(int client, const char* format, ...)
+{
+    char line[LINE_SIZE];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, LINE_SIZE, format, args);
+    va_end(args);
+    if (len >= LINE_SIZE)
+    {
+        len = LINE_SIZE - 1;
+    }
+    int sent = 0;
+    while (sent < len)
+    {
+        ssize_t n = write(client, line + sent, len - sent);
+        if (n <= 0)
+        {
+            return;
+        }
+        sent += n;
+    }
+}
+
+/*
+ * read a line of a client (without newline) within timeout seconds, so that
+ * a client that does not send its request cannot block the daemon; returns
+ * -1 if the time is up
+ */
+int readLine(int client, char* line, int timeout)
+{
+    time_t end = time(0) + timeout;
+    int len = 0;
+    while (len < LINE_SIZE - 1)
+    {
+        time_t now = time(0);
+        if (now >= end)
+        {
+            len = -1;
+            break;
+        }
+        // wait at most the remaining time for the next bytes
+        struct timeval tv = {end - now, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        char c;
+        ssize_t n = read(client, &c, 1);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            len = -1;
+            break;
+        }
+        if (n <= 0 || c == '\n')
+        {
+            break;
+        }
+        line[len] = c;
+        len++;
+    }
+    line[len < 0 ? 0 : len] = '\0';
+    return len;
+}
+
+/*
+ * return value of a key=value token of a request or NULL
+ */
+char* getValue(char** tokens, int token_count, char* key)
+{
+    size_t len = strlen(key);
+    int i;
+    for (i = 1; i < token_count; i++) {
+        if (!strncmp(tokens[i], key, len) && tokens[i][len] == '=')
+        {
+            return tokens[i] + len + 1;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * read a subset of EFMs in the format of the LTCS output (1,0,1 or 101)
+ */
+char* readSubset(char* filename, unsigned long efm_count, char* message)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        snprintf(message, MESSAGE_SIZE, "Error in opening subset file");
+        return NULL;
+    }
+    char* subset = calloc(1, efm_count / CHAR_BIT + 1);
+    if (NULL == subset)
+    {
+        fclose(file);
+        snprintf(message, MESSAGE_SIZE, "Not enough free memory");
+        return NULL;
+    }
+    unsigned long ul = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF && c != '\n')
+    {
+        if (c == '0' || c == '1')
+        {
+            if (ul < efm_count && c == '1')
+            {
+                BITSET(subset, ul);
+            }
+            ul++;
+        }
+    }
+    fclose(file);
+    if (ul != efm_count)
+    {
+        snprintf(message, MESSAGE_SIZE, "subset file has %lu entries, EFM file "
+                "has %lu EFMs", ul, efm_count);
+        free(subset);
+        return NULL;
+    }
+    return subset;
+}
+
+/*
+ * copy an error message of libltcs without newline
+ */
+void copyMessage(char* message, ltcs_context* ctx)
+{
+    snprintf(message, MESSAGE_SIZE, "%s", ltcsGetErrorMessage(ctx));
+    size_t len = strlen(message);
+    if (len > 0 && message[len-1] == '\n')
+    {
+        message[len-1] = '\0';
+    }
+}
+
+/*
+ * remove a cached matrix and set its memory free
+ */
+void removeMatrix(struct daemon_state* d, struct matrix_entry* e)
+{
+    char time_string[TIME_STRING_SIZE];
+    struct matrix_entry** p = &d->matrices;
+    while (*p != e)
+    {
+        p = &(*p)->next;
+    }
+    *p = e->next;
+    if (e->state == MATRIX_READY)
+    {
+        printf("%s unload %s\n", getTime(time_string), e->efm_file);
+    }
+    ltcsFreeContext(e->ctx);
+    free(e->efm_file);
+    free(e->sfile);
+    free(e);
+    d->matrix_count--;
+}
+
+/*
+ * set memory of cached matrices free that are not used: failed loads are
+ * removed at once, loaded matrices starting with the least recently used one
+ * until at most max_matrices are cached
+ */
+void evictMatrices(struct daemon_state* d)
+{
+    struct matrix_entry* e = d->matrices;
+    while (NULL != e)
+    {
+        struct matrix_entry* next = e->next;
+        if (e->users == 0 && e->state == MATRIX_FAILED)
+        {
+            removeMatrix(d, e);
+        }
+        e = next;
+    }
+    while (d->matrix_count > d->max_matrices)
+    {
+        struct matrix_entry* oldest = NULL;
+        for (e = d->matrices; NULL != e; e = e->next) {
+            if (e->users == 0 && e->state == MATRIX_READY && (NULL == oldest
+                        || e->last_used < oldest->last_used))
+            {
+                oldest = e;
+            }
+        }
+        if (NULL == oldest)
+        {
+            return;
+        }
+        removeMatrix(d, oldest);
+    }
+}
+
+/*
+ * return cached matrix of a job, load it if it is not cached yet
+ * the returned entry is reserved for the job until releaseMatrix is called
+ */
+struct matrix_entry* getMatrix(struct daemon_state* d, struct job* job)
+{
+    char time_string[TIME_STRING_SIZE];
+    pthread_mutex_lock(&d->lock);
+    struct matrix_entry* e;
+    for (e = d->matrices; NULL != e; e = e->next) {
+        if (!strcmp(e->efm_file, job->efm_file) && e->threshold ==
+                job->threshold && ((NULL == e->sfile && NULL == job->sfile) ||
+                    (NULL != e->sfile && NULL != job->sfile &&
+                     !strcmp(e->sfile, job->sfile))))
+        {
+            break;
+        }
+    }
+    if (NULL != e)
+    {
+        e->users++;
+        while (e->state == MATRIX_LOADING)
+        {
+            pthread_cond_wait(&d->matrix_ready, &d->lock);
+        }
+        e->last_used = time(0);
+        pthread_mutex_unlock(&d->lock);
+        return e;
+    }
+    e = calloc(1, sizeof(struct matrix_entry));
+    if (NULL == e)
+    {
+        pthread_mutex_unlock(&d->lock);
+        return NULL;
+    }
+    e->efm_file = strdup(job->efm_file);
+    e->sfile = NULL != job->sfile ? strdup(job->sfile) : NULL;
+    e->threshold = job->threshold;
+    e->state = MATRIX_LOADING;
+    e->users = 1;
+    e->next = d->matrices;
+    d->matrices = e;
+    d->matrix_count++;
+    pthread_mutex_unlock(&d->lock);
+
+    // load matrix without holding the lock
+    printf("%s load %s\n", getTime(time_string), e->efm_file);
+    fflush(stdout);
+    ltcs_context* ctx = ltcsCreateContext();
+    int rv = NULL == ctx ? LTCS_ERROR_RAM : LTCS_OK;
+    if (rv == LTCS_OK)
+    {
+        ltcsSetLogCallback(ctx, printJobLog, job);
+        ltcsSetThreshold(ctx, e->threshold);
+        ltcsSetKeepFullMatrix(ctx, 1);
+        if (NULL != e->sfile)
+        {
+            rv = ltcsReadStoichiometricFile(ctx, e->sfile);
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        if (ltcsIsBinaryEfmFile(e->efm_file))
+        {
+            rv = ltcsLoadBinaryEfmFile(ctx, e->efm_file);
+        }
+        else
+        {
+            rv = ltcsLoadEfmFile(ctx, e->efm_file);
+        }
+    }
+
+    pthread_mutex_lock(&d->lock);
+    if (rv == LTCS_OK)
+    {
+        ltcsSetLogCallback(ctx, NULL, NULL);
+        e->ctx = ctx;
+        e->state = MATRIX_READY;
+    }
+    else
+    {
+        if (NULL == ctx)
+        {
+            snprintf(e->message, MESSAGE_SIZE, "Not enough free memory");
+        }
+        else
+        {
+            copyMessage(e->message, ctx);
+        }
+        ltcsFreeContext(ctx);
+        e->state = MATRIX_FAILED;
+    }
+    e->last_used = time(0);
+    pthread_cond_broadcast(&d->matrix_ready);
+    evictMatrices(d);
+    pthread_mutex_unlock(&d->lock);
+    return e;
+}
+
+void releaseMatrix(struct daemon_state* d, struct matrix_entry* e)
+{
+    pthread_mutex_lock(&d->lock);
+    e->users--;
+    evictMatrices(d);
+    pthread_mutex_unlock(&d->lock);
+}
+
+/*
+ * derive context of a compute job from the cached matrix and compute LTCS
+ */
+int runCompute(struct daemon_state* d, struct job* job, struct matrix_entry*
+        e)
+{
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        snprintf(job->message, MESSAGE_SIZE, "Not enough free memory");
+        return STATE_FAILED;
+    }
+    ltcsSetLogCallback(ctx, printJobLog, job);
+    char* subset = NULL;
+    int rv = LTCS_OK;
+    if (NULL != job->rvfile)
+    {
+        rv = ltcsReadReversibleFile(ctx, job->rvfile);
+    }
+    if (rv == LTCS_OK && NULL != job->subset_file)
+    {
+        subset = readSubset(job->subset_file, ltcsGetEfmCount(e->ctx),
+                job->message);
+        if (NULL == subset)
+        {
+            ltcsFreeContext(ctx);
+            return STATE_FAILED;
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = ltcsLoadFromContext(ctx, e->ctx, subset);
+    }
+    free(subset);
+
+    // make context visible for cancel requests and take the threads of the
+    // job from the budget of the daemon, waiting for running jobs if needed
+    int threads = job->threads < d->max_threads ? job->threads :
+        d->max_threads;
+    pthread_mutex_lock(&d->lock);
+    job->ctx = ctx;
+    if (job->cancel > 0)
+    {
+        ltcsCancel(ctx);
+    }
+    while (rv == LTCS_OK && job->cancel == 0 && d->free_threads < threads)
+    {
+        pthread_cond_wait(&d->threads_free, &d->lock);
+    }
+    if (rv == LTCS_OK && job->cancel > 0)
+    {
+        snprintf(job->message, MESSAGE_SIZE, "calculation canceled");
+        rv = LTCS_ERROR_CANCELED;
+    }
+    if (rv == LTCS_OK)
+    {
+        d->free_threads -= threads;
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    if (rv == LTCS_OK)
+    {
+        rv = ltcsCompute(ctx, threads, LTCS_COMPUTE_DEFAULT);
+        pthread_mutex_lock(&d->lock);
+        d->free_threads += threads;
+        pthread_cond_broadcast(&d->threads_free);
+        pthread_mutex_unlock(&d->lock);
+    }
+    if (rv == LTCS_OK)
+    {
+        job->result_count = ltcsGetResultCount(ctx);
+        if (!strcmp(job->output, "-"))
+        {
+            FILE* out = fdopen(dup(job->client), "w");
+            if (NULL != out)
+            {
+                rv = ltcsWriteResults(ctx, out, job->csv);
+                fclose(out);
+            }
+        }
+        else
+        {
+            FILE* out = fopen(job->output, "w");
+            if (NULL == out)
+            {
+                snprintf(job->message, MESSAGE_SIZE, "Error in opening output file");
+                rv = LTCS_ERROR_FILE;
+            }
+            else
+            {
+                rv = ltcsWriteResults(ctx, out, job->csv);
+                fclose(out);
+            }
+        }
+    }
+    if (rv != LTCS_OK && job->message[0] == '\0')
+    {
+        copyMessage(job->message, ctx);
+    }
+
+    pthread_mutex_lock(&d->lock);
+    job->ctx = NULL;
+    pthread_mutex_unlock(&d->lock);
+    ltcsFreeContext(ctx);
+    if (rv == LTCS_ERROR_CANCELED)
+    {
+        return STATE_CANCELED;
+    }
+    return rv == LTCS_OK ? STATE_DONE : STATE_FAILED;
+}
+
+/*
+ * worker of the thread pool
+ * takes jobs from the queue until the daemon is shut down
+ */
+void* workerThread(void* pointer_daemon)
+{
+    char time_string[TIME_STRING_SIZE];
+    struct daemon_state* d = (struct daemon_state*) pointer_daemon;
+    while (1)
+    {
+        pthread_mutex_lock(&d->lock);
+        while (NULL == d->queue_head && d->shutdown == 0)
+        {
+            pthread_cond_wait(&d->job_ready, &d->lock);
+        }
+        if (d->shutdown > 0)
+        {
+            pthread_mutex_unlock(&d->lock);
+            break;
+        }
+        struct job* job = d->queue_head;
+        d->queue_head = job->next;
+        if (NULL == d->queue_head)
+        {
+            d->queue_tail = NULL;
+        }
+        if (job->state == STATE_CANCELED)
+        {
+            pthread_mutex_unlock(&d->lock);
+            continue;
+        }
+        job->state = STATE_RUNNING;
+        pthread_mutex_unlock(&d->lock);
+        printf("%s job %lu: started\n", getTime(time_string), job->id);
+        fflush(stdout);
+
+        int state = STATE_DONE;
+        struct matrix_entry* e = getMatrix(d, job);
+        if (NULL == e)
+        {
+            snprintf(job->message, MESSAGE_SIZE, "Not enough free memory");
+            state = STATE_FAILED;
+        }
+        else
+        {
+            if (e->state == MATRIX_FAILED)
+            {
+                snprintf(job->message, MESSAGE_SIZE, "%s", e->message);
+                state = STATE_FAILED;
+            }
+            else if (job->type == JOB_COMPUTE)
+            {
+                state = runCompute(d, job, e);
+            }
+            releaseMatrix(d, e);
+        }
+
+        pthread_mutex_lock(&d->lock);
+        job->state = state;
+        int client = job->client;
+        job->client = -1;
+        pthread_mutex_unlock(&d->lock);
+        printf("%s job %lu: %s %s\n", getTime(time_string), job->id, state_names[state],
+                job->message);
+        fflush(stdout);
+        if (client >= 0)
+        {
+            if (state == STATE_DONE)
+            {
+                sendLine(client, "done %lu %lu\n", job->id, job->result_count);
+            }
+            else
+            {
+                sendLine(client, "%s %lu %s\n", state_names[state], job->id,
+                        job->message);
+            }
+            close(client);
+        }
+    }
+    return((void*)NULL);
+}
+
+/*
+ * create a job from a load or compute request and put it into the queue
+ */
+void queueJob(struct daemon_state* d, int client, char** tokens, int
+        token_count, int type)
+{
+    char* efm_file = getValue(tokens, token_count, "efm");
+    if (NULL == efm_file)
+    {
+        sendLine(client, "error missing efm=FILE\n");
+        close(client);
+        return;
+    }
+    char* output = getValue(tokens, token_count, "output");
+    if (type == JOB_COMPUTE && NULL == output)
+    {
+        sendLine(client, "error missing output=FILE or output=-\n");
+        close(client);
+        return;
+    }
+    struct job* job = calloc(1, sizeof(struct job));
+    if (NULL == job)
+    {
+        sendLine(client, "error Not enough free memory\n");
+        close(client);
+        return;
+    }
+    char* value;
+    job->type = type;
+    job->efm_file = strdup(efm_file);
+    value = getValue(tokens, token_count, "sfile");
+    job->sfile = NULL != value ? strdup(value) : NULL;
+    value = getValue(tokens, token_count, "rvfile");
+    job->rvfile = NULL != value ? strdup(value) : NULL;
+    value = getValue(tokens, token_count, "subset");
+    job->subset_file = NULL != value ? strdup(value) : NULL;
+    job->output = NULL != output ? strdup(output) : NULL;
+    value = getValue(tokens, token_count, "threshold");
+    job->threshold = NULL != value ? atof(value) : 1e-10;
+    value = getValue(tokens, token_count, "csv");
+    job->csv = NULL != value && !strcmp(value, "no") ? 0 : 1;
+    value = getValue(tokens, token_count, "threads");
+    job->threads = NULL != value ? atoi(value) : 1;
+    if (job->threads < 1)
+    {
+        job->threads = 1;
+    }
+    value = getValue(tokens, token_count, "wait");
+    int wait = (NULL != value && !strcmp(value, "yes")) || (NULL != output &&
+            !strcmp(output, "-"));
+    job->client = -1;
+    job->state = STATE_QUEUED;
+
+    // requests of several clients are handled at the same time
+    pthread_mutex_lock(&d->lock);
+    struct job** m_jobs = realloc(d->jobs, (d->job_count + 1) * sizeof(struct job*));
+    if (NULL == m_jobs)
+    {
+        pthread_mutex_unlock(&d->lock);
+        free(job->efm_file);
+        free(job->sfile);
+        free(job->rvfile);
+        free(job->subset_file);
+        free(job->output);
+        free(job);
+        sendLine(client, "error Not enough free memory\n");
+        close(client);
+        return;
+    }
+    d->jobs = m_jobs;
+    d->jobs[d->job_count] = job;
+    d->job_count++;
+    job->id = d->job_count;
+    sendLine(client, "job %lu\n", job->id);
+    if (wait > 0)
+    {
+        job->client = client;
+    }
+    else
+    {
+        close(client);
+    }
+    if (NULL == d->queue_tail)
+    {
+        d->queue_head = job;
+    }
+    else
+    {
+        d->queue_tail->next = job;
+    }
+    d->queue_tail = job;
+    pthread_cond_signal(&d->job_ready);
+    pthread_mutex_unlock(&d->lock);
+}
+
+/*
+ * print state of a job, of all jobs and cached matrices if id is 0
+ */
+void sendStatus(struct daemon_state* d, int client, unsigned long id)
+{
+    pthread_mutex_lock(&d->lock);
+    unsigned long ul;
+    for (ul = 0; ul < d->job_count; ul++) {
+        struct job* job = d->jobs[ul];
+        if (id == 0 || job->id == id)
+        {
+            if (job->state == STATE_DONE && job->type == JOB_COMPUTE)
+            {
+                sendLine(client, "job %lu done %lu ltcs\n", job->id,
+                        job->result_count);
+            }
+            else
+            {
+                sendLine(client, "job %lu %s %s\n", job->id,
+                        state_names[job->state], job->message);
+            }
+        }
+    }
+    if (id == 0)
+    {
+        struct matrix_entry* e;
+        for (e = d->matrices; NULL != e; e = e->next) {
+            if (e->state == MATRIX_READY)
+            {
+                sendLine(client, "matrix %s sfile=%s threshold=%.2e efms=%lu "
+                        "reactions=%u\n", e->efm_file, NULL != e->sfile ?
+                        e->sfile : "-", e->threshold, ltcsGetEfmCount(e->ctx),
+                        ltcsGetReactionCount(e->ctx));
+            }
+        }
+    }
+    else if (id > d->job_count)
+    {
+        sendLine(client, "error unknown job %lu\n", id);
+    }
+    pthread_mutex_unlock(&d->lock);
+}
+
+/*
+ * cancel a queued or running job
+ */
+void cancelJob(struct daemon_state* d, int client, unsigned long id)
+{
+    pthread_mutex_lock(&d->lock);
+    if (id < 1 || id > d->job_count)
+    {
+        sendLine(client, "error unknown job %lu\n", id);
+    }
+    else
+    {
+        struct job* job = d->jobs[id-1];
+        if (job->state == STATE_QUEUED)
+        {
+            job->state = STATE_CANCELED;
+            if (job->client >= 0)
+            {
+                sendLine(job->client, "canceled %lu\n", job->id);
+                close(job->client);
+                job->client = -1;
+            }
+            sendLine(client, "canceled %lu\n", id);
+        }
+        else if (job->state == STATE_RUNNING)
+        {
+            job->cancel = 1;
+            if (NULL != job->ctx)
+            {
+                ltcsCancel(job->ctx);
+            }
+            // a job waiting for threads is canceled at once
+            pthread_cond_broadcast(&d->threads_free);
+            sendLine(client, "canceling %lu\n", id);
+        }
+        else
+        {
+            sendLine(client, "error job %lu is %s\n", id, state_names[job->state]);
+        }
+    }
+    pthread_mutex_unlock(&d->lock);
+}
+
+/*
+ * handle a single request of a client
+ * returns 1 if the daemon should shut down
+ */
+int handleRequest(struct daemon_state* d, int client)
+{
+    char line[LINE_SIZE];
+    char* tokens[64];
+    int token_count = 0;
+    if (readLine(client, line, d->request_timeout) < 0)
+    {
+        sendLine(client, "error request timeout\n");
+        close(client);
+        return 0;
+    }
+    char *saveptr;
+    char *ptr = strtok_r(line, " \t\r", &saveptr);
+    while (ptr != NULL && token_count < 64)
+    {
+        tokens[token_count] = ptr;
+        token_count++;
+        ptr = strtok_r(NULL, " \t\r", &saveptr);
+    }
+    if (token_count == 0)
+    {
+        sendLine(client, "error empty request\n");
+    }
+    else if (!strcmp(tokens[0], "compute"))
+    {
+        queueJob(d, client, tokens, token_count, JOB_COMPUTE);
+        return 0;
+    }
+    else if (!strcmp(tokens[0], "load"))
+    {
+        queueJob(d, client, tokens, token_count, JOB_LOAD);
+        return 0;
+    }
+    else if (!strcmp(tokens[0], "status"))
+    {
+        sendStatus(d, client, token_count > 1 ? strtoul(tokens[1], NULL, 10) : 0);
+    }
+    else if (!strcmp(tokens[0], "cancel") && token_count > 1)
+    {
+        cancelJob(d, client, strtoul(tokens[1], NULL, 10));
+    }
+    else if (!strcmp(tokens[0], "shutdown"))
+    {
+        sendLine(client, "bye\n");
+        close(client);
+        return 1;
+    }
+    else
+    {
+        sendLine(client, "error unknown request %s\n", tokens[0]);
+    }
+    close(client);
+    return 0;
+}
+
+/*
+ * thread of a connection: reads and handles its request, so that a slow
+ * client only blocks its own thread; a shutdown request stops the accept
+ * loop
+ */
+void* requestThread(void* pointer_request_args)
+{
+    struct request_args* request_args = (struct request_args*) pointer_request_args;
+    struct daemon_state* d = request_args->d;
+    int stop = handleRequest(d, request_args->client);
+    free(request_args);
+    pthread_mutex_lock(&d->lock);
+    if (stop > 0 && d->closing == 0)
+    {
+        d->closing = 1;
+        // wakes up accept of the main thread
+        shutdown(d->server, SHUT_RDWR);
+    }
+    d->requests--;
+    pthread_cond_signal(&d->requests_done);
+    pthread_mutex_unlock(&d->lock);
+    return((void*)NULL);
+}
+
+int main (int argc, char *argv[])
+{
+    char time_string[TIME_STRING_SIZE];
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-s", "-t", "-m", "-c", "-r" };
+    char *optd[MAX_ARGS] = {"unix domain socket",
+                            "number of worker threads (concurrent jobs) [default: 1]",
+                            "number of cached EFM matrices [default: 4]",
+                            "number of calculation threads of all running jobs; the threads of a job are limited to it and a job waits until enough threads are free [default: number of cpus]",
+                            "seconds a client may take to send its request [default: 5]"};
+    char *optr[MAX_ARGS];
+    char *description = "Resident LTCS calculation: keeps parsed EFM matrices "
+        "in memory\nand computes requests of ltcsClient on a pool of worker threads";
+    char *usg = "\n   ltcsDaemon -s /tmp/ltcs.sock -t 8 -m 4 -c 16";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_SOCKET] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    int threads = optr[ARG_THREADS] ? atoi(optr[ARG_THREADS]) : 1;
+    int max_matrices = optr[ARG_CACHE] ? atoi(optr[ARG_CACHE]) : 4;
+    int cpus = optr[ARG_CPUS] ? atoi(optr[ARG_CPUS]) :
+        sysconf(_SC_NPROCESSORS_ONLN);
+    int request_timeout = optr[ARG_TIMEOUT] ? atoi(optr[ARG_TIMEOUT]) : 5;
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    if (max_matrices < 1)
+    {
+        max_matrices = 1;
+    }
+    if (cpus < 1)
+    {
+        cpus = 1;
+    }
+    if (request_timeout < 1)
+    {
+        request_timeout = 1;
+    }
+    // end read arguments
+    //================================================== 
+
+    //================================================== 
+    // open socket
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(optr[ARG_SOCKET]) >= sizeof(addr.sun_path))
+    {
+        quitError("socket path is too long\n", LTCS_ERROR_ARGS);
+    }
+    strcpy(addr.sun_path, optr[ARG_SOCKET]);
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(optr[ARG_SOCKET]);
+    if (server < 0 || bind(server, (struct sockaddr*) &addr, sizeof(addr)) < 0
+            || listen(server, 16) < 0)
+    {
+        quitError("Error in opening socket\n", LTCS_ERROR_FILE);
+    }
+    // clients closing their connection must not stop the daemon
+    signal(SIGPIPE, SIG_IGN);
+    // end open socket
+    //================================================== 
+
+    //================================================== 
+    // start worker threads
+    struct daemon_state d;
+    memset(&d, 0, sizeof(d));
+    pthread_mutex_init(&d.lock, NULL);
+    pthread_cond_init(&d.job_ready, NULL);
+    pthread_cond_init(&d.matrix_ready, NULL);
+    pthread_cond_init(&d.threads_free, NULL);
+    pthread_cond_init(&d.requests_done, NULL);
+    d.server = server;
+    d.max_matrices = max_matrices;
+    d.max_threads = cpus;
+    d.free_threads = cpus;
+    d.request_timeout = request_timeout;
+    pthread_t thread[threads];
+    int ti;
+    for (ti = 0; ti < threads; ti++) {
+        pthread_create(&thread[ti], NULL, workerThread, (void*)&d);
+    }
+    printf("%s listening on %s with %d worker threads and %d calculation "
+            "threads\n", getTime(time_string), optr[ARG_SOCKET], threads, cpus);
+    fflush(stdout);
+    // end start worker threads
+    //================================================== 
+
+    //================================================== 
+    // handle requests
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    while (1)
+    {
+        int client = accept(server, NULL, NULL);
+        pthread_mutex_lock(&d.lock);
+        int closing = d.closing;
+        int busy = d.requests >= MAX_REQUESTS;
+        if (client >= 0 && closing == 0 && busy == 0)
+        {
+            d.requests++;
+        }
+        pthread_mutex_unlock(&d.lock);
+        if (client < 0)
+        {
+            if (closing > 0)
+            {
+                break;
+            }
+            continue;
+        }
+        if (closing > 0 || busy > 0)
+        {
+            sendLine(client, closing > 0 ? "error shutting down\n" :
+                    "error too many requests\n");
+            close(client);
+            if (closing > 0)
+            {
+                break;
+            }
+            continue;
+        }
+        pthread_t request_thread;
+        struct request_args* request_args = malloc(sizeof(struct request_args));
+        if (NULL != request_args)
+        {
+            request_args->d = &d;
+            request_args->client = client;
+        }
+        if (NULL == request_args || pthread_create(&request_thread, &attr,
+                    requestThread, (void*)request_args) != 0)
+        {
+            free(request_args);
+            sendLine(client, "error Not enough free memory\n");
+            close(client);
+            pthread_mutex_lock(&d.lock);
+            d.requests--;
+            pthread_mutex_unlock(&d.lock);
+        }
+    }
+    pthread_attr_destroy(&attr);
+    // requests being read may still queue jobs
+    pthread_mutex_lock(&d.lock);
+    while (d.requests > 0)
+    {
+        pthread_cond_wait(&d.requests_done, &d.lock);
+    }
+    pthread_mutex_unlock(&d.lock);
+    // end handle requests
+    //================================================== 
+
+    //================================================== 
+    // stop workers and set memory free
+    printf("%s shutting down\n", getTime(time_string));
+    pthread_mutex_lock(&d.lock);
+    d.shutdown = 1;
+    unsigned long ul;
+    for (ul = 0; ul < d.job_count; ul++) {
+        struct job* job = d.jobs[ul];
+        if (job->state == STATE_RUNNING && NULL != job->ctx)
+        {
+            job->cancel = 1;
+            ltcsCancel(job->ctx);
+        }
+        else if (job->state == STATE_QUEUED)
+        {
+            job->state = STATE_CANCELED;
+        }
+    }
+    pthread_cond_broadcast(&d.job_ready);
+    pthread_cond_broadcast(&d.threads_free);
+    pthread_mutex_unlock(&d.lock);
+    for (ti = 0; ti < threads; ti++) {
+        pthread_join(thread[ti], NULL);
+    }
+    close(server);
+    unlink(optr[ARG_SOCKET]);
+    for (ul = 0; ul < d.job_count; ul++) {
+        struct job* job = d.jobs[ul];
+        if (job->client >= 0)
+        {
+            sendLine(job->client, "canceled %lu\n", job->id);
+            close(job->client);
+        }
+        free(job->efm_file);
+        free(job->sfile);
+        free(job->rvfile);
+        free(job->subset_file);
+        free(job->output);
+        free(job);
+    }
+    free(d.jobs);
+    d.max_matrices = 0;
+    evictMatrices(&d);
+    pthread_mutex_destroy(&d.lock);
+    pthread_cond_destroy(&d.job_ready);
+    pthread_cond_destroy(&d.matrix_ready);
+    pthread_cond_destroy(&d.threads_free);
+    pthread_cond_destroy(&d.requests_done);
+    // end stop workers and set memory free
+    //================================================== 
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,653 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+#include "bitmakros.h"
+
+#define MAX_ARGS       19
+#define ARG_SBML       0
+#define ARG_RFILE      1
+#define ARG_EFMS       2
+#define ARG_CONC       3
+#define ARG_GIBBS      4
+#define ARG_PROTON     5
+#define ARG_TEMP       6
+#define ARG_PH         7
+#define ARG_IONIC      8
+#define ARG_YIELDS     9
+#define ARG_TIGHT      10
+#define ARG_ZERO       11
+#define ARG_THREADS    12
+#define ARG_WORKERS    13
+#define ARG_DIR        14
+#define ARG_TEMPLATE   15
+#define ARG_OUTPUT     16
+#define ARG_FILTER     17
+#define ARG_SPLITS     18
+
+struct command
+{
+    char* text;
+    size_t length;
+    size_t size;
+};
+
+// feasible sets of all subproblems by EFM of the whole EFM file
+struct set_list
+{
+    char** sets;
+    unsigned long* cardinality;
+    unsigned long count;
+    unsigned long capacity;
+};
+
+/*
+ * print progress messages of libltcs with time stamp
+ */
+void printLog(const char* message, void* user_data)
+{
+    char time_string[TIME_STRING_SIZE];
+    printf("%s %s\n", getTime(time_string), message);
+    fflush(stdout);
+}
+
+/*
+ * quit with the error message of libltcs if a call failed
+ */
+void checkLtcs(ltcs_context* ctx, int rv)
+{
+    if (rv != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
+    }
+}
+
+/*
+ * append text to a command
+ */
+void appendText(struct command* cmd, const char* text, size_t length)
+{
+    if (cmd->length + length + 1 > cmd->size)
+    {
+        cmd->size = 2 * (cmd->length + length + 1);
+        cmd->text = realloc(cmd->text, cmd->size);
+        if (NULL == cmd->text)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    memcpy(cmd->text + cmd->length, text, length);
+    cmd->length += length;
+    cmd->text[cmd->length] = '\0';
+}
+
+/*
+ * replace {mps} of the template by the MILP file, {sol} by the prefix of the
+ * solution files, {n} by the number of EFMs and {i} by the subproblem
+ */
+char* applyTemplate(const char* template, const char* mps, const char* sol,
+        unsigned long efms, unsigned long subproblem)
+{
+    struct command cmd = {NULL, 0, 0};
+    char efm_number[32];
+    char number[32];
+    sprintf(efm_number, "%lu", efms);
+    sprintf(number, "%lu", subproblem);
+    appendText(&cmd, "", 0);
+    const char* c = template;
+    while (*c != '\0')
+    {
+        if (!strncmp(c, "{mps}", 5))
+        {
+            appendText(&cmd, mps, strlen(mps));
+            c += 5;
+        }
+        else if (!strncmp(c, "{sol}", 5))
+        {
+            appendText(&cmd, sol, strlen(sol));
+            c += 5;
+        }
+        else if (!strncmp(c, "{n}", 3))
+        {
+            appendText(&cmd, efm_number, strlen(efm_number));
+            c += 3;
+        }
+        else if (!strncmp(c, "{i}", 3))
+        {
+            appendText(&cmd, number, strlen(number));
+            c += 3;
+        }
+        else
+        {
+            appendText(&cmd, c, 1);
+            c++;
+        }
+    }
+    return cmd.text;
+}
+
+/*
+ * run a command by the shell with stdout and stderr written to logfile
+ */
+pid_t launch(const char* command, const char* logfile)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int fd = open(logfile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execl("/bin/sh", "sh", "-c", command, (char*) NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+/*
+ * wait for one solver of the pool, return 1 if it failed
+ */
+int waitSolver(pid_t* pids, unsigned long count, const char* dir)
+{
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0)
+    {
+        quitError("Error in waiting for solver\n", LTCS_ERROR_ARGS);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < count && pids[ul] != pid; ul++);
+    if (ul < count)
+    {
+        pids[ul] = 0;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        fprintf(stderr, "solver of LTCS %lu failed, see %s/ltcs%lu.log\n",
+                ul + 1, dir, ul + 1);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * add a feasible set to the list
+ */
+void addSet(struct set_list* list, char* set, unsigned long cardinality)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = 2 * list->capacity + 64;
+        list->sets = realloc(list->sets, list->capacity * sizeof(char*));
+        list->cardinality = realloc(list->cardinality, list->capacity *
+                sizeof(unsigned long));
+        if (NULL == list->sets || NULL == list->cardinality)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    list->sets[list->count] = set;
+    list->cardinality[list->count] = cardinality;
+    list->count++;
+}
+
+/*
+ * read a solution file of a subproblem: every line holds the values of its
+ * lambda columns (separated by commas or whitespace); efms maps them to the
+ * EFMs of the whole EFM file
+ */
+void readSolutionFile(const char* filename, const unsigned long* efms,
+        unsigned long n, unsigned long efm_count, struct set_list* list)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        quitError("Error in opening solution file\n", LTCS_ERROR_FILE);
+    }
+    size_t bytes = BITNSLOTS(efm_count);
+    char* line = NULL;
+    size_t len = 0;
+    while (getline(&line, &len, file) != -1)
+    {
+        char* saveptr;
+        char* ptr = strtok_r(line, ",\n\t ", &saveptr);
+        if (NULL == ptr)
+        {
+            continue;
+        }
+        char* set = calloc(1, bytes + 1);
+        if (NULL == set)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+        unsigned long cardinality = 0;
+        unsigned long ul = 0;
+        for (; NULL != ptr; ptr = strtok_r(NULL, ",\n\t ", &saveptr)) {
+            if (ul == n)
+            {
+                break;
+            }
+            if (atof(ptr) > 0.5)
+            {
+                BITSET(set, efms[ul]);
+                cardinality++;
+            }
+            ul++;
+        }
+        if (ul != n || NULL != ptr)
+        {
+            fprintf(stderr, "%s: solution does not have %lu values\n",
+                    filename, n);
+            quitError("Error in solution file format\n", LTCS_ERROR_FILE);
+        }
+        addSet(list, set, cardinality);
+    }
+    free(line);
+    fclose(file);
+}
+
+/*
+ * read all solution files (prefix ltcs<i>_sol_ and suffix .csv) of a
+ * subproblem, return their number
+ */
+unsigned long readSolutions(const char* dir, unsigned long subproblem, const
+        unsigned long* efms, unsigned long n, unsigned long efm_count, struct
+        set_list* list)
+{
+    char prefix[64];
+    sprintf(prefix, "ltcs%lu_sol_", subproblem);
+    size_t prefix_length = strlen(prefix);
+    DIR* d = opendir(dir);
+    if (NULL == d)
+    {
+        quitError("Error in opening working directory\n", LTCS_ERROR_FILE);
+    }
+    char filename[strlen(dir) + NAME_MAX + 2];
+    unsigned long files = 0;
+    struct dirent* entry;
+    while (NULL != (entry = readdir(d)))
+    {
+        size_t length = strlen(entry->d_name);
+        if (length > prefix_length + 4 && !strncmp(entry->d_name, prefix,
+                    prefix_length) && !strcmp(entry->d_name + length - 4,
+                    ".csv"))
+        {
+            sprintf(filename, "%s/%s", dir, entry->d_name);
+            readSolutionFile(filename, efms, n, efm_count, list);
+            files++;
+        }
+    }
+    closedir(d);
+    return files;
+}
+
+/*
+ * sort sets by cardinality (descending)
+ */
+const unsigned long* sort_cardinality;
+int compareCardinality(const void* a, const void* b)
+{
+    unsigned long x = sort_cardinality[*(const unsigned long*) a];
+    unsigned long y = sort_cardinality[*(const unsigned long*) b];
+    if (x != y)
+    {
+        return x > y ? -1 : 1;
+    }
+    return *(const unsigned long*) a < *(const unsigned long*) b ? -1 : 1;
+}
+
+/*
+ * check if set a is a subset of set b
+ */
+int isSubset(const char* a, const char* b, size_t bytes)
+{
+    size_t i;
+    for (i = 0; i < bytes; i++) {
+        if (a[i] & ~b[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * global maximality filter: write the sets that are no subset of another
+ * set (duplicates once), return their number
+ */
+unsigned long writeMaximalSets(FILE* file, struct set_list* list, unsigned
+        long efm_count)
+{
+    size_t bytes = BITNSLOTS(efm_count);
+    unsigned long* order = malloc((list->count + 1) * sizeof(unsigned long));
+    unsigned long* kept = malloc((list->count + 1) * sizeof(unsigned long));
+    if (NULL == order || NULL == kept)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    unsigned long ul, k;
+    for (ul = 0; ul < list->count; ul++) {
+        order[ul] = ul;
+    }
+    sort_cardinality = list->cardinality;
+    qsort(order, list->count, sizeof(unsigned long), compareCardinality);
+    unsigned long kept_count = 0;
+    for (ul = 0; ul < list->count; ul++) {
+        const char* set = list->sets[order[ul]];
+        for (k = 0; k < kept_count && !isSubset(set, list->sets[kept[k]],
+                    bytes); k++);
+        if (k == kept_count)
+        {
+            kept[kept_count++] = order[ul];
+            ltcsWriteSet(file, set, efm_count, 1);
+        }
+    }
+    free(order);
+    free(kept);
+    return kept_count;
+}
+
+/*
+ * find the thermodynamically feasible sets of EFMs by one small MILP per
+ * LTCS: every consistent set is contained in some LTCS of the reversibility
+ * of the model, so the MILP of each LTCS only has its EFMs and reactions;
+ * the MILPs are solved by a pool of solver processes and their solutions are
+ * merged by a global maximality filter
+ */
+int main (int argc, char *argv[])
+{
+    char time_string[TIME_STRING_SIZE];
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-s", "-r", "-e", "-c", "-g", "-o", "-k", "-p",
+        "-i", "-y", "-b", "-z", "-t", "-n", "-d", "-x", "-l", "-f", "-m" };
+    char *optd[MAX_ARGS] = {"sbml file of the model (reversibility of the LTCS calculation)",
+                            "rfile of the model",
+                            "file with EFMs (text or binary efm file, see src/ltcs.h)",
+                            "file with concentration of metabolites",
+                            "file with gibbs energies",
+                            "proton name in model [optional]",
+                            "temperature in K [default: 310.15]",
+                            "pH value [default: 7]",
+                            "ionic strength [default: 0.15]",
+                            "yield file [optional] lines like 'R_BIOMASS > 0.0095' (<, = or >), each yield has to be reached by an active EFM",
+                            "bounds tightening [yes/no; default: no]",
+                            "zero threshold of EFM fluxes [default: 1e-10]",
+                            "number of threads of the LTCS calculation [default: 1]",
+                            "number of concurrent solvers [default: 1]",
+                            "working directory for MILPs, solutions and logs [default: ltcs_milps]",
+                            "solver command template: {mps} is replaced by the MILP file, {sol} by the prefix of the solution files (<prefix><k>.csv, one line of comma separated lambda values per solution), {n} by the number of EFMs and {i} by the number of the LTCS",
+                            "output file of the feasible sets [default: feasible.out]",
+                            "check the LTCS with a LP over the concentration ranges before the MILPs are built (infeasible LTCS are split) [yes/no; default: no]",
+                            "maximal number of splits of an LTCS by the LP check, 0 for no limit [default: 1000]"};
+    char *optr[MAX_ARGS];
+    char *description = "Find the largest thermodynamically feasible sets of "
+        "EFMs with one MILP\nper LTCS (see ltcsMilp) solved by concurrent "
+        "solver processes";
+    char *usg = "\n   ltcsDecompose -s e_coli.xml -r e_coli.rfile -e efm.modes "
+        "-c glc.conc -g group_contribution.txt -o M_h_c -t 4 -n 8 -x "
+        "\"perl scripts/ltcstool_hotstart_clever.pl -i {mps} -s {n} -f {sol} "
+        "-l {sol}lp_\"";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_SBML] || !optr[ARG_RFILE] || !optr[ARG_EFMS] ||
+            !optr[ARG_CONC] || !optr[ARG_GIBBS] || !optr[ARG_TEMPLATE] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    double temperature = optr[ARG_TEMP] ? atof(optr[ARG_TEMP]) : 310.15;
+    double ph = optr[ARG_PH] ? atof(optr[ARG_PH]) : 7;
+    double ionic_strength = optr[ARG_IONIC] ? atof(optr[ARG_IONIC]) : 0.15;
+    double threshold = optr[ARG_ZERO] ? atof(optr[ARG_ZERO]) : 1e-10;
+    int threads = optr[ARG_THREADS] ? atoi(optr[ARG_THREADS]) : 1;
+    int workers = optr[ARG_WORKERS] ? atoi(optr[ARG_WORKERS]) : 1;
+    if (threads < 1 || workers < 1)
+    {
+        quitError("number of threads and solvers must be greater than 0\n",
+                LTCS_ERROR_ARGS);
+    }
+    char* dir = optr[ARG_DIR] ? optr[ARG_DIR] : "ltcs_milps";
+    char* output = optr[ARG_OUTPUT] ? optr[ARG_OUTPUT] : "feasible.out";
+    char* template = optr[ARG_TEMPLATE];
+    int prefilter = optr[ARG_FILTER] && !strcmp(optr[ARG_FILTER], "yes");
+    unsigned long max_splits = optr[ARG_SPLITS] ? strtoul(optr[ARG_SPLITS],
+            NULL, 10) : 1000;
+    unsigned int options = LTCS_MILP_OBJ_ROWS;
+    if (optr[ARG_TIGHT] && !strcmp(optr[ARG_TIGHT], "yes"))
+    {
+        options |= LTCS_MILP_TIGHT_BOUNDS;
+    }
+    if (mkdir(dir, 0755) != 0 && access(dir, W_OK) != 0)
+    {
+        quitError("Error in creating working directory\n", LTCS_ERROR_FILE);
+    }
+    // end read arguments
+    //================================================== 
+
+    printf("Start: %s\n", getTime(time_string));
+    printf("\n");
+    printf("sbml file:             %s\n", optr[ARG_SBML]);
+    printf("EFM file:              %s\n", optr[ARG_EFMS]);
+    printf("yields file:           %s\n", optr[ARG_YIELDS] ?
+            optr[ARG_YIELDS] : "not used");
+    printf("Output:                %s\n", output);
+    printf("LP check:              %s\n", prefilter ? "yes" : "no");
+    printf("Solvers:               %d\n", workers);
+    printf("Directory:             %s\n", dir);
+    printf("Template:              %s\n", template);
+    printf("\n");
+    fflush(stdout);
+
+    //================================================== 
+    // calculate LTCS with the reversibility of the model
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, printLog, NULL);
+    ltcsSetThreshold(ctx, threshold);
+    checkLtcs(ctx, ltcsSetConditions(ctx, temperature, ph, ionic_strength,
+                optr[ARG_PROTON]));
+    checkLtcs(ctx, ltcsReadReactionFile(ctx, optr[ARG_RFILE]));
+    checkLtcs(ctx, ltcsReadSbmlFile(ctx, optr[ARG_SBML]));
+    checkLtcs(ctx, ltcsReadGibbsFile(ctx, optr[ARG_GIBBS]));
+    checkLtcs(ctx, ltcsReadConcentrationFile(ctx, optr[ARG_CONC]));
+    checkLtcs(ctx, ltcsSetModelReversibility(ctx));
+    // the LP check needs the directions of all reactions
+    ltcsSetKeepFullMatrix(ctx, prefilter);
+    if (ltcsIsBinaryEfmFile(optr[ARG_EFMS]))
+    {
+        checkLtcs(ctx, ltcsLoadBinaryEfmFile(ctx, optr[ARG_EFMS]));
+    }
+    else
+    {
+        checkLtcs(ctx, ltcsLoadEfmFile(ctx, optr[ARG_EFMS]));
+    }
+    checkLtcs(ctx, ltcsCompute(ctx, threads, LTCS_COMPUTE_DEFAULT));
+    if (prefilter)
+    {
+        checkLtcs(ctx, ltcsCheckFeasibility(ctx, threads, max_splits));
+    }
+    // yields are constraints of the MILPs, so they are read after loading
+    if (optr[ARG_YIELDS])
+    {
+        checkLtcs(ctx, ltcsReadYieldsFile(ctx, optr[ARG_YIELDS]));
+    }
+    unsigned long efm_count = ltcsGetEfmCount(ctx);
+    unsigned long ltcs_count = ltcsGetResultCount(ctx);
+    printf("%s %lu LTCS of %lu EFMs\n", getTime(time_string), ltcs_count, efm_count);
+    // end calculate LTCS
+    //================================================== 
+
+    //================================================== 
+    // write and solve one MILP per LTCS
+    pid_t* pids = calloc(ltcs_count + 1, sizeof(pid_t));
+    unsigned long* sizes = calloc(ltcs_count + 1, sizeof(unsigned long));
+    if (NULL == pids || NULL == sizes)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    char mps[strlen(dir) + 64];
+    char sol[strlen(dir) + 64];
+    char logfile[strlen(dir) + 64];
+    int running = 0;
+    unsigned long failed = 0;
+    unsigned long ul;
+    for (ul = 0; ul < ltcs_count; ul++) {
+        sizes[ul] = ltcsGetResultCardinality(ctx, ul);
+        sprintf(mps, "%s/ltcs%lu.mps", dir, ul + 1);
+        sprintf(sol, "%s/ltcs%lu_sol_", dir, ul + 1);
+        sprintf(logfile, "%s/ltcs%lu.log", dir, ul + 1);
+        checkLtcs(ctx, ltcsWriteMilpSubset(ctx, optr[ARG_EFMS],
+                    ltcsGetResult(ctx, ul), mps, options));
+        for (; running >= workers; running--) {
+            failed += waitSolver(pids, ltcs_count, dir);
+        }
+        char* command = applyTemplate(template, mps, sol, sizes[ul], ul + 1);
+        printf("%s LTCS %lu (%lu EFMs): %s\n", getTime(time_string), ul + 1, sizes[ul],
+                command);
+        fflush(stdout);
+        pids[ul] = launch(command, logfile);
+        free(command);
+        if (pids[ul] < 0)
+        {
+            quitError("Error in starting solver\n", LTCS_ERROR_ARGS);
+        }
+        running++;
+    }
+    for (; running > 0; running--) {
+        failed += waitSolver(pids, ltcs_count, dir);
+    }
+    if (failed > 0)
+    {
+        quitError("Error in solving MILPs\n", LTCS_ERROR_ARGS);
+    }
+    printf("%s all MILPs solved\n", getTime(time_string));
+    // end write and solve MILPs
+    //================================================== 
+
+    //================================================== 
+    // merge solutions
+    struct set_list list = {NULL, NULL, 0, 0};
+    unsigned long* efms = calloc(efm_count + 1, sizeof(unsigned long));
+    if (NULL == efms)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    for (ul = 0; ul < ltcs_count; ul++) {
+        const char* set = ltcsGetResult(ctx, ul);
+        unsigned long n = 0;
+        unsigned long efm;
+        for (efm = 0; efm < efm_count; efm++) {
+            if (BITTEST(set, efm))
+            {
+                efms[n++] = efm;
+            }
+        }
+        unsigned long first = list.count;
+        readSolutions(dir, ul + 1, efms, n, efm_count, &list);
+        printf("%s LTCS %lu: %lu solutions\n", getTime(time_string), ul + 1,
+                list.count - first);
+    }
+    FILE* fileout = fopen(output, "w");
+    if (!fileout)
+    {
+        quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+    }
+    unsigned long feasible = writeMaximalSets(fileout, &list, efm_count);
+    if (ferror(fileout) || fclose(fileout) != 0)
+    {
+        quitError("Error in writing output file\n", LTCS_ERROR_FILE);
+    }
+    // end merge solutions
+    //================================================== 
+
+    printf("\n");
+    printf("Nr of LTCS:           %lu\n", ltcs_count);
+    printf("Nr of solutions:      %lu\n", list.count);
+    printf("Nr of feasible sets:  %lu\n", feasible);
+    printf("\n");
+    printf("End: %s\n", getTime(time_string));
+    for (ul = 0; ul < list.count; ul++) {
+        free(list.sets[ul]);
+    }
+    free(list.sets);
+    free(list.cardinality);
+    free(efms);
+    free(sizes);
+    free(pids);
+    ltcsFreeContext(ctx);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "ltcsIntern.h"
+
+/*
+ * thread function of split tree estimation
+ * performs random descents through the split tree of findLtcs; at each
+ * reaction one of the existing children is chosen uniformly and the product
+ * of the numbers of children is an unbiased estimate of the frontier size
+ * (Knuth's estimator)
+ * an LTCS that uses neither direction of a split reaction is reached by both
+ * children, so a maximal leaf is only counted on its canonical path, which
+ * keeps the positive direction at each such split; every LTCS has exactly one
+ * canonical path
+ */
+static void* estimateThread(void *pointer_estimate_args)
+{
+    struct estimate_args* estimate_args = (struct estimate_args*) pointer_estimate_args;
+    unsigned int rx_count = estimate_args->rx_count;
+    unsigned long efm_count = estimate_args->efm_count;
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    unsigned int seed = 4711 + 7919 * estimate_args->thread_id;
+    char* set = calloc(1, bitarray_size);
+    char* forbidden = calloc(1, bitarray_size);
+    // direction removed at each reaction: 1 positive, -1 negative, 0 no split
+    signed char* removed = calloc(rx_count + 1, sizeof(signed char));
+    if (NULL == set || NULL == forbidden || NULL == removed)
+    {
+        free(set);
+        free(forbidden);
+        free(removed);
+        estimate_args->error = LTCS_ERROR_RAM;
+        return((void*)NULL);
+    }
+    unsigned long us, ul;
+    unsigned int i;
+    for (us = 0; us < estimate_args->samples; us++) {
+        memset(set, 0, bitarray_size);
+        for (ul = 0; ul < efm_count; ul++) {
+            if (!BITTEST(estimate_args->loops, ul))
+            {
+                BITSET(set, ul);
+            }
+        }
+        double weight = 1;
+        for (i = 0; i < rx_count; i++) {
+            int pos = ltcs_bitsetIntersects(set, estimate_args->pos_mask[i], bitarray_size);
+            int neg = ltcs_bitsetIntersects(set, estimate_args->neg_mask[i], bitarray_size);
+            removed[i] = 0;
+            if (pos > 0 && neg > 0)
+            {
+                weight *= 2;
+                // the lowest bit of rand_r misses some sequences of children
+                if (rand_r(&seed) < RAND_MAX / 2)
+                {
+                    ltcs_bitsetAndNot(set, estimate_args->pos_mask[i], bitarray_size);
+                    removed[i] = 1;
+                }
+                else
+                {
+                    ltcs_bitsetAndNot(set, estimate_args->neg_mask[i], bitarray_size);
+                    removed[i] = -1;
+                }
+            }
+            estimate_args->sum[i] += weight;
+            estimate_args->sum_sq[i] += weight * weight;
+        }
+        int canonical = 1;
+        for (i = 0; i < rx_count && canonical > 0; i++) {
+            if (removed[i] > 0 && !ltcs_bitsetIntersects(set,
+                        estimate_args->neg_mask[i], bitarray_size))
+            {
+                canonical = 0;
+            }
+        }
+        if (canonical > 0 && ltcs_isMaximalSet(set, forbidden,
+                    estimate_args->loops, estimate_args->pos_mask,
+                    estimate_args->neg_mask, rx_count, efm_count))
+        {
+            estimate_args->ltcs_sum += weight;
+            estimate_args->ltcs_sum_sq += weight * weight;
+        }
+    }
+    free(set);
+    free(forbidden);
+    free(removed);
+    return((void*)NULL);
+}
+
+/*
+ * calculate mean and half width of 95% confidence interval from sums of
+ * samples
+ */
+static void getConfidenceInterval(double sum, double sum_sq, unsigned long
+        samples, double* mean, double* half_width)
+{
+    double m = sum / samples;
+    double var = 0;
+    if (samples > 1)
+    {
+        var = (sum_sq - samples * m * m) / (samples - 1);
+        if (var < 0)
+        {
+            var = 0;
+        }
+    }
+    *mean = m;
+    *half_width = 1.96 * sqrt(var / samples);
+}
+
+/*
+ * estimate number of LTCS and frontier size of each iteration of findLtcs by
+ * random descents through the split tree
+ * frontier arrays of estimate have to be set free by ltcsFreeEstimate
+ */
+int ltcsEstimate(ltcs_context* ctx, int threads, unsigned long samples,
+        struct ltcs_estimate* estimate)
+{
+    if (NULL == ctx->matrix)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "no EFMs loaded\n");
+    }
+    if (samples < 1)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "number of random descents must be greater than 0\n");
+    }
+    int max_threads = threads < 1 ? 1 : threads;
+    unsigned int rx_count = ctx->clean_rx_count;
+    unsigned long efm_count = ctx->efm_count;
+    ltcs_log(ctx, "estimate split tree by %lu random descents", samples);
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    if (ltcs_getColumnMasks(ctx->matrix, efm_count, rx_count, ctx->loops,
+                &pos_mask, &neg_mask) != LTCS_OK)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in getColumnMasks\n");
+    }
+
+    int num_threads = (samples > max_threads) ? max_threads : samples;
+    pthread_t thread[num_threads];
+    struct estimate_args estimate_args[num_threads];
+    int ti;
+    unsigned int i;
+    int error = LTCS_OK;
+    for (ti = 0; ti < num_threads; ti++) {
+        estimate_args[ti].thread_id = ti;
+        estimate_args[ti].samples = samples / num_threads +
+            (ti < samples % num_threads ? 1 : 0);
+        estimate_args[ti].rx_count = rx_count;
+        estimate_args[ti].efm_count = efm_count;
+        estimate_args[ti].loops = ctx->loops;
+        estimate_args[ti].pos_mask = pos_mask;
+        estimate_args[ti].neg_mask = neg_mask;
+        estimate_args[ti].sum = calloc(rx_count + 1, sizeof(double));
+        estimate_args[ti].sum_sq = calloc(rx_count + 1, sizeof(double));
+        estimate_args[ti].ltcs_sum = 0;
+        estimate_args[ti].ltcs_sum_sq = 0;
+        estimate_args[ti].error = LTCS_OK;
+        if (NULL == estimate_args[ti].sum || NULL == estimate_args[ti].sum_sq)
+        {
+            error = LTCS_ERROR_RAM;
+        }
+    }
+    if (error == LTCS_OK)
+    {
+        for (ti = 0; ti < num_threads; ti++) {
+            pthread_create(&thread[ti], NULL, estimateThread,
+                    (void*)&estimate_args[ti]);
+        }
+        for (ti = 0; ti < num_threads; ti++) {
+            pthread_join(thread[ti], NULL);
+            if (estimate_args[ti].error != LTCS_OK)
+            {
+                error = estimate_args[ti].error;
+            }
+        }
+    }
+
+    // merge sums of threads
+    double* sum = calloc(rx_count + 1, sizeof(double));
+    double* sum_sq = calloc(rx_count + 1, sizeof(double));
+    memset(estimate, 0, sizeof(struct ltcs_estimate));
+    estimate->frontier = calloc(rx_count + 1, sizeof(double));
+    estimate->frontier_low = calloc(rx_count + 1, sizeof(double));
+    estimate->frontier_high = calloc(rx_count + 1, sizeof(double));
+    if (NULL == sum || NULL == sum_sq || NULL == estimate->frontier || NULL
+            == estimate->frontier_low || NULL == estimate->frontier_high)
+    {
+        error = LTCS_ERROR_RAM;
+    }
+    double ltcs_sum = 0;
+    double ltcs_sum_sq = 0;
+    for (ti = 0; ti < num_threads; ti++) {
+        for (i = 0; i < rx_count && error == LTCS_OK; i++) {
+            sum[i] += estimate_args[ti].sum[i];
+            sum_sq[i] += estimate_args[ti].sum_sq[i];
+        }
+        ltcs_sum += estimate_args[ti].ltcs_sum;
+        ltcs_sum_sq += estimate_args[ti].ltcs_sum_sq;
+        free(estimate_args[ti].sum);
+        free(estimate_args[ti].sum_sq);
+    }
+    ltcs_freeColumnMasks(pos_mask, neg_mask, rx_count);
+    if (error != LTCS_OK)
+    {
+        free(sum);
+        free(sum_sq);
+        ltcsFreeEstimate(estimate);
+        return ltcs_setError(ctx, error,
+                "Not enough free memory in ltcsEstimate\n");
+    }
+
+    // estimated frontier of each iteration
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    double mean, half_width;
+    double peak = 1;
+    double nodes = 1;
+    estimate->iterations = rx_count;
+    for (i = 0; i < rx_count; i++) {
+        getConfidenceInterval(sum[i], sum_sq[i], samples, &mean, &half_width);
+        estimate->frontier[i] = mean;
+        estimate->frontier_low[i] = (mean - half_width < 1) ? 1 : mean - half_width;
+        estimate->frontier_high[i] = mean + half_width;
+        peak = mean > peak ? mean : peak;
+        nodes += mean;
+    }
+    estimate->leaves = 1;
+    if (rx_count > 0)
+    {
+        estimate->leaves = sum[rx_count-1] / samples;
+    }
+    getConfidenceInterval(ltcs_sum, ltcs_sum_sq, samples, &mean, &half_width);
+    estimate->ltcs = mean;
+    estimate->ltcs_low = mean - half_width < 0 ? 0 : mean - half_width;
+    estimate->ltcs_high = mean + half_width;
+    estimate->nodes = nodes;
+    estimate->peak_frontier = peak;
+    // old and new frontier are held in memory at the same time
+    estimate->peak_bytes = 2 * peak * (bitarray_size + sizeof(char*));
+    free(sum);
+    free(sum_sq);
+    return LTCS_OK;
+}
+
+/*
+ * set memory of an estimate free
+ */
+void ltcsFreeEstimate(struct ltcs_estimate* estimate)
+{
+    free(estimate->frontier);
+    free(estimate->frontier_low);
+    free(estimate->frontier_high);
+    estimate->frontier = NULL;
+    estimate->frontier_low = NULL;
+    estimate->frontier_high = NULL;
+}
@@ -0,0 +1,862 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "ltcsIntern.h"
+
+// tolerance of pivots and reduced costs and of the sum of infeasibilities
+#define LP_EPS         1e-9
+#define LP_FEAS_TOL    1e-7
+
+// result of a feasibility check
+#define LP_FEASIBLE    0
+#define LP_INFEASIBLE  1
+#define LP_UNKNOWN     2
+
+// dense phase 1 simplex with bounded variables: structural variables
+// (logarithm of the concentration minus its minimum) in [0, upper], a slack
+// per row and an artificial variable per row with negative right hand side
+struct lp_problem
+{
+    unsigned int rows;
+    unsigned int vars;
+    unsigned int cols;
+    double* tableau;
+    double* upper;
+    double* cost;
+    double* reduced;
+    double* value;
+    int* basis;
+    int* position;
+    char* at_upper;
+    int* local;
+    int* species;
+};
+
+/*
+ * free the arrays of the direction constraints
+ */
+static void freeDirectionRows(struct direction_row* rows, unsigned int count)
+{
+    unsigned int i;
+    for (i = 0; NULL != rows && i < count; i++) {
+        free(rows[i].conc);
+        free(rows[i].coef);
+    }
+    free(rows);
+}
+
+/*
+ * set the coefficient of a species in the DrG of a reaction (a species given
+ * twice keeps the last coefficient as in the MILP)
+ */
+static void setDirectionCoef(struct direction_row* row, long conc, double coef)
+{
+    unsigned int i;
+    for (i = 0; i < row->count && row->conc[i] != conc; i++);
+    row->conc[i] = conc;
+    row->coef[i] = coef;
+    if (i == row->count)
+    {
+        row->count++;
+    }
+}
+
+/*
+ * DrG of every usable reaction (all species have a dfg, see the MILP) as
+ * coefficients of the logarithms of the concentrations and a constant:
+ * DrG = constant + sum of coef * ln(c)
+ */
+static int getDirectionRows(ltcs_context* ctx, struct direction_row** rows,
+        double** conc_min, double** conc_max)
+{
+    double rt = GAS_CONSTANT * ctx->temperature / 1000;
+    char* has_dfg = calloc(ctx->conc_count + 1, 1);
+    double* dfg0 = calloc(ctx->conc_count + 1, sizeof(double));
+    struct direction_row* m_rows = calloc(ctx->model_rx_count + 1,
+            sizeof(struct direction_row));
+    double* m_min = calloc(ctx->conc_count + 1, sizeof(double));
+    double* m_max = calloc(ctx->conc_count + 1, sizeof(double));
+    int rv = LTCS_OK;
+    if (NULL == has_dfg || NULL == dfg0 || NULL == m_rows || NULL == m_min ||
+            NULL == m_max)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int c;
+    for (c = 0; rv == LTCS_OK && c < ctx->conc_count; c++) {
+        struct gibbs_entry* entry = bsearch(ctx->conc[c].compound,
+                ctx->gibbs, ctx->gibbs_count, sizeof(struct gibbs_entry),
+                ltcs_compareGibbs);
+        m_min[c] = ctx->conc[c].min;
+        m_max[c] = ctx->conc[c].max;
+        if (!ltcs_isProton(ctx, ctx->conc[c].species) && NULL != entry)
+        {
+            has_dfg[c] = 1;
+            dfg0[c] = ltcs_getTransformedDfg(ctx, entry);
+        }
+    }
+    unsigned int r;
+    for (r = 0; rv == LTCS_OK && r < ctx->model_rx_count; r++) {
+        struct model_reaction* rx = &ctx->model_rx[r];
+        if (!ltcs_hasSpeciesDfg(ctx, rx->reactants, rx->reactant_count, has_dfg)
+                || !ltcs_hasSpeciesDfg(ctx, rx->products, rx->product_count,
+                    has_dfg))
+        {
+            continue;
+        }
+        unsigned int size = rx->reactant_count + rx->product_count + 1;
+        struct direction_row* row = &m_rows[r];
+        row->use = 1;
+        row->conc = calloc(size, sizeof(long));
+        row->coef = calloc(size, sizeof(double));
+        if (NULL == row->conc || NULL == row->coef)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+            break;
+        }
+        unsigned int j;
+        for (j = 0; j < rx->reactant_count; j++) {
+            if (!ltcs_isProton(ctx, rx->reactants[j].species))
+            {
+                setDirectionCoef(row, ltcs_findConcentration(ctx,
+                            rx->reactants[j].species),
+                        -rx->reactants[j].stoichiometry);
+            }
+        }
+        for (j = 0; j < rx->product_count; j++) {
+            if (!ltcs_isProton(ctx, rx->products[j].species))
+            {
+                setDirectionCoef(row, ltcs_findConcentration(ctx,
+                            rx->products[j].species),
+                        rx->products[j].stoichiometry);
+            }
+        }
+        // dfg = dfg0 + RT ln(c)
+        for (j = 0; j < row->count; j++) {
+            row->constant += row->coef[j] * dfg0[row->conc[j]];
+            row->coef[j] *= rt;
+        }
+    }
+    free(has_dfg);
+    free(dfg0);
+    if (rv != LTCS_OK)
+    {
+        freeDirectionRows(m_rows, ctx->model_rx_count);
+        free(m_min);
+        free(m_max);
+        return rv;
+    }
+    *rows = m_rows;
+    *conc_min = m_min;
+    *conc_max = m_max;
+    return LTCS_OK;
+}
+
+/*
+ * free the arrays of a LP
+ */
+static void freeLp(struct lp_problem* lp)
+{
+    free(lp->tableau);
+    free(lp->upper);
+    free(lp->cost);
+    free(lp->reduced);
+    free(lp->value);
+    free(lp->basis);
+    free(lp->position);
+    free(lp->at_upper);
+    free(lp->local);
+    free(lp->species);
+}
+
+/*
+ * allocate a LP for up to rows constraints of the directions of a reaction
+ * set and all concentrations
+ */
+static int allocLp(struct lp_problem* lp, unsigned int rows, unsigned int
+        conc_count)
+{
+    memset(lp, 0, sizeof(struct lp_problem));
+    unsigned long cols = conc_count + 2 * (unsigned long) rows + 1;
+    lp->tableau = malloc((rows + 1) * cols * sizeof(double));
+    lp->upper = malloc(cols * sizeof(double));
+    lp->cost = malloc(cols * sizeof(double));
+    lp->reduced = malloc(cols * sizeof(double));
+    lp->value = malloc((rows + 1) * sizeof(double));
+    lp->basis = malloc((rows + 1) * sizeof(int));
+    lp->position = malloc(cols * sizeof(int));
+    lp->at_upper = malloc(cols);
+    lp->local = malloc((conc_count + 1) * sizeof(int));
+    lp->species = malloc((conc_count + 1) * sizeof(int));
+    if (NULL == lp->tableau || NULL == lp->upper || NULL == lp->cost || NULL ==
+            lp->reduced || NULL == lp->value || NULL == lp->basis || NULL ==
+            lp->position || NULL == lp->at_upper || NULL == lp->local ||
+            NULL == lp->species)
+    {
+        freeLp(lp);
+        return LTCS_ERROR_RAM;
+    }
+    unsigned int c;
+    for (c = 0; c < conc_count; c++) {
+        lp->local[c] = -1;
+    }
+    return LTCS_OK;
+}
+
+/*
+ * pivot the tableau on row r and column q
+ */
+static void pivotLp(struct lp_problem* lp, unsigned int r, unsigned int q)
+{
+    unsigned int cols = lp->cols;
+    double* row = lp->tableau + (unsigned long) r * cols;
+    double p = row[q];
+    unsigned int i, j;
+    for (j = 0; j < cols; j++) {
+        row[j] /= p;
+    }
+    for (i = 0; i < lp->rows; i++) {
+        double* other = lp->tableau + (unsigned long) i * cols;
+        double f = other[q];
+        if (i != r && f != 0)
+        {
+            for (j = 0; j < cols; j++) {
+                other[j] -= f * row[j];
+            }
+        }
+    }
+    double f = lp->reduced[q];
+    for (j = 0; j < cols; j++) {
+        lp->reduced[j] -= f * row[j];
+    }
+}
+
+/*
+ * check if the logarithms of the concentrations can be chosen in their ranges
+ * such that the DrG of all given directions (index 2*r forward, 2*r+1
+ * backward of reaction r) is not positive; phase 1 of the bounded simplex
+ * with Bland's rule minimizes the sum of the artificial variables
+ */
+static int isFeasibleLp(struct lp_problem* lp, const struct direction_row* rows,
+        const double* conc_min, const double* conc_max, const unsigned int*
+        directions, unsigned int count)
+{
+    unsigned int i, j, k;
+    // structural variables of the species of the directions
+    unsigned int vars = 0;
+    int* species = lp->species;
+    for (i = 0; i < count; i++) {
+        const struct direction_row* row = &rows[directions[i] / 2];
+        for (k = 0; k < row->count; k++) {
+            if (lp->local[row->conc[k]] < 0)
+            {
+                lp->local[row->conc[k]] = vars;
+                species[vars++] = row->conc[k];
+            }
+        }
+    }
+    lp->rows = count;
+    lp->vars = vars;
+    lp->cols = vars + 2 * count;
+    unsigned int cols = lp->cols;
+    memset(lp->tableau, 0, (unsigned long) count * cols * sizeof(double));
+    for (j = 0; j < cols; j++) {
+        lp->upper[j] = j < vars ? conc_max[species[j]] - conc_min[species[j]]
+            : INFINITY;
+        lp->cost[j] = j >= vars + count ? 1 : 0;
+        lp->position[j] = -1;
+        lp->at_upper[j] = 0;
+    }
+    // d * (constant + a * (y + min)) <= 0 with slack: d * a * y + s = b
+    for (i = 0; i < count; i++) {
+        const struct direction_row* row = &rows[directions[i] / 2];
+        double d = directions[i] % 2 ? -1 : 1;
+        double* t = lp->tableau + (unsigned long) i * cols;
+        double b = -d * row->constant;
+        for (k = 0; k < row->count; k++) {
+            t[lp->local[row->conc[k]]] += d * row->coef[k];
+            b -= d * row->coef[k] * conc_min[row->conc[k]];
+        }
+        t[vars + i] = 1;
+        if (b >= 0)
+        {
+            lp->basis[i] = vars + i;
+            lp->value[i] = b;
+        }
+        else
+        {
+            for (j = 0; j < vars + count; j++) {
+                t[j] = -t[j];
+            }
+            t[vars + count + i] = 1;
+            lp->basis[i] = vars + count + i;
+            lp->value[i] = -b;
+        }
+        lp->position[lp->basis[i]] = i;
+    }
+    for (i = 0; i < vars; i++) {
+        lp->local[species[i]] = -1;
+    }
+    for (j = 0; j < cols; j++) {
+        lp->reduced[j] = lp->cost[j];
+        for (i = 0; i < count; i++) {
+            lp->reduced[j] -= lp->cost[lp->basis[i]] *
+                lp->tableau[(unsigned long) i * cols + j];
+        }
+    }
+    unsigned long iteration;
+    unsigned long max_iterations = 50 * (unsigned long) (cols + count) + 100;
+    for (iteration = 0; iteration < max_iterations; iteration++) {
+        // entering variable: smallest index that improves
+        unsigned int q;
+        for (q = 0; q < cols; q++) {
+            if (lp->position[q] < 0 && lp->upper[q] > 0 && ((!lp->at_upper[q]
+                            && lp->reduced[q] < -LP_EPS) || (lp->at_upper[q]
+                            && lp->reduced[q] > LP_EPS)))
+            {
+                break;
+            }
+        }
+        if (q == cols)
+        {
+            double infeasibility = 0;
+            double scale = 1;
+            for (i = 0; i < count; i++) {
+                if (lp->basis[i] >= (int) (vars + count))
+                {
+                    infeasibility += lp->value[i];
+                }
+                scale += fabs(lp->value[i]);
+            }
+            return infeasibility > LP_FEAS_TOL * scale ? LP_INFEASIBLE :
+                LP_FEASIBLE;
+        }
+        double sigma = lp->at_upper[q] ? -1 : 1;
+        double theta = lp->upper[q];
+        int r = -1;
+        int to_upper = 0;
+        for (i = 0; i < count; i++) {
+            double t = sigma * lp->tableau[(unsigned long) i * cols + q];
+            double limit;
+            int upper = 0;
+            if (t > LP_EPS)
+            {
+                limit = lp->value[i] / t;
+            }
+            else if (t < -LP_EPS && isfinite(lp->upper[lp->basis[i]]))
+            {
+                limit = (lp->upper[lp->basis[i]] - lp->value[i]) / -t;
+                upper = 1;
+            }
+            else
+            {
+                continue;
+            }
+            if (limit < 0)
+            {
+                limit = 0;
+            }
+            if (limit < theta || (limit == theta && r >= 0 && lp->basis[i] <
+                        lp->basis[r]))
+            {
+                theta = limit;
+                r = i;
+                to_upper = upper;
+            }
+        }
+        if (isinf(theta))
+        {
+            // phase 1 is bounded, numerical trouble
+            return LP_UNKNOWN;
+        }
+        for (i = 0; i < count; i++) {
+            lp->value[i] -= sigma * theta * lp->tableau[(unsigned long) i *
+                cols + q];
+        }
+        if (r < 0)
+        {
+            lp->at_upper[q] = !lp->at_upper[q];
+            continue;
+        }
+        int leaving = lp->basis[r];
+        double entering = lp->at_upper[q] ? lp->upper[q] - theta : theta;
+        lp->position[leaving] = -1;
+        lp->at_upper[leaving] = to_upper;
+        pivotLp(lp, r, q);
+        lp->basis[r] = q;
+        lp->position[q] = r;
+        lp->at_upper[q] = 0;
+        lp->value[r] = entering;
+    }
+    return LP_UNKNOWN;
+}
+
+/*
+ * directions of the reactions used by the EFMs of a set (only reactions with
+ * DrG; backward only for reversible reactions as in the MILP), return their
+ * number
+ */
+static unsigned int getSetDirections(ltcs_context* ctx, struct feasible_args*
+        args, const char* set, unsigned int* directions)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    unsigned int count = 0;
+    unsigned int r;
+    for (r = 0; r < ctx->rx_count; r++) {
+        if (!args->rows[r].use)
+        {
+            continue;
+        }
+        if (ltcs_bitsetIntersects(set, args->pos_mask[r], bitarray_size))
+        {
+            directions[count++] = 2 * r;
+        }
+        if (ctx->model_rx[r].reversible && ltcs_bitsetIntersects(set,
+                    args->neg_mask[r], bitarray_size))
+        {
+            directions[count++] = 2 * r + 1;
+        }
+    }
+    return count;
+}
+
+/*
+ * reduce infeasible directions to a minimal infeasible subset (deletion
+ * filter), return its size
+ */
+static unsigned int getConflict(struct feasible_args* args, unsigned int*
+        directions, unsigned int count)
+{
+    unsigned int i = 0;
+    while (i < count)
+    {
+        unsigned int removed = directions[i];
+        directions[i] = directions[count - 1];
+        if (isFeasibleLp(args->lp, args->rows, args->conc_min, args->conc_max,
+                    directions, count - 1) == LP_INFEASIBLE)
+        {
+            count--;
+        }
+        else
+        {
+            directions[count - 1] = directions[i];
+            directions[i] = removed;
+            i++;
+        }
+    }
+    return count;
+}
+
+/*
+ * add a set to a list of sets
+ */
+static int addFeasibleSet(char*** sets, unsigned long* count, unsigned long*
+        capacity, char* set)
+{
+    if (*count == *capacity)
+    {
+        unsigned long m_capacity = 2 * *capacity + 16;
+        char** m_sets = realloc(*sets, m_capacity * sizeof(char*));
+        if (NULL == m_sets)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        *sets = m_sets;
+        *capacity = m_capacity;
+    }
+    (*sets)[(*count)++] = set;
+    return LTCS_OK;
+}
+
+/*
+ * check one LTCS: a feasible LTCS is kept, an infeasible one is split by a
+ * conflict of directions into the sets without one of its directions until
+ * all sets are feasible or empty; an LTCS with more than max_splits splits is
+ * kept for the MILP
+ */
+static int checkLtcsFeasibility(ltcs_context* ctx, struct feasible_args* args,
+        unsigned long li)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    char** stack = NULL;
+    unsigned long stack_count = 0;
+    unsigned long stack_capacity = 0;
+    char** found = NULL;
+    unsigned long found_count = 0;
+    unsigned long found_capacity = 0;
+    unsigned long splits = 0;
+    int status = LP_FEASIBLE;
+    int rv = LTCS_OK;
+    char* start = malloc(bitarray_size);
+    if (NULL == start || addFeasibleSet(&stack, &stack_count,
+                &stack_capacity, start) != LTCS_OK)
+    {
+        free(start);
+        free(stack);
+        return LTCS_ERROR_RAM;
+    }
+    memcpy(start, ctx->ltcs[ctx->result_index[li]], bitarray_size);
+    while (rv == LTCS_OK && stack_count > 0)
+    {
+        char* set = stack[--stack_count];
+        unsigned long ul;
+        for (ul = 0; ul < found_count && !ltcs_bitsetIsSubset(set, found[ul],
+                    bitarray_size); ul++);
+        if (ul < found_count || ltcs_bitsetCount(set, bitarray_size) == 0 ||
+                status == LP_UNKNOWN || ltcs_isCanceled(ctx))
+        {
+            free(set);
+            continue;
+        }
+        unsigned int count = getSetDirections(ctx, args, set,
+                args->directions);
+        int feasible = isFeasibleLp(args->lp, args->rows, args->conc_min,
+                args->conc_max, args->directions, count);
+        if (feasible == LP_FEASIBLE)
+        {
+            rv = addFeasibleSet(&found, &found_count, &found_capacity, set);
+            continue;
+        }
+        if (feasible == LP_UNKNOWN || (args->max_splits > 0 && splits ==
+                    args->max_splits))
+        {
+            // the MILP decides
+            status = LP_UNKNOWN;
+            free(set);
+            continue;
+        }
+        splits++;
+        count = getConflict(args, args->directions, count);
+        unsigned int i;
+        for (i = 0; rv == LTCS_OK && i < count; i++) {
+            unsigned int r = args->directions[i] / 2;
+            char* child = malloc(bitarray_size);
+            if (NULL == child)
+            {
+                rv = LTCS_ERROR_RAM;
+                break;
+            }
+            memcpy(child, set, bitarray_size);
+            ltcs_bitsetAndNot(child, args->directions[i] % 2 ?
+                    args->neg_mask[r] : args->pos_mask[r], bitarray_size);
+            rv = addFeasibleSet(&stack, &stack_count, &stack_capacity, child);
+            if (rv != LTCS_OK)
+            {
+                free(child);
+            }
+        }
+        free(set);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < stack_count; ul++) {
+        free(stack[ul]);
+    }
+    free(stack);
+    if (rv != LTCS_OK || status == LP_UNKNOWN || ltcs_isCanceled(ctx))
+    {
+        for (ul = 0; ul < found_count; ul++) {
+            free(found[ul]);
+        }
+        free(found);
+        found = NULL;
+        found_count = 0;
+    }
+    args->status[li] = status == LP_UNKNOWN ? 'u' : splits > 0 ? 's' : 'f';
+    args->found[li] = found;
+    args->found_count[li] = found_count;
+    return rv;
+}
+
+/*
+ * thread of the feasibility check: takes the next LTCS until all are checked
+ */
+static void* feasibleThread(void* arguments)
+{
+    struct feasible_args* args = arguments;
+    ltcs_context* ctx = args->ctx;
+    unsigned long li;
+    while (args->error == LTCS_OK && !ltcs_isCanceled(ctx) && (li =
+                __atomic_fetch_add(args->next, 1, __ATOMIC_RELAXED)) <
+            ctx->result_count)
+    {
+        args->error = checkLtcsFeasibility(ctx, args, li);
+    }
+    return NULL;
+}
+
+/*
+ * compare sets by cardinality (descending) for the maximality filter
+ */
+static int compareFeasibleSets(const void* a, const void* b)
+{
+    const struct feasible_set* x = a;
+    const struct feasible_set* y = b;
+    if (x->cardinality != y->cardinality)
+    {
+        return x->cardinality > y->cardinality ? -1 : 1;
+    }
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+/*
+ * replace the results by the thermodynamically feasible sets: feasible sets
+ * that are subsets of other feasible sets are removed, LTCS the check could
+ * not decide are kept
+ */
+static int installFeasibleSets(ltcs_context* ctx, struct feasible_args* args,
+        unsigned long* feasible_count)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    unsigned long count = 0;
+    unsigned long li, ul;
+    for (li = 0; li < ctx->result_count; li++) {
+        count += args->status[li] == 'u' ? 1 : args->found_count[li];
+    }
+    struct feasible_set* sets = calloc(count + 1, sizeof(struct
+                feasible_set));
+    char** results = calloc(count + 1, sizeof(char*));
+    if (NULL == sets || NULL == results)
+    {
+        free(sets);
+        free(results);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long n = 0;
+    unsigned long undecided = 0;
+    for (li = 0; li < ctx->result_count; li++) {
+        if (args->status[li] == 'u')
+        {
+            results[undecided] = malloc(bitarray_size);
+            if (NULL == results[undecided])
+            {
+                break;
+            }
+            memcpy(results[undecided++], ctx->ltcs[ctx->result_index[li]],
+                    bitarray_size);
+            continue;
+        }
+        for (ul = 0; ul < args->found_count[li]; ul++) {
+            sets[n].set = args->found[li][ul];
+            sets[n].cardinality = ltcs_bitsetCount(sets[n].set, bitarray_size);
+            sets[n].index = n;
+            n++;
+        }
+        free(args->found[li]);
+        args->found[li] = NULL;
+        args->found_count[li] = 0;
+    }
+    int rv = li < ctx->result_count ? LTCS_ERROR_RAM : LTCS_OK;
+    qsort(sets, n, sizeof(struct feasible_set), compareFeasibleSets);
+    unsigned long kept = undecided;
+    for (ul = 0; ul < n; ul++) {
+        unsigned long k;
+        for (k = undecided; k < kept && !ltcs_bitsetIsSubset(sets[ul].set,
+                    results[k], bitarray_size); k++);
+        if (rv == LTCS_OK && k == kept)
+        {
+            results[kept++] = sets[ul].set;
+        }
+        else
+        {
+            free(sets[ul].set);
+        }
+    }
+    free(sets);
+    if (rv != LTCS_OK)
+    {
+        for (ul = 0; ul < kept; ul++) {
+            free(results[ul]);
+        }
+        free(results);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    *feasible_count = kept - undecided;
+    ltcs_freeResults(ctx);
+    unsigned long duplicates;
+    return ltcs_setUniqueResults(ctx, results, kept, &duplicates);
+}
+
+int ltcsCheckFeasibility(ltcs_context* ctx, int threads, unsigned long
+        max_splits)
+{
+    if (NULL == ctx->model_rx || NULL == ctx->full_mat || NULL == ctx->ltcs)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "Feasibility check needs "
+                "the SBML file, the full EFM matrix and calculated LTCS\n");
+    }
+    if (ctx->model_rx_count != ctx->rx_count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "EFMs have %u reactions, "
+                "but the reaction file %u\n", ctx->rx_count,
+                ctx->model_rx_count);
+    }
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    struct direction_row* rows = NULL;
+    double* conc_min = NULL;
+    double* conc_max = NULL;
+    int rv = getDirectionRows(ctx, &rows, &conc_min, &conc_max);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    unsigned long ltcs_count = ctx->result_count;
+    char* status = calloc(ltcs_count + 1, 1);
+    char*** found = calloc(ltcs_count + 1, sizeof(char**));
+    unsigned long* found_count = calloc(ltcs_count + 1, sizeof(unsigned
+                long));
+    if (NULL == status || NULL == found || NULL == found_count ||
+            ltcs_getColumnMasks(ctx->full_mat, ctx->efm_count, ctx->rx_count,
+                ctx->loops, &pos_mask, &neg_mask) != LTCS_OK)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    ltcs_log(ctx, "check thermodynamic feasibility of %lu LTCS", ltcs_count);
+    unsigned long next = 0;
+    pthread_t thread[threads];
+    struct feasible_args args[threads];
+    struct lp_problem lp[threads];
+    int ti;
+    int started = 0;
+    for (ti = 0; rv == LTCS_OK && ti < threads; ti++) {
+        args[ti].ctx = ctx;
+        args[ti].rows = rows;
+        args[ti].conc_min = conc_min;
+        args[ti].conc_max = conc_max;
+        args[ti].pos_mask = pos_mask;
+        args[ti].neg_mask = neg_mask;
+        args[ti].max_splits = max_splits;
+        args[ti].next = &next;
+        args[ti].status = status;
+        args[ti].found = found;
+        args[ti].found_count = found_count;
+        args[ti].lp = &lp[ti];
+        args[ti].error = LTCS_OK;
+        args[ti].directions = malloc((2 * ctx->rx_count + 1) * sizeof(unsigned
+                    int));
+        if (NULL == args[ti].directions || allocLp(&lp[ti], 2 * ctx->rx_count,
+                    ctx->conc_count) != LTCS_OK)
+        {
+            free(args[ti].directions);
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+            break;
+        }
+        started++;
+    }
+    if (rv == LTCS_OK)
+    {
+        for (ti = 0; ti < threads; ti++) {
+            pthread_create(&thread[ti], NULL, feasibleThread,
+                    (void*)&args[ti]);
+        }
+        for (ti = 0; ti < threads; ti++) {
+            pthread_join(thread[ti], NULL);
+            if (args[ti].error != LTCS_OK && rv == LTCS_OK)
+            {
+                rv = ltcs_setError(ctx, args[ti].error,
+                        "Not enough free memory\n");
+            }
+        }
+        if (rv == LTCS_OK && ltcs_isCanceled(ctx))
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_CANCELED,
+                    "Calculation canceled\n");
+        }
+    }
+    for (ti = 0; ti < started; ti++) {
+        free(args[ti].directions);
+        freeLp(&lp[ti]);
+    }
+    unsigned long feasible = 0, split = 0, undecided = 0;
+    unsigned long li;
+    for (li = 0; li < ltcs_count && NULL != status; li++) {
+        feasible += status[li] == 'f' ? 1 : 0;
+        split += status[li] == 's' ? 1 : 0;
+        undecided += status[li] == 'u' ? 1 : 0;
+    }
+    unsigned long feasible_sets = 0;
+    if (rv == LTCS_OK)
+    {
+        struct feasible_args install = args[0];
+        rv = installFeasibleSets(ctx, &install, &feasible_sets);
+    }
+    for (li = 0; li < ltcs_count && NULL != found; li++) {
+        unsigned long ul;
+        for (ul = 0; ul < found_count[li]; ul++) {
+            free(found[li][ul]);
+        }
+        free(found[li]);
+    }
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "%lu LTCS feasible, %lu split, %lu left to the MILP: "
+                "%lu feasible sets and %lu LTCS", feasible, split, undecided,
+                feasible_sets, undecided);
+    }
+    if (NULL != pos_mask)
+    {
+        ltcs_freeColumnMasks(pos_mask, neg_mask, ctx->rx_count);
+    }
+    free(status);
+    free(found);
+    free(found_count);
+    freeDirectionRows(rows, ctx->model_rx_count);
+    free(conc_min);
+    free(conc_max);
+    return rv;
+}
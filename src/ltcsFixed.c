@@ -0,0 +1,646 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "ltcsIntern.h"
+
+/*
+ * kernels for at most 512 EFMs: a set is stored inline in the frontier as
+ * 1, 2, 4 or 8 words of 64 bits, a reaction is split with its column masks
+ * and subsets are found by comparing whole words. The number of words is a
+ * constant in every kernel, so the compiler unrolls all loops over words.
+ */
+#define FIXED_INLINE static inline __attribute__((always_inline))
+
+struct fixed_args
+{
+    ltcs_context* ctx;
+    int words;
+    const uint64_t* ltcs;
+    unsigned long first;
+    unsigned long last;
+    const uint64_t* pos;
+    const uint64_t* neg;
+    uint64_t* new_ltcs;
+    unsigned long new_ltcs_count;
+    int error;
+    double busy;
+};
+
+struct fixed_order
+{
+    unsigned long cardinality;
+    unsigned long index;
+};
+
+/*
+ * split the sets first to last at a reaction given by its column masks,
+ * with the same rules as splitLtcs; returns the number of new sets
+ */
+FIXED_INLINE unsigned long splitFixed(const uint64_t* ltcs, unsigned long
+        first, unsigned long last, const uint64_t* pos, const uint64_t* neg,
+        uint64_t* new_ltcs, const int words)
+{
+    unsigned long ui;
+    unsigned long count = 0;
+    int k;
+    for (ui = first; ui < last; ui++) {
+        const uint64_t* set = ltcs + ui * words;
+        uint64_t has_pos = 0;
+        uint64_t has_neg = 0;
+        for (k = 0; k < words; k++) {
+            has_pos |= set[k] & pos[k];
+            has_neg |= set[k] & neg[k];
+        }
+        // EFMs with positive or zero flux
+        if (has_pos || !has_neg)
+        {
+            uint64_t* p_set = new_ltcs + count * words;
+            for (k = 0; k < words; k++) {
+                p_set[k] = set[k] & ~neg[k];
+            }
+            count++;
+        }
+        // EFMs with negative or zero flux
+        if (has_neg)
+        {
+            uint64_t* n_set = new_ltcs + count * words;
+            for (k = 0; k < words; k++) {
+                n_set[k] = set[k] & ~pos[k];
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+ * find a kept set that contains the set, returns its position in kept plus 1
+ * or 0; kept sets are searched from the end, so sets of the same cardinality
+ * (equal sets) are found first
+ */
+FIXED_INLINE unsigned long findFixedSuperset(const uint64_t* ltcs, unsigned
+        long index, const struct fixed_order* kept, unsigned long kept_count,
+        const int words)
+{
+    const uint64_t* set = ltcs + index * words;
+    unsigned long ul;
+    int k;
+    for (ul = kept_count; ul > 0; ul--) {
+        const uint64_t* other = ltcs + kept[ul - 1].index * words;
+        uint64_t rest = 0;
+        for (k = 0; k < words; k++) {
+            rest |= set[k] & ~other[k];
+        }
+        if (0 == rest)
+        {
+            return ul;
+        }
+    }
+    return 0;
+}
+
+static unsigned long splitFixed64(const uint64_t* ltcs, unsigned long first,
+        unsigned long last, const uint64_t* pos, const uint64_t* neg, uint64_t*
+        new_ltcs)
+{
+    return splitFixed(ltcs, first, last, pos, neg, new_ltcs, 1);
+}
+
+static unsigned long splitFixed128(const uint64_t* ltcs, unsigned long first,
+        unsigned long last, const uint64_t* pos, const uint64_t* neg, uint64_t*
+        new_ltcs)
+{
+    return splitFixed(ltcs, first, last, pos, neg, new_ltcs, 2);
+}
+
+static unsigned long splitFixed256(const uint64_t* ltcs, unsigned long first,
+        unsigned long last, const uint64_t* pos, const uint64_t* neg, uint64_t*
+        new_ltcs)
+{
+    return splitFixed(ltcs, first, last, pos, neg, new_ltcs, 4);
+}
+
+static unsigned long splitFixed512(const uint64_t* ltcs, unsigned long first,
+        unsigned long last, const uint64_t* pos, const uint64_t* neg, uint64_t*
+        new_ltcs)
+{
+    return splitFixed(ltcs, first, last, pos, neg, new_ltcs, 8);
+}
+
+static unsigned long findFixedSuperset64(const uint64_t* ltcs, unsigned long
+        index, const struct fixed_order* kept, unsigned long kept_count)
+{
+    return findFixedSuperset(ltcs, index, kept, kept_count, 1);
+}
+
+static unsigned long findFixedSuperset128(const uint64_t* ltcs, unsigned long
+        index, const struct fixed_order* kept, unsigned long kept_count)
+{
+    return findFixedSuperset(ltcs, index, kept, kept_count, 2);
+}
+
+static unsigned long findFixedSuperset256(const uint64_t* ltcs, unsigned long
+        index, const struct fixed_order* kept, unsigned long kept_count)
+{
+    return findFixedSuperset(ltcs, index, kept, kept_count, 4);
+}
+
+static unsigned long findFixedSuperset512(const uint64_t* ltcs, unsigned long
+        index, const struct fixed_order* kept, unsigned long kept_count)
+{
+    return findFixedSuperset(ltcs, index, kept, kept_count, 8);
+}
+
+/*
+ * number of 64 bit words of a set if the fixed-width kernels can be used,
+ * else 0; memory limit, NUMA and shards need the sets of the generic kernel
+ */
+int ltcs_getFixedWords(ltcs_context* ctx, unsigned int options)
+{
+    if ((options & LTCS_COMPUTE_GENERIC) || ctx->memory_limit > 0 ||
+            ctx->numa > 0 || ctx->shard_count > 1)
+    {
+        return 0;
+    }
+    unsigned long words = (ctx->efm_count + 63) / 64;
+    if (words <= 1)
+    {
+        return 1;
+    }
+    else if (words <= 2)
+    {
+        return 2;
+    }
+    else if (words <= 4)
+    {
+        return 4;
+    }
+    else if (words <= 8)
+    {
+        return 8;
+    }
+    return 0;
+}
+
+/*
+ * thread function of the fixed-width kernels: splits the sets first to last
+ * block by block, new sets are written to 2 slots per set starting at first
+ */
+static void* fixedThread(void* pointer_fixed_args)
+{
+    struct fixed_args* args = (struct fixed_args*) pointer_fixed_args;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t* new_ltcs = args->new_ltcs + 2 * args->first * args->words;
+    unsigned long first;
+    args->new_ltcs_count = 0;
+    args->error = LTCS_OK;
+    for (first = args->first; first < args->last; first += FIXED_BLOCK) {
+        if (ltcs_isCanceled(args->ctx))
+        {
+            args->error = LTCS_ERROR_CANCELED;
+            break;
+        }
+        unsigned long last = first + FIXED_BLOCK < args->last ? first +
+            FIXED_BLOCK : args->last;
+        uint64_t* block = new_ltcs + args->new_ltcs_count * args->words;
+        switch (args->words)
+        {
+            case 1:
+                args->new_ltcs_count += splitFixed64(args->ltcs, first, last,
+                        args->pos, args->neg, block);
+                break;
+            case 2:
+                args->new_ltcs_count += splitFixed128(args->ltcs, first, last,
+                        args->pos, args->neg, block);
+                break;
+            case 4:
+                args->new_ltcs_count += splitFixed256(args->ltcs, first, last,
+                        args->pos, args->neg, block);
+                break;
+            default:
+                args->new_ltcs_count += splitFixed512(args->ltcs, first, last,
+                        args->pos, args->neg, block);
+                break;
+        }
+        ltcs_telemetryAdvance(args->ctx, last - first);
+    }
+    args->busy = ltcs_getElapsedTime(&start);
+    return((void*)NULL);
+}
+
+/*
+ * column masks of all reactions as fixed-width sets: EFMs with positive flux
+ * followed by EFMs with negative flux of each reaction
+ */
+static uint64_t* getFixedMasks(ltcs_context* ctx, int words)
+{
+    uint64_t* masks = calloc(2 * ctx->clean_rx_count * words + 1,
+            sizeof(uint64_t));
+    if (NULL == masks)
+    {
+        return NULL;
+    }
+    unsigned long ul;
+    unsigned int ui;
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (BITTEST(ctx->loops, ul))
+        {
+            continue;
+        }
+        uint64_t bit = (uint64_t) 1 << (ul % 64);
+        for (ui = 0; ui < ctx->clean_rx_count; ui++) {
+            uint64_t* pos = masks + 2 * ui * words;
+            uint64_t* neg = pos + words;
+            if (BITTEST(ctx->matrix[ul], 2 * ui))
+            {
+                pos[ul / 64] |= bit;
+            }
+            else if (BITTEST(ctx->matrix[ul], 2 * ui + 1))
+            {
+                neg[ul / 64] |= bit;
+            }
+        }
+    }
+    return masks;
+}
+
+/*
+ * split the frontier at every reaction, the frontier is divided into one
+ * contiguous share per thread so the order of the sets is the same as with
+ * one thread
+ */
+static int splitFixedFrontier(ltcs_context* ctx, int words, int max_threads,
+        uint64_t** ltcs, unsigned long* ltcs_count)
+{
+    unsigned int rx_count = ctx->clean_rx_count;
+    unsigned long set_bytes = words * sizeof(uint64_t);
+    uint64_t* masks = getFixedMasks(ctx, words);
+    uint64_t* m_ltcs = calloc(1, set_bytes);
+    double* busy = calloc(2 * max_threads, sizeof(double));
+    if (NULL == masks || NULL == m_ltcs || NULL == busy)
+    {
+        free(masks);
+        free(m_ltcs);
+        free(busy);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in findLtcs\n");
+    }
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, 2 * rx_count * set_bytes);
+    double* iteration_busy = busy + max_threads;
+    // first set contains all EFMs that are not internal loops
+    unsigned long m_ltcs_count = 1;
+    unsigned long ul;
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (!BITTEST(ctx->loops, ul))
+        {
+            m_ltcs[ul / 64] |= (uint64_t) 1 << (ul % 64);
+        }
+    }
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, set_bytes);
+    ltcs_telemetryBegin(ctx, "split");
+    ctx->iterations = rx_count;
+    ctx->frontier = m_ltcs_count;
+
+    unsigned int i;
+    int error = LTCS_OK;
+    for (i = 0; i < rx_count && error == LTCS_OK; i++) {
+        ltcs_telemetryProgress(ctx, i + 1, m_ltcs_count);
+        uint64_t* new_ltcs = malloc(2 * m_ltcs_count * set_bytes);
+        if (NULL == new_ltcs)
+        {
+            error = LTCS_ERROR_RAM;
+            break;
+        }
+        ltcs_memoryAdd(ctx, LTCS_MEMORY_FRONTIER, 2 * m_ltcs_count * set_bytes);
+
+        // small frontiers are split without starting threads
+        int num_threads = m_ltcs_count / FIXED_BLOCK + 1;
+        if (num_threads > max_threads)
+        {
+            num_threads = max_threads;
+        }
+        pthread_t thread[num_threads];
+        struct fixed_args args[num_threads];
+        int ti;
+        for (ti = 0; ti < num_threads; ti++) {
+            args[ti].ctx = ctx;
+            args[ti].words = words;
+            args[ti].ltcs = m_ltcs;
+            args[ti].first = m_ltcs_count * ti / num_threads;
+            args[ti].last = m_ltcs_count * (ti + 1) / num_threads;
+            args[ti].pos = masks + 2 * i * words;
+            args[ti].neg = masks + (2 * i + 1) * words;
+            args[ti].new_ltcs = new_ltcs;
+        }
+        if (num_threads == 1)
+        {
+            fixedThread(&args[0]);
+        }
+        else
+        {
+            for (ti = 0; ti < num_threads; ti++) {
+                pthread_create(&thread[ti], NULL, fixedThread, &args[ti]);
+            }
+            for (ti = 0; ti < num_threads; ti++) {
+                pthread_join(thread[ti], NULL);
+            }
+        }
+
+        // move the new sets of every thread behind the sets of the previous
+        // thread
+        unsigned long new_ltcs_count = 0;
+        memset(iteration_busy, 0, max_threads * sizeof(double));
+        for (ti = 0; ti < num_threads; ti++) {
+            if (args[ti].error != LTCS_OK)
+            {
+                error = args[ti].error;
+            }
+            if (new_ltcs_count != 2 * args[ti].first)
+            {
+                memmove(new_ltcs + new_ltcs_count * words, new_ltcs + 2 *
+                        args[ti].first * words, args[ti].new_ltcs_count *
+                        set_bytes);
+            }
+            new_ltcs_count += args[ti].new_ltcs_count;
+            iteration_busy[ti] = args[ti].busy;
+            busy[ti] += args[ti].busy;
+        }
+        free(m_ltcs);
+        m_ltcs = new_ltcs;
+        m_ltcs_count = new_ltcs_count;
+        ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, m_ltcs_count * set_bytes);
+        if (error != LTCS_OK)
+        {
+            break;
+        }
+        ltcs_log(ctx, "iteration %d/%d: %lu ltcs", i+1, rx_count, m_ltcs_count);
+        ltcs_telemetryIteration(ctx, i + 1, rx_count, m_ltcs_count,
+                ltcs_getElapsedTime(&ctx->iteration_start), iteration_busy,
+                max_threads);
+    }
+    free(masks);
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -(long) (2 * rx_count * set_bytes));
+    if (error != LTCS_OK)
+    {
+        free(m_ltcs);
+        free(busy);
+        ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, 0);
+        if (error == LTCS_ERROR_CANCELED)
+        {
+            return ltcs_setError(ctx, error, "calculation canceled\n");
+        }
+        return ltcs_setError(ctx, error,
+                "Not enough free memory in findLtcs\n");
+    }
+
+    // busy time of every thread over all iterations
+    char busy_list[ERROR_SIZE];
+    int len = 0;
+    int ti;
+    for (ti = 0; ti < max_threads && len < ERROR_SIZE - 32; ti++) {
+        len += sprintf(busy_list + len, "%s%.6f", ti > 0 ? "," : "", busy[ti]);
+    }
+    busy_list[len] = '\0';
+    ltcs_telemetryEnd(ctx, "\"frontier\":%lu,\"threads\":%d,\"busy\":[%s],"
+            "\"words\":%d", m_ltcs_count, max_threads, busy_list, words);
+    free(busy);
+    *ltcs = m_ltcs;
+    *ltcs_count = m_ltcs_count;
+    return LTCS_OK;
+}
+
+/*
+ * sort by descending cardinality, sets of equal cardinality keep their order
+ */
+static int compareFixedOrder(const void* a, const void* b)
+{
+    const struct fixed_order* order_a = (const struct fixed_order*) a;
+    const struct fixed_order* order_b = (const struct fixed_order*) b;
+    if (order_a->cardinality != order_b->cardinality)
+    {
+        return order_a->cardinality > order_b->cardinality ? -1 : 1;
+    }
+    return order_a->index < order_b->index ? -1 : order_a->index >
+        order_b->index;
+}
+
+/*
+ * mark sets that are subsets of or equal to other sets in not_an_ltcs
+ * sets are visited by descending cardinality, so a set can only be a subset
+ * of a set kept before; of equal sets the first one is kept as in filterLtcs
+ */
+static int filterFixed(ltcs_context* ctx, int words, const uint64_t* ltcs,
+        unsigned long ltcs_count, char* not_an_ltcs, unsigned long* duplicates,
+        unsigned long* dominated)
+{
+    struct fixed_order* order = malloc(ltcs_count * sizeof(struct
+                fixed_order));
+    struct fixed_order* kept = malloc(ltcs_count * sizeof(struct
+                fixed_order));
+    if (NULL == order || NULL == kept)
+    {
+        free(order);
+        free(kept);
+        return LTCS_ERROR_RAM;
+    }
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_FILTER, 2 * ltcs_count * sizeof(struct
+                fixed_order));
+    unsigned long ul;
+    int k;
+    for (ul = 0; ul < ltcs_count; ul++) {
+        order[ul].cardinality = 0;
+        order[ul].index = ul;
+        for (k = 0; k < words; k++) {
+            order[ul].cardinality += __builtin_popcountll(ltcs[ul * words +
+                    k]);
+        }
+    }
+    qsort(order, ltcs_count, sizeof(struct fixed_order), compareFixedOrder);
+    unsigned long kept_count = 0;
+    *duplicates = 0;
+    *dominated = 0;
+    ltcs_telemetryProgress(ctx, 1, ltcs_count);
+    for (ul = 0; ul < ltcs_count; ul++) {
+        if (ul % FIXED_BLOCK == 0)
+        {
+            if (ltcs_isCanceled(ctx))
+            {
+                free(order);
+                free(kept);
+                return LTCS_ERROR_CANCELED;
+            }
+            ltcs_telemetryAdvance(ctx, ul > 0 ? FIXED_BLOCK : 0);
+        }
+        unsigned long index = order[ul].index;
+        unsigned long superset;
+        switch (words)
+        {
+            case 1:
+                superset = findFixedSuperset64(ltcs, index, kept, kept_count);
+                break;
+            case 2:
+                superset = findFixedSuperset128(ltcs, index, kept, kept_count);
+                break;
+            case 4:
+                superset = findFixedSuperset256(ltcs, index, kept, kept_count);
+                break;
+            default:
+                superset = findFixedSuperset512(ltcs, index, kept, kept_count);
+                break;
+        }
+        if (0 == superset)
+        {
+            kept[kept_count++] = order[ul];
+        }
+        // a superset of the same cardinality is an equal set
+        else if (kept[superset - 1].cardinality == order[ul].cardinality)
+        {
+            BITSET(not_an_ltcs, index);
+            (*duplicates)++;
+        }
+        else
+        {
+            BITSET(not_an_ltcs, index);
+            (*dominated)++;
+        }
+    }
+    free(order);
+    free(kept);
+    return LTCS_OK;
+}
+
+/*
+ * calculate all LTCS with the fixed-width kernels of the given number of
+ * words and store the results as sets of the generic kernel
+ * unless LTCS_COMPUTE_NO_FILTER is given, subsets are removed before the
+ * sets are converted, so only results are kept
+ */
+int ltcs_computeFixed(ltcs_context* ctx, int words, int threads, unsigned int
+        options)
+{
+    uint64_t* ltcs = NULL;
+    unsigned long ltcs_count = 0;
+    int rv = splitFixedFrontier(ctx, words, threads, &ltcs, &ltcs_count);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    char* not_an_ltcs = calloc(1, ltcs_getBitsize(ltcs_count) + 1);
+    if (NULL == not_an_ltcs)
+    {
+        free(ltcs);
+        ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, 0);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in filterLtcs\n");
+    }
+    if (ltcs_count > 0 && !(options & LTCS_COMPUTE_NO_FILTER))
+    {
+        ltcs_log(ctx, "filter LTCS to remove subsets");
+        ltcs_telemetryBegin(ctx, "filter");
+        ctx->frontier = ltcs_count;
+        unsigned long duplicates = 0;
+        unsigned long dominated = 0;
+        rv = filterFixed(ctx, words, ltcs, ltcs_count, not_an_ltcs,
+                &duplicates, &dominated);
+        ltcs_memorySet(ctx, LTCS_MEMORY_FILTER, 0);
+        if (rv != LTCS_OK)
+        {
+            free(ltcs);
+            free(not_an_ltcs);
+            ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, 0);
+            if (rv == LTCS_ERROR_CANCELED)
+            {
+                return ltcs_setError(ctx, rv, "calculation canceled\n");
+            }
+            return ltcs_setError(ctx, rv,
+                    "Not enough free memory in filterLtcs\n");
+        }
+        ltcs_telemetryEnd(ctx, "\"candidates\":%lu,\"duplicates\":%lu,"
+                "\"dominated\":%lu,\"results\":%lu", ltcs_count,
+                duplicates, dominated, ltcs_count - duplicates - dominated);
+    }
+
+    // convert the remaining sets byte by byte
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    ctx->ltcs = calloc(ltcs_count + 1, sizeof(char*));
+    rv = NULL == ctx->ltcs ? LTCS_ERROR_RAM : LTCS_OK;
+    unsigned long ul, uj;
+    for (ul = 0; ul < ltcs_count && rv == LTCS_OK; ul++) {
+        if (BITTEST(not_an_ltcs, ul))
+        {
+            continue;
+        }
+        char* set = calloc(1, bitarray_size);
+        if (NULL == set)
+        {
+            rv = LTCS_ERROR_RAM;
+            break;
+        }
+        const uint64_t* fixed = ltcs + ul * words;
+        for (uj = 0; uj < bitarray_size; uj++) {
+            set[uj] = (char) (fixed[uj / 8] >> (8 * (uj % 8)));
+        }
+        ctx->ltcs[ctx->ltcs_count++] = set;
+    }
+    free(ltcs);
+    free(not_an_ltcs);
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, ctx->ltcs_count *
+            ltcs_getSetBytes(ctx->efm_count));
+    if (rv != LTCS_OK)
+    {
+        return ltcs_setError(ctx, rv, "Not enough free memory\n");
+    }
+    return LTCS_OK;
+}
@@ -0,0 +1,969 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "ltcsIntern.h"
+
+#define STATE_EXCHANGE 1
+// full matrix rows of internal loops are stored as well
+#define STATE_LOOP_SIGNS 2
+
+/*
+ * FNV-1a hash of data, continuing hash
+ */
+unsigned long long ltcs_getFingerprint(const char* data, unsigned long bytes,
+        unsigned long long hash)
+{
+    unsigned long ul;
+    for (ul = 0; ul < bytes; ul++) {
+        hash ^= (unsigned char) data[ul];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * fingerprint of the cleaned matrix including the internal loops
+ * only reactions used in both directions by EFMs that are not loops are
+ * taken, as loops found while loading text EFMs can add further reactions
+ */
+static unsigned long long getMatrixFingerprint(ltcs_context* ctx)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    unsigned int clean_rx_count = ctx->clean_rx_count;
+    char* fwd = calloc(1, ltcs_getBitsize(clean_rx_count) + 1);
+    char* rev = calloc(1, ltcs_getBitsize(clean_rx_count) + 1);
+    char* row = calloc(1, ltcs_getBitsize(2 * clean_rx_count) + 1);
+    if (NULL == fwd || NULL == rev || NULL == row)
+    {
+        free(fwd);
+        free(rev);
+        free(row);
+        return 0;
+    }
+    unsigned long ul;
+    unsigned int i, j;
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (!BITTEST(ctx->loops, ul))
+        {
+            for (i = 0; i < clean_rx_count; i++) {
+                if (BITTEST(ctx->matrix[ul], 2*i))
+                {
+                    BITSET(fwd, i);
+                }
+                if (BITTEST(ctx->matrix[ul], 2*i+1))
+                {
+                    BITSET(rev, i);
+                }
+            }
+        }
+    }
+    uint64_t header[2] = {ctx->efm_count, 0};
+    for (i = 0; i < clean_rx_count; i++) {
+        if (BITTEST(fwd, i) && BITTEST(rev, i))
+        {
+            header[1]++;
+        }
+    }
+    hash = ltcs_getFingerprint((char*) header, sizeof(header), hash);
+    unsigned long row_size = ltcs_getBitsize(2 * header[1]);
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        char loop = BITTEST(ctx->loops, ul) ? 1 : 0;
+        hash = ltcs_getFingerprint(&loop, 1, hash);
+        if (loop == 0)
+        {
+            memset(row, 0, row_size);
+            for (i = 0, j = 0; i < clean_rx_count; i++) {
+                if (BITTEST(fwd, i) && BITTEST(rev, i))
+                {
+                    if (BITTEST(ctx->matrix[ul], 2*i))
+                    {
+                        BITSET(row, 2*j);
+                    }
+                    if (BITTEST(ctx->matrix[ul], 2*i+1))
+                    {
+                        BITSET(row, 2*j+1);
+                    }
+                    j++;
+                }
+            }
+            hash = ltcs_getFingerprint(row, row_size, hash);
+        }
+    }
+    free(fwd);
+    free(rev);
+    free(row);
+    return hash;
+}
+
+/*
+ * write state of a context: header, reversibility, exchange reactions (if
+ * known), loops, full matrix (one row of 2 bits per reaction for every EFM,
+ * for internal loops only if their signs are known) and LTCS
+ */
+int ltcsSaveState(ltcs_context* ctx, const char* filename)
+{
+    if (NULL == ctx->full_mat || NULL == ctx->ltcs)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "saving a state needs "
+                "calculated LTCS and the full matrix\n");
+    }
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening state file\n");
+    }
+    // states of older versions do not hold the signs of internal loops
+    int loop_signs = 1;
+    unsigned long ul;
+    for (ul = 0; ul < ctx->efm_count && loop_signs > 0; ul++) {
+        if (NULL == ctx->full_mat[ul])
+        {
+            loop_signs = 0;
+        }
+    }
+    uint32_t header[2] = {ctx->rx_count, (NULL != ctx->exchange_reaction ?
+        STATE_EXCHANGE : 0) | (loop_signs > 0 ? STATE_LOOP_SIGNS : 0)};
+    uint64_t counts[3] = {ctx->efm_count, ctx->result_count,
+        getMatrixFingerprint(ctx)};
+    double threshold = ctx->threshold;
+    fwrite(LTCS_STATE_MAGIC, 1, strlen(LTCS_STATE_MAGIC), file);
+    fwrite(header, sizeof(uint32_t), 2, file);
+    fwrite(counts, sizeof(uint64_t), 3, file);
+    fwrite(&threshold, sizeof(double), 1, file);
+    unsigned long rx_size = ltcs_getBitsize(ctx->rx_count);
+    unsigned long row_size = ltcs_getBitsize(2 * ctx->rx_count);
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    char* all_reversible = NULL;
+    const char* reversible = ctx->reversible_reactions;
+    if (NULL == reversible)
+    {
+        all_reversible = calloc(1, rx_size + 1);
+        if (NULL == all_reversible)
+        {
+            fclose(file);
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        memset(all_reversible, 0xff, rx_size);
+        reversible = all_reversible;
+    }
+    fwrite(reversible, 1, rx_size, file);
+    free(all_reversible);
+    if (NULL != ctx->exchange_reaction)
+    {
+        fwrite(ctx->exchange_reaction, 1, rx_size, file);
+    }
+    fwrite(ctx->loops, 1, bitarray_size, file);
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (loop_signs > 0 || !BITTEST(ctx->loops, ul))
+        {
+            fwrite(ctx->full_mat[ul], 1, row_size, file);
+        }
+    }
+    for (ul = 0; ul < ctx->result_count; ul++) {
+        fwrite(ctx->ltcs[ctx->result_index[ul]], 1, bitarray_size, file);
+    }
+    if (ferror(file) | fclose(file))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in writing state file\n");
+    }
+    ltcs_log(ctx, "saved state of %lu EFMs and %lu LTCS", ctx->efm_count,
+            ctx->result_count);
+    return LTCS_OK;
+}
+
+/*
+ * read a state written by ltcsSaveState
+ * a reversibility given before has to be equal to the one of the state, the
+ * cleaned matrix is built again and checked against the fingerprint
+ */
+int ltcsLoadState(ltcs_context* ctx, const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening state file\n");
+    }
+    char magic[sizeof(LTCS_STATE_MAGIC)];
+    uint32_t header[2];
+    uint64_t counts[3];
+    double threshold;
+    if (fread(magic, 1, strlen(LTCS_STATE_MAGIC), file) !=
+            strlen(LTCS_STATE_MAGIC) || memcmp(magic, LTCS_STATE_MAGIC,
+                strlen(LTCS_STATE_MAGIC)) || fread(header, sizeof(uint32_t), 2,
+                    file) != 2 || fread(counts, sizeof(uint64_t), 3, file) != 3
+            || fread(&threshold, sizeof(double), 1, file) != 1)
+    {
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in state file format\n");
+    }
+    unsigned int rx_count = header[0];
+    unsigned long efm_count = counts[0];
+    unsigned long ltcs_count = counts[1];
+    unsigned long rx_size = ltcs_getBitsize(rx_count);
+    unsigned long row_size = ltcs_getBitsize(2 * rx_count);
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+
+    // temporary context holding the full matrix of the state
+    ltcs_context* base = ltcsCreateContext();
+    char* reversible = calloc(1, rx_size + 1);
+    char* exchange = calloc(1, rx_size + 1);
+    char** ltcs = calloc(ltcs_count + 1, sizeof(char*));
+    int rv = LTCS_OK;
+    if (NULL == base || NULL == reversible || NULL == exchange || NULL == ltcs)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    else
+    {
+        base->rx_count = rx_count;
+        base->efm_count = efm_count;
+        base->loops = calloc(1, bitarray_size + 1);
+        if (NULL == base->loops)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    if (rv == LTCS_OK && (fread(reversible, 1, rx_size, file) != rx_size ||
+                ((header[1] & STATE_EXCHANGE) && fread(exchange, 1, rx_size,
+                    file) != rx_size) || fread(base->loops, 1, bitarray_size,
+                    file) != bitarray_size))
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in state file format\n");
+    }
+    if (rv == LTCS_OK)
+    {
+        base->full_mat = ltcs_allocMatrix(efm_count, row_size + 1, (header[1] &
+                    STATE_LOOP_SIGNS) ? NULL : base->loops);
+        if (NULL == base->full_mat)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    unsigned long ul;
+    for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+        if (NULL != base->full_mat[ul] && fread(base->full_mat[ul], 1,
+                    row_size, file) != row_size)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in state file format\n");
+        }
+    }
+    for (ul = 0; ul < ltcs_count && rv == LTCS_OK; ul++) {
+        ltcs[ul] = calloc(1, bitarray_size + 1);
+        if (NULL == ltcs[ul])
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+        else if (fread(ltcs[ul], 1, bitarray_size, file) != bitarray_size)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in state file format\n");
+        }
+    }
+    fclose(file);
+
+    // reversibility of the state
+    if (rv == LTCS_OK && NULL != ctx->reversible_reactions)
+    {
+        unsigned int i;
+        if (ctx->rv_count != rx_count)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "not a correct reversibility file\n");
+        }
+        for (i = 0; i < rx_count && rv == LTCS_OK; i++) {
+            if (!BITTEST(ctx->reversible_reactions, i) != !BITTEST(reversible, i))
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_ARGS, "reversibility of "
+                        "reaction %u differs from state\n", i + 1);
+            }
+        }
+    }
+    else if (rv == LTCS_OK)
+    {
+        ctx->reversible_reactions = reversible;
+        ctx->rv_count = rx_count;
+        reversible = NULL;
+    }
+    if (rv == LTCS_OK && NULL == ctx->exchange_reaction && (header[1] &
+                STATE_EXCHANGE))
+    {
+        ctx->exchange_reaction = exchange;
+        ctx->s_cols = rx_count;
+        exchange = NULL;
+    }
+
+    // build cleaned matrix and compare fingerprint
+    if (rv == LTCS_OK)
+    {
+        ctx->threshold = threshold;
+        ctx->keep_full_mat = 1;
+        rv = ltcsLoadFromContext(ctx, base, NULL);
+    }
+    if (rv == LTCS_OK && getMatrixFingerprint(ctx) != counts[2])
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "fingerprint of cleaned "
+                "matrix differs from state\n");
+    }
+    if (rv == LTCS_OK)
+    {
+        ctx->result_index = calloc(ltcs_count + 1, sizeof(unsigned long));
+        if (NULL == ctx->result_index)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        for (ul = 0; ul < ltcs_count; ul++) {
+            ctx->result_index[ul] = ul;
+        }
+        ctx->ltcs = ltcs;
+        ctx->ltcs_count = ltcs_count;
+        ctx->result_count = ltcs_count;
+        ltcs_log(ctx, "loaded state of %lu EFMs and %lu LTCS", efm_count,
+                ltcs_count);
+    }
+    else if (NULL != ltcs)
+    {
+        for (ul = 0; ul < ltcs_count; ul++) {
+            free(ltcs[ul]);
+        }
+        free(ltcs);
+    }
+    free(reversible);
+    free(exchange);
+    ltcsFreeContext(base);
+    return rv;
+}
+
+/*
+ * install sets as results of a context; the context takes over the sets and
+ * duplicates are removed by hashing
+ */
+int ltcs_setUniqueResults(ltcs_context* ctx, char** sets, unsigned long count,
+        unsigned long* duplicates)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    unsigned long table_size = 1;
+    unsigned long ul;
+    while (table_size < 2 * count + 2)
+    {
+        table_size *= 2;
+    }
+    char** table = calloc(table_size, sizeof(char*));
+    ctx->result_index = calloc(count + 1, sizeof(unsigned long));
+    if (NULL == table || NULL == ctx->result_index)
+    {
+        free(table);
+        free(ctx->result_index);
+        ctx->result_index = NULL;
+        for (ul = 0; ul < count; ul++) {
+            free(sets[ul]);
+        }
+        free(sets);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long ltcs_count = 0;
+    *duplicates = 0;
+    for (ul = 0; ul < count; ul++) {
+        char* set = sets[ul];
+        unsigned long long hash = ltcs_getFingerprint(set, bitarray_size,
+                14695981039346656037ULL);
+        unsigned long slot = hash & (table_size - 1);
+        while (NULL != table[slot] && memcmp(table[slot], set, bitarray_size))
+        {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        if (NULL != table[slot])
+        {
+            free(set);
+            (*duplicates)++;
+        }
+        else
+        {
+            table[slot] = set;
+            sets[ltcs_count] = set;
+            ctx->result_index[ltcs_count] = ltcs_count;
+            ltcs_count++;
+        }
+    }
+    free(table);
+    ctx->ltcs = sets;
+    ctx->ltcs_count = ltcs_count;
+    ctx->result_count = ltcs_count;
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, ltcs_count * ltcs_getSetBytes(
+                ctx->efm_count));
+    ltcs_memorySet(ctx, LTCS_MEMORY_OUTPUT, (count + 1) * sizeof(unsigned
+            long));
+    return LTCS_OK;
+}
+
+/*
+ * store a consistent set found by the update
+ */
+static int addFoundSet(struct update_args* args, char* set)
+{
+    if (args->found_count == args->found_size)
+    {
+        unsigned long size = args->found_size > 0 ? 2 * args->found_size : 64;
+        char** m_found = realloc(args->found, size * sizeof(char*));
+        if (NULL == m_found)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        args->found = m_found;
+        args->found_size = size;
+    }
+    args->found[args->found_count] = set;
+    args->found_count++;
+    return LTCS_OK;
+}
+
+/*
+ * split a set at every reaction (starting at given reaction) that is used
+ * in both directions by EFMs of the set; leaves are consistent and kept if
+ * they are maximal
+ * only added EFMs are checked for maximality if the leaf still contains the
+ * complete previous LTCS, as every other EFM outside of a previous LTCS
+ * conflicts with it
+ */
+static void splitSet(struct update_args* args, char* set, unsigned int reaction,
+        const char* prev)
+{
+    unsigned long bytes = args->bitarray_size;
+    unsigned int i;
+    for (i = reaction; i < args->ctx->clean_rx_count && args->error ==
+            LTCS_OK; i++) {
+        if (ltcs_bitsetIntersects(set, args->pos_mask[i], bytes) &&
+                ltcs_bitsetIntersects(set, args->neg_mask[i], bytes))
+        {
+            char* neg_set = malloc(bytes);
+            if (NULL == neg_set)
+            {
+                args->error = LTCS_ERROR_RAM;
+                break;
+            }
+            memcpy(neg_set, set, bytes);
+            ltcs_bitsetAndNot(neg_set, args->pos_mask[i], bytes);
+            ltcs_bitsetAndNot(set, args->neg_mask[i], bytes);
+            splitSet(args, neg_set, i + 1, prev);
+        }
+    }
+    if (args->error != LTCS_OK)
+    {
+        free(set);
+        return;
+    }
+
+    // check maximality of leaf
+    ltcs_context* ctx = args->ctx;
+    unsigned long start = 0;
+    const char* check = NULL;
+    if (NULL != prev && ltcs_bitsetIsSubset(prev, set, bytes))
+    {
+        start = args->first_added;
+        check = args->added;
+    }
+    ltcs_getForbiddenEfms(set, args->forbidden, args->pos_mask, args->neg_mask,
+            ctx->clean_rx_count, bytes);
+    unsigned long ul;
+    for (ul = start; ul < ctx->efm_count; ul++) {
+        if ((NULL == check || BITTEST(check, ul)) && !BITTEST(ctx->loops, ul)
+                && !BITTEST(set, ul) && !BITTEST(args->forbidden, ul))
+        {
+            free(set);
+            return;
+        }
+    }
+    if (addFoundSet(args, set) != LTCS_OK)
+    {
+        free(set);
+        args->error = LTCS_ERROR_RAM;
+    }
+}
+
+/*
+ * thread function of the incremental update
+ * every previous LTCS is extended by all added EFMs and split where they
+ * conflict
+ */
+static void* updateThread(void *pointer_update_args)
+{
+    struct update_args* args = (struct update_args*) pointer_update_args;
+    unsigned long bytes = args->bitarray_size;
+    unsigned long ul;
+    for (ul = args->thread_id; ul < args->prev_count && args->error ==
+            LTCS_OK; ul += args->max_threads) {
+        if (ltcs_isCanceled(args->ctx))
+        {
+            args->error = LTCS_ERROR_CANCELED;
+            break;
+        }
+        char* set = malloc(bytes);
+        if (NULL == set)
+        {
+            args->error = LTCS_ERROR_RAM;
+            break;
+        }
+        memcpy(set, args->prev[ul], bytes);
+        ltcs_bitsetOr(set, args->added, bytes);
+        splitSet(args, set, 0, args->prev[ul]);
+    }
+    return((void*)NULL);
+}
+
+/*
+ * update LTCS of previous EFMs after the EFMs of added (a bitset of the
+ * actual EFMs) were appended or changed
+ * every maximal consistent set of all EFMs is a subset of a previous LTCS
+ * united with the added EFMs, so only those sets are split; duplicates found
+ * from different previous LTCS are removed by hashing
+ */
+static int updateLtcs(ltcs_context* ctx, char** prev, unsigned long prev_count,
+        unsigned long old_efm_count, const char* added, int threads)
+{
+    unsigned long efm_count = ctx->efm_count;
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    unsigned long old_size = ltcs_getBitsize(old_efm_count);
+    unsigned long ul, uj;
+    int rv = LTCS_OK;
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    if (ltcs_getColumnMasks(ctx->matrix, efm_count, ctx->clean_rx_count,
+                ctx->loops, &pos_mask, &neg_mask) != LTCS_OK)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long first_added = efm_count;
+    for (ul = 0; ul < efm_count && first_added == efm_count; ul++) {
+        if (BITTEST(added, ul))
+        {
+            first_added = ul;
+        }
+    }
+
+    // extend previous LTCS to the new number of EFMs
+    for (ul = 0; ul < prev_count && rv == LTCS_OK; ul++) {
+        char* m_prev = realloc(prev[ul], bitarray_size + 1);
+        if (NULL == m_prev)
+        {
+            rv = LTCS_ERROR_RAM;
+        }
+        else
+        {
+            memset(m_prev + old_size, 0, bitarray_size + 1 - old_size);
+            prev[ul] = m_prev;
+        }
+    }
+
+    // without any previous LTCS all added EFMs are split
+    char* empty = NULL;
+    if (rv == LTCS_OK && prev_count == 0)
+    {
+        empty = calloc(1, bitarray_size + 1);
+        if (NULL == empty)
+        {
+            rv = LTCS_ERROR_RAM;
+        }
+        else
+        {
+            prev = &empty;
+            prev_count = 1;
+        }
+    }
+
+    int num_threads = threads < 1 ? 1 : threads;
+    if (num_threads > prev_count && prev_count > 0)
+    {
+        num_threads = prev_count;
+    }
+    pthread_t thread[num_threads];
+    struct update_args update_args[num_threads];
+    int ti;
+    for (ti = 0; ti < num_threads; ti++) {
+        memset(&update_args[ti], 0, sizeof(struct update_args));
+        update_args[ti].thread_id = ti;
+        update_args[ti].max_threads = num_threads;
+        update_args[ti].ctx = ctx;
+        update_args[ti].prev = prev;
+        update_args[ti].prev_count = prev_count;
+        update_args[ti].bitarray_size = bitarray_size;
+        update_args[ti].added = added;
+        update_args[ti].first_added = first_added;
+        update_args[ti].pos_mask = pos_mask;
+        update_args[ti].neg_mask = neg_mask;
+        update_args[ti].forbidden = calloc(1, bitarray_size + 1);
+        if (NULL == update_args[ti].forbidden)
+        {
+            rv = LTCS_ERROR_RAM;
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        for (ti = 0; ti < num_threads; ti++) {
+            pthread_create(&thread[ti], NULL, updateThread,
+                    (void*)&update_args[ti]);
+        }
+        for (ti = 0; ti < num_threads; ti++) {
+            pthread_join(thread[ti], NULL);
+            if (update_args[ti].error != LTCS_OK)
+            {
+                rv = update_args[ti].error;
+            }
+        }
+    }
+
+    // merge sets of threads
+    unsigned long total = 0;
+    for (ti = 0; ti < num_threads; ti++) {
+        total += update_args[ti].found_count;
+    }
+    char** found = NULL;
+    if (rv == LTCS_OK)
+    {
+        found = calloc(total + 1, sizeof(char*));
+        if (NULL == found)
+        {
+            rv = LTCS_ERROR_RAM;
+        }
+    }
+    total = 0;
+    for (ti = 0; ti < num_threads; ti++) {
+        for (uj = 0; uj < update_args[ti].found_count; uj++) {
+            if (NULL != found)
+            {
+                found[total] = update_args[ti].found[uj];
+                total++;
+            }
+            else
+            {
+                free(update_args[ti].found[uj]);
+            }
+        }
+        free(update_args[ti].found);
+        free(update_args[ti].forbidden);
+    }
+    free(empty);
+    ltcs_freeColumnMasks(pos_mask, neg_mask, ctx->clean_rx_count);
+
+    if (rv != LTCS_OK)
+    {
+        if (NULL != found)
+        {
+            for (ul = 0; ul < total; ul++) {
+                free(found[ul]);
+            }
+            free(found);
+        }
+        if (rv == LTCS_ERROR_CANCELED)
+        {
+            __atomic_store_n(&ctx->canceled, 0, __ATOMIC_RELAXED);
+            return ltcs_setError(ctx, rv, "calculation canceled\n");
+        }
+        return ltcs_setError(ctx, rv, "Not enough free memory in updateLtcs\n");
+    }
+    unsigned long duplicates = 0;
+    rv = ltcs_setUniqueResults(ctx, found, total, &duplicates);
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "%lu LTCS after update (%lu found twice)",
+                ctx->result_count, duplicates);
+    }
+    return rv;
+}
+
+/*
+ * append EFMs of a file or of memory (if filename is NULL) and update the
+ * LTCS calculated (or loaded by ltcsLoadState) before
+ */
+static int appendEfms(ltcs_context* ctx, const char* filename, const double*
+        values, unsigned long efm_count, unsigned int rx_count, int threads)
+{
+    if (NULL == ctx->ltcs || NULL == ctx->result_index)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "appending EFMs needs "
+                "calculated LTCS\n");
+    }
+
+    // detach previous LTCS
+    unsigned long prev_count = ctx->result_count;
+    char** prev = calloc(prev_count + 1, sizeof(char*));
+    if (NULL == prev)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long ul;
+    for (ul = 0; ul < prev_count; ul++) {
+        prev[ul] = ctx->ltcs[ctx->result_index[ul]];
+        ctx->ltcs[ctx->result_index[ul]] = NULL;
+    }
+    ltcs_freeResults(ctx);
+    unsigned long old_efm_count = ctx->efm_count;
+
+    int rv = ltcs_extendEfms(ctx, filename, values, efm_count, rx_count);
+    char* new_efms = NULL;
+    if (rv == LTCS_OK)
+    {
+        new_efms = calloc(1, ltcs_getBitsize(ctx->efm_count) + 1);
+        if (NULL == new_efms)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        unsigned long new_count = 0;
+        for (ul = old_efm_count; ul < ctx->efm_count; ul++) {
+            if (!BITTEST(ctx->loops, ul))
+            {
+                BITSET(new_efms, ul);
+                new_count++;
+            }
+        }
+        ltcs_log(ctx, "update %lu LTCS with %lu new EFMs", prev_count,
+                new_count);
+        rv = updateLtcs(ctx, prev, prev_count, old_efm_count, new_efms,
+                threads);
+    }
+    free(new_efms);
+    for (ul = 0; ul < prev_count; ul++) {
+        free(prev[ul]);
+    }
+    free(prev);
+    return rv;
+}
+
+int ltcsAppendEfmFile(ltcs_context* ctx, const char* filename, int threads)
+{
+    return appendEfms(ctx, filename, NULL, 0, 0, threads);
+}
+
+int ltcsAppendEfmMatrix(ltcs_context* ctx, const double* values, unsigned
+        long efm_count, unsigned int rx_count, int threads)
+{
+    return appendEfms(ctx, NULL, values, efm_count, rx_count, threads);
+}
+
+/*
+ * change the reversibility (a bitset taken over by the function) of a
+ * context with calculated LTCS and full matrix
+ * the cleaned matrix is built again from the full matrix; LTCS that were
+ * split at a reaction that is no longer reversible can merge, so the EFMs
+ * using such a reaction are added to every previous LTCS before the sets are
+ * split at the reactions that are reversible now and where the added EFMs
+ * conflict
+ */
+static int updateReversibility(ltcs_context* ctx, char* reversible, unsigned int
+        rx_count, int threads)
+{
+    if (NULL == ctx->ltcs || NULL == ctx->result_index || NULL ==
+            ctx->full_mat)
+    {
+        free(reversible);
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "changing the reversibility "
+                "needs calculated LTCS and the full matrix\n");
+    }
+    if (rx_count != ctx->rx_count)
+    {
+        free(reversible);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "not a correct reversibility file\n");
+    }
+    const char* old_reversible = ctx->reversible_reactions;
+    unsigned int* irreversible = calloc(rx_count + 1, sizeof(unsigned int));
+    char* changed = calloc(1, ltcs_getBitsize(ctx->efm_count) + 1);
+    if (NULL == irreversible || NULL == changed)
+    {
+        free(reversible);
+        free(irreversible);
+        free(changed);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int irreversible_count = 0;
+    unsigned int reversible_count = 0;
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        int was_reversible = NULL == old_reversible || BITTEST(old_reversible,
+                i) ? 1 : 0;
+        if (was_reversible > 0 && !BITTEST(reversible, i))
+        {
+            irreversible[irreversible_count++] = i;
+        }
+        else if (was_reversible == 0 && BITTEST(reversible, i))
+        {
+            reversible_count++;
+        }
+    }
+    ltcs_log(ctx, "reversibility changed: %u reactions irreversible, %u "
+            "reactions reversible", irreversible_count, reversible_count);
+    free(ctx->reversible_reactions);
+    ctx->reversible_reactions = reversible;
+    ctx->rv_count = rx_count;
+    if (irreversible_count == 0 && reversible_count == 0)
+    {
+        free(irreversible);
+        free(changed);
+        return LTCS_OK;
+    }
+
+    // EFMs using a reaction that is no longer reversible
+    unsigned long efm_count = ctx->efm_count;
+    unsigned long changed_count = 0;
+    unsigned long ul;
+    for (ul = 0; ul < efm_count; ul++) {
+        if (!BITTEST(ctx->loops, ul))
+        {
+            for (i = 0; i < irreversible_count; i++) {
+                unsigned int rx = irreversible[i];
+                if (BITTEST(ctx->full_mat[ul], 2*rx) ||
+                        BITTEST(ctx->full_mat[ul], 2*rx+1))
+                {
+                    BITSET(changed, ul);
+                    changed_count++;
+                    break;
+                }
+            }
+        }
+    }
+    free(irreversible);
+
+    // detach previous LTCS and build the cleaned matrix from the full matrix
+    // moved to a temporary context
+    unsigned long prev_count = ctx->result_count;
+    char** prev = calloc(prev_count + 1, sizeof(char*));
+    ltcs_context* base = ltcsCreateContext();
+    if (NULL == prev || NULL == base)
+    {
+        free(prev);
+        ltcsFreeContext(base);
+        free(changed);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    for (ul = 0; ul < prev_count; ul++) {
+        prev[ul] = ctx->ltcs[ctx->result_index[ul]];
+        ctx->ltcs[ctx->result_index[ul]] = NULL;
+    }
+    ltcs_freeResults(ctx);
+    base->rx_count = rx_count;
+    base->efm_count = efm_count;
+    base->full_mat = ctx->full_mat;
+    base->loops = ctx->loops;
+    ctx->full_mat = NULL;
+    ctx->loops = NULL;
+    ctx->keep_full_mat = 1;
+    int rv = ltcsLoadFromContext(ctx, base, NULL);
+    ltcsFreeContext(base);
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "update %lu LTCS with %lu EFMs of irreversible reactions",
+                prev_count, changed_count);
+        rv = updateLtcs(ctx, prev, prev_count, efm_count, changed, threads);
+    }
+    free(changed);
+    for (ul = 0; ul < prev_count; ul++) {
+        free(prev[ul]);
+    }
+    free(prev);
+    return rv;
+}
+
+int ltcsUpdateReversibility(ltcs_context* ctx, const int* reversible, unsigned
+        int rx_count, int threads)
+{
+    char* m_reversible = calloc(1, ltcs_getBitsize(rx_count) + 1);
+    if (NULL == m_reversible)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        if (reversible[i])
+        {
+            BITSET(m_reversible, i);
+        }
+    }
+    return updateReversibility(ctx, m_reversible, rx_count, threads);
+}
+
+int ltcsUpdateReversibleFile(ltcs_context* ctx, const char* filename, int
+        threads)
+{
+    // the file is read like ltcsReadReversibleFile into a temporary context
+    ltcs_context* file_ctx = ltcsCreateContext();
+    if (NULL == file_ctx)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    int rv = ltcsReadReversibleFile(file_ctx, filename);
+    if (rv != LTCS_OK || NULL == file_ctx->reversible_reactions)
+    {
+        rv = ltcs_setError(ctx, rv != LTCS_OK ? rv : LTCS_ERROR_FILE, "%s",
+                rv != LTCS_OK ? ltcsGetErrorMessage(file_ctx) :
+                "not a correct reversibility file\n");
+        ltcsFreeContext(file_ctx);
+        return rv;
+    }
+    char* reversible = file_ctx->reversible_reactions;
+    unsigned int rx_count = file_ctx->rv_count;
+    file_ctx->reversible_reactions = NULL;
+    ltcsFreeContext(file_ctx);
+    return updateReversibility(ctx, reversible, rx_count, threads);
+}
@@ -0,0 +1,389 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "ltcsIntern.h"
+
+/*
+ * set memory of an index free
+ */
+void ltcs_freeIndex(ltcs_context* ctx)
+{
+    unsigned long ul;
+    if (NULL != ctx->postings)
+    {
+        for (ul = 0; ul < ctx->index_efm_count; ul++) {
+            free(ctx->postings[ul]);
+        }
+        free(ctx->postings);
+    }
+    if (NULL != ctx->index_pos)
+    {
+        ltcs_freeColumnMasks(ctx->index_pos, ctx->index_neg,
+                ctx->index_rx_count);
+    }
+    free(ctx->index_loops);
+    free(ctx->index_cardinality);
+    ctx->postings = NULL;
+    ctx->index_pos = NULL;
+    ctx->index_neg = NULL;
+    ctx->index_loops = NULL;
+    ctx->index_cardinality = NULL;
+    ctx->index_efm_count = 0;
+    ctx->index_ltcs_count = 0;
+    ctx->index_rx_count = 0;
+}
+
+/*
+ * allocate empty index of given size
+ */
+static int allocIndex(ltcs_context* ctx, unsigned long efm_count, unsigned long
+        ltcs_count, unsigned int rx_count, int masks)
+{
+    ltcs_freeIndex(ctx);
+    unsigned long ul;
+    unsigned int i;
+    ctx->index_efm_count = efm_count;
+    ctx->index_ltcs_count = ltcs_count;
+    ctx->index_rx_count = rx_count;
+    ctx->index_loops = calloc(1, ltcs_getBitsize(efm_count) + 1);
+    ctx->index_cardinality = calloc(ltcs_count + 1, sizeof(unsigned long));
+    ctx->postings = calloc(efm_count + 1, sizeof(char*));
+    int rv = NULL == ctx->index_loops || NULL == ctx->index_cardinality ||
+        NULL == ctx->postings ? LTCS_ERROR_RAM : LTCS_OK;
+    for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+        ctx->postings[ul] = calloc(1, ltcs_getBitsize(ltcs_count) + 1);
+        if (NULL == ctx->postings[ul])
+        {
+            rv = LTCS_ERROR_RAM;
+        }
+    }
+    if (rv == LTCS_OK && masks > 0)
+    {
+        ctx->index_pos = calloc(rx_count + 1, sizeof(char*));
+        ctx->index_neg = calloc(rx_count + 1, sizeof(char*));
+        if (NULL == ctx->index_pos || NULL == ctx->index_neg)
+        {
+            free(ctx->index_pos);
+            free(ctx->index_neg);
+            ctx->index_pos = NULL;
+            ctx->index_neg = NULL;
+            rv = LTCS_ERROR_RAM;
+        }
+        for (i = 0; i < rx_count && rv == LTCS_OK; i++) {
+            ctx->index_pos[i] = calloc(1, ltcs_getBitsize(efm_count) + 1);
+            ctx->index_neg[i] = calloc(1, ltcs_getBitsize(efm_count) + 1);
+            if (NULL == ctx->index_pos[i] || NULL == ctx->index_neg[i])
+            {
+                rv = LTCS_ERROR_RAM;
+            }
+        }
+    }
+    if (rv != LTCS_OK)
+    {
+        ltcs_freeIndex(ctx);
+        return ltcs_setError(ctx, rv, "Not enough free memory\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * build index of calculated LTCS: for every EFM a bitset of the LTCS (in
+ * order of the results) containing it and for every cleaned reaction the
+ * EFMs using it in positive and in negative direction
+ */
+int ltcsBuildIndex(ltcs_context* ctx)
+{
+    if (NULL == ctx->ltcs || NULL == ctx->matrix)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "index needs calculated LTCS\n");
+    }
+    unsigned long efm_count = ctx->efm_count;
+    unsigned long ltcs_count = ctx->result_count;
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    if (ltcs_getColumnMasks(ctx->matrix, efm_count, ctx->clean_rx_count,
+                ctx->loops, &pos_mask, &neg_mask) != LTCS_OK)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    int rv = allocIndex(ctx, efm_count, ltcs_count, ctx->clean_rx_count, 0);
+    if (rv != LTCS_OK)
+    {
+        ltcs_freeColumnMasks(pos_mask, neg_mask, ctx->clean_rx_count);
+        return rv;
+    }
+    ctx->index_pos = pos_mask;
+    ctx->index_neg = neg_mask;
+    unsigned long ul, uk;
+    for (ul = 0; ul < efm_count; ul++) {
+        if (BITTEST(ctx->loops, ul))
+        {
+            BITSET(ctx->index_loops, ul);
+        }
+    }
+    for (uk = 0; uk < ltcs_count; uk++) {
+        const char* ltcs = ctx->ltcs[ctx->result_index[uk]];
+        for (ul = 0; ul < efm_count; ul++) {
+            if (BITTEST(ltcs, ul))
+            {
+                BITSET(ctx->postings[ul], uk);
+                ctx->index_cardinality[uk]++;
+            }
+        }
+    }
+    ltcs_log(ctx, "built index of %lu EFMs and %lu LTCS", efm_count,
+            ltcs_count);
+    return LTCS_OK;
+}
+
+/*
+ * write index: magic, uint64 EFM count, uint64 LTCS count, uint32 number of
+ * cleaned reactions, uint32 reserved, loops, postings of every EFM and
+ * positive and negative column mask of every cleaned reaction
+ */
+int ltcsWriteIndex(ltcs_context* ctx, const char* filename)
+{
+    int rv = LTCS_OK;
+    if (NULL == ctx->postings)
+    {
+        rv = ltcsBuildIndex(ctx);
+    }
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening index file\n");
+    }
+    uint64_t counts[2] = {ctx->index_efm_count, ctx->index_ltcs_count};
+    uint32_t header[2] = {ctx->index_rx_count, 0};
+    unsigned long efm_size = ltcs_getBitsize(ctx->index_efm_count);
+    unsigned long ltcs_size = ltcs_getBitsize(ctx->index_ltcs_count);
+    fwrite(LTCS_INDEX_MAGIC, 1, strlen(LTCS_INDEX_MAGIC), file);
+    fwrite(counts, sizeof(uint64_t), 2, file);
+    fwrite(header, sizeof(uint32_t), 2, file);
+    fwrite(ctx->index_loops, 1, efm_size, file);
+    unsigned long ul;
+    unsigned int i;
+    for (ul = 0; ul < ctx->index_efm_count; ul++) {
+        fwrite(ctx->postings[ul], 1, ltcs_size, file);
+    }
+    for (i = 0; i < ctx->index_rx_count; i++) {
+        fwrite(ctx->index_pos[i], 1, efm_size, file);
+        fwrite(ctx->index_neg[i], 1, efm_size, file);
+    }
+    if (ferror(file) | fclose(file))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in writing index file\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * read index written by ltcsWriteIndex
+ */
+int ltcsLoadIndex(ltcs_context* ctx, const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening index file\n");
+    }
+    char magic[sizeof(LTCS_INDEX_MAGIC)];
+    uint64_t counts[2];
+    uint32_t header[2];
+    if (fread(magic, 1, strlen(LTCS_INDEX_MAGIC), file) !=
+            strlen(LTCS_INDEX_MAGIC) || memcmp(magic, LTCS_INDEX_MAGIC,
+                strlen(LTCS_INDEX_MAGIC)) || fread(counts, sizeof(uint64_t), 2,
+                    file) != 2 || fread(header, sizeof(uint32_t), 2, file) != 2)
+    {
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in index file format\n");
+    }
+    int rv = allocIndex(ctx, counts[0], counts[1], header[0], 1);
+    if (rv != LTCS_OK)
+    {
+        fclose(file);
+        return rv;
+    }
+    unsigned long efm_size = ltcs_getBitsize(ctx->index_efm_count);
+    unsigned long ltcs_size = ltcs_getBitsize(ctx->index_ltcs_count);
+    unsigned long ul, uk;
+    unsigned int i;
+    int ok = fread(ctx->index_loops, 1, efm_size, file) == efm_size;
+    for (ul = 0; ul < ctx->index_efm_count && ok; ul++) {
+        ok = fread(ctx->postings[ul], 1, ltcs_size, file) == ltcs_size;
+    }
+    for (i = 0; i < ctx->index_rx_count && ok; i++) {
+        ok = fread(ctx->index_pos[i], 1, efm_size, file) == efm_size &&
+            fread(ctx->index_neg[i], 1, efm_size, file) == efm_size;
+    }
+    fclose(file);
+    if (!ok)
+    {
+        ltcs_freeIndex(ctx);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in index file format\n");
+    }
+    for (ul = 0; ul < ctx->index_efm_count; ul++) {
+        for (uk = 0; uk < ctx->index_ltcs_count; uk++) {
+            if (BITTEST(ctx->postings[ul], uk))
+            {
+                ctx->index_cardinality[uk]++;
+            }
+        }
+    }
+    ltcs_log(ctx, "loaded index of %lu EFMs and %lu LTCS", ctx->index_efm_count,
+            ctx->index_ltcs_count);
+    return LTCS_OK;
+}
+
+unsigned long ltcsGetIndexEfmCount(ltcs_context* ctx)
+{
+    return ctx->index_efm_count;
+}
+
+unsigned long ltcsGetIndexLtcsCount(ltcs_context* ctx)
+{
+    return ctx->index_ltcs_count;
+}
+
+unsigned long ltcsGetIndexCardinality(ltcs_context* ctx, unsigned long index)
+{
+    return index < ctx->index_ltcs_count ? ctx->index_cardinality[index] : 0;
+}
+
+/*
+ * a set of EFMs is consistent if it contains no internal loop and no reaction
+ * is used in both directions by EFMs of the set
+ */
+int ltcsQueryConsistent(ltcs_context* ctx, const char* set)
+{
+    unsigned long bytes = ltcs_getBitsize(ctx->index_efm_count);
+    if (ltcs_bitsetIntersects(set, ctx->index_loops, bytes))
+    {
+        return 0;
+    }
+    return ltcs_isConsistentSet(set, ctx->index_pos, ctx->index_neg,
+            ctx->index_rx_count, bytes);
+}
+
+/*
+ * mark all LTCS containing the set in result (bitset of LTCS) and return
+ * their number
+ */
+unsigned long ltcsQueryContaining(ltcs_context* ctx, const char* set, char*
+        result)
+{
+    unsigned long ltcs_count = ctx->index_ltcs_count;
+    unsigned long bytes = ltcs_getBitsize(ltcs_count);
+    unsigned long ul;
+    memset(result, 0xff, bytes);
+    for (ul = ltcs_count; ul < bytes * BITSIZE; ul++) {
+        BITCLEAR(result, ul);
+    }
+    for (ul = 0; ul < ctx->index_efm_count; ul++) {
+        if (BITTEST(set, ul))
+        {
+            unsigned long uk;
+            for (uk = 0; uk < bytes; uk++) {
+                result[uk] &= ctx->postings[ul][uk];
+            }
+        }
+    }
+    return ltcs_bitsetCount(result, bytes);
+}
+
+/*
+ * the maximal extensions of a consistent set are the LTCS containing it;
+ * write the largest one to extension (bitset of EFMs) and return its index
+ * or -1 if no LTCS contains the set
+ */
+long ltcsQueryExtension(ltcs_context* ctx, const char* set, char* extension)
+{
+    char* containing = calloc(1, ltcs_getBitsize(ctx->index_ltcs_count) + 1);
+    if (NULL == containing)
+    {
+        return -1;
+    }
+    ltcsQueryContaining(ctx, set, containing);
+    long best = -1;
+    unsigned long uk, ul;
+    for (uk = 0; uk < ctx->index_ltcs_count; uk++) {
+        if (BITTEST(containing, uk) && (best < 0 ||
+                    ctx->index_cardinality[uk] > ctx->index_cardinality[best]))
+        {
+            best = uk;
+        }
+    }
+    free(containing);
+    if (best >= 0)
+    {
+        memset(extension, 0, ltcs_getBitsize(ctx->index_efm_count));
+        for (ul = 0; ul < ctx->index_efm_count; ul++) {
+            if (BITTEST(ctx->postings[ul], best))
+            {
+                BITSET(extension, ul);
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,603 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl
+// Email: matthias.gerstl@acib.at
+// Company: Austrian Centre of Industrial Biotechnology (ACIB)
+// Web: http://www.acib.at
+// Copyright (C) 2015
+// Published unter GNU Public License V3
+//////////////////////////////////////////////////////////////////////////////////
+// Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright on
+// the Program, and are irrevocable provided the stated conditions are met.  This
+// License explicitly affirms your unlimited permission to run the unmodified
+// Program. The output from running a covered work is covered by this License only
+// if the output, given its content, constitutes a covered work. This License
+// acknowledges your rights of fair use or other equivalent, as provided by
+// copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey, without
+// conditions so long as your license otherwise remains in force. You may convey
+// covered works to others for the sole purpose of having them make modifications
+// exclusively for you, or provide you with facilities for running those works,
+// provided that you comply with the terms of this License in conveying all
+// material for which you do not control copyright. Those thus making or running
+// the covered works for you must do so exclusively on your behalf, under your
+// direction and control, on terms that prohibit them from making any copies of
+// your copyrighted material outside their relationship with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR OTHER
+// PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND, EITHER
+// EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.  THE ENTIRE RISK AS TO
+// THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.  SHOULD THE PROGRAM
+// PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR
+// CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL ANY
+// COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE PROGRAM AS
+// PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY GENERAL, SPECIAL,
+// INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE OR INABILITY TO USE
+// THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA OR DATA BEING RENDERED
+// INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD PARTIES OR A FAILURE OF THE
+// PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS), EVEN IF SUCH HOLDER OR OTHER PARTY
+// HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LTCS_INTERN_H
+#define LTCS_INTERN_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <signal.h>
+
+#include "ltcs.h"
+#include "bitmakros.h"
+
+#define BITSIZE        CHAR_BIT
+#define ERROR_SIZE     512
+#define ANALYSIS_BLOCK 64
+#define NUMA_CHUNK     16
+#define FIXED_BLOCK    4096
+// rows of an EFM matrix are stored in blocks of MATRIX_CHUNK rows
+#define MATRIX_CHUNK   65536
+#define SHARD_FACTOR   8
+// gas constant in J/(mol K)
+#define GAS_CONSTANT   8.31451
+
+struct yield_filter
+{
+    unsigned int reaction;
+    char comparison;
+    double value;
+};
+
+struct efm_range
+{
+    unsigned long first;
+    unsigned long last;
+};
+
+struct species_ref
+{
+    char* species;
+    double stoichiometry;
+};
+
+// reaction of a SBML file
+struct model_reaction
+{
+    char* id;
+    int reversible;
+    unsigned int reactant_count;
+    unsigned int product_count;
+    struct species_ref* reactants;
+    struct species_ref* products;
+};
+
+// species of a SBML file; boundary species are external
+struct model_species
+{
+    char* id;
+    char* compartment;
+    int boundary;
+};
+
+// entry of the stoichiometric matrix of a SBML model
+struct stoich_entry
+{
+    unsigned long row;
+    unsigned int column;
+    double value;
+};
+
+// dfg, charge and number of hydrogen atoms of the pseudo isomers of a
+// compound in a gibbs file
+struct gibbs_entry
+{
+    char* name;
+    unsigned int count;
+    double* dfg;
+    double* charge;
+    double* nh;
+};
+
+// name of an input line for sorting by name (of equal names the last line
+// first) and lookups
+struct name_index
+{
+    const char* name;
+    unsigned long index;
+};
+
+// logarithms of the concentration range of a species and its compound
+struct concentration
+{
+    char* species;
+    char* compound;
+    double min;
+    double max;
+};
+
+struct ltcs_context
+{
+    // settings
+    double threshold;
+    int keep_full_mat;
+    ltcs_log_callback log_callback;
+    void* log_user_data;
+    char error_message[ERROR_SIZE];
+    int canceled;
+
+    // model information
+    char* reversible_reactions;
+    unsigned int rv_count;
+    char* exchange_reaction;
+    unsigned int s_cols;
+    // a triplet list ends with its last column that has an entry, the EFMs
+    // may have more (zero) columns
+    int s_cols_open;
+    char** reaction_names;
+    unsigned int rx_names_count;
+
+    // EFM filters of the loaders: yield predicates and sorted 0-based ranges
+    // of input EFMs to load (all if none) and to skip
+    struct yield_filter* yields;
+    unsigned int yield_count;
+    struct efm_range* efm_include;
+    unsigned long include_count;
+    struct efm_range* efm_exclude;
+    unsigned long exclude_count;
+    unsigned long efm_filtered;
+
+    // thermodynamic model: reactions of the SBML file in order of the
+    // reaction file (id NULL if missing), gibbs entries and concentrations
+    // sorted by name
+    struct model_reaction* model_rx;
+    unsigned int model_rx_count;
+    struct model_species* model_species;
+    unsigned long model_species_count;
+    struct gibbs_entry* gibbs;
+    unsigned int gibbs_count;
+    struct concentration* conc;
+    unsigned int conc_count;
+    double temperature;
+    double ph;
+    double ionic_strength;
+    char* proton;
+
+    // EFMs
+    unsigned int rx_count;
+    unsigned int clean_rx_count;
+    unsigned long efm_count;
+    char** matrix;
+    char** full_mat;
+    char* loops;
+
+    // threshold sweep: per entry the sign times the number of sorted
+    // thresholds reached by its absolute value
+    signed char* sweep_classes;
+    unsigned long sweep_efm_count;
+    unsigned long sweep_filtered;
+    unsigned int sweep_rx_count;
+    double* sweep_thresholds;
+    unsigned int sweep_count;
+    int sweep_index;
+
+    // index of results: LTCS containing an EFM and column masks
+    unsigned long index_efm_count;
+    unsigned long index_ltcs_count;
+    unsigned int index_rx_count;
+    char* index_loops;
+    char** index_pos;
+    char** index_neg;
+    char** postings;
+    unsigned long* index_cardinality;
+
+    // pin threads and place sets and matrix per NUMA node
+    int numa;
+
+    // number of the shard and number of shards of a sharded calculation
+    unsigned int shard;
+    unsigned int shard_count;
+
+    // accounted bytes per category
+    unsigned long memory_limit;
+    unsigned long memory[LTCS_MEMORY_ALL];
+    unsigned long memory_used;
+    unsigned long memory_peak;
+
+    // telemetry: JSON lines of stages and iterations, progress of the
+    // running stage for snapshots
+    FILE* telemetry;
+    pthread_mutex_t telemetry_lock;
+    volatile sig_atomic_t snapshot_requested;
+    struct timespec telemetry_start;
+    struct timespec stage_start;
+    struct timespec iteration_start;
+    const char* stage;
+    unsigned int iteration;
+    unsigned int iterations;
+    unsigned long progress_total;
+    unsigned long progress_done;
+    unsigned long frontier;
+
+    // results
+    char** ltcs;
+    unsigned long ltcs_count;
+    char* not_an_ltcs;
+    unsigned long result_count;
+    unsigned long* result_index;
+};
+
+struct analysis_args
+{
+    int thread_id;
+    int max_threads;
+    ltcs_context* ctx;
+    char** pos_mask;
+    char** neg_mask;
+    unsigned long* cardinality;
+    unsigned int first_rx;
+    unsigned int block_rx;
+    double* values;
+};
+
+struct efm_loader
+{
+    unsigned long mat_ix;
+    unsigned long input_ix;
+    unsigned long capacity;
+    unsigned int rev_rx_count;
+    char* reversible;
+    int own_reversible;
+    // rows of the initial and full matrix in chunks of MATRIX_CHUNK rows
+    unsigned long row_bytes;
+    unsigned long full_bytes;
+    unsigned long chunk_count;
+    char** chunks;
+    char** full_chunks;
+    char* loops;
+    char* rxs_fwd;
+    char* rxs_rev;
+    // indices of the exchange reactions for the loop check (NULL without
+    // stoichiometric matrix)
+    unsigned int* exchange;
+    unsigned int exchange_count;
+};
+
+// receives a row of an EFM file
+typedef int (*efm_row_handler)(ltcs_context* ctx, void* target, const double*
+        values);
+
+struct numa_shared
+{
+    int node_count;
+    int* node_ids;
+    int* cpu_count;
+    int** cpus;
+    // cleaned matrix copied on every node (NULL with a single node)
+    char*** replicas;
+    unsigned long replica_bytes;
+    // ltcs created on node n are ltcs[node_first[n]] to ltcs[node_first[n+1]-1]
+    unsigned long* node_first;
+    unsigned long* node_next;
+    unsigned long local;
+    unsigned long stolen;
+    unsigned long* stat_local;
+    unsigned long* stat_remote;
+};
+
+struct replica_args
+{
+    int cpu;
+    char** mat;
+    unsigned long efm_count;
+    unsigned long row_bytes;
+    char* loops;
+    char** replica;
+    int error;
+};
+
+struct thread_args
+{
+    int max_threads;
+    int thread_id;
+    unsigned long bitarray_size;
+    unsigned long ltcs_count;
+    unsigned long efm_count;
+    unsigned int reaction;
+    char** ltcs;
+    char** matrix;
+    unsigned long* new_ltcs_count;
+    char** new_ltcs;
+    unsigned long new_ltcs_size;
+    int* canceled;
+    ltcs_context* ctx;
+    double busy;
+    struct numa_shared* numa;
+    int node;
+    int cpu;
+    unsigned long local;
+    unsigned long stolen;
+    int error;
+};
+
+struct anytime_shared
+{
+    ltcs_context* ctx;
+    double time_budget;
+    struct timespec start;
+    unsigned long efm_count;
+    unsigned int rx_count;
+    unsigned long bitarray_size;
+    char** matrix;
+    char* loops;
+    char** pos_mask;
+    char** neg_mask;
+    ltcs_anytime_callback callback;
+    void* user_data;
+    pthread_mutex_t lock;
+    unsigned long best_cardinality;
+    // hash set (open addressing) of the reported sets
+    unsigned long found_count;
+    unsigned long table_size;
+    char** found;
+    char* forbidden;
+    int error;
+};
+
+struct anytime_args
+{
+    int thread_id;
+    struct anytime_shared* shared;
+};
+
+struct update_args
+{
+    int thread_id;
+    int max_threads;
+    ltcs_context* ctx;
+    char** prev;
+    unsigned long prev_count;
+    unsigned long bitarray_size;
+    // EFMs added to every previous LTCS and the first of them
+    const char* added;
+    unsigned long first_added;
+    char* forbidden;
+    char** pos_mask;
+    char** neg_mask;
+    char** found;
+    unsigned long found_count;
+    unsigned long found_size;
+    int error;
+};
+
+struct knockout_shared
+{
+    ltcs_context* base;
+    const unsigned int* reactions;
+    unsigned int count;
+    unsigned int next;
+    int stop;
+    ltcs_knockout_callback callback;
+    void* user_data;
+    pthread_mutex_t lock;
+    int error;
+};
+
+struct estimate_args
+{
+    int thread_id;
+    unsigned long samples;
+    unsigned int rx_count;
+    unsigned long efm_count;
+    char* loops;
+    char** pos_mask;
+    char** neg_mask;
+    double* sum;
+    double* sum_sq;
+    double ltcs_sum;
+    double ltcs_sum_sq;
+    int error;
+};
+
+// DrG of a model reaction as constant + sum of coef * ln(c) of concentrations
+struct direction_row
+{
+    int use;
+    unsigned int count;
+    long* conc;
+    double* coef;
+    double constant;
+};
+
+struct feasible_args
+{
+    ltcs_context* ctx;
+    const struct direction_row* rows;
+    const double* conc_min;
+    const double* conc_max;
+    char** pos_mask;
+    char** neg_mask;
+    unsigned long max_splits;
+    unsigned long* next;
+    char* status;
+    char*** found;
+    unsigned long* found_count;
+    unsigned int* directions;
+    struct lp_problem* lp;
+    int error;
+};
+
+// feasible set for the maximality filter
+struct feasible_set
+{
+    char* set;
+    unsigned long cardinality;
+    unsigned long index;
+};
+
+// lines of a stoichiometric file parsed by one thread
+struct stoich_args
+{
+    int format;
+    double threshold;
+    const char* start;
+    const char* end;
+    // size of the matrix (0 if not given like for triplet lists)
+    unsigned long rows;
+    unsigned int cols;
+    // columns with positive and negative entries, grown for triplet lists
+    char* pos;
+    char* neg;
+    unsigned int size;
+    unsigned int max_col;
+    int error;
+    const char* error_line;
+};
+
+// functions used by several files of the library are prefixed with ltcs_,
+// all other helpers are static, so the library only exports names beginning
+// with ltcs
+
+// ltcsLoad.c
+int ltcs_setError(ltcs_context* ctx, int code, const char* format, ...);
+void ltcs_log(ltcs_context* ctx, const char* format, ...);
+unsigned long ltcs_getBitsize(unsigned long count);
+unsigned long ltcs_getChunkCount(unsigned long efm_count);
+unsigned long ltcs_getChunkRows(unsigned long chunk, unsigned long efm_count);
+char** ltcs_allocMatrix(unsigned long efm_count, unsigned long row_bytes, const
+        char* loops);
+unsigned long ltcs_estimateEfmCount(FILE* file);
+int ltcs_isCanceled(ltcs_context* ctx);
+int ltcs_extendEfms(ltcs_context* ctx, const char* filename, const double*
+        values, unsigned long efm_count, unsigned int rx_count);
+int ltcs_startLoading(ltcs_context* ctx, unsigned int rx_count, struct
+        efm_loader* loader);
+int ltcs_reserveLoading(ltcs_context* ctx, struct efm_loader* loader, unsigned
+        long efm_count);
+int ltcs_loadEfmSigns(ltcs_context* ctx, struct efm_loader* loader, const char*
+        signs, int loop);
+int ltcs_abortLoading(struct efm_loader* loader, int rv);
+int ltcs_finishLoading(ltcs_context* ctx, struct efm_loader* loader);
+int ltcs_getRxCount(FILE* file);
+int ltcs_readEfmText(ltcs_context* ctx, FILE* file, int rx_count,
+        efm_row_handler handler, void* target);
+int ltcs_openBinaryEfmFile(ltcs_context* ctx, const char* filename, FILE** file,
+        unsigned int* rx_count, unsigned long* efm_count);
+int ltcs_readEfmBinary(ltcs_context* ctx, FILE* file, unsigned int rx_count,
+        unsigned long efm_count, efm_row_handler handler, void* target);
+
+// ltcsCompute.c
+void ltcs_freeResults(ltcs_context* ctx);
+int ltcs_getColumnMasks(char** mat, unsigned long efm_count, unsigned int
+        rx_count, char* loops, char*** pos_mask, char*** neg_mask);
+void ltcs_freeColumnMasks(char** pos_mask, char** neg_mask, unsigned int
+        rx_count);
+int ltcs_isConsistentSet(const char* set, char** pos_mask, char** neg_mask,
+        unsigned int rx_count, unsigned long bitarray_size);
+void ltcs_getForbiddenEfms(const char* set, char* forbidden, char** pos_mask,
+        char** neg_mask, unsigned int rx_count, unsigned long bitarray_size);
+int ltcs_isMaximalSet(const char* set, char* forbidden, char* loops, char**
+        pos_mask, char** neg_mask, unsigned int rx_count, unsigned long
+        efm_count);
+double ltcs_getElapsedTime(struct timespec* start);
+
+// ltcsMemory.c
+void ltcs_memoryAdd(ltcs_context* ctx, int category, long bytes);
+void ltcs_memorySet(ltcs_context* ctx, int category, unsigned long bytes);
+unsigned long ltcs_getSetBytes(unsigned long efm_count);
+unsigned long ltcs_predictFrontier(char** ltcs, unsigned long ltcs_count, const
+        char* pos_mask, const char* neg_mask, unsigned long bitarray_size);
+
+// ltcsNuma.c
+int ltcs_startNuma(ltcs_context* ctx, struct numa_shared* numa, char** mat,
+        unsigned long efm_count, unsigned int rx_count, char* loops);
+void ltcs_stopNuma(ltcs_context* ctx, struct numa_shared* numa, unsigned long
+        efm_count);
+void ltcs_assignNumaThread(struct numa_shared* numa, struct thread_args* args,
+        int thread_id, int threads);
+void ltcs_pinThread(int cpu);
+
+// ltcsShard.c
+void ltcs_selectShard(ltcs_context* ctx, char** ltcs, unsigned long* ltcs_count,
+        unsigned long efm_count, unsigned int reaction);
+
+// ltcsFixed.c
+int ltcs_getFixedWords(ltcs_context* ctx, unsigned int options);
+int ltcs_computeFixed(ltcs_context* ctx, int words, int threads, unsigned int
+        options);
+
+// ltcsSelect.c
+int ltcs_isSelectedEfm(ltcs_context* ctx, unsigned long index, const double*
+        values);
+int ltcs_checkEfmFilters(ltcs_context* ctx, unsigned int rx_count);
+
+// ltcsThermo.c
+void ltcs_freeThermoModel(ltcs_context* ctx);
+int ltcs_compareGibbs(const void* key, const void* entry);
+long ltcs_findConcentration(ltcs_context* ctx, const char* species);
+int ltcs_isProton(ltcs_context* ctx, const char* species);
+double ltcs_getTransformedDfg(ltcs_context* ctx, const struct gibbs_entry*
+        entry);
+int ltcs_hasSpeciesDfg(ltcs_context* ctx, const struct species_ref* refs,
+        unsigned int count, const char* has_dfg);
+
+// ltcsTelemetry.c
+void ltcs_telemetryBegin(ltcs_context* ctx, const char* stage);
+void ltcs_telemetryEnd(ltcs_context* ctx, const char* format, ...);
+void ltcs_telemetryIteration(ltcs_context* ctx, unsigned int iteration, unsigned
+        int iterations, unsigned long frontier, double seconds, double* busy,
+        int threads);
+void ltcs_telemetryProgress(ltcs_context* ctx, unsigned int iteration, unsigned
+        long total);
+void ltcs_telemetryAdvance(ltcs_context* ctx, unsigned long done);
+
+// ltcsIndex.c
+void ltcs_freeIndex(ltcs_context* ctx);
+
+// ltcsIncremental.c
+unsigned long long ltcs_getFingerprint(const char* data, unsigned long bytes,
+        unsigned long long hash);
+int ltcs_setUniqueResults(ltcs_context* ctx, char** sets, unsigned long count,
+        unsigned long* duplicates);
+
+// bitsetFunctions.c
+unsigned long ltcs_bitsetCount(const char* a, unsigned long bytes);
+unsigned long ltcs_bitsetAndCount(const char* a, const char* b, unsigned long
+        bytes);
+int ltcs_bitsetIntersects(const char* a, const char* b, unsigned long bytes);
+int ltcs_bitsetIsSubset(const char* a, const char* b, unsigned long bytes);
+void ltcs_bitsetOr(char* dst, const char* src, unsigned long bytes);
+void ltcs_bitsetAndNot(char* dst, const char* src, unsigned long bytes);
+
+#endif
@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ltcsIntern.h"
+
+/*
+ * calculate LTCS of a reaction knockout from the LTCS of base
+ * removing EFMs keeps every subset of a LTCS consistent and every LTCS of the
+ * knockout lies in a LTCS of base, so the LTCS of the knockout are the
+ * maximal sets among the LTCS of base restricted to the remaining EFMs
+ */
+int ltcsComputeKnockout(ltcs_context* ctx, ltcs_context* base, unsigned int
+        reaction)
+{
+    if (NULL == base->full_mat || NULL == base->ltcs)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "knockout needs calculated "
+                "LTCS and the full matrix of base\n");
+    }
+    if (reaction >= base->rx_count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "knockout reaction %u does "
+                "not exist\n", reaction + 1);
+    }
+    if (NULL == ctx->reversible_reactions && NULL != base->reversible_reactions)
+    {
+        ctx->reversible_reactions = calloc(1, ltcs_getBitsize(base->rv_count) +
+                1);
+        if (NULL == ctx->reversible_reactions)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        memcpy(ctx->reversible_reactions, base->reversible_reactions,
+                ltcs_getBitsize(base->rv_count));
+        ctx->rv_count = base->rv_count;
+    }
+
+    // EFMs that do not use the reaction
+    unsigned long base_efm_count = base->efm_count;
+    char* subset = calloc(1, ltcs_getBitsize(base_efm_count) + 1);
+    unsigned long* new_index = calloc(base_efm_count + 1, sizeof(unsigned long));
+    if (NULL == subset || NULL == new_index)
+    {
+        free(subset);
+        free(new_index);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long efm_count = 0;
+    unsigned long ul, uj;
+    for (ul = 0; ul < base_efm_count; ul++) {
+        if (NULL == base->full_mat[ul])
+        {
+            free(subset);
+            free(new_index);
+            return ltcs_setError(ctx, LTCS_ERROR_ARGS, "knockout needs the "
+                    "signs of internal loops, which states of older "
+                    "versions do not hold\n");
+        }
+        if (!(BITTEST(base->full_mat[ul], 2*reaction) ||
+                    BITTEST(base->full_mat[ul], 2*reaction+1)))
+        {
+            BITSET(subset, ul);
+            new_index[ul] = efm_count;
+            efm_count++;
+        }
+    }
+    int rv = ltcsLoadFromContext(ctx, base, subset);
+    if (rv != LTCS_OK)
+    {
+        free(subset);
+        free(new_index);
+        return rv;
+    }
+
+    // restrict LTCS of base and keep maximal sets
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    char** pos_mask = NULL;
+    char** neg_mask = NULL;
+    char* forbidden = calloc(1, bitarray_size + 1);
+    char** sets = calloc(base->result_count + 1, sizeof(char*));
+    unsigned long set_count = 0;
+    if (NULL == forbidden || NULL == sets || ltcs_getColumnMasks(ctx->matrix,
+                efm_count, ctx->clean_rx_count, ctx->loops, &pos_mask,
+                &neg_mask) != LTCS_OK)
+    {
+        rv = LTCS_ERROR_RAM;
+    }
+    for (ul = 0; ul < base->result_count && rv == LTCS_OK; ul++) {
+        const char* ltcs = base->ltcs[base->result_index[ul]];
+        char* set = calloc(1, bitarray_size + 1);
+        if (NULL == set)
+        {
+            rv = LTCS_ERROR_RAM;
+            break;
+        }
+        for (uj = 0; uj < base_efm_count; uj++) {
+            if (BITTEST(ltcs, uj) && BITTEST(subset, uj))
+            {
+                BITSET(set, new_index[uj]);
+            }
+        }
+        if (ltcs_isMaximalSet(set, forbidden, ctx->loops, pos_mask, neg_mask,
+                    ctx->clean_rx_count, efm_count))
+        {
+            sets[set_count] = set;
+            set_count++;
+        }
+        else
+        {
+            free(set);
+        }
+    }
+    free(subset);
+    free(new_index);
+    free(forbidden);
+    if (NULL != pos_mask)
+    {
+        ltcs_freeColumnMasks(pos_mask, neg_mask, ctx->clean_rx_count);
+    }
+    if (rv != LTCS_OK)
+    {
+        for (ul = 0; ul < set_count; ul++) {
+            free(sets[ul]);
+        }
+        free(sets);
+        return ltcs_setError(ctx, rv,
+                "Not enough free memory in ltcsComputeKnockout\n");
+    }
+    unsigned long duplicates;
+    rv = ltcs_setUniqueResults(ctx, sets, set_count, &duplicates);
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "knockout of reaction %u: %lu of %lu EFMs, %lu LTCS",
+                reaction + 1, efm_count, base_efm_count, ctx->result_count);
+    }
+    return rv;
+}
+
+/*
+ * thread function of the knockout scan
+ * knockouts are taken from a shared counter, results are passed to the
+ * callback one at a time
+ */
+static void* knockoutThread(void *pointer_knockout_shared)
+{
+    struct knockout_shared* shared = (struct knockout_shared*)
+        pointer_knockout_shared;
+    ltcs_context* base = shared->base;
+    while (1)
+    {
+        unsigned int ix = __atomic_fetch_add(&shared->next, 1, __ATOMIC_RELAXED);
+        if (ix >= shared->count || __atomic_load_n(&shared->stop,
+                    __ATOMIC_RELAXED) || ltcs_isCanceled(base))
+        {
+            break;
+        }
+        int rv = LTCS_ERROR_RAM;
+        ltcs_context* ctx = ltcsCreateContext();
+        if (NULL != ctx)
+        {
+            ctx->threshold = base->threshold;
+            rv = ltcsComputeKnockout(ctx, base, shared->reactions[ix]);
+        }
+        pthread_mutex_lock(&shared->lock);
+        if (rv != LTCS_OK)
+        {
+            if (shared->error == LTCS_OK)
+            {
+                shared->error = ltcs_setError(base, rv, "%s", NULL != ctx ?
+                        ctx->error_message : "Not enough free memory\n");
+            }
+            __atomic_store_n(&shared->stop, 1, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            ltcs_log(base, "knockout of reaction %u: %lu EFMs, %lu LTCS",
+                    shared->reactions[ix] + 1, ctx->efm_count,
+                    ctx->result_count);
+            if (NULL != shared->callback && shared->callback(
+                        shared->reactions[ix], ctx, shared->user_data))
+            {
+                __atomic_store_n(&shared->stop, 1, __ATOMIC_RELAXED);
+            }
+        }
+        pthread_mutex_unlock(&shared->lock);
+        if (NULL != ctx)
+        {
+            ltcsFreeContext(ctx);
+        }
+    }
+    return((void*)NULL);
+}
+
+/*
+ * calculate LTCS of several reaction knockouts of base in parallel
+ */
+int ltcsKnockoutScan(ltcs_context* base, const unsigned int* reactions,
+        unsigned int count, int threads, ltcs_knockout_callback callback,
+        void* user_data)
+{
+    if (NULL == base->full_mat || NULL == base->ltcs)
+    {
+        return ltcs_setError(base, LTCS_ERROR_ARGS, "knockout needs calculated "
+                "LTCS and the full matrix\n");
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        if (reactions[i] >= base->rx_count)
+        {
+            return ltcs_setError(base, LTCS_ERROR_ARGS, "knockout reaction %u "
+                    "does not exist\n", reactions[i] + 1);
+        }
+    }
+    ltcs_log(base, "knockout scan of %u reactions", count);
+    struct knockout_shared shared;
+    memset(&shared, 0, sizeof(struct knockout_shared));
+    shared.base = base;
+    shared.reactions = reactions;
+    shared.count = count;
+    shared.callback = callback;
+    shared.user_data = user_data;
+    shared.error = LTCS_OK;
+    pthread_mutex_init(&shared.lock, NULL);
+
+    int num_threads = threads < 1 ? 1 : threads;
+    if (num_threads > count && count > 0)
+    {
+        num_threads = count;
+    }
+    pthread_t thread[num_threads];
+    int ti;
+    for (ti = 0; ti < num_threads; ti++) {
+        pthread_create(&thread[ti], NULL, knockoutThread, (void*)&shared);
+    }
+    for (ti = 0; ti < num_threads; ti++) {
+        pthread_join(thread[ti], NULL);
+    }
+    pthread_mutex_destroy(&shared.lock);
+    if (shared.error != LTCS_OK)
+    {
+        return shared.error;
+    }
+    if (ltcs_isCanceled(base))
+    {
+        __atomic_store_n(&base->canceled, 0, __ATOMIC_RELAXED);
+        return ltcs_setError(base, LTCS_ERROR_CANCELED,
+                "calculation canceled\n");
+    }
+    return LTCS_OK;
+}
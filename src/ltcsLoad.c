@@ -0,0 +1,1504 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "ltcsIntern.h"
+#include "efmMethods.c"
+
+static void freeMatrix(char** matrix, unsigned long efm_count);
+
+/*
+ * create a new context
+ */
+ltcs_context* ltcsCreateContext(void)
+{
+    ltcs_context* ctx = calloc(1, sizeof(ltcs_context));
+    if (NULL != ctx)
+    {
+        ctx->threshold = 1e-10;
+        ctx->sweep_index = -1;
+        ctx->temperature = 310.15;
+        ctx->ph = 7;
+        ctx->ionic_strength = 0.15;
+        pthread_mutex_init(&ctx->telemetry_lock, NULL);
+    }
+    return ctx;
+}
+
+/*
+ * set memory of a context free
+ */
+void ltcsFreeContext(ltcs_context* ctx)
+{
+    if (NULL == ctx)
+    {
+        return;
+    }
+    ltcs_freeResults(ctx);
+    freeMatrix(ctx->matrix, ctx->efm_count);
+    freeMatrix(ctx->full_mat, ctx->efm_count);
+    unsigned int i;
+    if (NULL != ctx->reaction_names)
+    {
+        for (i = 0; i < ctx->rx_names_count; i++) {
+            free(ctx->reaction_names[i]);
+        }
+        free(ctx->reaction_names);
+    }
+    free(ctx->loops);
+    free(ctx->exchange_reaction);
+    free(ctx->reversible_reactions);
+    free(ctx->sweep_classes);
+    free(ctx->sweep_thresholds);
+    ltcsClearEfmFilters(ctx);
+    ltcs_freeThermoModel(ctx);
+    pthread_mutex_destroy(&ctx->telemetry_lock);
+    free(ctx);
+}
+
+/*
+ * store an error message and return error code
+ */
+int ltcs_setError(ltcs_context* ctx, int code, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vsnprintf(ctx->error_message, ERROR_SIZE, format, args);
+    va_end(args);
+    return code;
+}
+
+const char* ltcsGetErrorMessage(ltcs_context* ctx)
+{
+    return ctx->error_message;
+}
+
+/*
+ * hand a progress message to the log callback
+ */
+void ltcs_log(ltcs_context* ctx, const char* format, ...)
+{
+    if (NULL == ctx->log_callback)
+    {
+        return;
+    }
+    char message[ERROR_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, ERROR_SIZE, format, args);
+    va_end(args);
+    ctx->log_callback(message, ctx->log_user_data);
+}
+
+void ltcsSetLogCallback(ltcs_context* ctx, ltcs_log_callback callback, void*
+        user_data)
+{
+    ctx->log_callback = callback;
+    ctx->log_user_data = user_data;
+}
+
+void ltcsSetThreshold(ltcs_context* ctx, double threshold)
+{
+    ctx->threshold = threshold;
+}
+
+/*
+ * keep a matrix with all reactions, needed for analysis
+ */
+void ltcsSetKeepFullMatrix(ltcs_context* ctx, int keep)
+{
+    ctx->keep_full_mat = keep;
+}
+
+void ltcsCancel(ltcs_context* ctx)
+{
+    __atomic_store_n(&ctx->canceled, 1, __ATOMIC_RELAXED);
+}
+
+int ltcs_isCanceled(ltcs_context* ctx)
+{
+    return __atomic_load_n(&ctx->canceled, __ATOMIC_RELAXED);
+}
+
+/**
+ * calculates needed number of chars for bit support of ltcs
+ */
+unsigned long ltcs_getBitsize(unsigned long count)
+{
+    unsigned long bitsize = count / BITSIZE;
+    int modulo  = count % BITSIZE;
+    if (modulo > 0)
+    {
+        bitsize++;
+    }
+    return bitsize;
+}
+
+/*
+ * number of chunks of MATRIX_CHUNK rows of an EFM matrix
+ */
+unsigned long ltcs_getChunkCount(unsigned long efm_count)
+{
+    return (efm_count + MATRIX_CHUNK - 1) / MATRIX_CHUNK;
+}
+
+/*
+ * number of rows of chunk c of a matrix with efm_count rows
+ */
+unsigned long ltcs_getChunkRows(unsigned long chunk, unsigned long efm_count)
+{
+    unsigned long first = chunk * MATRIX_CHUNK;
+    return efm_count - first < MATRIX_CHUNK ? efm_count - first : MATRIX_CHUNK;
+}
+
+/*
+ * build the rows of an EFM matrix stored in chunks
+ * the matrix holds efm_count row pointers (NULL for internal loops, none if
+ * loops is NULL) followed by the pointers of the chunks, which belong to the
+ * matrix afterwards
+ */
+static char** getChunkedMatrix(char** chunks, unsigned long efm_count, unsigned
+        long row_bytes, const char* loops)
+{
+    unsigned long chunk_count = ltcs_getChunkCount(efm_count);
+    char** matrix = calloc(efm_count + chunk_count + 1, sizeof(char*));
+    if (NULL == matrix)
+    {
+        return NULL;
+    }
+    unsigned long ul;
+    for (ul = 0; ul < efm_count; ul++) {
+        if (NULL == loops || !BITTEST(loops, ul))
+        {
+            matrix[ul] = chunks[ul / MATRIX_CHUNK] + (ul % MATRIX_CHUNK) *
+                row_bytes;
+        }
+    }
+    if (chunk_count > 0)
+    {
+        memcpy(matrix + efm_count, chunks, chunk_count * sizeof(char*));
+    }
+    return matrix;
+}
+
+/*
+ * allocate an EFM matrix with zeroed rows of row_bytes (see getChunkedMatrix)
+ */
+char** ltcs_allocMatrix(unsigned long efm_count, unsigned long row_bytes, const
+        char* loops)
+{
+    unsigned long chunk_count = ltcs_getChunkCount(efm_count);
+    char** chunks = calloc(chunk_count + 1, sizeof(char*));
+    char** matrix = NULL;
+    unsigned long uc;
+    int error = NULL == chunks ? 1 : 0;
+    for (uc = 0; uc < chunk_count && error == 0; uc++) {
+        chunks[uc] = calloc(ltcs_getChunkRows(uc, efm_count), row_bytes);
+        error = NULL == chunks[uc] ? 1 : 0;
+    }
+    if (error == 0)
+    {
+        matrix = getChunkedMatrix(chunks, efm_count, row_bytes, loops);
+    }
+    if (NULL == matrix && NULL != chunks)
+    {
+        for (uc = 0; uc < chunk_count; uc++) {
+            free(chunks[uc]);
+        }
+    }
+    free(chunks);
+    return matrix;
+}
+
+/*
+ * set memory of an EFM matrix free
+ */
+static void freeMatrix(char** matrix, unsigned long efm_count)
+{
+    if (NULL == matrix)
+    {
+        return;
+    }
+    unsigned long uc;
+    for (uc = 0; uc < ltcs_getChunkCount(efm_count); uc++) {
+        free(matrix[efm_count + uc]);
+    }
+    free(matrix);
+}
+
+/*
+ * estimate the number of EFMs of a text file by its length and the length
+ * of the first line; file has to be positioned after the first line
+ */
+unsigned long ltcs_estimateEfmCount(FILE* file)
+{
+    long first = ftell(file);
+    if (first <= 0 || fseek(file, 0, SEEK_END) != 0)
+    {
+        return 0;
+    }
+    long size = ftell(file);
+    return size > 0 ? size / first + 1 : 0;
+}
+
+/*
+ * read file containing reversibilty of reactions in form of:
+ * 1 0 0 1 1
+ * where 1 describes a reversible and 0 a non reversible reaction
+ */
+int ltcsReadReversibleFile(ltcs_context* ctx, const char* filename)
+{
+    char* line = NULL;
+    size_t len = 0;
+    int* values = NULL;
+    int count = -1;
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in opening file\n");
+    }
+    while ( getline(&line, &len, file) != -1)
+    {
+        char *saveptr;
+        char *ptr;
+        ptr = strtok_r(line, "\n\t ", &saveptr);
+        int i = 0;
+        while(ptr != NULL) 
+        {
+            int x = atoi(ptr);
+            if ((x != 0 && x != 1) || (count > -1 && i >= count))
+            {
+                free(values);
+                free(line);
+                fclose(file);
+                return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                        "not a correct reversibility file\n");
+            }
+            values = realloc(values, (i + 1) * sizeof(int));
+            values[i] = x;
+            i++;
+            ptr = strtok_r(NULL, "\n\t ", &saveptr);
+        }
+        if (count > -1 && i != count)
+        {
+            free(values);
+            free(line);
+            fclose(file);
+            return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "not a correct reversibility file\n");
+        }
+        count = i;
+    }
+    fclose(file);
+    free(line);
+    int rv = LTCS_OK;
+    if (count > 0)
+    {
+        rv = ltcsSetReversibility(ctx, values, count);
+    }
+    free(values);
+    return rv;
+}
+
+/*
+ * define reversibility of reactions: 1 reversible, 0 not reversible
+ */
+int ltcsSetReversibility(ltcs_context* ctx, const int* reversible, unsigned
+        int rx_count)
+{
+    char* m_reversible = calloc(1, ltcs_getBitsize(rx_count) + 1);
+    if (NULL == m_reversible)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        if (reversible[i])
+        {
+            BITSET(m_reversible, i);
+        }
+    }
+    free(ctx->reversible_reactions);
+    ctx->reversible_reactions = m_reversible;
+    ctx->rv_count = rx_count;
+    return LTCS_OK;
+}
+
+/*
+ * read reaction names (first line of file)
+ */
+int ltcsReadReactionFile(ltcs_context* ctx, const char* filename)
+{
+    char* line = NULL;
+    size_t len = 0;
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in opening file\n");
+    }
+    char** m_rx_names = NULL;
+    unsigned int i = 0;
+    if ( getline(&line, &len, file) != -1)
+    {
+        char *saveptr;
+        char *ptr;
+        ptr = strtok_r(line, "\"\n\t ", &saveptr);
+        while(ptr != NULL) 
+        {
+            m_rx_names = realloc(m_rx_names, (i + 1) * sizeof(char*));
+            if (NULL == m_rx_names)
+            {
+                fclose(file);
+                free(line);
+                return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                        "Not enough free memory\n");
+            }
+            m_rx_names[i] = strdup(ptr);
+            ptr = strtok_r(NULL, "\"\n\t ", &saveptr);
+            i++;
+        }
+    }
+    fclose(file);
+    free(line);
+    ctx->reaction_names = m_rx_names;
+    ctx->rx_names_count = i;
+    return LTCS_OK;
+}
+
+/*
+ * prepare loading of EFMs with given number of reactions
+ */
+int ltcs_startLoading(ltcs_context* ctx, unsigned int rx_count, struct
+        efm_loader* loader)
+{
+    if (rx_count < 1)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in EFM file format; number of reactions < 1\n");
+    }
+    if (NULL != ctx->exchange_reaction && (ctx->s_cols_open > 0 ?
+                ctx->s_cols > rx_count : ctx->s_cols != rx_count))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in EFM of "
+                "stoichiometric file format. Number of reactions is not equal\n");
+    }
+    if (NULL != ctx->reversible_reactions && ctx->rv_count != rx_count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "not a correct reversibility file\n");
+    }
+    if (NULL != ctx->reaction_names && ctx->rx_names_count != rx_count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Number of reactions in EFM "
+                "file: %u\nNumber of reactions in reaction file: %u\n"
+                "not a correct reaction file\n", rx_count, ctx->rx_names_count);
+    }
+    if (ltcs_checkEfmFilters(ctx, rx_count) != LTCS_OK)
+    {
+        return LTCS_ERROR_ARGS;
+    }
+    if (NULL != ctx->exchange_reaction && ctx->s_cols < rx_count)
+    {
+        // columns after the last entry of a triplet list are zero
+        char* exchange = realloc(ctx->exchange_reaction, ltcs_getBitsize(rx_count)
+                + 1);
+        if (NULL == exchange)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        memset(exchange + ltcs_getBitsize(ctx->s_cols) + 1, 0,
+                ltcs_getBitsize(rx_count) - ltcs_getBitsize(ctx->s_cols));
+        ctx->exchange_reaction = exchange;
+        ctx->s_cols = rx_count;
+    }
+
+    // remove EFMs of a previous load
+    ltcs_freeResults(ctx);
+    freeMatrix(ctx->matrix, ctx->efm_count);
+    freeMatrix(ctx->full_mat, ctx->efm_count);
+    free(ctx->loops);
+    ctx->matrix = NULL;
+    ctx->full_mat = NULL;
+    ctx->loops = NULL;
+    ctx->efm_count = 0;
+    ctx->clean_rx_count = 0;
+    ctx->rx_count = rx_count;
+    ctx->sweep_index = -1;
+    ctx->efm_filtered = 0;
+    ltcs_memorySet(ctx, LTCS_MEMORY_MATRIX, 0);
+
+    ltcs_log(ctx, "loading EFMs");
+    ltcs_telemetryBegin(ctx, "parse");
+    memset(loader, 0, sizeof(struct efm_loader));
+    unsigned int i;
+    loader->reversible = ctx->reversible_reactions;
+    if (NULL == loader->reversible)
+    {
+        // all reactions are reversible
+        loader->reversible = calloc(1, ltcs_getBitsize(rx_count) + 1);
+        if (NULL == loader->reversible)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        loader->own_reversible = 1;
+        for (i = 0; i < rx_count; i++) {
+            BITSET(loader->reversible, i);
+        }
+    }
+    for (i = 0; i < rx_count; i++) {
+        if (BITTEST(loader->reversible, i))
+        {
+            loader->rev_rx_count++;
+        }
+    }
+    loader->row_bytes = ltcs_getBitsize(2 * loader->rev_rx_count) + 1;
+    loader->full_bytes = ctx->keep_full_mat > 0 ? ltcs_getBitsize(2 * rx_count)
+            : 0;
+    unsigned long rxs_bitarray_size = ltcs_getBitsize(loader->rev_rx_count) + 1;
+    loader->rxs_fwd = calloc(1, rxs_bitarray_size);
+    loader->rxs_rev = calloc(1, rxs_bitarray_size);
+    int exchange_error = 0;
+    if (NULL != ctx->exchange_reaction)
+    {
+        // one more index than needed, the list is not NULL without exchange
+        // reactions (all EFMs are loops then)
+        loader->exchange = malloc((ltcs_bitsetCount(ctx->exchange_reaction,
+                        ltcs_getBitsize(rx_count)) + 1) * sizeof(unsigned int));
+        exchange_error = NULL == loader->exchange ? 1 : 0;
+        for (i = 0; i < rx_count && exchange_error == 0; i++) {
+            if (BITTEST(ctx->exchange_reaction, i))
+            {
+                loader->exchange[loader->exchange_count++] = i;
+            }
+        }
+    }
+    if (NULL == loader->rxs_fwd || NULL == loader->rxs_rev || exchange_error >
+            0)
+    {
+        free(loader->rxs_fwd);
+        free(loader->rxs_rev);
+        free(loader->exchange);
+        if (loader->own_reversible > 0)
+        {
+            free(loader->reversible);
+        }
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * resize the last chunk of the initial (and full) matrix to the rows it holds
+ * with the given capacity; added rows are zeroed
+ */
+static int resizeLastChunk(ltcs_context* ctx, struct efm_loader* loader,
+        unsigned long capacity)
+{
+    if (loader->chunk_count == 0)
+    {
+        return LTCS_OK;
+    }
+    unsigned long uc = loader->chunk_count - 1;
+    unsigned long old_rows = ltcs_getChunkRows(uc, loader->capacity);
+    unsigned long new_rows = ltcs_getChunkRows(uc, capacity);
+    if (old_rows == new_rows)
+    {
+        return LTCS_OK;
+    }
+    char* chunk = realloc(loader->chunks[uc], new_rows * loader->row_bytes);
+    if (NULL == chunk)
+    {
+        return LTCS_ERROR_RAM;
+    }
+    loader->chunks[uc] = chunk;
+    if (new_rows > old_rows)
+    {
+        memset(chunk + old_rows * loader->row_bytes, 0, (new_rows - old_rows) *
+                loader->row_bytes);
+    }
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, ((long) new_rows - (long) old_rows)
+            * (long) loader->row_bytes);
+    if (NULL != loader->full_chunks)
+    {
+        chunk = realloc(loader->full_chunks[uc], new_rows *
+                loader->full_bytes);
+        if (NULL == chunk)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        loader->full_chunks[uc] = chunk;
+        if (new_rows > old_rows)
+        {
+            memset(chunk + old_rows * loader->full_bytes, 0, (new_rows -
+                        old_rows) * loader->full_bytes);
+        }
+        ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, ((long) new_rows - (long)
+                old_rows) * (long) loader->full_bytes);
+    }
+    return LTCS_OK;
+}
+
+/*
+ * reserve memory for efm_count EFMs in the loader, e.g. given by the header
+ * of a binary file or estimated by the length of a text file
+ */
+int ltcs_reserveLoading(ltcs_context* ctx, struct efm_loader* loader, unsigned
+        long efm_count)
+{
+    if (efm_count <= loader->capacity)
+    {
+        return LTCS_OK;
+    }
+    unsigned long chunk_count = ltcs_getChunkCount(efm_count);
+    unsigned long loop_bytes = NULL != loader->loops ?
+        ltcs_getBitsize(loader->capacity) + 1 : 0;
+    char* m_loops = (char*) realloc(loader->loops, ltcs_getBitsize(efm_count) +
+            1);
+    if (NULL != m_loops)
+    {
+        memset(m_loops + loop_bytes, 0, ltcs_getBitsize(efm_count) + 1 -
+                loop_bytes);
+        loader->loops = m_loops;
+    }
+    char** m_chunks = (char**) realloc(loader->chunks, (chunk_count + 1) *
+            sizeof(char*));
+    if (NULL != m_chunks)
+    {
+        loader->chunks = m_chunks;
+    }
+    char** m_full_chunks = loader->full_chunks;
+    if (loader->full_bytes > 0)
+    {
+        m_full_chunks = (char**) realloc(loader->full_chunks, (chunk_count +
+                    1) * sizeof(char*));
+        if (NULL != m_full_chunks)
+        {
+            loader->full_chunks = m_full_chunks;
+        }
+    }
+    if (NULL == m_loops || NULL == m_chunks || (loader->full_bytes > 0 &&
+                NULL == m_full_chunks) || resizeLastChunk(ctx, loader,
+                efm_count) != LTCS_OK)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                "Not enough free memory in reserveLoading\n");
+    }
+    loader->capacity = efm_count;
+    return LTCS_OK;
+}
+
+/*
+ * rows of the initial and full matrix for the next EFM of the loader; a new
+ * chunk is allocated for every MATRIX_CHUNK rows, the capacity is doubled if
+ * it is reached
+ */
+static int getLoaderRows(ltcs_context* ctx, struct efm_loader* loader, char**
+        row, char** full)
+{
+    unsigned long mat_ix = loader->mat_ix;
+    int rv = LTCS_OK;
+    if (mat_ix == loader->capacity)
+    {
+        rv = ltcs_reserveLoading(ctx, loader, 2 * loader->capacity + 1024);
+    }
+    unsigned long uc = mat_ix / MATRIX_CHUNK;
+    if (rv == LTCS_OK && mat_ix % MATRIX_CHUNK == 0)
+    {
+        unsigned long rows = ltcs_getChunkRows(uc, loader->capacity);
+        loader->chunks[uc] = calloc(rows, loader->row_bytes);
+        if (NULL != loader->full_chunks)
+        {
+            loader->full_chunks[uc] = calloc(rows, loader->full_bytes);
+        }
+        if (NULL != loader->chunks[uc])
+        {
+            loader->chunk_count++;
+        }
+        if (NULL == loader->chunks[uc] || (NULL != loader->full_chunks &&
+                    NULL == loader->full_chunks[uc]))
+        {
+            if (NULL != loader->full_chunks)
+            {
+                free(loader->full_chunks[uc]);
+                loader->full_chunks[uc] = NULL;
+            }
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory in getLoaderRows\n");
+        }
+        else
+        {
+            ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, rows * (loader->row_bytes +
+                        loader->full_bytes));
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        unsigned long offset = mat_ix % MATRIX_CHUNK;
+        *row = loader->chunks[uc] + offset * loader->row_bytes;
+        *full = NULL != loader->full_chunks ? loader->full_chunks[uc] + offset
+            * loader->full_bytes : NULL;
+    }
+    return rv;
+}
+
+/*
+ * stores an EFM into a bitset if it is not an internal loop
+ * every reaction is mapped to two bits
+ * first bit is if reaction has a positive flux
+ * second bit is set if reaction has a negative flux
+ * none is set if reaction has no flux
+ * only reversible reactions are stored, all reactions are stored in addition
+ * if the full matrix is kept; EFMs removed by the EFM filters are skipped
+ */
+static int loadEfm (ltcs_context* ctx, struct efm_loader* loader, const double*
+        values)
+{
+    if (!ltcs_isSelectedEfm(ctx, loader->input_ix++, values))
+    {
+        ltcs_telemetryAdvance(ctx, 1);
+        ctx->efm_filtered++;
+        return LTCS_OK;
+    }
+    char* matrix;
+    char* full;
+    int rv = getLoaderRows(ctx, loader, &matrix, &full);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    unsigned long mat_ix = loader->mat_ix;
+    ltcs_telemetryAdvance(ctx, 1);
+    double threshold = ctx->threshold;
+    double n_thres = -1 * threshold;
+    unsigned int i;
+    unsigned int j = 0;
+    if (NULL != loader->exchange)
+    {
+        // EFM is an internal loop if no exchange reaction has a flux - its
+        // (zeroed) rows are not used
+        int loop = 1;
+        for (i = 0; i < loader->exchange_count && loop > 0; i++) {
+            double x = values[loader->exchange[i]];
+            if (x >= threshold || x <= n_thres)
+            {
+                loop = 0;
+            }
+        }
+        if (loop > 0)
+        {
+            // signs of a loop are only kept in the full matrix
+            for (i = 0; NULL != full && i < ctx->rx_count; i++) {
+                if (values[i] >= threshold)
+                {
+                    BITSET(full, 2*i);
+                }
+                else if (values[i] <= n_thres)
+                {
+                    BITSET(full, (2*i)+1);
+                }
+            }
+            BITSET(loader->loops, mat_ix);
+            loader->mat_ix++;
+            return LTCS_OK;
+        }
+    }
+    for (i = 0; i < ctx->rx_count; i++)
+    {
+        double x = values[i];
+        if (NULL != full)
+        {
+            if (x >= threshold)
+            {
+                BITSET(full, 2*i);
+            }
+            else if (x <= n_thres)
+            {
+                BITSET(full, (2*i)+1);
+            }
+        }
+        if (BITTEST(loader->reversible,i))
+        {
+            // positive flux
+            if (x >= threshold)
+            {
+                BITSET(matrix, 2*j);
+                BITSET(loader->rxs_fwd,j);
+            }
+            // negative flux
+            else if (x <= n_thres)
+            {
+                BITSET(matrix, (2*j)+1);
+                BITSET(loader->rxs_rev, j);
+            }
+            j++;
+        }
+    }
+    BITCLEAR(loader->loops, mat_ix);
+    loader->mat_ix++;
+    return LTCS_OK;
+}
+
+/*
+ * row handler of the EFM readers that stores an EFM into the loader
+ */
+static int loadEfmRow(ltcs_context* ctx, void* loader, const double* values)
+{
+    return loadEfm(ctx, (struct efm_loader*) loader, values);
+}
+
+/*
+ * stores an EFM given as sign vector of all reactions (two bits per reaction
+ * like in the full matrix); loop defines if the EFM is an internal loop, its
+ * signs (may be NULL) are only kept in the full matrix
+ */
+int ltcs_loadEfmSigns (ltcs_context* ctx, struct efm_loader* loader, const char*
+        signs, int loop)
+{
+    char* matrix;
+    char* full;
+    int rv = getLoaderRows(ctx, loader, &matrix, &full);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    unsigned long mat_ix = loader->mat_ix;
+    ltcs_telemetryAdvance(ctx, 1);
+    if (NULL != full && NULL != signs)
+    {
+        memcpy(full, signs, loader->full_bytes);
+    }
+    if (loop > 0)
+    {
+        BITSET(loader->loops, mat_ix);
+        loader->mat_ix++;
+        return LTCS_OK;
+    }
+    unsigned int i;
+    unsigned int j = 0;
+    for (i = 0; i < ctx->rx_count; i++)
+    {
+        if (BITTEST(loader->reversible,i))
+        {
+            if (BITTEST(signs, 2*i))
+            {
+                BITSET(matrix, 2*j);
+                BITSET(loader->rxs_fwd,j);
+            }
+            else if (BITTEST(signs, 2*i+1))
+            {
+                BITSET(matrix, (2*j)+1);
+                BITSET(loader->rxs_rev, j);
+            }
+            j++;
+        }
+    }
+    BITCLEAR(loader->loops, mat_ix);
+    loader->mat_ix++;
+    return LTCS_OK;
+}
+
+/*
+ * clean matrix
+ * keep only those reactions that have a positive and a negative flux in any of
+ * the EFMs
+ */
+static int getCleanedMatrix(char **initial_mat, unsigned long efms, unsigned int
+        init_rx_count, char ***cleaned_mat, char *rxs_both, unsigned int
+        result_rx_count, char* loops) {
+    unsigned int i;
+    unsigned int j;
+    unsigned long ul;
+    char **m_cleaned_mat = ltcs_allocMatrix(efms, ltcs_getBitsize(2 *
+            result_rx_count) + 1, loops);
+    if (NULL == m_cleaned_mat)
+    {
+        return LTCS_ERROR_RAM;
+    }
+    for (ul = 0; ul < efms; ul++) 
+    {
+        if (!BITTEST(loops, ul))
+        {
+            j = 0;
+            for (i = 0; i < init_rx_count; i++) 
+            {
+                if (BITTEST(rxs_both,i))
+                {
+                    if (BITTEST(initial_mat[ul], 2*i))
+                    {
+                        BITSET(m_cleaned_mat[ul], j);
+                    }
+                    j++;
+                    if (BITTEST(initial_mat[ul], 2*i+1))
+                    {
+                        BITSET(m_cleaned_mat[ul], j);
+                    }
+                    j++;
+                }
+            }
+        }
+    }
+    *cleaned_mat = m_cleaned_mat;
+    return LTCS_OK;
+}
+
+/*
+ * set memory of a failed load free
+ */
+int ltcs_abortLoading(struct efm_loader* loader, int rv)
+{
+    unsigned long uc;
+    for (uc = 0; uc < loader->chunk_count; uc++) {
+        free(loader->chunks[uc]);
+        if (NULL != loader->full_chunks)
+        {
+            free(loader->full_chunks[uc]);
+        }
+    }
+    free(loader->chunks);
+    free(loader->full_chunks);
+    free(loader->loops);
+    free(loader->rxs_fwd);
+    free(loader->rxs_rev);
+    free(loader->exchange);
+    if (loader->own_reversible > 0)
+    {
+        free(loader->reversible);
+    }
+    return rv;
+}
+
+/*
+ * clean matrix by removing reactions that have a flux in only one direction
+ * and store EFMs in context
+ */
+int ltcs_finishLoading(ltcs_context* ctx, struct efm_loader* loader)
+{
+    unsigned long mat_ix = loader->mat_ix;
+    char* m_loops = (char*) realloc(loader->loops, ltcs_getBitsize(mat_ix) + 1);
+    if (NULL != m_loops)
+    {
+        loader->loops = m_loops;
+    }
+    if (resizeLastChunk(ctx, loader, mat_ix) == LTCS_OK)
+    {
+        loader->capacity = mat_ix;
+    }
+    char** full_mat = NULL;
+    char** initial_mat = getChunkedMatrix(loader->chunks, mat_ix,
+            loader->row_bytes, loader->loops);
+    if (NULL != initial_mat && NULL != loader->full_chunks)
+    {
+        // the full matrix keeps the signs of internal loops as well
+        full_mat = getChunkedMatrix(loader->full_chunks, mat_ix,
+                loader->full_bytes, NULL);
+        if (NULL == full_mat)
+        {
+            free(initial_mat);
+            initial_mat = NULL;
+        }
+    }
+    if (NULL == initial_mat)
+    {
+        return ltcs_abortLoading(loader, ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n"));
+    }
+    // chunks belong to the matrices now
+    free(loader->chunks);
+    free(loader->full_chunks);
+    loader->chunks = NULL;
+    loader->full_chunks = NULL;
+    loader->chunk_count = 0;
+
+    // define reactions that have a flux in both directions
+    unsigned long rxs_bitarray_size = ltcs_getBitsize(loader->rev_rx_count) + 1;
+    char* rxs_both = calloc(1, rxs_bitarray_size);
+    if (NULL == rxs_both)
+    {
+        freeMatrix(initial_mat, mat_ix);
+        freeMatrix(full_mat, mat_ix);
+        return ltcs_abortLoading(loader, ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n"));
+    }
+    unsigned int i = 0;
+    unsigned int result_rx_count = 0;
+    for (i = 0; i < loader->rev_rx_count; i++) 
+    {
+        if (BITTEST(loader->rxs_fwd,i) && BITTEST(loader->rxs_rev,i))
+        {
+            BITSET(rxs_both,i);
+            result_rx_count++;
+        }
+    }
+    free(loader->rxs_fwd);
+    free(loader->rxs_rev);
+    free(loader->exchange);
+    loader->rxs_fwd = NULL;
+    loader->rxs_rev = NULL;
+    loader->exchange = NULL;
+    if (loader->own_reversible > 0)
+    {
+        free(loader->reversible);
+    }
+
+    // clean matrix by removing reactions that are active in only one direction
+    if (ctx->efm_filtered > 0)
+    {
+        ltcs_log(ctx, "%lu of %lu EFMs removed by EFM filters",
+                ctx->efm_filtered, ctx->efm_filtered + mat_ix);
+    }
+    ltcs_telemetryEnd(ctx, "\"efms\":%lu,\"reactions\":%u,\"filtered\":%lu",
+            mat_ix, ctx->rx_count, ctx->efm_filtered);
+    ltcs_log(ctx, "optimizating EFM matrix");
+    ltcs_telemetryBegin(ctx, "clean");
+    char** cleaned_mat = NULL;
+    int rv = getCleanedMatrix(initial_mat, mat_ix, loader->rev_rx_count,
+            &cleaned_mat, rxs_both, result_rx_count, loader->loops);
+    free(rxs_both);
+    freeMatrix(initial_mat, mat_ix);
+    if (rv != LTCS_OK)
+    {
+        freeMatrix(full_mat, mat_ix);
+        free(loader->loops);
+        return ltcs_setError(ctx, rv,
+                "Not enough free memory in getCleanedMatrix\n");
+    }
+
+    ctx->matrix = cleaned_mat;
+    ctx->full_mat = full_mat;
+    ctx->loops = loader->loops;
+    ctx->efm_count = mat_ix;
+    ctx->clean_rx_count = result_rx_count;
+
+    // cleaned and full matrix replace the initial matrix
+    unsigned long pointers = mat_ix + ltcs_getChunkCount(mat_ix) + 1;
+    unsigned long bytes = ltcs_getBitsize(mat_ix) + 1 + pointers * sizeof(char*)
+        + mat_ix * (ltcs_getBitsize(2 * result_rx_count) + 1);
+    if (NULL != ctx->full_mat)
+    {
+        bytes += pointers * sizeof(char*) + mat_ix * loader->full_bytes;
+    }
+    ltcs_memorySet(ctx, LTCS_MEMORY_MATRIX, bytes);
+    ltcs_telemetryEnd(ctx, "\"reactions\":%u", result_rx_count);
+    return LTCS_OK;
+}
+
+/*
+ * read EFMs of a text file and hand them to the loader
+ */
+int ltcs_readEfmText(ltcs_context* ctx, FILE* file, int rx_count,
+        efm_row_handler handler, void* target)
+{
+    int rv = LTCS_OK;
+    double* values = calloc(rx_count, sizeof(double));
+    if (NULL == values)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    char* line = NULL;
+    size_t len = 0;
+    unsigned long line_nr = 0;
+    while ( getline(&line, &len, file) != -1)
+    {
+        line_nr++;
+        char *saveptr;
+        char *ptr;
+        ptr = strtok_r(line, "\n\t ", &saveptr);
+        int i = 0;
+        memset(values, 0, rx_count * sizeof(double));
+        while(ptr != NULL) 
+        {
+            if (i >= rx_count)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in EFM file "
+                        "format; line %lu has more than %d values\n",
+                        line_nr, rx_count);
+                break;
+            }
+            values[i] = atof(ptr);
+            i++;
+            ptr = strtok_r(NULL, "\n\t ", &saveptr);
+        }
+        if (rv == LTCS_OK)
+        {
+            rv = handler(ctx, target, values);
+        }
+        if (rv != LTCS_OK)
+        {
+            break;
+        }
+    }
+    free(line);
+    free(values);
+    return rv;
+}
+
+/*
+ * open binary EFM file (see LTCS_BINARY_MAGIC) and read its header
+ */
+int ltcs_openBinaryEfmFile(ltcs_context* ctx, const char* filename, FILE** file,
+        unsigned int* rx_count, unsigned long* efm_count)
+{
+    FILE* m_file = fopen(filename, "rb");
+    if (!m_file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening input file\n");
+    }
+    char magic[sizeof(LTCS_BINARY_MAGIC)];
+    uint64_t count = 0;
+    uint32_t header[2] = {0, 0};
+    if (fread(magic, 1, strlen(LTCS_BINARY_MAGIC), m_file) !=
+            strlen(LTCS_BINARY_MAGIC) || memcmp(magic, LTCS_BINARY_MAGIC,
+                strlen(LTCS_BINARY_MAGIC)) || fread(&count, sizeof(count), 1,
+                    m_file) != 1 || fread(header, sizeof(uint32_t), 2, m_file)
+            != 2)
+    {
+        fclose(m_file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in binary EFM file format\n");
+    }
+    *file = m_file;
+    *rx_count = header[0];
+    *efm_count = count;
+    return LTCS_OK;
+}
+
+/*
+ * read EFMs of an opened binary file and hand them to the loader
+ */
+int ltcs_readEfmBinary(ltcs_context* ctx, FILE* file, unsigned int rx_count,
+        unsigned long efm_count, efm_row_handler handler, void* target)
+{
+    int rv = LTCS_OK;
+    double* values = calloc(rx_count, sizeof(double));
+    if (NULL == values)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long ul;
+    for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+        if (fread(values, sizeof(double), rx_count, file) != rx_count)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in binary EFM "
+                    "file format; file contains less than %lu EFMs\n",
+                    efm_count);
+        }
+        else
+        {
+            rv = handler(ctx, target, values);
+        }
+    }
+    free(values);
+    return rv;
+}
+
+/*
+ * read EFM file
+ * store EFMs in bit vectors
+ * clean matrix by removing reactions that have a flux in only one direction
+ * store internal loops in EFMs
+ */
+int ltcsLoadEfmFile(ltcs_context* ctx, const char* filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening input file\n");
+    }
+    int rx_count = ltcs_getRxCount(file);
+    unsigned long estimate = ltcs_estimateEfmCount(file);
+    rewind(file);
+    struct efm_loader loader;
+    int rv = ltcs_startLoading(ctx, rx_count, &loader);
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_reserveLoading(ctx, &loader, estimate);
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_readEfmText(ctx, file, rx_count, loadEfmRow, &loader);
+        if (rv != LTCS_OK)
+        {
+            ltcs_abortLoading(&loader, rv);
+        }
+    }
+    fclose(file);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    return ltcs_finishLoading(ctx, &loader);
+}
+
+/*
+ * check if file starts with magic of binary EFM files
+ */
+int ltcsIsBinaryEfmFile(const char* filename)
+{
+    char magic[sizeof(LTCS_BINARY_MAGIC)];
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+    {
+        return 0;
+    }
+    size_t n = fread(magic, 1, strlen(LTCS_BINARY_MAGIC), file);
+    fclose(file);
+    return n == strlen(LTCS_BINARY_MAGIC) && !memcmp(magic,
+            LTCS_BINARY_MAGIC, n);
+}
+
+/*
+ * read binary EFM file (see LTCS_BINARY_MAGIC)
+ */
+int ltcsLoadBinaryEfmFile(ltcs_context* ctx, const char* filename)
+{
+    FILE *file = NULL;
+    unsigned int rx_count = 0;
+    unsigned long efm_count = 0;
+    int rv = ltcs_openBinaryEfmFile(ctx, filename, &file, &rx_count,
+            &efm_count);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    struct efm_loader loader;
+    rv = ltcs_startLoading(ctx, rx_count, &loader);
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_reserveLoading(ctx, &loader, efm_count);
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_readEfmBinary(ctx, file, rx_count, efm_count, loadEfmRow,
+                &loader);
+        if (rv != LTCS_OK)
+        {
+            ltcs_abortLoading(&loader, rv);
+        }
+    }
+    fclose(file);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    return ltcs_finishLoading(ctx, &loader);
+}
+
+/*
+ * load EFMs from memory; values are given row by row (one EFM per row)
+ */
+int ltcsLoadEfmMatrix(ltcs_context* ctx, const double* values, unsigned long
+        efm_count, unsigned int rx_count)
+{
+    struct efm_loader loader;
+    int rv = ltcs_startLoading(ctx, rx_count, &loader);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    rv = ltcs_reserveLoading(ctx, &loader, efm_count);
+    unsigned long ul;
+    for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+        rv = loadEfm(ctx, &loader, values + ul * rx_count);
+    }
+    if (rv != LTCS_OK)
+    {
+        return ltcs_abortLoading(&loader, rv);
+    }
+    return ltcs_finishLoading(ctx, &loader);
+}
+
+/*
+ * append EFMs of a file (text or binary) or of memory (if filename is NULL)
+ * to the loaded EFMs; needs the full matrix of the loaded EFMs, which is
+ * read again instead of the EFM file, and cleans the combined matrix
+ * results of ctx are set free
+ */
+int ltcs_extendEfms(ltcs_context* ctx, const char* filename, const double*
+        values, unsigned long efm_count, unsigned int rx_count)
+{
+    if (NULL == ctx->full_mat)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "appending EFMs needs the full matrix\n");
+    }
+    FILE* file = NULL;
+    int binary = 0;
+    int rv = LTCS_OK;
+    if (NULL != filename)
+    {
+        binary = ltcsIsBinaryEfmFile(filename);
+        if (binary > 0)
+        {
+            rv = ltcs_openBinaryEfmFile(ctx, filename, &file, &rx_count,
+                    &efm_count);
+        }
+        else
+        {
+            file = fopen(filename, "r");
+            if (!file)
+            {
+                return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                        "Error in opening input file\n");
+            }
+            rx_count = ltcs_getRxCount(file);
+            efm_count = ltcs_estimateEfmCount(file);
+            rewind(file);
+        }
+    }
+    if (rv == LTCS_OK && rx_count != ctx->rx_count)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Number of reactions of new "
+                "EFMs (%u) differs from loaded EFMs (%u)\n", rx_count,
+                ctx->rx_count);
+    }
+    if (rv != LTCS_OK)
+    {
+        if (NULL != file)
+        {
+            fclose(file);
+        }
+        return rv;
+    }
+
+    // detach loaded EFMs, they are loaded again from the full matrix
+    char** old_full = ctx->full_mat;
+    char* old_loops = ctx->loops;
+    unsigned long old_count = ctx->efm_count;
+    freeMatrix(ctx->matrix, ctx->efm_count);
+    ctx->matrix = NULL;
+    ctx->full_mat = NULL;
+    ctx->loops = NULL;
+    ctx->efm_count = 0;
+    ctx->keep_full_mat = 1;
+    struct efm_loader loader;
+    rv = ltcs_startLoading(ctx, rx_count, &loader);
+    int started = rv == LTCS_OK ? 1 : 0;
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_reserveLoading(ctx, &loader, old_count + efm_count);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < old_count && rv == LTCS_OK; ul++) {
+        int loop = BITTEST(old_loops, ul) ? 1 : 0;
+        rv = ltcs_loadEfmSigns(ctx, &loader, old_full[ul], loop);
+    }
+    freeMatrix(old_full, old_count);
+    free(old_loops);
+    if (rv == LTCS_OK && NULL == filename)
+    {
+        for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+            rv = loadEfm(ctx, &loader, values + ul * rx_count);
+        }
+    }
+    else if (rv == LTCS_OK && binary > 0)
+    {
+        rv = ltcs_readEfmBinary(ctx, file, rx_count, efm_count, loadEfmRow,
+                &loader);
+    }
+    else if (rv == LTCS_OK)
+    {
+        rv = ltcs_readEfmText(ctx, file, rx_count, loadEfmRow, &loader);
+    }
+    if (started > 0 && rv != LTCS_OK)
+    {
+        ltcs_abortLoading(&loader, rv);
+    }
+    if (NULL != file)
+    {
+        fclose(file);
+    }
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    return ltcs_finishLoading(ctx, &loader);
+}
+
+/*
+ * load EFMs from the full matrix of an already loaded context (see
+ * ltcsSetKeepFullMatrix) using the reversibility of ctx instead of reading
+ * and cleaning the EFMs again; if subset is given (bitset over EFMs of base)
+ * only those EFMs are loaded and numbered in the order of base
+ */
+int ltcsLoadFromContext(ltcs_context* ctx, ltcs_context* base, const char*
+        subset)
+{
+    if (NULL == base->full_mat)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "base context does not keep the full matrix\n");
+    }
+    struct efm_loader loader;
+    int rv = ltcs_startLoading(ctx, base->rx_count, &loader);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    rv = ltcs_reserveLoading(ctx, &loader, base->efm_count);
+    unsigned long ul;
+    for (ul = 0; ul < base->efm_count && rv == LTCS_OK; ul++) {
+        if (NULL == subset || BITTEST(subset, ul))
+        {
+            int loop = BITTEST(base->loops, ul) ? 1 : 0;
+            rv = ltcs_loadEfmSigns(ctx, &loader, base->full_mat[ul], loop);
+        }
+    }
+    if (rv != LTCS_OK)
+    {
+        return ltcs_abortLoading(&loader, rv);
+    }
+    return ltcs_finishLoading(ctx, &loader);
+}
+
+/*
+ * convert a text EFM file into a binary EFM file
+ */
+int ltcsConvertEfmFile(const char* text_file, const char* binary_file)
+{
+    FILE *in = fopen(text_file, "r");
+    if (!in)
+    {
+        return LTCS_ERROR_FILE;
+    }
+    int rx_count = ltcs_getRxCount(in);
+    rewind(in);
+    FILE *out = fopen(binary_file, "wb");
+    if (!out || rx_count < 1)
+    {
+        fclose(in);
+        if (out)
+        {
+            fclose(out);
+        }
+        return LTCS_ERROR_FILE;
+    }
+    uint64_t efm_count = 0;
+    uint32_t header[2] = {rx_count, 0};
+    fwrite(LTCS_BINARY_MAGIC, 1, strlen(LTCS_BINARY_MAGIC), out);
+    fwrite(&efm_count, sizeof(efm_count), 1, out);
+    fwrite(header, sizeof(uint32_t), 2, out);
+    double* values = calloc(rx_count, sizeof(double));
+    char* line = NULL;
+    size_t len = 0;
+    int rv = NULL == values ? LTCS_ERROR_RAM : LTCS_OK;
+    while (rv == LTCS_OK && getline(&line, &len, in) != -1)
+    {
+        char *saveptr;
+        char *ptr = strtok_r(line, "\n\t ", &saveptr);
+        int i = 0;
+        memset(values, 0, rx_count * sizeof(double));
+        while(ptr != NULL && i < rx_count) 
+        {
+            values[i] = atof(ptr);
+            i++;
+            ptr = strtok_r(NULL, "\n\t ", &saveptr);
+        }
+        if (fwrite(values, sizeof(double), rx_count, out) != rx_count)
+        {
+            rv = LTCS_ERROR_FILE;
+        }
+        efm_count++;
+    }
+    free(line);
+    free(values);
+    fclose(in);
+    // write number of EFMs into header
+    fseek(out, strlen(LTCS_BINARY_MAGIC), SEEK_SET);
+    fwrite(&efm_count, sizeof(efm_count), 1, out);
+    if (fclose(out) != 0)
+    {
+        rv = LTCS_ERROR_FILE;
+    }
+    return rv;
+}
+
+unsigned int ltcsGetReactionCount(ltcs_context* ctx)
+{
+    return ctx->rx_count;
+}
+
+unsigned int ltcsGetCleanedReactionCount(ltcs_context* ctx)
+{
+    return ctx->clean_rx_count;
+}
+
+unsigned long ltcsGetEfmCount(ltcs_context* ctx)
+{
+    return ctx->efm_count;
+}
+
+const char* ltcsGetLoops(ltcs_context* ctx)
+{
+    return ctx->loops;
+}
+
+/*
+ * count EFMs that are internal loops
+ */
+unsigned long ltcsGetLoopCount(ltcs_context* ctx)
+{
+    unsigned long loop_count = 0;
+    unsigned long ul;
+    for (ul = 0; ul < ctx->efm_count; ul++) {
+        if (BITTEST(ctx->loops, ul))
+        {
+            loop_count++;
+        }
+    }
+    return loop_count;
+}
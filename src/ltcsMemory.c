@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ltcsIntern.h"
+
+void ltcsSetMemoryLimit(ltcs_context* ctx, unsigned long bytes)
+{
+    ctx->memory_limit = bytes;
+}
+
+unsigned long ltcsGetMemoryUsage(ltcs_context* ctx, int category)
+{
+    if (category < 0 || category >= LTCS_MEMORY_ALL)
+    {
+        return __atomic_load_n(&ctx->memory_used, __ATOMIC_RELAXED);
+    }
+    return __atomic_load_n(&ctx->memory[category], __ATOMIC_RELAXED);
+}
+
+unsigned long ltcsGetMemoryPeak(ltcs_context* ctx)
+{
+    return __atomic_load_n(&ctx->memory_peak, __ATOMIC_RELAXED);
+}
+
+/*
+ * account allocated (positive) or freed (negative) bytes of a category;
+ * called by worker threads concurrently
+ */
+void ltcs_memoryAdd(ltcs_context* ctx, int category, long bytes)
+{
+    __atomic_add_fetch(&ctx->memory[category], bytes, __ATOMIC_RELAXED);
+    unsigned long used = __atomic_add_fetch(&ctx->memory_used, bytes,
+            __ATOMIC_RELAXED);
+    unsigned long peak = __atomic_load_n(&ctx->memory_peak, __ATOMIC_RELAXED);
+    while (used > peak && !__atomic_compare_exchange_n(&ctx->memory_peak,
+                &peak, used, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/*
+ * set accounted bytes of a category, e.g. after memory of it was replaced
+ */
+void ltcs_memorySet(ltcs_context* ctx, int category, unsigned long bytes)
+{
+    unsigned long old = __atomic_load_n(&ctx->memory[category],
+            __ATOMIC_RELAXED);
+    ltcs_memoryAdd(ctx, category, (long) bytes - (long) old);
+}
+
+/*
+ * bytes of a set of EFMs including its pointer
+ */
+unsigned long ltcs_getSetBytes(unsigned long efm_count)
+{
+    return ltcs_getBitsize(efm_count) + sizeof(char*);
+}
+
+/*
+ * number of sets after splitting the frontier at a reaction: a set is split
+ * in two if it contains EFMs using the reaction in both directions
+ */
+unsigned long ltcs_predictFrontier(char** ltcs, unsigned long ltcs_count, const
+        char* pos_mask, const char* neg_mask, unsigned long bitarray_size)
+{
+    unsigned long count = ltcs_count;
+    unsigned long ul;
+    for (ul = 0; ul < ltcs_count; ul++) {
+        if (ltcs_bitsetIntersects(ltcs[ul], pos_mask, bitarray_size) &&
+                ltcs_bitsetIntersects(ltcs[ul], neg_mask, bitarray_size))
+        {
+            count++;
+        }
+    }
+    return count;
+}
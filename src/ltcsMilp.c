@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+
+#define MAX_ARGS       13
+#define ARG_SBML       0
+#define ARG_RFILE      1
+#define ARG_EFMS       2
+#define ARG_CONC       3
+#define ARG_GIBBS      4
+#define ARG_PROTON     5
+#define ARG_TEMP       6
+#define ARG_PH         7
+#define ARG_IONIC      8
+#define ARG_YIELDS     9
+#define ARG_TIGHT      10
+#define ARG_OUTPUT     11
+#define ARG_ZERO       12
+
+/*
+ * print progress messages of libltcs with time stamp
+ */
+void printLog(const char* message, void* user_data)
+{
+    char time_string[TIME_STRING_SIZE];
+    printf("%s %s\n", getTime(time_string), message);
+    fflush(stdout);
+}
+
+/*
+ * quit with the error message of libltcs if a call failed
+ */
+void checkLtcs(ltcs_context* ctx, int rv)
+{
+    if (rv != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
+    }
+}
+
+/*
+ * write the thermodynamic MILP of ltcstool_clever.pl to a MPS file without
+ * building it in perl hashes; the EFMs are streamed into the columns
+ */
+int main (int argc, char *argv[])
+{
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-s", "-r", "-e", "-c", "-g", "-o", "-k", "-p",
+        "-i", "-y", "-b", "-l", "-z" };
+    char *optd[MAX_ARGS] = {"sbml file of the model",
+                            "rfile of the model",
+                            "file with EFMs (text like for ltcstool_clever.pl or binary efm file, see src/ltcs.h)",
+                            "file with concentration of metabolites",
+                            "file with gibbs energies",
+                            "proton name in model [optional]",
+                            "temperature in K [default: 310.15]",
+                            "pH value [default: 7]",
+                            "ionic strength [default: 0.15]",
+                            "yield file [optional] lines like 'R_BIOMASS > 0.0095' (<, = or >), each yield has to be reached by an active EFM",
+                            "bounds tightening [yes/no; default: no]",
+                            "MILP output file in MPS format [default: milp.mps]",
+                            "zero threshold of EFM fluxes [default: 1e-10]"};
+    char *optr[MAX_ARGS];
+    char *description = "Write the MILP of ltcstool_clever.pl (largest "
+        "feasible set of EFMs)\nin MPS format with CPLEX indicator "
+        "constraints";
+    char *usg = "\n   ltcsMilp -s e_coli.xml -r e_coli.rfile -e efm.modes -c "
+        "glc.conc -g group_contribution.txt -o M_h_c -l e_coli.mps\n"
+        "   ltcsMilp -s e_coli.xml -r e_coli.rfile -e efm.modes -c glc.conc "
+        "-g group_contribution.txt -k 273 -i 0.2 -p 7.4 -y yields.txt";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_SBML] || !optr[ARG_RFILE] || !optr[ARG_EFMS] ||
+            !optr[ARG_CONC] || !optr[ARG_GIBBS] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    double temperature = optr[ARG_TEMP] ? atof(optr[ARG_TEMP]) : 310.15;
+    double ph = optr[ARG_PH] ? atof(optr[ARG_PH]) : 7;
+    double ionic_strength = optr[ARG_IONIC] ? atof(optr[ARG_IONIC]) : 0.15;
+    double threshold = optr[ARG_ZERO] ? atof(optr[ARG_ZERO]) : 1e-10;
+    char* output = optr[ARG_OUTPUT] ? optr[ARG_OUTPUT] : "milp.mps";
+    unsigned int options = LTCS_MILP_DEFAULT;
+    if (optr[ARG_TIGHT] && !strcmp(optr[ARG_TIGHT], "yes"))
+    {
+        options |= LTCS_MILP_TIGHT_BOUNDS;
+    }
+    // end read arguments
+    //================================================== 
+
+    //================================================== 
+    // print log
+    printf("sbml file:             %s\n", optr[ARG_SBML]);
+    printf("r-file:                %s\n", optr[ARG_RFILE]);
+    printf("EFM file:              %s\n", optr[ARG_EFMS]);
+    printf("concentration file:    %s\n", optr[ARG_CONC]);
+    printf("energy file:           %s\n", optr[ARG_GIBBS]);
+    printf("yields file:           %s\n", optr[ARG_YIELDS] ?
+            optr[ARG_YIELDS] : "not used");
+    printf("temperature:           %g\n", temperature);
+    printf("ionic strength:        %g\n", ionic_strength);
+    printf("pH-value:              %g\n", ph);
+    printf("proton:                %s\n", optr[ARG_PROTON] ?
+            optr[ARG_PROTON] : "");
+    printf("MILP outputfile:       %s\n", output);
+    printf("tight bounds:          %s\n", options & LTCS_MILP_TIGHT_BOUNDS ?
+            "yes" : "no");
+    // end print log
+    //================================================== 
+
+    //================================================== 
+    // read model and write MILP
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, printLog, NULL);
+    ltcsSetThreshold(ctx, threshold);
+    checkLtcs(ctx, ltcsSetConditions(ctx, temperature, ph, ionic_strength,
+                optr[ARG_PROTON]));
+    checkLtcs(ctx, ltcsReadReactionFile(ctx, optr[ARG_RFILE]));
+    checkLtcs(ctx, ltcsReadSbmlFile(ctx, optr[ARG_SBML]));
+    checkLtcs(ctx, ltcsReadGibbsFile(ctx, optr[ARG_GIBBS]));
+    checkLtcs(ctx, ltcsReadConcentrationFile(ctx, optr[ARG_CONC]));
+    if (optr[ARG_YIELDS])
+    {
+        checkLtcs(ctx, ltcsReadYieldsFile(ctx, optr[ARG_YIELDS]));
+    }
+    checkLtcs(ctx, ltcsWriteMilp(ctx, optr[ARG_EFMS], output, options));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Time (s):              %.3f\n", (end.tv_sec - start.tv_sec) +
+            (end.tv_nsec - start.tv_nsec) / 1e9);
+    ltcsFreeContext(ctx);
+    // end read model and write MILP
+    //================================================== 
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,369 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+#include <sched.h>
+
+#include "ltcsIntern.h"
+
+#define NUMA_PATH "/sys/devices/system/node"
+
+void ltcsSetNuma(ltcs_context* ctx, int enable)
+{
+    ctx->numa = enable;
+}
+
+/*
+ * parse a list like 0-3,8,10-11 of sysfs; returns number of entries
+ */
+static int parseNumaList(const char* list, int** entries)
+{
+    int count = 0;
+    int size = 16;
+    int* m_entries = malloc(size * sizeof(int));
+    const char* c = list;
+    while (NULL != m_entries && *c >= '0' && *c <= '9')
+    {
+        char* end;
+        int first = strtol(c, &end, 10);
+        int last = first;
+        if (*end == '-')
+        {
+            last = strtol(end + 1, &end, 10);
+        }
+        int i;
+        for (i = first; i <= last && NULL != m_entries; i++) {
+            if (count == size)
+            {
+                size *= 2;
+                int* bigger = realloc(m_entries, size * sizeof(int));
+                if (NULL == bigger)
+                {
+                    free(m_entries);
+                    m_entries = NULL;
+                    break;
+                }
+                m_entries = bigger;
+            }
+            m_entries[count++] = i;
+        }
+        c = *end == ',' ? end + 1 : end;
+    }
+    *entries = m_entries;
+    return NULL == m_entries ? -1 : count;
+}
+
+/*
+ * read a list file of sysfs
+ */
+static int readNumaList(const char* path, int** entries)
+{
+    char line[4096];
+    FILE* file = fopen(path, "r");
+    if (NULL == file)
+    {
+        *entries = NULL;
+        return 0;
+    }
+    int count = 0;
+    *entries = NULL;
+    if (NULL != fgets(line, sizeof(line), file))
+    {
+        count = parseNumaList(line, entries);
+    }
+    fclose(file);
+    return count;
+}
+
+/*
+ * read page allocations served by the node (local) and by other nodes for
+ * processes of the node (remote); returns 0 if not available
+ */
+static int readNumaStat(int node, unsigned long* local, unsigned long* remote)
+{
+    char path[256];
+    char name[64];
+    unsigned long value;
+    snprintf(path, sizeof(path), NUMA_PATH "/node%d/numastat", node);
+    FILE* file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return 0;
+    }
+    *local = 0;
+    *remote = 0;
+    while (fscanf(file, "%63s %lu", name, &value) == 2)
+    {
+        if (!strcmp(name, "local_node"))
+        {
+            *local = value;
+        }
+        else if (!strcmp(name, "other_node"))
+        {
+            *remote = value;
+        }
+    }
+    fclose(file);
+    return 1;
+}
+
+void ltcs_pinThread(int cpu)
+{
+    if (cpu < 0)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+}
+
+/*
+ * copy the matrix on the node of cpu: memory is placed on the node that
+ * touches it first
+ */
+static void* replicateThread(void* pointer_replica_args)
+{
+    struct replica_args* args = (struct replica_args*) pointer_replica_args;
+    ltcs_pinThread(args->cpu);
+    char* block = malloc(args->efm_count * args->row_bytes + 1);
+    args->replica = calloc(args->efm_count + 1, sizeof(char*));
+    if (NULL == block || NULL == args->replica)
+    {
+        free(block);
+        free(args->replica);
+        args->replica = NULL;
+        args->error = LTCS_ERROR_RAM;
+        return((void*)NULL);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < args->efm_count; ul++) {
+        if (!BITTEST(args->loops, ul))
+        {
+            args->replica[ul] = block + ul * args->row_bytes;
+            memcpy(args->replica[ul], args->mat[ul], args->row_bytes);
+        }
+    }
+    // the entry after the last row keeps the block for freeing
+    args->replica[args->efm_count] = block;
+    return((void*)NULL);
+}
+
+static void freeNuma(struct numa_shared* numa, unsigned long efm_count)
+{
+    int n;
+    for (n = 0; n < numa->node_count; n++) {
+        if (NULL != numa->cpus)
+        {
+            free(numa->cpus[n]);
+        }
+        if (NULL != numa->replicas && NULL != numa->replicas[n])
+        {
+            free(numa->replicas[n][efm_count]);
+            free(numa->replicas[n]);
+        }
+    }
+    free(numa->cpus);
+    free(numa->replicas);
+    free(numa->node_ids);
+    free(numa->cpu_count);
+    free(numa->node_first);
+    free(numa->node_next);
+    free(numa->stat_local);
+    free(numa->stat_remote);
+}
+
+/*
+ * read the nodes and their cpus from sysfs and copy the matrix to every node;
+ * without sysfs a single node without pinning is used
+ */
+int ltcs_startNuma(ltcs_context* ctx, struct numa_shared* numa, char** mat,
+        unsigned long efm_count, unsigned int rx_count, char* loops)
+{
+    memset(numa, 0, sizeof(struct numa_shared));
+    numa->node_count = readNumaList(NUMA_PATH "/online", &numa->node_ids);
+    if (numa->node_count < 1)
+    {
+        free(numa->node_ids);
+        numa->node_count = 1;
+        numa->node_ids = calloc(1, sizeof(int));
+    }
+    int node_count = numa->node_count;
+    numa->cpu_count = calloc(node_count, sizeof(int));
+    numa->cpus = calloc(node_count, sizeof(int*));
+    numa->node_first = calloc(node_count + 1, sizeof(unsigned long));
+    numa->node_next = calloc(node_count, sizeof(unsigned long));
+    numa->stat_local = calloc(node_count, sizeof(unsigned long));
+    numa->stat_remote = calloc(node_count, sizeof(unsigned long));
+    if (NULL == numa->node_ids || NULL == numa->cpu_count || NULL ==
+            numa->cpus || NULL == numa->node_first || NULL ==
+            numa->node_next || NULL == numa->stat_local || NULL ==
+            numa->stat_remote)
+    {
+        freeNuma(numa, efm_count);
+        return LTCS_ERROR_RAM;
+    }
+    int n;
+    char path[256];
+    for (n = 0; n < node_count; n++) {
+        snprintf(path, sizeof(path), NUMA_PATH "/node%d/cpulist",
+                numa->node_ids[n]);
+        numa->cpu_count[n] = readNumaList(path, &numa->cpus[n]);
+        if (numa->cpu_count[n] < 0)
+        {
+            freeNuma(numa, efm_count);
+            return LTCS_ERROR_RAM;
+        }
+        readNumaStat(numa->node_ids[n], &numa->stat_local[n],
+                &numa->stat_remote[n]);
+    }
+    // the first ltcs is created on the first node
+    for (n = 1; n <= node_count; n++) {
+        numa->node_first[n] = 1;
+    }
+    if (node_count < 2)
+    {
+        return LTCS_OK;
+    }
+
+    numa->replicas = calloc(node_count, sizeof(char**));
+    if (NULL == numa->replicas)
+    {
+        freeNuma(numa, efm_count);
+        return LTCS_ERROR_RAM;
+    }
+    pthread_t thread[node_count];
+    struct replica_args replica_args[node_count];
+    for (n = 0; n < node_count; n++) {
+        replica_args[n].cpu = numa->cpu_count[n] > 0 ? numa->cpus[n][0] : -1;
+        replica_args[n].mat = mat;
+        replica_args[n].efm_count = efm_count;
+        replica_args[n].row_bytes = ltcs_getBitsize(2 * rx_count) + 1;
+        replica_args[n].loops = loops;
+        replica_args[n].replica = NULL;
+        replica_args[n].error = LTCS_OK;
+        pthread_create(&thread[n], NULL, replicateThread,
+                (void*)&replica_args[n]);
+    }
+    int error = LTCS_OK;
+    for (n = 0; n < node_count; n++) {
+        pthread_join(thread[n], NULL);
+        numa->replicas[n] = replica_args[n].replica;
+        if (replica_args[n].error != LTCS_OK)
+        {
+            error = replica_args[n].error;
+        }
+    }
+    if (error != LTCS_OK)
+    {
+        freeNuma(numa, efm_count);
+        return error;
+    }
+    numa->replica_bytes = node_count * efm_count * (ltcs_getBitsize(2 *
+            rx_count) + 1 + sizeof(char*));
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, numa->replica_bytes);
+    return LTCS_OK;
+}
+
+/*
+ * threads are spread in blocks over the nodes and pinned round robin to the
+ * cpus of their node
+ */
+void ltcs_assignNumaThread(struct numa_shared* numa, struct thread_args* args,
+        int thread_id, int threads)
+{
+    int node = thread_id * numa->node_count / threads;
+    int first = (node * threads + numa->node_count - 1) / numa->node_count;
+    args->numa = numa;
+    args->node = node;
+    args->cpu = numa->cpu_count[node] > 0 ? numa->cpus[node][(thread_id -
+            first) % numa->cpu_count[node]] : -1;
+    if (NULL != numa->replicas)
+    {
+        args->matrix = numa->replicas[node];
+    }
+}
+
+/*
+ * log statistics and set memory free
+ */
+void ltcs_stopNuma(ltcs_context* ctx, struct numa_shared* numa, unsigned long
+        efm_count)
+{
+    if (NULL == numa)
+    {
+        return;
+    }
+    ltcs_log(ctx, "numa: %d nodes, %lu ltcs split on their node, %lu stolen",
+            numa->node_count, numa->local, numa->stolen);
+    unsigned long local = 0;
+    unsigned long remote = 0;
+    int n;
+    for (n = 0; n < numa->node_count; n++) {
+        unsigned long node_local, node_remote;
+        if (!readNumaStat(numa->node_ids[n], &node_local, &node_remote))
+        {
+            local = remote = 0;
+            break;
+        }
+        local += node_local - numa->stat_local[n];
+        remote += node_remote - numa->stat_remote[n];
+    }
+    if (local + remote > 0)
+    {
+        ltcs_log(ctx, "numa: %lu local and %lu remote page allocations "
+                "(system wide)", local, remote);
+    }
+    ltcs_memoryAdd(ctx, LTCS_MEMORY_MATRIX, -(long) numa->replica_bytes);
+    freeNuma(numa, efm_count);
+}
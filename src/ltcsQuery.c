@@ -0,0 +1,256 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+#include "bitmakros.h"
+
+#define MAX_ARGS       3
+#define ARG_INDEX      0
+#define ARG_QUERIES    1
+#define ARG_OUTPUT     2
+
+/*
+ * read EFM numbers (1-based, separated by comma or blank) into set
+ * return 0 if a number is not valid
+ */
+int readQuerySet(char* list, char* set, unsigned long efm_count, char*
+        message)
+{
+    memset(set, 0, efm_count / CHAR_BIT + 1);
+    char *saveptr;
+    char *ptr = strtok_r(list, ", \t\n", &saveptr);
+    while (ptr != NULL)
+    {
+        char* end;
+        unsigned long efm = strtoul(ptr, &end, 10);
+        if (*end != '\0' || efm < 1 || efm > efm_count)
+        {
+            sprintf(message, "error: EFM %.32s does not exist", ptr);
+            return 0;
+        }
+        BITSET(set, efm - 1);
+        ptr = strtok_r(NULL, ", \t\n", &saveptr);
+    }
+    return 1;
+}
+
+/*
+ * print members of a bitset as 1-based numbers separated by comma
+ */
+void printMembers(FILE* file, const char* set, unsigned long count)
+{
+    unsigned long ul;
+    int first = 1;
+    for (ul = 0; ul < count; ul++) {
+        if (BITTEST(set, ul))
+        {
+            fprintf(file, first ? "%lu" : ",%lu", ul + 1);
+            first = 0;
+        }
+    }
+}
+
+/*
+ * answer queries on an index written by calcLtcs --index
+ * one query per line, one answer per line:
+ *   consistent 1,5,9  ->  yes | no
+ *   contains 1,5      ->  number of LTCS <tab> LTCS numbers
+ *   extend 1,5        ->  LTCS number <tab> cardinality <tab> EFMs | none
+ */
+int main (int argc, char *argv[])
+{
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-x", "-q", "-o" };
+    char *optd[MAX_ARGS] = {"index file written by calcLtcs --index",
+                            "query file [default: STDIN]",
+                            "output file [default: STDOUT]"};
+    char *optr[MAX_ARGS];
+    char *description = "Answer consistency, containment and extension "
+        "queries\non LTCS (EFMs and LTCS are numbered from 1 like in the "
+        "output of calcLtcs)\n\nqueries:\n   consistent 1,5,9\n   contains "
+        "1,5\n   extend 1,5";
+    char *usg = "\n   ltcsQuery -x ltcs.idx -q queries.txt -o answers.txt\n"
+        "   echo \"contains 7\" | ltcsQuery -x ltcs.idx";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments and index
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_INDEX] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    FILE* in = stdin;
+    FILE* out = stdout;
+    if (optr[ARG_QUERIES])
+    {
+        in = fopen(optr[ARG_QUERIES], "r");
+        if (!in)
+        {
+            quitError("Error in opening query file\n", LTCS_ERROR_FILE);
+        }
+    }
+    if (optr[ARG_OUTPUT])
+    {
+        out = fopen(optr[ARG_OUTPUT], "w");
+        if (!out)
+        {
+            quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+        }
+    }
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    if (ltcsLoadIndex(ctx, optr[ARG_INDEX]) != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), LTCS_ERROR_FILE);
+    }
+    unsigned long efm_count = ltcsGetIndexEfmCount(ctx);
+    unsigned long ltcs_count = ltcsGetIndexLtcsCount(ctx);
+    char* set = calloc(1, efm_count / CHAR_BIT + 1);
+    char* extension = calloc(1, efm_count / CHAR_BIT + 1);
+    char* containing = calloc(1, ltcs_count / CHAR_BIT + 1);
+    if (NULL == set || NULL == extension || NULL == containing)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    // end read arguments and index
+    //================================================== 
+
+    //================================================== 
+    // answer queries
+    struct timespec start, end;
+    double seconds = 0;
+    unsigned long query_count = 0;
+    char message[64];
+    char* line = NULL;
+    size_t len = 0;
+    while ( getline(&line, &len, in) != -1)
+    {
+        char *saveptr;
+        char *type = strtok_r(line, " \t\n", &saveptr);
+        if (NULL == type)
+        {
+            continue;
+        }
+        char *list = strtok_r(NULL, "\n", &saveptr);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (!readQuerySet(NULL != list ? list : "", set, efm_count, message))
+        {
+            fprintf(out, "%s\n", message);
+        }
+        else if (!strcmp(type, "consistent"))
+        {
+            fprintf(out, "%s\n", ltcsQueryConsistent(ctx, set) ? "yes" : "no");
+        }
+        else if (!strcmp(type, "contains"))
+        {
+            fprintf(out, "%lu\t", ltcsQueryContaining(ctx, set, containing));
+            printMembers(out, containing, ltcs_count);
+            fprintf(out, "\n");
+        }
+        else if (!strcmp(type, "extend"))
+        {
+            long best = ltcsQueryExtension(ctx, set, extension);
+            if (best < 0)
+            {
+                fprintf(out, "none\n");
+            }
+            else
+            {
+                fprintf(out, "%ld\t%lu\t", best + 1,
+                        ltcsGetIndexCardinality(ctx, best));
+                printMembers(out, extension, efm_count);
+                fprintf(out, "\n");
+            }
+        }
+        else
+        {
+            fprintf(out, "error: unknown query %.32s\n", type);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec -
+                start.tv_nsec) / 1e9;
+        query_count++;
+    }
+    free(line);
+    fprintf(stderr, "%lu queries in %.3f ms (%.2f us per query)\n",
+            query_count, seconds * 1e3, query_count > 0 ? seconds * 1e6 /
+            query_count : 0);
+    // end answer queries
+    //================================================== 
+
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    free(set);
+    free(extension);
+    free(containing);
+    ltcsFreeContext(ctx);
+    return EXIT_SUCCESS;
+}
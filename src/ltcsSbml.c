@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+
+#define MAX_ARGS       7
+#define ARG_SBML       0
+#define ARG_SFILE      1
+#define ARG_RVFILE     2
+#define ARG_RFILE      3
+#define ARG_MFILE      4
+#define ARG_ORDER      5
+#define ARG_EXTERNAL   6
+
+/*
+ * print progress messages of libltcs with time stamp
+ */
+void printLog(const char* message, void* user_data)
+{
+    char time_string[TIME_STRING_SIZE];
+    printf("%s %s\n", getTime(time_string), message);
+    fflush(stdout);
+}
+
+/*
+ * quit with the error message of libltcs if a call failed
+ */
+void checkLtcs(ltcs_context* ctx, int rv)
+{
+    if (rv != LTCS_OK)
+    {
+        quitError((char*) ltcsGetErrorMessage(ctx), rv);
+    }
+}
+
+/*
+ * read a SBML model tag by tag and write the stoichiometric matrix,
+ * reversibility and reaction names for calcLtcs -s, -v and -r (the reaction
+ * file is the -r file of the perl scripts as well)
+ */
+int main (int argc, char *argv[])
+{
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-i", "-s", "-v", "-r", "-m", "-o", "-b" };
+    char *optd[MAX_ARGS] = {"sbml file of the model",
+                            "output: stoichiometric matrix, one row per internal species [default: sfile]",
+                            "output: reversibility of the reactions [default: rvfile]",
+                            "output: reaction names [default: rfile]",
+                            "output: internal species of the rows of the stoichiometric matrix [optional]",
+                            "rfile giving the order of the reactions [optional, default: order of the sbml file]",
+                            "comma separated compartments of external species [optional, species with boundaryCondition are always external]"};
+    char *optr[MAX_ARGS];
+    char *description = "Write the stoichiometric matrix, reversibility and "
+        "reaction names of a SBML\nmodel in the formats of calcLtcs";
+    char *usg = "\n   ltcsSbml -i e_coli.xml -b C_b\n"
+        "   ltcsSbml -i e_coli.xml -b C_b -o e_coli.rfile -s sfile -v rvfile "
+        "-m mfile";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_SBML] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    char* sfile = optr[ARG_SFILE] ? optr[ARG_SFILE] : "sfile";
+    char* rvfile = optr[ARG_RVFILE] ? optr[ARG_RVFILE] : "rvfile";
+    char* rfile = optr[ARG_RFILE] ? optr[ARG_RFILE] : "rfile";
+    // end read arguments
+    //================================================== 
+
+    //================================================== 
+    // print log
+    printf("sbml file:             %s\n", optr[ARG_SBML]);
+    printf("reaction order:        %s\n", optr[ARG_ORDER] ?
+            optr[ARG_ORDER] : "sbml file");
+    printf("external compartments: %s\n", optr[ARG_EXTERNAL] ?
+            optr[ARG_EXTERNAL] : "none");
+    printf("sfile:                 %s\n", sfile);
+    printf("rvfile:                %s\n", rvfile);
+    printf("rfile:                 %s\n", rfile);
+    printf("mfile:                 %s\n", optr[ARG_MFILE] ?
+            optr[ARG_MFILE] : "not written");
+    // end print log
+    //================================================== 
+
+    //================================================== 
+    // read model and write files
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ltcs_context* ctx = ltcsCreateContext();
+    if (NULL == ctx)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    ltcsSetLogCallback(ctx, printLog, NULL);
+    if (optr[ARG_ORDER])
+    {
+        checkLtcs(ctx, ltcsReadReactionFile(ctx, optr[ARG_ORDER]));
+    }
+    checkLtcs(ctx, ltcsReadSbmlFile(ctx, optr[ARG_SBML]));
+    checkLtcs(ctx, ltcsWriteModelFiles(ctx, optr[ARG_EXTERNAL], sfile,
+                rvfile, rfile, optr[ARG_MFILE]));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Time (s):              %.3f\n", (end.tv_sec - start.tv_sec) +
+            (end.tv_nsec - start.tv_nsec) / 1e9);
+    ltcsFreeContext(ctx);
+    // end read model and write files
+    //================================================== 
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ctype.h>
+
+#include "ltcsIntern.h"
+
+/*
+ * read a yields file like ltcstool.pl: every line containing <, = or > holds
+ * a reaction name of the reaction file, the comparison and a value, e.g.
+ * "R_EX_glc < -5"; EFMs are kept if their flux is <= (<), >= (>) or equal
+ * (=) to the value, the reaction file has to be read before
+ */
+int ltcsReadYieldsFile(ltcs_context* ctx, const char* filename)
+{
+    if (NULL == ctx->reaction_names)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "yields file needs the reaction file\n");
+    }
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening yields file\n");
+    }
+    char* line = NULL;
+    size_t len = 0;
+    int rv = LTCS_OK;
+    while (rv == LTCS_OK && getline(&line, &len, file) != -1)
+    {
+        if (NULL == strpbrk(line, "<=>"))
+        {
+            continue;
+        }
+        char *saveptr;
+        char* name = strtok_r(line, "\n\t ", &saveptr);
+        char* comparison = strtok_r(NULL, "\n\t ", &saveptr);
+        char* value = strtok_r(NULL, "\n\t ", &saveptr);
+        unsigned int i;
+        for (i = 0; NULL != name && i < ctx->rx_names_count; i++) {
+            if (!strcmp(ctx->reaction_names[i], name))
+            {
+                break;
+            }
+        }
+        char* end = NULL;
+        double yield = NULL != value ? strtod(value, &end) : 0;
+        if (NULL == name || i == ctx->rx_names_count)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Could not find %s in "
+                    "list of reactions. Stopped at parsing yields file!\n",
+                    NULL != name ? name : "");
+        }
+        else if (NULL == comparison || strlen(comparison) != 1 || NULL ==
+                strchr("<=>", comparison[0]))
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Comparison value of %s "
+                    "is not <, = or > ( %s ). Stopped at parsing yields "
+                    "file!\n", name, NULL != comparison ? comparison : "");
+        }
+        else if (NULL == value || *end != '\0')
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Yield value of %s is not "
+                    "a number ( %s ). Stopped at parsing yields file!\n",
+                    name, NULL != value ? value : "");
+        }
+        else
+        {
+            char comp = comparison[0] == '<' ? 'l' : (comparison[0] == '>' ?
+                    'g' : 'e');
+            rv = ltcsAddYieldFilter(ctx, i, comp, yield);
+        }
+    }
+    free(line);
+    fclose(file);
+    return rv;
+}
+
+/*
+ * keep only EFMs whose flux through reaction (0-based) is lower or equal
+ * ('l'), greater or equal ('g') or equal ('e') to value
+ */
+int ltcsAddYieldFilter(ltcs_context* ctx, unsigned int reaction, char
+        comparison, double value)
+{
+    if (comparison != 'l' && comparison != 'g' && comparison != 'e')
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "comparison of a yield filter has to be l, g or e\n");
+    }
+    struct yield_filter* m_yields = realloc(ctx->yields, (ctx->yield_count +
+                1) * sizeof(struct yield_filter));
+    if (NULL == m_yields)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    m_yields[ctx->yield_count].reaction = reaction;
+    m_yields[ctx->yield_count].comparison = comparison;
+    m_yields[ctx->yield_count].value = value;
+    ctx->yields = m_yields;
+    ctx->yield_count++;
+    return LTCS_OK;
+}
+
+/*
+ * sort ranges by their first EFM
+ */
+static int compareRanges(const void* a, const void* b)
+{
+    const struct efm_range* range_a = (const struct efm_range*) a;
+    const struct efm_range* range_b = (const struct efm_range*) b;
+    return range_a->first < range_b->first ? -1 : range_a->first >
+        range_b->first;
+}
+
+/*
+ * set the EFMs of the input to load (exclude = 0) or to skip (exclude = 1)
+ * as list of 1-based indices and ranges separated by commas or white space,
+ * e.g. "1,4-7 12"; NULL removes the list
+ */
+int ltcsSetEfmSelection(ltcs_context* ctx, const char* list, int exclude)
+{
+    struct efm_range** ranges = exclude > 0 ? &ctx->efm_exclude :
+        &ctx->efm_include;
+    unsigned long* range_count = exclude > 0 ? &ctx->exclude_count :
+        &ctx->include_count;
+    free(*ranges);
+    *ranges = NULL;
+    *range_count = 0;
+    if (NULL == list)
+    {
+        return LTCS_OK;
+    }
+    char* copy = strdup(list);
+    struct efm_range* m_ranges = NULL;
+    unsigned long count = 0;
+    unsigned long size = 0;
+    int rv = NULL == copy ? LTCS_ERROR_RAM : LTCS_OK;
+    char *saveptr;
+    char *ptr = NULL != copy ? strtok_r(copy, ",\n\t ", &saveptr) : NULL;
+    while (rv == LTCS_OK && ptr != NULL)
+    {
+        char* end;
+        unsigned long first = isdigit((unsigned char) *ptr) ? strtoul(ptr,
+                &end, 10) : 0;
+        unsigned long last = first;
+        if (first > 0 && *end == '-' && isdigit((unsigned char) end[1]))
+        {
+            last = strtoul(end + 1, &end, 10);
+        }
+        if (first < 1 || last < first || *end != '\0')
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                    "not a correct list of EFMs ( %s )\n", ptr);
+            free(copy);
+            free(m_ranges);
+            return rv;
+        }
+        if (count == size)
+        {
+            size = 2 * size + 16;
+            struct efm_range* t_ranges = realloc(m_ranges, size *
+                    sizeof(struct efm_range));
+            if (NULL == t_ranges)
+            {
+                rv = LTCS_ERROR_RAM;
+                break;
+            }
+            m_ranges = t_ranges;
+        }
+        m_ranges[count].first = first - 1;
+        m_ranges[count].last = last - 1;
+        count++;
+        ptr = strtok_r(NULL, ",\n\t ", &saveptr);
+    }
+    free(copy);
+    if (rv != LTCS_OK)
+    {
+        free(m_ranges);
+        return ltcs_setError(ctx, rv, "Not enough free memory\n");
+    }
+    // merge overlapping and adjacent ranges
+    qsort(m_ranges, count, sizeof(struct efm_range), compareRanges);
+    unsigned long ul, merged = 0;
+    for (ul = 0; ul < count; ul++) {
+        if (merged > 0 && m_ranges[ul].first <= m_ranges[merged - 1].last + 1)
+        {
+            if (m_ranges[ul].last > m_ranges[merged - 1].last)
+            {
+                m_ranges[merged - 1].last = m_ranges[ul].last;
+            }
+        }
+        else
+        {
+            m_ranges[merged++] = m_ranges[ul];
+        }
+    }
+    *ranges = m_ranges;
+    *range_count = merged;
+    return LTCS_OK;
+}
+
+/*
+ * remove yield filters and lists of EFMs
+ */
+void ltcsClearEfmFilters(ltcs_context* ctx)
+{
+    free(ctx->yields);
+    ctx->yields = NULL;
+    ctx->yield_count = 0;
+    ltcsSetEfmSelection(ctx, NULL, 0);
+    ltcsSetEfmSelection(ctx, NULL, 1);
+}
+
+/*
+ * number of EFMs skipped by the filters during the last load
+ */
+unsigned long ltcsGetFilteredEfmCount(ltcs_context* ctx)
+{
+    return ctx->efm_filtered;
+}
+
+/*
+ * check if index lies in one of the sorted ranges
+ */
+static int isInRanges(const struct efm_range* ranges, unsigned long count,
+        unsigned long index)
+{
+    unsigned long low = 0;
+    unsigned long high = count;
+    while (low < high)
+    {
+        unsigned long mid = low + (high - low) / 2;
+        if (index < ranges[mid].first)
+        {
+            high = mid;
+        }
+        else if (index > ranges[mid].last)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * check if the EFM with given (0-based) index of the input and flux values
+ * passes the lists of EFMs and all yield filters
+ */
+int ltcs_isSelectedEfm(ltcs_context* ctx, unsigned long index, const double*
+        values)
+{
+    if (ctx->include_count > 0 && !isInRanges(ctx->efm_include,
+                ctx->include_count, index))
+    {
+        return 0;
+    }
+    if (ctx->exclude_count > 0 && isInRanges(ctx->efm_exclude,
+                ctx->exclude_count, index))
+    {
+        return 0;
+    }
+    unsigned int i;
+    for (i = 0; i < ctx->yield_count; i++) {
+        double x = values[ctx->yields[i].reaction];
+        double value = ctx->yields[i].value;
+        if ((ctx->yields[i].comparison == 'l' && !(x <= value)) ||
+                (ctx->yields[i].comparison == 'g' && !(x >= value)) ||
+                (ctx->yields[i].comparison == 'e' && !(x == value)))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * check that the yield filters refer to reactions of the EFMs
+ */
+int ltcs_checkEfmFilters(ltcs_context* ctx, unsigned int rx_count)
+{
+    unsigned int i;
+    for (i = 0; i < ctx->yield_count; i++) {
+        if (ctx->yields[i].reaction >= rx_count)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_ARGS, "yield filter of "
+                    "reaction %u, but EFMs have %u reactions\n",
+                    ctx->yields[i].reaction + 1, rx_count);
+        }
+    }
+    return LTCS_OK;
+}
@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+
+#include "ltcsIntern.h"
+
+struct shard_set
+{
+    unsigned long cardinality;
+    unsigned long index;
+};
+
+void ltcsSetShard(ltcs_context* ctx, unsigned int shard, unsigned int shards)
+{
+    ctx->shard = shard;
+    ctx->shard_count = shards;
+}
+
+/*
+ * keep the sets of the frontier that belong to the shard of the context
+ * a set belongs to the shard given by its fingerprint, which does not depend
+ * on the order of the frontier (and therefore not on the number of threads)
+ */
+void ltcs_selectShard(ltcs_context* ctx, char** ltcs, unsigned long* ltcs_count,
+        unsigned long efm_count, unsigned int reaction)
+{
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    unsigned long ul, kept = 0;
+    for (ul = 0; ul < *ltcs_count; ul++) {
+        if (ltcs_getFingerprint(ltcs[ul], bitarray_size,
+                14695981039346656037ULL) % ctx->shard_count == ctx->shard)
+        {
+            ltcs[kept++] = ltcs[ul];
+        }
+        else
+        {
+            free(ltcs[ul]);
+        }
+    }
+    ltcs_log(ctx, "shard %u/%u: %lu of %lu prefixes after %u reactions",
+            ctx->shard + 1, ctx->shard_count, kept, *ltcs_count, reaction);
+    *ltcs_count = kept;
+    ltcs_memorySet(ctx, LTCS_MEMORY_FRONTIER, kept *
+            ltcs_getSetBytes(efm_count));
+}
+
+static int compareShardSets(const void* a, const void* b)
+{
+    const struct shard_set* sa = (const struct shard_set*) a;
+    const struct shard_set* sb = (const struct shard_set*) b;
+    if (sa->cardinality != sb->cardinality)
+    {
+        return sa->cardinality > sb->cardinality ? -1 : 1;
+    }
+    return sa->index < sb->index ? -1 : (sa->index > sb->index);
+}
+
+/*
+ * write the LTCS of a shard for the merge: header, buckets (cardinality and
+ * number of sets, descending cardinality) and sets in the order of the
+ * buckets
+ */
+int ltcsWriteShard(ltcs_context* ctx, const char* filename)
+{
+    unsigned long count = ctx->result_count;
+    unsigned long bitarray_size = ltcs_getBitsize(ctx->efm_count);
+    struct shard_set* sets = calloc(count + 1, sizeof(struct shard_set));
+    if (NULL == sets)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long ul;
+    uint64_t bucket_count = 0;
+    for (ul = 0; ul < count; ul++) {
+        sets[ul].cardinality =
+                ltcs_bitsetCount(ctx->ltcs[ctx->result_index[ul]],
+                bitarray_size);
+        sets[ul].index = ctx->result_index[ul];
+    }
+    qsort(sets, count, sizeof(struct shard_set), compareShardSets);
+    for (ul = 0; ul < count; ul++) {
+        if (ul == 0 || sets[ul].cardinality != sets[ul - 1].cardinality)
+        {
+            bucket_count++;
+        }
+    }
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        free(sets);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening shard file\n");
+    }
+    uint32_t header[2] = {ctx->shard, ctx->shard_count};
+    uint64_t counts[3] = {ctx->efm_count, count, bucket_count};
+    fwrite(LTCS_SHARD_MAGIC, 1, strlen(LTCS_SHARD_MAGIC), file);
+    fwrite(header, sizeof(uint32_t), 2, file);
+    fwrite(counts, sizeof(uint64_t), 3, file);
+    unsigned long first = 0;
+    for (ul = 1; ul <= count; ul++) {
+        if (ul == count || sets[ul].cardinality != sets[first].cardinality)
+        {
+            uint64_t bucket[2] = {sets[first].cardinality, ul - first};
+            fwrite(bucket, sizeof(uint64_t), 2, file);
+            first = ul;
+        }
+    }
+    for (ul = 0; ul < count; ul++) {
+        fwrite(ctx->ltcs[sets[ul].index], 1, bitarray_size, file);
+    }
+    free(sets);
+    if (ferror(file) | fclose(file))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in writing shard file\n");
+    }
+    ltcs_log(ctx, "saved %lu LTCS of shard %u/%u", count, ctx->shard + 1,
+            ctx->shard_count);
+    return LTCS_OK;
+}
+
+/*
+ * open a shard file and read its header and buckets
+ */
+static int openShardFile(ltcs_context* ctx, const char* filename, FILE** file,
+        uint32_t* header, uint64_t* counts, uint64_t** buckets)
+{
+    *buckets = NULL;
+    *file = fopen(filename, "rb");
+    if (!*file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in opening shard "
+                "file %s\n", filename);
+    }
+    char magic[sizeof(LTCS_SHARD_MAGIC)];
+    if (fread(magic, 1, strlen(LTCS_SHARD_MAGIC), *file) !=
+            strlen(LTCS_SHARD_MAGIC) || memcmp(magic, LTCS_SHARD_MAGIC,
+                strlen(LTCS_SHARD_MAGIC)) || fread(header, sizeof(uint32_t), 2,
+                    *file) != 2 || fread(counts, sizeof(uint64_t), 3, *file) !=
+            3)
+    {
+        fclose(*file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in shard file format "
+                "of %s\n", filename);
+    }
+    *buckets = calloc(2 * counts[2] + 1, sizeof(uint64_t));
+    if (NULL == *buckets)
+    {
+        fclose(*file);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    if (fread(*buckets, sizeof(uint64_t), 2 * counts[2], *file) != 2 *
+            counts[2])
+    {
+        free(*buckets);
+        fclose(*file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in shard file format "
+                "of %s\n", filename);
+    }
+    return LTCS_OK;
+}
+
+/*
+ * remove sets of the own shard that are subsets of a set of another shard
+ * (equal sets are kept by the shard with the lower number); the other shard
+ * is read bucket by bucket down to the smallest own cardinality and a set of
+ * it is only compared to own sets of lower or equal cardinality
+ */
+static int filterByShard(ltcs_context* ctx, const char* filename, unsigned int
+        shard, char** own, unsigned long* own_cardinality, unsigned long
+        own_count, char* removed, unsigned long efm_count, unsigned int shards)
+{
+    FILE* file;
+    uint32_t header[2];
+    uint64_t counts[3];
+    uint64_t* buckets;
+    int rv = openShardFile(ctx, filename, &file, header, counts, &buckets);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    if (counts[0] != efm_count || header[1] != shards)
+    {
+        free(buckets);
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "shard file %s belongs to "
+                "another calculation\n", filename);
+    }
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    char* set = malloc(bitarray_size + 1);
+    if (NULL == set)
+    {
+        free(buckets);
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long min_cardinality = own_count > 0 ?
+        own_cardinality[own_count - 1] : 0;
+    unsigned long first_own = 0;
+    uint64_t b, ub;
+    for (b = 0; b < counts[2] && own_count > 0 && rv == LTCS_OK; b++) {
+        unsigned long cardinality = buckets[2 * b];
+        if (cardinality < min_cardinality)
+        {
+            break;
+        }
+        while (first_own < own_count && own_cardinality[first_own] >
+                cardinality)
+        {
+            first_own++;
+        }
+        for (ub = 0; ub < buckets[2 * b + 1]; ub++) {
+            if (fread(set, 1, bitarray_size, file) != bitarray_size)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in shard file "
+                        "format of %s\n", filename);
+                break;
+            }
+            unsigned long ul;
+            for (ul = first_own; ul < own_count; ul++) {
+                if (BITTEST(removed, ul) || !ltcs_bitsetIsSubset(own[ul], set,
+                            bitarray_size))
+                {
+                    continue;
+                }
+                if (own_cardinality[ul] < cardinality || header[0] < shard)
+                {
+                    BITSET(removed, ul);
+                }
+            }
+        }
+    }
+    free(set);
+    free(buckets);
+    fclose(file);
+    return rv;
+}
+
+/*
+ * merge step of shard number index of the files: its LTCS are read and all
+ * LTCS that are not maximal with respect to the other shards are removed;
+ * the remaining LTCS are the results of ctx
+ */
+int ltcsMergeShard(ltcs_context* ctx, const char* const* filenames, unsigned
+        int count, unsigned int index)
+{
+    if (index >= count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "no shard file %u\n", index
+                + 1);
+    }
+    FILE* file;
+    uint32_t header[2];
+    uint64_t counts[3];
+    uint64_t* buckets;
+    int rv = openShardFile(ctx, filenames[index], &file, header, counts,
+            &buckets);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    unsigned long efm_count = counts[0];
+    unsigned long own_count = counts[1];
+    unsigned long bitarray_size = ltcs_getBitsize(efm_count);
+    char** own = calloc(own_count + 1, sizeof(char*));
+    unsigned long* own_cardinality = calloc(own_count + 1, sizeof(unsigned
+                long));
+    char* removed = calloc(1, ltcs_getBitsize(own_count) + 1);
+    unsigned long ul = 0;
+    uint64_t b, ub;
+    if (NULL == own || NULL == own_cardinality || NULL == removed)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    for (b = 0; b < counts[2] && rv == LTCS_OK; b++) {
+        for (ub = 0; ub < buckets[2 * b + 1] && rv == LTCS_OK; ub++) {
+            own[ul] = malloc(bitarray_size + 1);
+            if (NULL == own[ul])
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_RAM,
+                        "Not enough free memory\n");
+            }
+            else if (fread(own[ul], 1, bitarray_size, file) != bitarray_size)
+            {
+                free(own[ul]);
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in shard file "
+                        "format of %s\n", filenames[index]);
+            }
+            else
+            {
+                own_cardinality[ul++] = buckets[2 * b];
+            }
+        }
+    }
+    free(buckets);
+    fclose(file);
+    unsigned int i;
+    for (i = 0; i < count && rv == LTCS_OK; i++) {
+        if (i != index)
+        {
+            rv = filterByShard(ctx, filenames[i], header[0], own,
+                    own_cardinality, ul, removed, efm_count, header[1]);
+        }
+    }
+    if (rv != LTCS_OK)
+    {
+        unsigned long uj;
+        for (uj = 0; uj < ul; uj++) {
+            free(own[uj]);
+        }
+        free(own);
+        free(own_cardinality);
+        free(removed);
+        return rv;
+    }
+
+    // install remaining LTCS as results
+    ltcs_freeResults(ctx);
+    ctx->efm_count = efm_count;
+    unsigned long kept = 0;
+    for (ul = 0; ul < own_count; ul++) {
+        if (BITTEST(removed, ul))
+        {
+            free(own[ul]);
+        }
+        else
+        {
+            own[kept++] = own[ul];
+        }
+    }
+    free(own_cardinality);
+    free(removed);
+    ltcs_log(ctx, "shard %u/%u: %lu of %lu LTCS are maximal", header[0] + 1,
+            header[1], kept, own_count);
+    unsigned long duplicates;
+    return ltcs_setUniqueResults(ctx, own, kept, &duplicates);
+}
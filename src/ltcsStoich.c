@@ -0,0 +1,571 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits.h>
+#include <strings.h>
+
+#include "ltcsIntern.h"
+
+// bytes of a stoichiometric file parsed at least by each thread
+#define STOICH_CHUNK   65536
+// reactions are stored with two bits in the EFM matrix
+#define STOICH_MAX_COLS (UINT_MAX / 2)
+
+/*
+ * separator of the values in a line of a stoichiometric file
+ */
+static int isStoichBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+static const char* skipStoichBlanks(const char* p, const char* eol)
+{
+    while (p < eol && isStoichBlank(*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+/*
+ * value like 0, 0.0 or -0 that is zero without converting it
+ */
+static int isZeroToken(const char* p, const char* end)
+{
+    for (; p < end; p++) {
+        if (*p != '0' && *p != '.' && *p != '-' && *p != '+')
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * end of the line starting at p (end of the text if it has no newline)
+ */
+static const char* getLineEnd(const char* p, const char* end)
+{
+    const char* eol = memchr(p, '\n', end - p);
+    return NULL != eol ? eol : end;
+}
+
+/*
+ * grow the positive and negative columns of a thread to hold column col
+ */
+static int growStoichColumns(struct stoich_args* a, unsigned int col)
+{
+    if (col < a->size)
+    {
+        return LTCS_OK;
+    }
+    unsigned long size = 2 * (unsigned long) a->size;
+    if (size <= col)
+    {
+        size = col + 1;
+    }
+    if (size > STOICH_MAX_COLS)
+    {
+        size = STOICH_MAX_COLS;
+    }
+    unsigned long old_bytes = a->size > 0 ? ltcs_getBitsize(a->size) + 1 : 0;
+    unsigned long bytes = ltcs_getBitsize(size) + 1;
+    char* pos = realloc(a->pos, bytes);
+    if (NULL != pos)
+    {
+        a->pos = pos;
+    }
+    char* neg = realloc(a->neg, bytes);
+    if (NULL != neg)
+    {
+        a->neg = neg;
+    }
+    if (NULL == pos || NULL == neg)
+    {
+        return LTCS_ERROR_RAM;
+    }
+    memset(a->pos + old_bytes, 0, bytes - old_bytes);
+    memset(a->neg + old_bytes, 0, bytes - old_bytes);
+    a->size = size;
+    return LTCS_OK;
+}
+
+/*
+ * mark column col (0-based) as positive or negative by the given value
+ */
+static int setStoichSign(struct stoich_args* a, unsigned int col, double val,
+        double threshold)
+{
+    if (val > threshold || val < -1 * threshold)
+    {
+        if (growStoichColumns(a, col) != LTCS_OK)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        if (val > threshold)
+        {
+            BITSET(a->pos, col);
+        }
+        else
+        {
+            BITSET(a->neg, col);
+        }
+    }
+    if (col >= a->max_col)
+    {
+        a->max_col = col + 1;
+    }
+    return LTCS_OK;
+}
+
+/*
+ * line of a dense matrix with a value for each reaction; missing values are
+ * zero and additional values are ignored
+ */
+static int parseDenseLine(struct stoich_args* a, const char* p, const char* eol,
+        double threshold)
+{
+    unsigned int i = 0;
+    while (p < eol && i < a->cols)
+    {
+        const char* token = p;
+        while (p < eol && !isStoichBlank(*p))
+        {
+            p++;
+        }
+        if (!isZeroToken(token, p) && setStoichSign(a, i, strtod(token, NULL),
+                    threshold) != LTCS_OK)
+        {
+            return LTCS_ERROR_RAM;
+        }
+        i++;
+        p = skipStoichBlanks(p, eol);
+    }
+    return LTCS_OK;
+}
+
+/*
+ * line 'row column value' of a MatrixMarket file or a triplet list
+ */
+static int parseEntryLine(struct stoich_args* a, const char* p, const char* eol,
+        double threshold)
+{
+    char* next;
+    unsigned long row = strtoul(p, &next, 10);
+    if (next == p || next >= eol || !isStoichBlank(*next))
+    {
+        return LTCS_ERROR_FILE;
+    }
+    p = skipStoichBlanks(next, eol);
+    unsigned long col = strtoul(p, &next, 10);
+    if (next == p || next >= eol || !isStoichBlank(*next))
+    {
+        return LTCS_ERROR_FILE;
+    }
+    p = skipStoichBlanks(next, eol);
+    double val = strtod(p, &next);
+    if (next == p || next > eol || row < 1 || row > UINT_MAX || col < 1 ||
+            col > STOICH_MAX_COLS || (a->rows > 0 && row > a->rows) ||
+            (a->cols > 0 && col > a->cols))
+    {
+        return LTCS_ERROR_FILE;
+    }
+    return setStoichSign(a, col - 1, val, threshold);
+}
+
+/*
+ * parse the lines of a part of a stoichiometric file; empty lines and lines
+ * starting with % or # are skipped
+ */
+static void parseStoichLines(struct stoich_args* a)
+{
+    const char* p = a->start;
+    while (p < a->end && a->error == LTCS_OK)
+    {
+        const char* line = p;
+        const char* eol = getLineEnd(p, a->end);
+        p = skipStoichBlanks(p, eol);
+        if (p < eol && *p != '%' && *p != '#')
+        {
+            int rv = a->format == LTCS_SFILE_DENSE ?
+                parseDenseLine(a, p, eol, a->threshold) :
+                parseEntryLine(a, p, eol, a->threshold);
+            if (rv != LTCS_OK)
+            {
+                a->error = rv;
+                a->error_line = line;
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+static void* stoichThread(void* arg)
+{
+    parseStoichLines((struct stoich_args*) arg);
+    return NULL;
+}
+
+/*
+ * banner and size line of a MatrixMarket file; only real or integer general
+ * matrices in coordinate format are accepted
+ */
+static int readMatrixMarketHeader(ltcs_context* ctx, const char** data, const
+        char* end, unsigned long* rows, unsigned int* cols)
+{
+    const char* p = *data;
+    const char* eol = getLineEnd(p, end);
+    char* line = strndup(p, eol - p);
+    if (NULL == line)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    char object[32], format[32], field[32], symmetry[32];
+    int count = sscanf(line, "%%%%MatrixMarket %31s %31s %31s %31s", object,
+            format, field, symmetry);
+    free(line);
+    if (count != 4 || strcasecmp(object, "matrix") || strcasecmp(format,
+                "coordinate") || (strcasecmp(field, "real") && strcasecmp(field,
+                    "integer") && strcasecmp(field, "double")) ||
+            strcasecmp(symmetry, "general"))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in stoichiometric "
+                "file; only MatrixMarket coordinate real general matrices "
+                "are supported\n");
+    }
+    p = eol < end ? eol + 1 : end;
+    while (p < end)
+    {
+        eol = getLineEnd(p, end);
+        const char* q = skipStoichBlanks(p, eol);
+        if (q < eol && *q != '%')
+        {
+            break;
+        }
+        p = eol < end ? eol + 1 : end;
+    }
+    unsigned long m_rows = 0;
+    unsigned long m_cols = 0;
+    unsigned long entries = 0;
+    line = strndup(p, getLineEnd(p, end) - p);
+    if (NULL == line)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    count = sscanf(line, "%lu %lu %lu", &m_rows, &m_cols, &entries);
+    free(line);
+    if (count != 3 || m_rows < 1 || m_cols < 1 || m_cols > STOICH_MAX_COLS)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in stoichiometric "
+                "file; missing or wrong size line of MatrixMarket file\n");
+    }
+    eol = getLineEnd(p, end);
+    *data = eol < end ? eol + 1 : end;
+    *rows = m_rows;
+    *cols = m_cols;
+    return LTCS_OK;
+}
+
+/*
+ * number of values in the first line of a dense matrix
+ */
+static unsigned int getDenseColumns(const char* p, const char* end)
+{
+    const char* eol = getLineEnd(p, end);
+    unsigned int cols = 0;
+    p = skipStoichBlanks(p, eol);
+    while (p < eol)
+    {
+        while (p < eol && !isStoichBlank(*p))
+        {
+            p++;
+        }
+        cols++;
+        p = skipStoichBlanks(p, eol);
+    }
+    return cols;
+}
+
+/*
+ * whole file as NUL terminated text
+ */
+static int readStoichText(ltcs_context* ctx, const char* filename, char** text,
+        unsigned long* length)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in opening file\n");
+    }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        size = ftell(file);
+    }
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in reading stoichiometric file\n");
+    }
+    char* m_text = malloc(size + 1);
+    if (NULL == m_text)
+    {
+        fclose(file);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    size_t read = fread(m_text, 1, size, file);
+    fclose(file);
+    if (read != (size_t) size)
+    {
+        free(m_text);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in reading stoichiometric file\n");
+    }
+    m_text[size] = '\0';
+    *text = m_text;
+    *length = size;
+    return LTCS_OK;
+}
+
+/*
+ * read stoichiometric matrix file and searches exchange reactions
+ * exchange reactions are defined as those reactions that have only positive
+ * or only negative values
+ * if exchange reactions are defined, EFMs without flux through any exchange
+ * reaction are stored as internal loops
+ * the file is split at line ends into parts of at least STOICH_CHUNK bytes,
+ * every thread marks the positive and negative columns of its part
+ */
+int ltcsReadStoichiometricFileFormat(ltcs_context* ctx, const char* filename,
+        int format, int threads)
+{
+    if (format < LTCS_SFILE_AUTO || format > LTCS_SFILE_TRIPLETS)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "unknown format of stoichiometric file\n");
+    }
+    char* text = NULL;
+    unsigned long length = 0;
+    int rv = readStoichText(ctx, filename, &text, &length);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    const char* data = text;
+    const char* end = text + length;
+    int is_mm = !strncmp(text, "%%MatrixMarket", strlen("%%MatrixMarket"));
+    if (format == LTCS_SFILE_AUTO)
+    {
+        format = is_mm ? LTCS_SFILE_MATRIX_MARKET : LTCS_SFILE_DENSE;
+    }
+    unsigned long rows = 0;
+    unsigned int cols = 0;
+    if (format == LTCS_SFILE_MATRIX_MARKET)
+    {
+        rv = is_mm ? readMatrixMarketHeader(ctx, &data, end, &rows, &cols) :
+            ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in stoichiometric file; "
+                    "missing banner of MatrixMarket file\n");
+    }
+    else if (format == LTCS_SFILE_DENSE)
+    {
+        // like ltcs_getRxCount the first line defines the number of reactions
+        cols = getDenseColumns(data, end);
+    }
+    if (rv != LTCS_OK)
+    {
+        free(text);
+        return rv;
+    }
+
+    unsigned long max_threads = (end - data) / STOICH_CHUNK + 1;
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+    if ((unsigned long) threads > max_threads)
+    {
+        threads = max_threads;
+    }
+    struct stoich_args stoich_args[threads];
+    int ti;
+    for (ti = 0; ti < threads; ti++) {
+        memset(&stoich_args[ti], 0, sizeof(struct stoich_args));
+        stoich_args[ti].format = format;
+        stoich_args[ti].threshold = ctx->threshold;
+        stoich_args[ti].rows = rows;
+        stoich_args[ti].cols = cols;
+        if (cols > 0 && growStoichColumns(&stoich_args[ti], cols - 1) !=
+                LTCS_OK)
+        {
+            stoich_args[ti].error = LTCS_ERROR_RAM;
+        }
+        // every part starts after a line end
+        const char* start = ti == 0 ? data : stoich_args[ti - 1].end;
+        const char* stop = end;
+        if (ti < threads - 1)
+        {
+            stop = data + (end - data) * (ti + 1) / threads;
+            if (stop < start)
+            {
+                stop = start;
+            }
+            stop = getLineEnd(stop, end);
+            if (stop < end)
+            {
+                stop++;
+            }
+        }
+        stoich_args[ti].start = start;
+        stoich_args[ti].end = stop;
+    }
+    if (threads == 1)
+    {
+        parseStoichLines(&stoich_args[0]);
+    }
+    else
+    {
+        pthread_t thread[threads];
+        for (ti = 0; ti < threads; ti++) {
+            pthread_create(&thread[ti], NULL, stoichThread,
+                    (void*)&stoich_args[ti]);
+        }
+        for (ti = 0; ti < threads; ti++) {
+            pthread_join(thread[ti], NULL);
+        }
+    }
+
+    // first error in the order of the file
+    unsigned int s_cols = cols;
+    for (ti = 0; ti < threads && rv == LTCS_OK; ti++) {
+        if (stoich_args[ti].error == LTCS_ERROR_RAM)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+        else if (stoich_args[ti].error != LTCS_OK)
+        {
+            unsigned long line = 1;
+            const char* p;
+            for (p = text; p < stoich_args[ti].error_line; p++) {
+                if (*p == '\n')
+                {
+                    line++;
+                }
+            }
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in stoichiometric "
+                    "file in line %lu; expected 'row column value' within "
+                    "the size of the matrix\n", line);
+        }
+        if (format == LTCS_SFILE_TRIPLETS && stoich_args[ti].max_col > s_cols)
+        {
+            s_cols = stoich_args[ti].max_col;
+        }
+    }
+    free(text);
+    if (rv == LTCS_OK && s_cols < 1)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in stoichiometric file; no reactions found\n");
+    }
+    char* m_exchange_reaction = NULL;
+    char* m_pos = NULL;
+    char* m_neg = NULL;
+    unsigned long bitarray_size = ltcs_getBitsize(s_cols) + 1;
+    if (rv == LTCS_OK)
+    {
+        m_exchange_reaction = calloc(1, bitarray_size);
+        m_pos = calloc(1, bitarray_size);
+        m_neg = calloc(1, bitarray_size);
+        if (NULL == m_exchange_reaction || NULL == m_pos || NULL == m_neg)
+        {
+            free(m_exchange_reaction);
+            m_exchange_reaction = NULL;
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    for (ti = 0; ti < threads; ti++) {
+        if (rv == LTCS_OK && stoich_args[ti].size > 0)
+        {
+            unsigned long bytes = ltcs_getBitsize(stoich_args[ti].size) + 1;
+            ltcs_bitsetOr(m_pos, stoich_args[ti].pos, bytes < bitarray_size ?
+                    bytes : bitarray_size);
+            ltcs_bitsetOr(m_neg, stoich_args[ti].neg, bytes < bitarray_size ?
+                    bytes : bitarray_size);
+        }
+        free(stoich_args[ti].pos);
+        free(stoich_args[ti].neg);
+    }
+    if (rv == LTCS_OK)
+    {
+        // exchange reactions have only positive or only negative values
+        unsigned long ul;
+        for (ul = 0; ul < bitarray_size; ul++) {
+            m_exchange_reaction[ul] = m_pos[ul] ^ m_neg[ul];
+        }
+        free(ctx->exchange_reaction);
+        ctx->exchange_reaction = m_exchange_reaction;
+        ctx->s_cols = s_cols;
+        ctx->s_cols_open = format == LTCS_SFILE_TRIPLETS ? 1 : 0;
+    }
+    free(m_pos);
+    free(m_neg);
+    return rv;
+}
+
+/*
+ * read a dense or MatrixMarket stoichiometric file with a single thread
+ */
+int ltcsReadStoichiometricFile(ltcs_context* ctx, const char* filename)
+{
+    return ltcsReadStoichiometricFileFormat(ctx, filename, LTCS_SFILE_AUTO, 1);
+}
@@ -0,0 +1,313 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+
+#include "ltcsIntern.h"
+
+#define MAX_SWEEP      127
+
+struct sweep_reader
+{
+    unsigned long efm_ix;
+    unsigned long input_ix;
+    unsigned long size;
+};
+
+/*
+ * row handler of the EFM readers that stores the magnitude class of every
+ * entry: sign times the number of thresholds reached by the absolute value;
+ * EFMs removed by the EFM filters are skipped
+ */
+static int loadSweepRow(ltcs_context* ctx, void* target, const double* values)
+{
+    struct sweep_reader* reader = (struct sweep_reader*) target;
+    unsigned int rx_count = ctx->sweep_rx_count;
+    if (!ltcs_isSelectedEfm(ctx, reader->input_ix++, values))
+    {
+        ctx->sweep_filtered++;
+        return LTCS_OK;
+    }
+    if (reader->efm_ix == reader->size)
+    {
+        unsigned long size = reader->size > 0 ? 2 * reader->size : 10000;
+        signed char* m_classes = realloc(ctx->sweep_classes, size * rx_count);
+        if (NULL == m_classes)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        ctx->sweep_classes = m_classes;
+        reader->size = size;
+    }
+    signed char* row = ctx->sweep_classes + reader->efm_ix * rx_count;
+    unsigned int i, t;
+    for (i = 0; i < rx_count; i++) {
+        double x = fabs(values[i]);
+        for (t = 0; t < ctx->sweep_count && x >= ctx->sweep_thresholds[t]; t++);
+        row[i] = values[i] < 0 ? -t : t;
+    }
+    reader->efm_ix++;
+    return LTCS_OK;
+}
+
+/*
+ * sort thresholds in ascending order
+ */
+static int compareThresholds(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*
+ * read EFM file (text or binary) once for several zero thresholds
+ * only the magnitude class of every entry is kept; ltcsSelectSweepThreshold
+ * builds the EFM matrix of a threshold
+ */
+int ltcsLoadEfmSweep(ltcs_context* ctx, const char* filename, const double*
+        thresholds, unsigned int count)
+{
+    if (count < 1 || count > MAX_SWEEP)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "number of sweep thresholds "
+                "has to be between 1 and %d\n", MAX_SWEEP);
+    }
+    double* m_thresholds = calloc(count, sizeof(double));
+    if (NULL == m_thresholds)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    memcpy(m_thresholds, thresholds, count * sizeof(double));
+    qsort(m_thresholds, count, sizeof(double), compareThresholds);
+    free(ctx->sweep_classes);
+    free(ctx->sweep_thresholds);
+    ctx->sweep_classes = NULL;
+    ctx->sweep_thresholds = m_thresholds;
+    ctx->sweep_count = count;
+    ctx->sweep_index = -1;
+    ctx->sweep_efm_count = 0;
+    ctx->sweep_filtered = 0;
+
+    FILE* file = NULL;
+    unsigned int rx_count = 0;
+    unsigned long efm_count = 0;
+    int binary = ltcsIsBinaryEfmFile(filename);
+    int rv = LTCS_OK;
+    if (binary)
+    {
+        rv = ltcs_openBinaryEfmFile(ctx, filename, &file, &rx_count,
+                &efm_count);
+    }
+    else
+    {
+        file = fopen(filename, "r");
+        if (!file)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in opening input file\n");
+        }
+        else
+        {
+            int text_rx_count = ltcs_getRxCount(file);
+            rx_count = text_rx_count > 0 ? text_rx_count : 0;
+            rewind(file);
+        }
+    }
+    if (rv == LTCS_OK && rx_count < 1)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in EFM file format; number of reactions < 1\n");
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = ltcs_checkEfmFilters(ctx, rx_count);
+    }
+    if (rv != LTCS_OK)
+    {
+        if (NULL != file)
+        {
+            fclose(file);
+        }
+        return rv;
+    }
+    ltcs_log(ctx, "reading EFMs for %u thresholds", count);
+    ctx->sweep_rx_count = rx_count;
+    struct sweep_reader reader;
+    memset(&reader, 0, sizeof(struct sweep_reader));
+    if (binary)
+    {
+        rv = ltcs_readEfmBinary(ctx, file, rx_count, efm_count, loadSweepRow, &reader);
+    }
+    else
+    {
+        rv = ltcs_readEfmText(ctx, file, rx_count, loadSweepRow, &reader);
+    }
+    fclose(file);
+    if (rv != LTCS_OK)
+    {
+        free(ctx->sweep_classes);
+        ctx->sweep_classes = NULL;
+        return rv;
+    }
+    ctx->sweep_efm_count = reader.efm_ix;
+    return LTCS_OK;
+}
+
+unsigned int ltcsGetSweepCount(ltcs_context* ctx)
+{
+    return NULL != ctx->sweep_classes ? ctx->sweep_count : 0;
+}
+
+double ltcsGetSweepThreshold(ltcs_context* ctx, unsigned int index)
+{
+    return index < ctx->sweep_count ? ctx->sweep_thresholds[index] : 0;
+}
+
+/*
+ * build EFM matrix of a sweep threshold (index of ascending thresholds)
+ * if no entry lies between the actual and the new threshold, matrix and
+ * results are kept and changed is set to 0
+ */
+int ltcsSelectSweepThreshold(ltcs_context* ctx, unsigned int index, int*
+        changed)
+{
+    if (NULL == ctx->sweep_classes || index >= ctx->sweep_count)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "sweep threshold %u is not "
+                "available\n", index + 1);
+    }
+    unsigned int rx_count = ctx->sweep_rx_count;
+    unsigned long efm_count = ctx->sweep_efm_count;
+    unsigned long total = efm_count * rx_count;
+    unsigned long ul;
+    int m_changed = 1;
+    if (ctx->sweep_index >= 0 && NULL != ctx->matrix)
+    {
+        // an entry changes if its class lies between both thresholds
+        int low = ctx->sweep_index < (int) index ? ctx->sweep_index : index;
+        int high = ctx->sweep_index < (int) index ? index : ctx->sweep_index;
+        m_changed = 0;
+        for (ul = 0; ul < total && m_changed == 0; ul++) {
+            int c = abs(ctx->sweep_classes[ul]);
+            if (c > low && c <= high)
+            {
+                m_changed = 1;
+            }
+        }
+    }
+    if (NULL != changed)
+    {
+        *changed = m_changed;
+    }
+    ctx->threshold = ctx->sweep_thresholds[index];
+    if (m_changed == 0)
+    {
+        ctx->sweep_index = index;
+        return LTCS_OK;
+    }
+
+    // entry is not zero if its class is above index
+    struct efm_loader loader;
+    int rv = ltcs_startLoading(ctx, rx_count, &loader);
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    ctx->sweep_index = -1;
+    ctx->efm_filtered = ctx->sweep_filtered;
+    char* signs = calloc(1, ltcs_getBitsize(2 * rx_count) + 1);
+    if (NULL == signs || ltcs_reserveLoading(ctx, &loader, efm_count) !=
+            LTCS_OK)
+    {
+        free(signs);
+        return ltcs_abortLoading(&loader, ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n"));
+    }
+    unsigned int i;
+    for (ul = 0; ul < efm_count && rv == LTCS_OK; ul++) {
+        const signed char* row = ctx->sweep_classes + ul * rx_count;
+        int loop = NULL != ctx->exchange_reaction ? 1 : 0;
+        memset(signs, 0, ltcs_getBitsize(2 * rx_count));
+        for (i = 0; i < rx_count; i++) {
+            if (row[i] > (int) index)
+            {
+                BITSET(signs, 2*i);
+            }
+            else if (row[i] < -(int) index)
+            {
+                BITSET(signs, 2*i+1);
+            }
+            else
+            {
+                continue;
+            }
+            if (loop > 0 && BITTEST(ctx->exchange_reaction, i))
+            {
+                loop = 0;
+            }
+        }
+        rv = ltcs_loadEfmSigns(ctx, &loader, signs, loop);
+    }
+    free(signs);
+    if (rv != LTCS_OK)
+    {
+        return ltcs_abortLoading(&loader, rv);
+    }
+    rv = ltcs_finishLoading(ctx, &loader);
+    if (rv == LTCS_OK)
+    {
+        ctx->sweep_index = index;
+    }
+    return rv;
+}
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdarg.h>
+
+#include "ltcsIntern.h"
+
+static void telemetryPoll(ltcs_context* ctx);
+
+void ltcsSetTelemetryFile(ltcs_context* ctx, FILE* file)
+{
+    ctx->telemetry = file;
+    clock_gettime(CLOCK_MONOTONIC, &ctx->telemetry_start);
+}
+
+void ltcsRequestSnapshot(ltcs_context* ctx)
+{
+    ctx->snapshot_requested = 1;
+}
+
+/*
+ * write a record to the telemetry file, fields is the record without braces
+ */
+static void writeTelemetry(ltcs_context* ctx, const char* type, const char*
+        fields)
+{
+    pthread_mutex_lock(&ctx->telemetry_lock);
+    fprintf(ctx->telemetry, "{\"type\":\"%s\",\"time\":%.6f,%s}\n", type,
+            ltcs_getElapsedTime(&ctx->telemetry_start), fields);
+    fflush(ctx->telemetry);
+    pthread_mutex_unlock(&ctx->telemetry_lock);
+}
+
+/*
+ * start timing of a stage
+ */
+void ltcs_telemetryBegin(ltcs_context* ctx, const char* stage)
+{
+    ctx->stage = stage;
+    ctx->frontier = 0;
+    clock_gettime(CLOCK_MONOTONIC, &ctx->stage_start);
+    ltcs_telemetryProgress(ctx, 1, 0);
+    ctx->iterations = 1;
+}
+
+/*
+ * write the record of a finished stage with additional fields given by format
+ */
+void ltcs_telemetryEnd(ltcs_context* ctx, const char* format, ...)
+{
+    if (NULL == ctx->telemetry || NULL == ctx->stage)
+    {
+        ctx->stage = NULL;
+        return;
+    }
+    char extra[ERROR_SIZE];
+    char fields[ERROR_SIZE * 2];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(extra, ERROR_SIZE, format, args);
+    va_end(args);
+    snprintf(fields, ERROR_SIZE * 2, "\"stage\":\"%s\",\"seconds\":%.6f,"
+            "\"bytes\":%lu,\"peak\":%lu%s%s", ctx->stage,
+            ltcs_getElapsedTime(&ctx->stage_start), ltcsGetMemoryUsage(ctx,
+                LTCS_MEMORY_ALL), ltcsGetMemoryPeak(ctx), *extra ? "," : "",
+            extra);
+    writeTelemetry(ctx, "stage", fields);
+    ctx->stage = NULL;
+}
+
+/*
+ * write the record of a finished iteration of the split stage; the eta
+ * assumes that the remaining iterations take as long as the last one, a lower
+ * bound unless subsets are removed from the frontier under a memory limit
+ */
+void ltcs_telemetryIteration(ltcs_context* ctx, unsigned int iteration, unsigned
+        int iterations, unsigned long frontier, double seconds, double* busy,
+        int threads)
+{
+    ctx->frontier = frontier;
+    if (NULL == ctx->telemetry)
+    {
+        return;
+    }
+    char fields[ERROR_SIZE * 4];
+    int len = snprintf(fields, ERROR_SIZE * 2, "\"stage\":\"%s\","
+            "\"iteration\":%u,\"iterations\":%u,\"frontier\":%lu,"
+            "\"seconds\":%.6f,\"bytes\":%lu,\"eta\":%.6f,\"busy\":[",
+            ctx->stage, iteration, iterations, frontier, seconds,
+            ltcsGetMemoryUsage(ctx, LTCS_MEMORY_ALL), seconds * (iterations -
+                iteration));
+    int ti;
+    for (ti = 0; ti < threads && len < ERROR_SIZE * 4 - 32; ti++) {
+        len += sprintf(fields + len, "%s%.6f", ti > 0 ? "," : "", busy[ti]);
+    }
+    sprintf(fields + len, "]");
+    writeTelemetry(ctx, "iteration", fields);
+}
+
+/*
+ * start a new iteration of the running stage with total units of work
+ */
+void ltcs_telemetryProgress(ltcs_context* ctx, unsigned int iteration, unsigned
+        long total)
+{
+    ctx->iteration = iteration;
+    ctx->progress_total = total;
+    __atomic_store_n(&ctx->progress_done, 0, __ATOMIC_RELAXED);
+    clock_gettime(CLOCK_MONOTONIC, &ctx->iteration_start);
+}
+
+/*
+ * add finished units of work and write a snapshot if one was requested
+ */
+void ltcs_telemetryAdvance(ltcs_context* ctx, unsigned long done)
+{
+    __atomic_add_fetch(&ctx->progress_done, done, __ATOMIC_RELAXED);
+    telemetryPoll(ctx);
+}
+
+/*
+ * write a snapshot of the running stage if one was requested
+ * the eta extrapolates the progress of the current iteration to it and to all
+ * remaining iterations
+ */
+static void telemetryPoll(ltcs_context* ctx)
+{
+    if (!ctx->snapshot_requested || !__atomic_exchange_n(
+                &ctx->snapshot_requested, 0, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+    if (NULL == ctx->telemetry)
+    {
+        return;
+    }
+    unsigned long done = __atomic_load_n(&ctx->progress_done,
+            __ATOMIC_RELAXED);
+    unsigned long total = ctx->progress_total;
+    double seconds = ltcs_getElapsedTime(&ctx->iteration_start);
+    char eta[64] = "null";
+    if (done > 0 && total >= done && NULL != ctx->stage)
+    {
+        double estimate = seconds * total / done;
+        snprintf(eta, 64, "%.6f", estimate - seconds + estimate *
+                (ctx->iterations - ctx->iteration));
+    }
+    char fields[ERROR_SIZE];
+    snprintf(fields, ERROR_SIZE, "\"stage\":\"%s\",\"seconds\":%.6f,"
+            "\"iteration\":%u,\"iterations\":%u,\"done\":%lu,\"total\":%lu,"
+            "\"frontier\":%lu,\"bytes\":%lu,\"eta\":%s", NULL == ctx->stage ?
+            "idle" : ctx->stage, NULL == ctx->stage ? 0 :
+            ltcs_getElapsedTime(&ctx->stage_start), ctx->iteration,
+            ctx->iterations, done, total, ctx->frontier, ltcsGetMemoryUsage(ctx,
+            LTCS_MEMORY_ALL), eta);
+    writeTelemetry(ctx, "snapshot", fields);
+}
@@ -0,0 +1,2202 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ctype.h>
+#include <math.h>
+
+#include "ltcsIntern.h"
+
+// usable reaction of the MILP (as in getUseableReactions of
+// ltcstool_clever.pl): all species have a dfg or the reaction is reversible
+struct milp_reaction
+{
+    unsigned int reaction;
+    int reversible;
+    int use;
+};
+
+// coefficient of a dfg column (by concentration) in a DrG row
+struct milp_entry
+{
+    unsigned int conc;
+    unsigned long row;
+    double value;
+};
+
+// MILP of ltcstool_clever.pl: dfg of species by concentration, usable
+// reactions, coefficients and bounds of the DrG rows and lambda columns of
+// the EFMs written to a temporary file; a subset of the EFMs (by their row in
+// the EFM file) restricts the MILP to these EFMs and their reactions
+struct milp_model
+{
+    int tight;
+    int objective_rows;
+    const char* efms;
+    unsigned long input_ix;
+    char* active;
+    double rt;
+    unsigned int rx_count;
+    char* has_dfg;
+    double* dfg0;
+    double* dfg_min;
+    double* dfg_max;
+    unsigned int met_count;
+    struct milp_reaction* reactions;
+    unsigned int count;
+    unsigned long sum_count;
+    unsigned long drg_count;
+    unsigned int* drg_reaction;
+    char* drg_reverse;
+    double* drg_min;
+    double* drg_max;
+    struct milp_entry* entries;
+    unsigned long entry_count;
+    unsigned long entry_capacity;
+    int* yields;
+    unsigned long* yield_efms;
+    FILE* columns;
+    unsigned long efm_count;
+};
+
+/*
+ * free species and id of a reaction of a SBML file
+ */
+static void clearModelReaction(struct model_reaction* reaction)
+{
+    unsigned int i;
+    for (i = 0; i < reaction->reactant_count; i++) {
+        free(reaction->reactants[i].species);
+    }
+    for (i = 0; i < reaction->product_count; i++) {
+        free(reaction->products[i].species);
+    }
+    free(reaction->reactants);
+    free(reaction->products);
+    free(reaction->id);
+    memset(reaction, 0, sizeof(struct model_reaction));
+}
+
+/*
+ * free reactions of a SBML file
+ */
+static void freeModelReactions(struct model_reaction* reactions, unsigned int
+        count)
+{
+    if (NULL == reactions)
+    {
+        return;
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        clearModelReaction(&reactions[i]);
+    }
+    free(reactions);
+}
+
+/*
+ * free species of a SBML file
+ */
+static void freeModelSpecies(struct model_species* species, unsigned long count)
+{
+    if (NULL == species)
+    {
+        return;
+    }
+    unsigned long ul;
+    for (ul = 0; ul < count; ul++) {
+        free(species[ul].id);
+        free(species[ul].compartment);
+    }
+    free(species);
+}
+
+/*
+ * free gibbs entries
+ */
+static void freeGibbsEntries(struct gibbs_entry* gibbs, unsigned int count)
+{
+    if (NULL == gibbs)
+    {
+        return;
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        free(gibbs[i].name);
+        free(gibbs[i].dfg);
+        free(gibbs[i].charge);
+        free(gibbs[i].nh);
+    }
+    free(gibbs);
+}
+
+/*
+ * free concentrations
+ */
+static void freeConcentrations(struct concentration* conc, unsigned int count)
+{
+    if (NULL == conc)
+    {
+        return;
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        free(conc[i].species);
+        free(conc[i].compound);
+    }
+    free(conc);
+}
+
+/*
+ * free the thermodynamic model of a context
+ */
+void ltcs_freeThermoModel(ltcs_context* ctx)
+{
+    freeModelReactions(ctx->model_rx, ctx->model_rx_count);
+    freeModelSpecies(ctx->model_species, ctx->model_species_count);
+    freeGibbsEntries(ctx->gibbs, ctx->gibbs_count);
+    freeConcentrations(ctx->conc, ctx->conc_count);
+    free(ctx->proton);
+    ctx->model_rx = NULL;
+    ctx->model_rx_count = 0;
+    ctx->model_species = NULL;
+    ctx->model_species_count = 0;
+    ctx->gibbs = NULL;
+    ctx->gibbs_count = 0;
+    ctx->conc = NULL;
+    ctx->conc_count = 0;
+    ctx->proton = NULL;
+}
+
+/*
+ * compare names, of equal names the later line first
+ */
+static int compareNameIndex(const void* a, const void* b)
+{
+    const struct name_index* x = a;
+    const struct name_index* y = b;
+    int c = strcmp(x->name, y->name);
+    if (c != 0)
+    {
+        return c;
+    }
+    return (x->index < y->index) - (x->index > y->index);
+}
+
+/*
+ * compare a name with a name of a sorted list
+ */
+static int compareName(const void* key, const void* entry)
+{
+    return strcmp(key, ((const struct name_index*) entry)->name);
+}
+
+/*
+ * sort names of count lines; unique gets the line of each name (the last
+ * line of equal names) in order of the names; return number of names or -1
+ */
+static long getUniqueNames(const char* const* names, unsigned long count,
+        unsigned long* unique)
+{
+    struct name_index* sorted = malloc((count + 1) * sizeof(struct
+                name_index));
+    if (NULL == sorted)
+    {
+        return -1;
+    }
+    unsigned long ul;
+    for (ul = 0; ul < count; ul++) {
+        sorted[ul].name = names[ul];
+        sorted[ul].index = ul;
+    }
+    qsort(sorted, count, sizeof(struct name_index), compareNameIndex);
+    long unique_count = 0;
+    for (ul = 0; ul < count; ul++) {
+        if (ul == 0 || strcmp(sorted[ul].name, sorted[ul - 1].name))
+        {
+            unique[unique_count++] = sorted[ul].index;
+        }
+    }
+    free(sorted);
+    return unique_count;
+}
+
+/*
+ * skip characters of a XML file up to and including the three characters of
+ * end
+ */
+static void skipXmlUntil(FILE* file, const char* end)
+{
+    char last[3] = {0, 0, 0};
+    int c;
+    while ((c = getc(file)) != EOF)
+    {
+        last[0] = last[1];
+        last[1] = last[2];
+        last[2] = c;
+        if (!memcmp(last, end, 3))
+        {
+            return;
+        }
+    }
+}
+
+/*
+ * read the next tag of a XML file into tag (without < and >); text,
+ * comments and CDATA sections are skipped
+ * return 1 for a tag, 0 at the end of the file and -1 without memory
+ */
+static int readXmlTag(FILE* file, char** tag, size_t* size)
+{
+    int c;
+    while ((c = getc(file)) != EOF)
+    {
+        if (c != '<')
+        {
+            continue;
+        }
+        size_t len = 0;
+        int quote = 0;
+        int skipped = 0;
+        while ((c = getc(file)) != EOF && (quote || c != '>'))
+        {
+            if (len + 2 > *size)
+            {
+                size_t new_size = *size > 0 ? 2 * *size : 256;
+                char* new_tag = realloc(*tag, new_size);
+                if (NULL == new_tag)
+                {
+                    return -1;
+                }
+                *tag = new_tag;
+                *size = new_size;
+            }
+            (*tag)[len++] = c;
+            if (quote == c)
+            {
+                quote = 0;
+            }
+            else if (!quote && (c == '"' || c == '\''))
+            {
+                quote = c;
+            }
+            if (len == 3 && !memcmp(*tag, "!--", 3))
+            {
+                skipXmlUntil(file, "-->");
+                skipped = 1;
+                break;
+            }
+            if (len == 8 && !memcmp(*tag, "![CDATA[", 8))
+            {
+                skipXmlUntil(file, "]]>");
+                skipped = 1;
+                break;
+            }
+        }
+        if (c == EOF)
+        {
+            return 0;
+        }
+        if (!skipped)
+        {
+            (*tag)[len] = '\0';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * check if a tag (opening or closing) is an element with the given name;
+ * namespace prefixes are ignored
+ */
+static int isXmlElement(const char* tag, const char* name)
+{
+    if (*tag == '/')
+    {
+        tag++;
+    }
+    size_t len = strcspn(tag, " \t\r\n/");
+    const char* colon = memchr(tag, ':', len);
+    if (NULL != colon)
+    {
+        len -= colon + 1 - tag;
+        tag = colon + 1;
+    }
+    return len == strlen(name) && !strncmp(tag, name, len);
+}
+
+/*
+ * get the value of an attribute of a tag and its length (without quotes);
+ * return NULL if the tag has no such attribute
+ */
+static const char* getXmlAttribute(const char* tag, const char* name, size_t*
+        length)
+{
+    size_t name_len = strlen(name);
+    const char* ptr = tag + strcspn(tag, " \t\r\n");
+    while (*ptr != '\0')
+    {
+        ptr += strspn(ptr, " \t\r\n");
+        const char* attribute = ptr;
+        size_t len = strcspn(ptr, "= \t\r\n");
+        ptr += len;
+        ptr += strspn(ptr, " \t\r\n");
+        if (*ptr != '=')
+        {
+            continue;
+        }
+        ptr++;
+        ptr += strspn(ptr, " \t\r\n");
+        char quote = *ptr;
+        if (quote != '"' && quote != '\'')
+        {
+            return NULL;
+        }
+        ptr++;
+        const char* end = strchr(ptr, quote);
+        if (NULL == end)
+        {
+            return NULL;
+        }
+        if (len == name_len && !strncmp(attribute, name, len))
+        {
+            *length = end - ptr;
+            return ptr;
+        }
+        ptr = end + 1;
+    }
+    return NULL;
+}
+
+/*
+ * add the species reference of a tag to a list of reactants or products;
+ * the stoichiometry defaults to 1 (like in ltcstool_clever.pl also for 0)
+ */
+static int addSpeciesRef(ltcs_context* ctx, const char* tag, const char*
+        reaction, struct species_ref** refs, unsigned int* count)
+{
+    size_t len = 0;
+    const char* species = getXmlAttribute(tag, "species", &len);
+    if (NULL == species)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Species reference "
+                "without species in reaction %s of SBML file\n", reaction);
+    }
+    struct species_ref* new_refs = realloc(*refs, (*count + 1) *
+            sizeof(struct species_ref));
+    if (NULL == new_refs)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    *refs = new_refs;
+    new_refs[*count].species = strndup(species, len);
+    if (NULL == new_refs[*count].species)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    new_refs[*count].stoichiometry = 1;
+    const char* value = getXmlAttribute(tag, "stoichiometry", &len);
+    if (NULL != value && atof(value) != 0)
+    {
+        new_refs[*count].stoichiometry = atof(value);
+    }
+    (*count)++;
+    return LTCS_OK;
+}
+
+/*
+ * add the species of a tag to the species of a SBML file
+ */
+static int addModelSpecies(ltcs_context* ctx, const char* tag, struct
+        model_species** species, unsigned long* count, unsigned long*
+        capacity)
+{
+    size_t len = 0;
+    const char* id = getXmlAttribute(tag, "id", &len);
+    if (NULL == id)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Species without id in SBML file\n");
+    }
+    if (*count == *capacity)
+    {
+        unsigned long new_capacity = 2 * *capacity + 64;
+        struct model_species* new_species = realloc(*species, new_capacity *
+                sizeof(struct model_species));
+        if (NULL == new_species)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        *species = new_species;
+        *capacity = new_capacity;
+    }
+    struct model_species* act = &(*species)[*count];
+    memset(act, 0, sizeof(struct model_species));
+    act->id = strndup(id, len);
+    const char* compartment = getXmlAttribute(tag, "compartment", &len);
+    act->compartment = strndup(NULL != compartment ? compartment : "", NULL
+            != compartment ? len : 0);
+    const char* boundary = getXmlAttribute(tag, "boundaryCondition", &len);
+    act->boundary = NULL != boundary && ((len == 4 && !strncmp(boundary,
+                    "true", 4)) || (len == 1 && boundary[0] == '1'));
+    (*count)++;
+    if (NULL == act->id || NULL == act->compartment)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * get the next reaction of a SBML file without reaction file (order of the
+ * SBML file); return NULL without memory
+ */
+static struct model_reaction* nextModelReaction(struct model_reaction**
+        reactions, unsigned int* count, unsigned int* capacity)
+{
+    if (*count == *capacity)
+    {
+        unsigned int new_capacity = 2 * *capacity + 64;
+        struct model_reaction* new_reactions = realloc(*reactions,
+                new_capacity * sizeof(struct model_reaction));
+        if (NULL == new_reactions)
+        {
+            return NULL;
+        }
+        *reactions = new_reactions;
+        *capacity = new_capacity;
+    }
+    struct model_reaction* act = &(*reactions)[(*count)++];
+    memset(act, 0, sizeof(struct model_reaction));
+    return act;
+}
+
+/*
+ * set the reaction names of a context to the reactions of a SBML file
+ * without reaction file; a reaction given twice is an error
+ */
+static int setModelReactionNames(ltcs_context* ctx, struct model_reaction*
+        reactions, unsigned int rx_count)
+{
+    if (rx_count == 0)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "No reactions in SBML file\n");
+    }
+    char** names = calloc(rx_count + 1, sizeof(char*));
+    unsigned long* unique = malloc((rx_count + 1) * sizeof(unsigned long));
+    if (NULL == names || NULL == unique)
+    {
+        free(names);
+        free(unique);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        names[i] = reactions[i].id;
+    }
+    long unique_count = getUniqueNames((const char* const*) names, rx_count,
+            unique);
+    free(unique);
+    if (unique_count < 0)
+    {
+        free(names);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    if (unique_count < rx_count)
+    {
+        free(names);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "SBML file has %u "
+                "reactions, but only %ld different ids\n", rx_count,
+                unique_count);
+    }
+    for (i = 0; i < rx_count; i++) {
+        names[i] = strdup(reactions[i].id);
+        if (NULL == names[i])
+        {
+            for (; i > 0; i--) {
+                free(names[i - 1]);
+            }
+            free(names);
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+    }
+    ctx->reaction_names = names;
+    ctx->rx_names_count = rx_count;
+    return LTCS_OK;
+}
+
+/*
+ * read species and reactions, their stoichiometry and reversibility of a
+ * SBML file tag by tag; with a reaction file the reactions are ordered like
+ * the reaction file and all reactions of the reaction file have to be in the
+ * SBML file, otherwise all reactions are read in the order of the SBML file
+ * and define the reaction names
+ */
+int ltcsReadSbmlFile(ltcs_context* ctx, const char* filename)
+{
+    int ordered = NULL != ctx->reaction_names;
+    unsigned int rx_count = ordered ? ctx->rx_names_count : 0;
+    unsigned int rx_capacity = rx_count;
+    struct model_reaction* reactions = calloc(rx_count + 1, sizeof(struct
+                model_reaction));
+    struct name_index* names = malloc((rx_count + 1) * sizeof(struct
+                name_index));
+    if (NULL == reactions || NULL == names)
+    {
+        free(reactions);
+        free(names);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int i;
+    for (i = 0; i < rx_count; i++) {
+        names[i].name = ctx->reaction_names[i];
+        names[i].index = i;
+    }
+    qsort(names, rx_count, sizeof(struct name_index), compareNameIndex);
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        free(reactions);
+        free(names);
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening SBML file\n");
+    }
+    int rv = LTCS_OK;
+    char* tag = NULL;
+    size_t size = 0;
+    int read;
+    struct model_reaction* act = NULL;
+    struct model_species* species = NULL;
+    unsigned long species_count = 0;
+    unsigned long species_capacity = 0;
+    // 1: listOfReactants, 2: listOfProducts
+    int list = 0;
+    while (rv == LTCS_OK && (read = readXmlTag(file, &tag, &size)) > 0)
+    {
+        int closing = tag[0] == '/';
+        int empty = tag[strlen(tag) - 1] == '/';
+        if (isXmlElement(tag, "species"))
+        {
+            if (!closing)
+            {
+                rv = addModelSpecies(ctx, tag, &species, &species_count,
+                        &species_capacity);
+            }
+        }
+        else if (isXmlElement(tag, "reaction"))
+        {
+            if (closing)
+            {
+                act = NULL;
+                continue;
+            }
+            size_t len = 0;
+            const char* id = getXmlAttribute(tag, "id", &len);
+            if (NULL == id)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                        "Reaction without id in SBML file\n");
+                break;
+            }
+            char* rx_id = strndup(id, len);
+            struct name_index* found = NULL != rx_id && ordered ?
+                bsearch(rx_id, names, rx_count, sizeof(struct name_index),
+                        compareName) : NULL;
+            act = NULL;
+            if (NULL == rx_id)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_RAM,
+                        "Not enough free memory\n");
+            }
+            else if (!ordered)
+            {
+                act = nextModelReaction(&reactions, &rx_count,
+                        &rx_capacity);
+                if (NULL == act)
+                {
+                    rv = ltcs_setError(ctx, LTCS_ERROR_RAM,
+                            "Not enough free memory\n");
+                    free(rx_id);
+                }
+            }
+            else if (NULL == found)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "%s not found in "
+                        "reaction file\n", rx_id);
+                free(rx_id);
+            }
+            else
+            {
+                // a reaction given twice replaces the first one
+                act = &reactions[found->index];
+                clearModelReaction(act);
+            }
+            if (NULL != act)
+            {
+                list = 0;
+                act->id = rx_id;
+                const char* rev = getXmlAttribute(tag, "reversible", &len);
+                act->reversible = NULL == rev || (len == 4 &&
+                        !strncmp(rev, "true", 4)) || (len == 1 && rev[0] ==
+                        '1');
+                if (empty)
+                {
+                    act = NULL;
+                }
+            }
+        }
+        else if (NULL != act && (isXmlElement(tag, "listOfReactants") ||
+                    isXmlElement(tag, "listOfProducts")))
+        {
+            list = closing || empty ? 0 : (isXmlElement(tag,
+                        "listOfReactants") ? 1 : 2);
+        }
+        else if (NULL != act && list > 0 && !closing && isXmlElement(tag,
+                    "speciesReference"))
+        {
+            rv = list == 1 ?
+                addSpeciesRef(ctx, tag, act->id, &act->reactants,
+                        &act->reactant_count) :
+                addSpeciesRef(ctx, tag, act->id, &act->products,
+                        &act->product_count);
+        }
+    }
+    if (rv == LTCS_OK && read < 0)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    fclose(file);
+    free(tag);
+    free(names);
+    for (i = 0; rv == LTCS_OK && ordered && i < rx_count; i++) {
+        if (NULL == reactions[i].id)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Reaction %s of the "
+                    "reaction file not found in SBML file\n",
+                    ctx->reaction_names[i]);
+        }
+    }
+    if (rv == LTCS_OK && !ordered)
+    {
+        rv = setModelReactionNames(ctx, reactions, rx_count);
+    }
+    if (rv != LTCS_OK)
+    {
+        freeModelReactions(reactions, rx_count);
+        freeModelSpecies(species, species_count);
+        return rv;
+    }
+    freeModelReactions(ctx->model_rx, ctx->model_rx_count);
+    freeModelSpecies(ctx->model_species, ctx->model_species_count);
+    ctx->model_rx = reactions;
+    ctx->model_rx_count = rx_count;
+    ctx->model_species = species;
+    ctx->model_species_count = species_count;
+    return LTCS_OK;
+}
+
+/*
+ * remove all white space of a string
+ */
+static void removeWhitespace(char* str)
+{
+    char* dst = str;
+    for (; *str != '\0'; str++) {
+        if (!isspace((unsigned char) *str))
+        {
+            *dst++ = *str;
+        }
+    }
+    *dst = '\0';
+}
+
+/*
+ * add the pseudo isomers "(dfg,charge,nh)(dfg,charge,nh)..." of value to a
+ * gibbs entry; return 0 if value is not correct
+ */
+static int addPseudoIsomers(struct gibbs_entry* entry, char* value)
+{
+    char* part = value;
+    while (*part != '\0')
+    {
+        char* close = strchr(part, ')');
+        if (NULL != close)
+        {
+            *close = '\0';
+        }
+        char* open = strchr(part, '(');
+        char* second = NULL != open ? strchr(open + 1, ',') : NULL;
+        char* third = NULL != second ? strchr(second + 1, ',') : NULL;
+        if (NULL == third || NULL != strchr(third + 1, ','))
+        {
+            return 0;
+        }
+        unsigned int n = entry->count + 1;
+        double* dfg = realloc(entry->dfg, n * sizeof(double));
+        if (NULL != dfg)
+        {
+            entry->dfg = dfg;
+        }
+        double* charge = realloc(entry->charge, n * sizeof(double));
+        if (NULL != charge)
+        {
+            entry->charge = charge;
+        }
+        double* nh = realloc(entry->nh, n * sizeof(double));
+        if (NULL != nh)
+        {
+            entry->nh = nh;
+        }
+        if (NULL == dfg || NULL == charge || NULL == nh)
+        {
+            return -1;
+        }
+        dfg[n - 1] = atof(open + 1);
+        charge[n - 1] = atof(second + 1);
+        nh[n - 1] = atof(third + 1);
+        entry->count = n;
+        part = NULL != close ? close + 1 : part + strlen(part);
+    }
+    return entry->count > 0;
+}
+
+/*
+ * read a gibbs file of ltcstool_clever.pl: every line containing = holds a
+ * compound and dfg, charge and number of hydrogen atoms of its pseudo
+ * isomers, e.g. "C00001=(-237.2,0,2)"; a compound given twice takes the
+ * last line
+ */
+int ltcsReadGibbsFile(ltcs_context* ctx, const char* filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening gibbs file\n");
+    }
+    struct gibbs_entry* gibbs = NULL;
+    unsigned int count = 0;
+    char* line = NULL;
+    size_t len = 0;
+    unsigned long line_nr = 0;
+    int rv = LTCS_OK;
+    while (rv == LTCS_OK && getline(&line, &len, file) != -1)
+    {
+        line_nr++;
+        if (NULL == strchr(line, '='))
+        {
+            continue;
+        }
+        removeWhitespace(line);
+        char* value = strchr(line, '=');
+        *value++ = '\0';
+        char* next = strchr(value, '=');
+        if (NULL != next)
+        {
+            *next = '\0';
+        }
+        struct gibbs_entry* new_gibbs = realloc(gibbs, (count + 1) *
+                sizeof(struct gibbs_entry));
+        if (NULL == new_gibbs)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+            break;
+        }
+        gibbs = new_gibbs;
+        memset(&gibbs[count], 0, sizeof(struct gibbs_entry));
+        gibbs[count].name = strdup(line);
+        int added = NULL != gibbs[count].name ? addPseudoIsomers(&gibbs[count],
+                value) : -1;
+        count++;
+        if (added < 0)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+        else if (added == 0)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Gibbs file is not "
+                    "correct in line %lu\n", line_nr);
+        }
+    }
+    free(line);
+    fclose(file);
+    const char** names = malloc((count + 1) * sizeof(char*));
+    unsigned long* unique = malloc((count + 1) * sizeof(unsigned long));
+    struct gibbs_entry* sorted = malloc((count + 1) * sizeof(struct
+                gibbs_entry));
+    if (rv == LTCS_OK && (NULL == names || NULL == unique || NULL == sorted))
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    long unique_count = 0;
+    if (rv == LTCS_OK)
+    {
+        unsigned int i;
+        for (i = 0; i < count; i++) {
+            names[i] = gibbs[i].name;
+        }
+        unique_count = getUniqueNames(names, count, unique);
+        if (unique_count < 0)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    free(names);
+    if (rv != LTCS_OK)
+    {
+        freeGibbsEntries(gibbs, count);
+        free(unique);
+        free(sorted);
+        return rv;
+    }
+    // move entries of unique names, free those of earlier lines
+    long l;
+    for (l = 0; l < unique_count; l++) {
+        sorted[l] = gibbs[unique[l]];
+        gibbs[unique[l]].name = NULL;
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        if (NULL != gibbs[i].name)
+        {
+            free(gibbs[i].name);
+            free(gibbs[i].dfg);
+            free(gibbs[i].charge);
+            free(gibbs[i].nh);
+        }
+    }
+    free(gibbs);
+    free(unique);
+    freeGibbsEntries(ctx->gibbs, ctx->gibbs_count);
+    ctx->gibbs = sorted;
+    ctx->gibbs_count = unique_count;
+    return LTCS_OK;
+}
+
+/*
+ * read a concentration file of ltcstool_clever.pl: every line containing ;
+ * holds species, compound of the gibbs file, minimal and maximal
+ * concentration, e.g. "M_3pg_c;C00197;1.51E-3;1.58E-3"; a species given
+ * twice takes the last line
+ */
+int ltcsReadConcentrationFile(ltcs_context* ctx, const char* filename)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in opening concentration file\n");
+    }
+    struct concentration* conc = NULL;
+    unsigned int count = 0;
+    char* line = NULL;
+    size_t len = 0;
+    unsigned long line_nr = 0;
+    int rv = LTCS_OK;
+    while (rv == LTCS_OK && getline(&line, &len, file) != -1)
+    {
+        line_nr++;
+        if (NULL == strchr(line, ';'))
+        {
+            continue;
+        }
+        removeWhitespace(line);
+        char* field[4];
+        char* ptr = line;
+        int i;
+        for (i = 0; i < 4 && NULL != ptr; i++) {
+            field[i] = ptr;
+            ptr = strchr(ptr, ';');
+            if (NULL != ptr)
+            {
+                *ptr++ = '\0';
+            }
+        }
+        double min = i == 4 ? atof(field[2]) : 0;
+        double max = i == 4 ? atof(field[3]) : 0;
+        if (min <= 0 || max <= 0)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Concentration file is "
+                    "not correct in line %lu\n", line_nr);
+            break;
+        }
+        struct concentration* new_conc = realloc(conc, (count + 1) *
+                sizeof(struct concentration));
+        if (NULL == new_conc)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+            break;
+        }
+        conc = new_conc;
+        conc[count].species = strdup(field[0]);
+        conc[count].compound = strdup(field[1]);
+        conc[count].min = log(min);
+        conc[count].max = log(max);
+        count++;
+        if (NULL == conc[count - 1].species || NULL == conc[count -
+                1].compound)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    free(line);
+    fclose(file);
+    const char** names = malloc((count + 1) * sizeof(char*));
+    unsigned long* unique = malloc((count + 1) * sizeof(unsigned long));
+    struct concentration* sorted = malloc((count + 1) * sizeof(struct
+                concentration));
+    if (rv == LTCS_OK && (NULL == names || NULL == unique || NULL == sorted))
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    long unique_count = 0;
+    if (rv == LTCS_OK)
+    {
+        unsigned int i;
+        for (i = 0; i < count; i++) {
+            names[i] = conc[i].species;
+        }
+        unique_count = getUniqueNames(names, count, unique);
+        if (unique_count < 0)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+        }
+    }
+    free(names);
+    if (rv != LTCS_OK)
+    {
+        freeConcentrations(conc, count);
+        free(unique);
+        free(sorted);
+        return rv;
+    }
+    // move entries of unique species, free those of earlier lines
+    long l;
+    for (l = 0; l < unique_count; l++) {
+        sorted[l] = conc[unique[l]];
+        conc[unique[l]].species = NULL;
+    }
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        if (NULL != conc[i].species)
+        {
+            free(conc[i].species);
+            free(conc[i].compound);
+        }
+    }
+    free(conc);
+    free(unique);
+    freeConcentrations(ctx->conc, ctx->conc_count);
+    ctx->conc = sorted;
+    ctx->conc_count = unique_count;
+    return LTCS_OK;
+}
+
+/*
+ * set temperature (K), pH, ionic strength and the proton species, which is
+ * left out of all reactions (NULL for none)
+ */
+int ltcsSetConditions(ltcs_context* ctx, double temperature, double ph,
+        double ionic_strength, const char* proton)
+{
+    if (temperature <= 0 || ionic_strength < 0)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS, "temperature has to be "
+                "positive and ionic strength must not be negative\n");
+    }
+    char* m_proton = NULL;
+    if (NULL != proton && *proton != '\0')
+    {
+        m_proton = strdup(proton);
+        if (NULL == m_proton)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+    }
+    free(ctx->proton);
+    ctx->proton = m_proton;
+    ctx->temperature = temperature;
+    ctx->ph = ph;
+    ctx->ionic_strength = ionic_strength;
+    return LTCS_OK;
+}
+
+/*
+ * set the reversibility of the reactions of the EFMs to the reversibility of
+ * the SBML model
+ */
+int ltcsSetModelReversibility(ltcs_context* ctx)
+{
+    if (NULL == ctx->model_rx)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "Reversibility of the model needs the SBML file\n");
+    }
+    int* reversible = calloc(ctx->model_rx_count + 1, sizeof(int));
+    if (NULL == reversible)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned int i;
+    for (i = 0; i < ctx->model_rx_count; i++) {
+        reversible[i] = ctx->model_rx[i].reversible;
+    }
+    int rv = ltcsSetReversibility(ctx, reversible, ctx->model_rx_count);
+    free(reversible);
+    return rv;
+}
+
+/*
+ * check if a species is external: boundary condition or in one of the comma
+ * separated external compartments
+ */
+static int isExternalSpecies(const struct model_species* species, const char*
+        external)
+{
+    if (species->boundary)
+    {
+        return 1;
+    }
+    size_t len = strlen(species->compartment);
+    const char* ptr = external;
+    while (NULL != ptr && *ptr != '\0')
+    {
+        size_t part = strcspn(ptr, ",");
+        if (part == len && !strncmp(ptr, species->compartment, len))
+        {
+            return 1;
+        }
+        ptr += part;
+        ptr += *ptr == ',';
+    }
+    return 0;
+}
+
+/*
+ * compare entries of the stoichiometric matrix by row and column
+ */
+static int compareStoichEntries(const void* a, const void* b)
+{
+    const struct stoich_entry* x = a;
+    const struct stoich_entry* y = b;
+    if (x->row != y->row)
+    {
+        return x->row < y->row ? -1 : 1;
+    }
+    return (x->column > y->column) - (x->column < y->column);
+}
+
+/*
+ * add the internal species of the species references of a reaction to the
+ * entries of the stoichiometric matrix
+ */
+static int addStoichEntries(ltcs_context* ctx, const struct species_ref* refs,
+        unsigned int count, double sign, unsigned int column, const struct
+        name_index* sorted, const long* rows, struct stoich_entry* entries,
+        unsigned long* entry_count)
+{
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        const struct name_index* found = bsearch(refs[i].species, sorted,
+                ctx->model_species_count, sizeof(struct name_index),
+                compareName);
+        if (NULL == found)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_FILE, "Species %s of "
+                    "reaction %s not found in SBML file\n", refs[i].species,
+                    ctx->model_rx[column].id);
+        }
+        if (rows[found->index] >= 0)
+        {
+            entries[*entry_count].row = rows[found->index];
+            entries[*entry_count].column = column;
+            entries[*entry_count].value = sign * refs[i].stoichiometry;
+            (*entry_count)++;
+        }
+    }
+    return LTCS_OK;
+}
+
+/*
+ * write the rows of the stoichiometric matrix (one column per reaction, the
+ * entries are sorted by row and column)
+ */
+static void writeStoichRows(ltcs_context* ctx, FILE* file, unsigned long
+        row_count, const struct stoich_entry* entries, unsigned long
+        entry_count)
+{
+    unsigned long e = 0;
+    unsigned long row;
+    for (row = 0; row < row_count; row++) {
+        unsigned int column;
+        for (column = 0; column < ctx->model_rx_count; column++) {
+            double value = 0;
+            for (; e < entry_count && entries[e].row == row &&
+                    entries[e].column == column; e++) {
+                value += entries[e].value;
+            }
+            fprintf(file, "\t%.10g", value == 0 ? 0 : value);
+        }
+        fprintf(file, "\n");
+    }
+}
+
+/*
+ * open a model output file, NULL names are skipped
+ */
+static int openModelFile(ltcs_context* ctx, const char* filename, FILE** file)
+{
+    *file = NULL;
+    if (NULL != filename && NULL == (*file = fopen(filename, "w")))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in opening file "
+                "%s\n", filename);
+    }
+    return LTCS_OK;
+}
+
+int ltcsWriteModelFiles(ltcs_context* ctx, const char* external, const char*
+        sfile, const char* rvfile, const char* rfile, const char* mfile)
+{
+    if (NULL == ctx->model_rx)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "Model files need the SBML file\n");
+    }
+    unsigned long species_count = ctx->model_species_count;
+    unsigned long ref_count = 0;
+    unsigned int i;
+    for (i = 0; i < ctx->model_rx_count; i++) {
+        ref_count += ctx->model_rx[i].reactant_count +
+            ctx->model_rx[i].product_count;
+    }
+    struct name_index* sorted = malloc((species_count + 1) * sizeof(struct
+                name_index));
+    long* rows = malloc((species_count + 1) * sizeof(long));
+    struct stoich_entry* entries = malloc((ref_count + 1) * sizeof(struct
+                stoich_entry));
+    if (NULL == sorted || NULL == rows || NULL == entries)
+    {
+        free(sorted);
+        free(rows);
+        free(entries);
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    // rows of the internal species in the order of the SBML file
+    unsigned long row_count = 0;
+    unsigned long ul;
+    for (ul = 0; ul < species_count; ul++) {
+        sorted[ul].name = ctx->model_species[ul].id;
+        sorted[ul].index = ul;
+        rows[ul] = isExternalSpecies(&ctx->model_species[ul], external) ? -1
+            : (long) row_count++;
+    }
+    qsort(sorted, species_count, sizeof(struct name_index),
+            compareNameIndex);
+    int rv = LTCS_OK;
+    for (ul = 1; ul < species_count; ul++) {
+        if (!strcmp(sorted[ul].name, sorted[ul - 1].name))
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Species %s given twice "
+                    "in SBML file\n", sorted[ul].name);
+            break;
+        }
+    }
+    unsigned long entry_count = 0;
+    for (i = 0; rv == LTCS_OK && i < ctx->model_rx_count; i++) {
+        struct model_reaction* rx = &ctx->model_rx[i];
+        rv = addStoichEntries(ctx, rx->reactants, rx->reactant_count, -1, i,
+                sorted, rows, entries, &entry_count);
+        if (rv == LTCS_OK)
+        {
+            rv = addStoichEntries(ctx, rx->products, rx->product_count, 1, i,
+                    sorted, rows, entries, &entry_count);
+        }
+    }
+    free(sorted);
+    qsort(entries, entry_count, sizeof(struct stoich_entry),
+            compareStoichEntries);
+    FILE* files[4] = {NULL, NULL, NULL, NULL};
+    const char* filenames[4] = {sfile, rvfile, rfile, mfile};
+    int f;
+    for (f = 0; rv == LTCS_OK && f < 4; f++) {
+        rv = openModelFile(ctx, filenames[f], &files[f]);
+    }
+    if (rv == LTCS_OK && NULL != files[0])
+    {
+        writeStoichRows(ctx, files[0], row_count, entries, entry_count);
+    }
+    for (i = 0; rv == LTCS_OK && i < ctx->model_rx_count; i++) {
+        if (NULL != files[1])
+        {
+            fprintf(files[1], i > 0 ? " %d" : "%d",
+                    ctx->model_rx[i].reversible ? 1 : 0);
+        }
+        if (NULL != files[2])
+        {
+            fprintf(files[2], i > 0 ? " \"%s\"" : "\"%s\"",
+                    ctx->model_rx[i].id);
+        }
+    }
+    for (ul = 0; rv == LTCS_OK && NULL != files[3] && ul < species_count;
+            ul++) {
+        if (rows[ul] >= 0)
+        {
+            fprintf(files[3], "%s\n", ctx->model_species[ul].id);
+        }
+    }
+    for (f = 0; f < 4; f++) {
+        if (NULL != files[f])
+        {
+            if (f == 1 || f == 2)
+            {
+                fprintf(files[f], "\n");
+            }
+            if (fclose(files[f]) != 0 && rv == LTCS_OK)
+            {
+                rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "Error in writing "
+                        "file %s\n", filenames[f]);
+            }
+        }
+    }
+    free(rows);
+    free(entries);
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "model of %lu internal species and %u reactions "
+                "written", row_count, ctx->model_rx_count);
+    }
+    return rv;
+}
+
+/*
+ * compare a name with the compound of a gibbs entry
+ */
+int ltcs_compareGibbs(const void* key, const void* entry)
+{
+    return strcmp(key, ((const struct gibbs_entry*) entry)->name);
+}
+
+/*
+ * compare a name with the species of a concentration
+ */
+static int compareConcentration(const void* key, const void* entry)
+{
+    return strcmp(key, ((const struct concentration*) entry)->species);
+}
+
+/*
+ * compare coefficients by concentration and row
+ */
+static int compareMilpEntries(const void* a, const void* b)
+{
+    const struct milp_entry* x = a;
+    const struct milp_entry* y = b;
+    if (x->conc != y->conc)
+    {
+        return x->conc < y->conc ? -1 : 1;
+    }
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+/*
+ * get the index of the concentration of a species or -1
+ */
+long ltcs_findConcentration(ltcs_context* ctx, const char* species)
+{
+    struct concentration* conc = bsearch(species, ctx->conc,
+            ctx->conc_count, sizeof(struct concentration),
+            compareConcentration);
+    return NULL != conc ? conc - ctx->conc : -1;
+}
+
+/*
+ * check if species is the proton
+ */
+int ltcs_isProton(ltcs_context* ctx, const char* species)
+{
+    return NULL != ctx->proton && !strcmp(species, ctx->proton);
+}
+
+/*
+ * standard transformed gibbs energy of formation of a compound at the
+ * conditions of the context (calcDfg of ltcstool_clever.pl)
+ */
+double ltcs_getTransformedDfg(ltcs_context* ctx, const struct gibbs_entry*
+        entry)
+{
+    double rt = GAS_CONSTANT * ctx->temperature / 1000;
+    double ph_part = rt * log(pow(10, -ctx->ph));
+    double is_pow = sqrt(ctx->ionic_strength);
+    double is_part = 2.91482 * is_pow / (1 + 1.6 * is_pow);
+    double max = 0;
+    double sum = 0;
+    int pass;
+    unsigned int i;
+    // log of the sum of exponentials: maximum first, sum afterwards
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < entry->count; i++) {
+            double ph_term = entry->nh[i] * ph_part;
+            double is_term = (entry->charge[i] * entry->charge[i] -
+                    entry->nh[i]) * is_part;
+            double x = -(entry->dfg[i] - ph_term - is_term) / rt;
+            if (pass == 0 && (i == 0 || x > max))
+            {
+                max = x;
+            }
+            else if (pass == 1)
+            {
+                sum += exp(x - max);
+            }
+        }
+        if (entry->count == 1)
+        {
+            return -rt * max;
+        }
+    }
+    return -rt * (max + log(sum));
+}
+
+/*
+ * check if all species (but the proton) have a dfg
+ */
+int ltcs_hasSpeciesDfg(ltcs_context* ctx, const struct species_ref* refs,
+        unsigned int count, const char* has_dfg)
+{
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        if (!ltcs_isProton(ctx, refs[i].species))
+        {
+            long c = ltcs_findConcentration(ctx, refs[i].species);
+            if (c < 0 || !has_dfg[c])
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/*
+ * set the coefficient of the dfg of a species in a DrG row (coefficients of
+ * the row start at first; a species given twice keeps the last coefficient)
+ * and add its range to the bounds of the row
+ */
+static int addDrgEntry(ltcs_context* ctx, struct milp_model* model, unsigned
+        long first, long conc, unsigned long row, double value, double
+        stoichiometry)
+{
+    unsigned long ul;
+    for (ul = first; ul < model->entry_count; ul++) {
+        if (model->entries[ul].conc == conc)
+        {
+            break;
+        }
+    }
+    if (ul == model->entry_capacity)
+    {
+        unsigned long capacity = 2 * model->entry_capacity + 64;
+        struct milp_entry* entries = realloc(model->entries, capacity *
+                sizeof(struct milp_entry));
+        if (NULL == entries)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_RAM,
+                    "Not enough free memory\n");
+        }
+        model->entries = entries;
+        model->entry_capacity = capacity;
+    }
+    if (ul == model->entry_count)
+    {
+        model->entry_count++;
+    }
+    model->entries[ul].conc = conc;
+    model->entries[ul].row = row;
+    model->entries[ul].value = value;
+    if (model->tight)
+    {
+        // DrG = -(sum of value * dfg)
+        model->drg_min[row] += value > 0 ?
+            -stoichiometry * model->dfg_max[conc] :
+            stoichiometry * model->dfg_min[conc];
+        model->drg_max[row] += value > 0 ?
+            -stoichiometry * model->dfg_min[conc] :
+            stoichiometry * model->dfg_max[conc];
+    }
+    return LTCS_OK;
+}
+
+/*
+ * define dfg of all species with concentration and gibbs entry (but the
+ * proton) and the usable reactions
+ */
+static int defineMilpModel(ltcs_context* ctx, struct milp_model* model)
+{
+    unsigned int c;
+    for (c = 0; c < ctx->conc_count; c++) {
+        struct gibbs_entry* entry = bsearch(ctx->conc[c].compound,
+                ctx->gibbs, ctx->gibbs_count, sizeof(struct gibbs_entry),
+                ltcs_compareGibbs);
+        if (ltcs_isProton(ctx, ctx->conc[c].species) || NULL == entry)
+        {
+            continue;
+        }
+        model->has_dfg[c] = 1;
+        model->met_count++;
+        model->dfg0[c] = ltcs_getTransformedDfg(ctx, entry);
+        model->dfg_min[c] = -INFINITY;
+        model->dfg_max[c] = INFINITY;
+        if (model->tight)
+        {
+            double min = model->dfg0[c] + model->rt * ctx->conc[c].min;
+            double max = model->dfg0[c] + model->rt * ctx->conc[c].max;
+            model->dfg_min[c] = min < max ? min : max;
+            model->dfg_max[c] = min < max ? max : min;
+        }
+    }
+    unsigned int r;
+    for (r = 0; r < model->rx_count; r++) {
+        struct model_reaction* rx = &ctx->model_rx[r];
+        int use = ltcs_hasSpeciesDfg(ctx, rx->reactants, rx->reactant_count,
+                model->has_dfg) && ltcs_hasSpeciesDfg(ctx, rx->products,
+                    rx->product_count, model->has_dfg);
+        if (use || rx->reversible)
+        {
+            model->reactions[model->count].reaction = r;
+            model->reactions[model->count].reversible = rx->reversible;
+            model->reactions[model->count].use = use;
+            model->count++;
+        }
+    }
+    return LTCS_OK;
+}
+
+/*
+ * drop the reactions without flux in any EFM of the subset
+ */
+static void restrictMilpReactions(struct milp_model* model)
+{
+    unsigned int i;
+    unsigned int count = 0;
+    for (i = 0; i < model->count; i++) {
+        if (model->active[i])
+        {
+            model->reactions[count++] = model->reactions[i];
+        }
+    }
+    model->count = count;
+}
+
+/*
+ * define the DrG rows of the usable reactions with dfg of all species; with
+ * a subset of EFMs only the species of these rows keep their dfg
+ */
+static int defineMilpDrg(ltcs_context* ctx, struct milp_model* model)
+{
+    unsigned int i;
+    for (i = 0; i < model->count; i++) {
+        int rows = 1 + model->reactions[i].reversible;
+        model->sum_count += rows;
+        model->drg_count += model->reactions[i].use ? rows : 0;
+    }
+    model->drg_reaction = malloc((model->drg_count + 1) * sizeof(unsigned
+                int));
+    model->drg_reverse = malloc(model->drg_count + 1);
+    model->drg_min = calloc(model->drg_count + 1, sizeof(double));
+    model->drg_max = calloc(model->drg_count + 1, sizeof(double));
+    if (NULL == model->drg_reaction || NULL == model->drg_reverse || NULL ==
+            model->drg_min || NULL == model->drg_max)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    unsigned long row = 0;
+    int d;
+    for (i = 0; i < model->count; i++) {
+        struct milp_reaction* mrx = &model->reactions[i];
+        struct model_reaction* rx = &ctx->model_rx[mrx->reaction];
+        for (d = 0; mrx->use && d < 1 + mrx->reversible; d++) {
+            double fct = d == 0 ? 1 : -1;
+            unsigned long first = model->entry_count;
+            model->drg_reaction[row] = i;
+            model->drg_reverse[row] = d;
+            if (!model->tight)
+            {
+                model->drg_min[row] = -INFINITY;
+                model->drg_max[row] = INFINITY;
+            }
+            unsigned int j;
+            int rv = LTCS_OK;
+            for (j = 0; rv == LTCS_OK && j < rx->reactant_count; j++) {
+                if (!ltcs_isProton(ctx, rx->reactants[j].species))
+                {
+                    double stoich = rx->reactants[j].stoichiometry;
+                    rv = addDrgEntry(ctx, model, first,
+                                ltcs_findConcentration(ctx,
+                                rx->reactants[j].species), row, fct * stoich,
+                                stoich);
+                }
+            }
+            for (j = 0; rv == LTCS_OK && j < rx->product_count; j++) {
+                if (!ltcs_isProton(ctx, rx->products[j].species))
+                {
+                    double stoich = rx->products[j].stoichiometry;
+                    rv = addDrgEntry(ctx, model, first,
+                                ltcs_findConcentration(ctx,
+                                rx->products[j].species), row, -fct * stoich,
+                                stoich);
+                }
+            }
+            if (rv != LTCS_OK)
+            {
+                return rv;
+            }
+            row++;
+        }
+    }
+    // entries is NULL if no DrG entry was added
+    if (model->entry_count > 0)
+    {
+        qsort(model->entries, model->entry_count, sizeof(struct milp_entry),
+                compareMilpEntries);
+    }
+    if (NULL != model->efms)
+    {
+        unsigned int c;
+        unsigned long ul = 0;
+        model->met_count = 0;
+        for (c = 0; c < ctx->conc_count; c++) {
+            if (ul < model->entry_count && model->entries[ul].conc == c)
+            {
+                model->met_count++;
+            }
+            else
+            {
+                model->has_dfg[c] = 0;
+            }
+            for (; ul < model->entry_count && model->entries[ul].conc == c;
+                    ul++);
+        }
+    }
+    return LTCS_OK;
+}
+
+/*
+ * flux of an EFM as in ltcstool_clever.pl: Inf is 1000 and NaN is 0
+ */
+static double getMilpFlux(double x)
+{
+    if (isnan(x))
+    {
+        return 0;
+    }
+    if (isinf(x))
+    {
+        return x > 0 ? 1000 : -1000;
+    }
+    return x;
+}
+
+/*
+ * write the lambda column of an EFM: entries in the SUM rows of reactions
+ * with flux (in the reverse row for negative flux of reversible reactions),
+ * in obj_sum and in the rows of the yields it reaches; EFMs without flux
+ * (empty lines) are skipped, with a subset of EFMs all EFMs not in the subset
+ * are skipped instead
+ */
+static int writeMilpEfm(ltcs_context* ctx, void* target, const double* values)
+{
+    struct milp_model* model = target;
+    FILE* file = model->columns;
+    double threshold = ctx->threshold;
+    unsigned long ix = model->input_ix++;
+    unsigned int i;
+    if (NULL != model->efms)
+    {
+        if (!BITTEST(model->efms, ix))
+        {
+            return LTCS_OK;
+        }
+    }
+    else
+    {
+        for (i = 0; i < model->rx_count && values[i] == 0; i++);
+        if (i == model->rx_count)
+        {
+            return LTCS_OK;
+        }
+    }
+    unsigned long efm = ++model->efm_count;
+    for (i = 0; i < model->count; i++) {
+        const struct milp_reaction* mrx = &model->reactions[i];
+        double x = getMilpFlux(values[mrx->reaction]);
+        if (x > threshold)
+        {
+            fprintf(file, "    l%lu  SUM_DrG_%s  1\n", efm,
+                    ctx->model_rx[mrx->reaction].id);
+            model->active[i] = 1;
+        }
+        else if (mrx->reversible && x < -threshold)
+        {
+            fprintf(file, "    l%lu  SUM_r_DrG_%s  1\n", efm,
+                    ctx->model_rx[mrx->reaction].id);
+            model->active[i] = 1;
+        }
+    }
+    fprintf(file, "    l%lu  obj_sum  1\n", efm);
+    for (i = 0; i < ctx->yield_count; i++) {
+        double x = getMilpFlux(values[ctx->yields[i].reaction]);
+        double value = ctx->yields[i].value;
+        char comparison = ctx->yields[i].comparison;
+        if (model->yields[i] && ((comparison == 'l' && x <= value) ||
+                    (comparison == 'g' && x >= value) || (comparison == 'e'
+                        && x == value)))
+        {
+            fprintf(file, "    l%lu  Yield_%s  1\n", efm,
+                    ctx->reaction_names[ctx->yields[i].reaction]);
+            model->yield_efms[i]++;
+        }
+    }
+    if (ferror(file))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in writing temporary MILP file\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * stream the EFMs of a text or binary file into the lambda columns
+ */
+static int readMilpEfms(ltcs_context* ctx, struct milp_model* model, const char*
+        efm_file)
+{
+    FILE* file = NULL;
+    unsigned int rx_count = 0;
+    unsigned long efm_count = 0;
+    int binary = ltcsIsBinaryEfmFile(efm_file);
+    int rv = LTCS_OK;
+    if (binary)
+    {
+        rv = ltcs_openBinaryEfmFile(ctx, efm_file, &file, &rx_count,
+                &efm_count);
+    }
+    else
+    {
+        file = fopen(efm_file, "r");
+        if (!file)
+        {
+            return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in opening input file\n");
+        }
+        rx_count = ltcs_getRxCount(file);
+        rewind(file);
+    }
+    if (rv != LTCS_OK)
+    {
+        return rv;
+    }
+    if (rx_count != model->rx_count)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE, "EFMs have %u reactions, "
+                "but the reaction file %u\n", rx_count, model->rx_count);
+    }
+    else if (binary)
+    {
+        rv = ltcs_readEfmBinary(ctx, file, rx_count, efm_count, writeMilpEfm,
+                model);
+    }
+    else
+    {
+        rv = ltcs_readEfmText(ctx, file, rx_count, writeMilpEfm, model);
+    }
+    fclose(file);
+    if (rv == LTCS_OK && model->efm_count == 0)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_EFM, NULL != model->efms ?
+                "No EFMs of the subset in EFM file\n" :
+                "No EFMs in EFM file\n");
+    }
+    return rv;
+}
+
+/*
+ * check if a yield has a row: the yields that no EFM reaches are left out,
+ * but in a MILP of a subset of EFMs such a row makes the MILP infeasible
+ */
+static int hasYieldRow(struct milp_model* model, unsigned int yield)
+{
+    return model->yields[yield] && (model->yield_efms[yield] > 0 || NULL !=
+            model->efms);
+}
+
+/*
+ * write ROWS section: DfG, DrG, SUM, obj_sum, yield and DIR rows and the
+ * rows of the indicator constraints (IND_)
+ */
+static void writeMilpRows(ltcs_context* ctx, struct milp_model* model, FILE*
+        file)
+{
+    unsigned int i;
+    int d;
+    fprintf(file, "ROWS\n N  obj\n");
+    for (i = 0; i < ctx->conc_count; i++) {
+        if (model->has_dfg[i])
+        {
+            fprintf(file, " E  DfG_%s\n", ctx->conc[i].species);
+        }
+    }
+    unsigned long ul;
+    for (ul = 0; ul < model->drg_count; ul++) {
+        fprintf(file, " E  %sDrG_%s\n", model->drg_reverse[ul] ? "r" : "",
+                ctx->model_rx[model->reactions[model->drg_reaction[ul]]
+                .reaction].id);
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            fprintf(file, " E  SUM_%sDrG_%s\n", d ? "r_" : "", id);
+        }
+    }
+    fprintf(file, " E  obj_sum\n");
+    if (model->objective_rows)
+    {
+        fprintf(file, " G  OBJ_MIN\n L  OBJ_MAX\n");
+    }
+    for (i = 0; i < ctx->yield_count; i++) {
+        if (hasYieldRow(model, i))
+        {
+            fprintf(file, " G  Yield_%s\n",
+                    ctx->reaction_names[ctx->yields[i].reaction]);
+        }
+    }
+    for (i = 0; i < model->count; i++) {
+        if (model->reactions[i].reversible)
+        {
+            fprintf(file, " L  DIR_%s\n",
+                    ctx->model_rx[model->reactions[i].reaction].id);
+        }
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            const char* pre = d ? "r" : "";
+            fprintf(file, " E  IND_%sSUM_z_%s\n G  IND_%sSUM_%s\n", pre, id,
+                    pre, id);
+            if (model->reactions[i].use)
+            {
+                fprintf(file, " L  IND_%sDrG_%s\n", pre, id);
+            }
+        }
+    }
+}
+
+/*
+ * write COLUMNS section; the lambda columns are copied from the temporary
+ * file
+ */
+static int writeMilpColumns(ltcs_context* ctx, struct milp_model* model, FILE*
+        file)
+{
+    unsigned int i;
+    int d;
+    fprintf(file, "COLUMNS\n");
+    unsigned long entry = 0;
+    for (i = 0; i < ctx->conc_count; i++) {
+        if (!model->has_dfg[i])
+        {
+            continue;
+        }
+        const char* species = ctx->conc[i].species;
+        fprintf(file, "    dfg_%s  DfG_%s  1\n", species, species);
+        for (; entry < model->entry_count && model->entries[entry].conc ==
+                i; entry++) {
+            unsigned long row = model->entries[entry].row;
+            fprintf(file, "    dfg_%s  %sDrG_%s  %.15g\n", species,
+                    model->drg_reverse[row] ? "r" : "",
+                    ctx->model_rx[model->reactions[model->drg_reaction[row]]
+                    .reaction].id, model->entries[entry].value);
+        }
+        fprintf(file, "    c_%s  DfG_%s  %.15g\n", species, species,
+                -model->rt);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < model->drg_count; ul++) {
+        const char* pre = model->drg_reverse[ul] ? "r" : "";
+        const char* id = ctx->model_rx[model->reactions[model->
+            drg_reaction[ul]].reaction].id;
+        fprintf(file, "    %sdrg_%s  %sDrG_%s  1\n", pre, id, pre, id);
+        fprintf(file, "    %sdrg_%s  IND_%sDrG_%s  1\n", pre, id, pre, id);
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            const char* pre = d ? "r_" : "";
+            const char* ind = d ? "r" : "";
+            fprintf(file, "    s_%sdrg_%s  SUM_%sDrG_%s  -1\n", pre, id, pre,
+                    id);
+            fprintf(file, "    s_%sdrg_%s  IND_%sSUM_z_%s  1\n", pre, id, ind,
+                    id);
+            fprintf(file, "    s_%sdrg_%s  IND_%sSUM_%s  1\n", pre, id, ind,
+                    id);
+        }
+    }
+    fprintf(file, "    MARKER  'MARKER'  'INTORG'\n");
+    rewind(model->columns);
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), model->columns)) > 0)
+    {
+        if (fwrite(buffer, 1, n, file) != n)
+        {
+            break;
+        }
+    }
+    if (ferror(model->columns))
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in reading temporary MILP file\n");
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            if (model->reactions[i].reversible)
+            {
+                fprintf(file, "    ind_%sdrg_%s  DIR_%s  1\n", d ? "r" : "",
+                        id, id);
+            }
+            else
+            {
+                fprintf(file, "    ind_drg_%s  obj  0\n", id);
+            }
+        }
+    }
+    fprintf(file, "    MARKER  'MARKER'  'INTEND'\n");
+    fprintf(file, "    obj_col  obj  1\n    obj_col  obj_sum  -1\n");
+    if (model->objective_rows)
+    {
+        fprintf(file, "    obj_col  OBJ_MIN  1\n    obj_col  OBJ_MAX  1\n");
+    }
+    return LTCS_OK;
+}
+
+/*
+ * write RHS, BOUNDS and INDICATORS sections
+ */
+static void writeMilpBounds(ltcs_context* ctx, struct milp_model* model, FILE*
+        file)
+{
+    unsigned int i;
+    int d;
+    fprintf(file, "RHS\n");
+    for (i = 0; i < ctx->conc_count; i++) {
+        if (model->has_dfg[i] && model->dfg0[i] != 0)
+        {
+            fprintf(file, "    rhs  DfG_%s  %.15g\n", ctx->conc[i].species,
+                    model->dfg0[i]);
+        }
+    }
+    for (i = 0; i < ctx->yield_count; i++) {
+        if (hasYieldRow(model, i))
+        {
+            fprintf(file, "    rhs  Yield_%s  1\n",
+                    ctx->reaction_names[ctx->yields[i].reaction]);
+        }
+    }
+    if (model->objective_rows)
+    {
+        fprintf(file, "    rhs  OBJ_MIN  1\n    rhs  OBJ_MAX  %lu\n",
+                model->efm_count);
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        if (model->reactions[i].reversible)
+        {
+            fprintf(file, "    rhs  DIR_%s  1\n", id);
+        }
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            fprintf(file, "    rhs  IND_%sSUM_%s  1\n", d ? "r" : "", id);
+        }
+    }
+    fprintf(file, "BOUNDS\n");
+    for (i = 0; i < ctx->conc_count; i++) {
+        if (!model->has_dfg[i])
+        {
+            continue;
+        }
+        const char* species = ctx->conc[i].species;
+        if (model->tight)
+        {
+            fprintf(file, " LO bnd  dfg_%s  %.15g\n UP bnd  dfg_%s  %.15g\n",
+                    species, model->dfg_min[i], species, model->dfg_max[i]);
+        }
+        else
+        {
+            fprintf(file, " FR bnd  dfg_%s\n", species);
+        }
+        fprintf(file, " LO bnd  c_%s  %.15g\n UP bnd  c_%s  %.15g\n", species,
+                ctx->conc[i].min, species, ctx->conc[i].max);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < model->drg_count; ul++) {
+        const char* pre = model->drg_reverse[ul] ? "r" : "";
+        const char* id = ctx->model_rx[model->reactions[model->
+            drg_reaction[ul]].reaction].id;
+        if (model->tight)
+        {
+            fprintf(file, " LO bnd  %sdrg_%s  %.15g\n UP bnd  %sdrg_%s  "
+                    "%.15g\n", pre, id, model->drg_min[ul], pre, id,
+                    model->drg_max[ul]);
+        }
+        else
+        {
+            fprintf(file, " FR bnd  %sdrg_%s\n", pre, id);
+        }
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            fprintf(file, " UP bnd  s_%sdrg_%s  %lu\n", d ? "r_" : "", id,
+                    model->efm_count);
+        }
+    }
+    for (ul = 1; ul <= model->efm_count; ul++) {
+        fprintf(file, " BV bnd  l%lu\n", ul);
+    }
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            fprintf(file, " BV bnd  ind_%sdrg_%s\n", d ? "r" : "", id);
+        }
+    }
+    fprintf(file, " LO bnd  obj_col  1\n UP bnd  obj_col  %lu\n",
+            model->efm_count);
+    fprintf(file, "INDICATORS\n");
+    for (i = 0; i < model->count; i++) {
+        const char* id = ctx->model_rx[model->reactions[i].reaction].id;
+        for (d = 0; d < 1 + model->reactions[i].reversible; d++) {
+            const char* pre = d ? "r" : "";
+            fprintf(file, " IF  IND_%sSUM_z_%s  ind_%sdrg_%s  0\n", pre, id,
+                    pre, id);
+            fprintf(file, " IF  IND_%sSUM_%s  ind_%sdrg_%s  1\n", pre, id,
+                    pre, id);
+            if (model->reactions[i].use)
+            {
+                fprintf(file, " IF  IND_%sDrG_%s  ind_%sdrg_%s  1\n", pre,
+                        id, pre, id);
+            }
+        }
+    }
+}
+
+/*
+ * free the arrays of a MILP
+ */
+static void freeMilpModel(struct milp_model* model)
+{
+    free(model->has_dfg);
+    free(model->dfg0);
+    free(model->dfg_min);
+    free(model->dfg_max);
+    free(model->reactions);
+    free(model->drg_reaction);
+    free(model->drg_reverse);
+    free(model->drg_min);
+    free(model->drg_max);
+    free(model->entries);
+    free(model->yields);
+    free(model->yield_efms);
+    free(model->active);
+    if (NULL != model->columns)
+    {
+        fclose(model->columns);
+    }
+}
+
+/*
+ * write the MILP of createLpProblem of ltcstool_clever.pl in MPS format
+ * (maximization of the number of active EFMs with CPLEX indicator
+ * constraints); the EFMs are streamed into a temporary file of their columns
+ * first, so only the model and not the EFMs are kept in memory
+ */
+int ltcsWriteMilp(ltcs_context* ctx, const char* efm_file, const char*
+        filename, unsigned int options)
+{
+    return ltcsWriteMilpSubset(ctx, efm_file, NULL, filename, options);
+}
+
+/*
+ * write the MILP of a subset of the EFMs (bitset by row of the EFM file, as
+ * the LTCS of an unfiltered calculation), restricted to the reactions with
+ * flux in these EFMs; lambda columns l1, l2, ... are the EFMs of the subset
+ * in their order, EFMs without flux are kept
+ */
+int ltcsWriteMilpSubset(ltcs_context* ctx, const char* efm_file, const char*
+        efms, const char* filename, unsigned int options)
+{
+    if (NULL == ctx->model_rx)
+    {
+        return ltcs_setError(ctx, LTCS_ERROR_ARGS,
+                "MILP needs the SBML file\n");
+    }
+    struct milp_model model;
+    memset(&model, 0, sizeof(struct milp_model));
+    model.tight = options & LTCS_MILP_TIGHT_BOUNDS;
+    model.objective_rows = options & LTCS_MILP_OBJ_ROWS;
+    model.efms = efms;
+    model.rt = GAS_CONSTANT * ctx->temperature / 1000;
+    model.rx_count = ctx->model_rx_count;
+    model.has_dfg = calloc(ctx->conc_count + 1, 1);
+    model.dfg0 = calloc(ctx->conc_count + 1, sizeof(double));
+    model.dfg_min = calloc(ctx->conc_count + 1, sizeof(double));
+    model.dfg_max = calloc(ctx->conc_count + 1, sizeof(double));
+    model.reactions = calloc(model.rx_count + 1, sizeof(struct
+                milp_reaction));
+    model.yields = calloc(ctx->yield_count + 1, sizeof(int));
+    model.yield_efms = calloc(ctx->yield_count + 1, sizeof(unsigned long));
+    model.active = calloc(model.rx_count + 1, 1);
+    int rv = LTCS_OK;
+    if (NULL == model.has_dfg || NULL == model.dfg0 || NULL == model.dfg_min
+            || NULL == model.dfg_max || NULL == model.reactions || NULL ==
+            model.yields || NULL == model.yield_efms || NULL == model.active)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_RAM, "Not enough free memory\n");
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = defineMilpModel(ctx, &model);
+    }
+    // a reaction with several yields keeps the last one
+    unsigned int i, j;
+    for (i = 0; rv == LTCS_OK && i < ctx->yield_count; i++) {
+        model.yields[i] = 1;
+        for (j = i + 1; j < ctx->yield_count; j++) {
+            if (ctx->yields[j].reaction == ctx->yields[i].reaction)
+            {
+                model.yields[i] = 0;
+            }
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        model.columns = tmpfile();
+        if (NULL == model.columns)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in opening temporary MILP file\n");
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        rv = readMilpEfms(ctx, &model, efm_file);
+    }
+    if (rv == LTCS_OK)
+    {
+        if (NULL != efms)
+        {
+            restrictMilpReactions(&model);
+        }
+        rv = defineMilpDrg(ctx, &model);
+    }
+    FILE* file = NULL;
+    if (rv == LTCS_OK)
+    {
+        file = fopen(filename, "w");
+        if (!file)
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in opening MILP file\n");
+        }
+    }
+    if (rv == LTCS_OK)
+    {
+        for (i = 0; i < ctx->yield_count; i++) {
+            if (model.yields[i] && model.yield_efms[i] == 0)
+            {
+                ltcs_log(ctx, NULL != efms ? "No EFM of the subset reaches "
+                        "the yield of %s, MILP is infeasible" : "No EFM "
+                        "reaches the yield of %s, constraint is left out",
+                        ctx->reaction_names[ctx->yields[i].reaction]);
+            }
+        }
+        fprintf(file, "NAME          LTCS\nOBJSENSE\n    MAX\n");
+        writeMilpRows(ctx, &model, file);
+        rv = writeMilpColumns(ctx, &model, file);
+    }
+    if (rv == LTCS_OK)
+    {
+        writeMilpBounds(ctx, &model, file);
+        fprintf(file, "ENDATA\n");
+        if (ferror(file))
+        {
+            rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                    "Error in writing MILP file\n");
+        }
+    }
+    if (NULL != file && fclose(file) != 0 && rv == LTCS_OK)
+    {
+        rv = ltcs_setError(ctx, LTCS_ERROR_FILE,
+                "Error in writing MILP file\n");
+    }
+    if (rv == LTCS_OK)
+    {
+        ltcs_log(ctx, "MILP of %lu EFMs, %u metabolites, %u of %u reactions "
+                "and %lu DrG rows written",
+                model.efm_count, model.met_count, model.count,
+                model.rx_count, model.drg_count);
+    }
+    freeMilpModel(&model);
+    return rv;
+}
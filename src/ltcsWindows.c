@@ -0,0 +1,708 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl 
+// Email: matthias.gerstl@acib.at 
+// Company: Austrian Centre of Industrial Biotechnology (ACIB) 
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+//Basic Permissions.
+// 
+// All rights granted under this License are granted for the term of copyright
+// on the Program, and are irrevocable provided the stated conditions are met.
+// This License explicitly affirms your unlimited permission to run the
+// unmodified Program. The output from running a covered work is covered by
+// this License only if the output, given its content, constitutes a covered
+// work. This License acknowledges your rights of fair use or other equivalent,
+// as provided by copyright law.
+// 
+// You may make, run and propagate covered works that you do not convey,
+// without conditions so long as your license otherwise remains in force. You
+// may convey covered works to others for the sole purpose of having them make
+// modifications exclusively for you, or provide you with facilities for
+// running those works, provided that you comply with the terms of this License
+// in conveying all material for which you do not control copyright. Those thus
+// making or running the covered works for you must do so exclusively on your
+// behalf, under your direction and control, on terms that prohibit them from
+// making any copies of your copyrighted material outside their relationship
+// with you.
+// 
+// Disclaimer of Warranty.
+// 
+// THERE IS NO WARRANTY FOR THE PROGRAM, TO THE EXTENT PERMITTED BY APPLICABLE
+// LAW. EXCEPT WHEN OTHERWISE STATED IN WRITING THE COPYRIGHT HOLDERS AND/OR
+// OTHER PARTIES PROVIDE THE PROGRAM “AS IS” WITHOUT WARRANTY OF ANY KIND,
+// EITHER EXPRESSED OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE
+// ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE PROGRAM IS WITH YOU.
+// SHOULD THE PROGRAM PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY
+// SERVICING, REPAIR OR CORRECTION.
+// 
+// Limitation of Liability.
+// 
+// IN NO EVENT UNLESS REQUIRED BY APPLICABLE LAW OR AGREED TO IN WRITING WILL
+// ANY COPYRIGHT HOLDER, OR ANY OTHER PARTY WHO MODIFIES AND/OR CONVEYS THE
+// PROGRAM AS PERMITTED ABOVE, BE LIABLE TO YOU FOR DAMAGES, INCLUDING ANY
+// GENERAL, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING OUT OF THE USE
+// OR INABILITY TO USE THE PROGRAM (INCLUDING BUT NOT LIMITED TO LOSS OF DATA
+// OR DATA BEING RENDERED INACCURATE OR LOSSES SUSTAINED BY YOU OR THIRD
+// PARTIES OR A FAILURE OF THE PROGRAM TO OPERATE WITH ANY OTHER PROGRAMS),
+// EVEN IF SUCH HOLDER OR OTHER PARTY HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGES.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "generalFunctions.c"
+#include "ltcs.h"
+#include "bitmakros.h"
+
+#define MAX_ARGS       10
+#define ARG_INPUT      0
+#define ARG_EFMS       1
+#define ARG_WORKERS    2
+#define ARG_THREADS    3
+#define ARG_WINDOWS    4
+#define ARG_LIMIT      5
+#define ARG_DIR        6
+#define ARG_TEMPLATE   7
+#define ARG_OUTPUT     8
+#define ARG_CSV_OUT    9
+
+// time limit of windows of a single cardinality that timed out before
+#define TIME_LIMIT_UNLIM 31536000
+
+struct command
+{
+    char* text;
+    size_t length;
+    size_t size;
+};
+
+// window of the objective (number of active EFMs)
+struct window
+{
+    unsigned long min;
+    unsigned long max;
+    int unlimited;
+};
+
+// solver process of a worker
+struct worker
+{
+    pid_t pid;
+    unsigned long task;
+    struct window window;
+};
+
+// solutions found so far as sets of lambda columns
+struct set_list
+{
+    char** sets;
+    unsigned long* cardinality;
+    unsigned long count;
+    unsigned long capacity;
+};
+
+/*
+ * append text to a command
+ */
+void appendText(struct command* cmd, const char* text, size_t length)
+{
+    if (cmd->length + length + 1 > cmd->size)
+    {
+        cmd->size = 2 * (cmd->length + length + 1);
+        cmd->text = realloc(cmd->text, cmd->size);
+        if (NULL == cmd->text)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    memcpy(cmd->text + cmd->length, text, length);
+    cmd->length += length;
+    cmd->text[cmd->length] = '\0';
+}
+
+/*
+ * replace the placeholders of the template: {mps} input file, {min} and {max}
+ * objective window, {cuts} file of the solutions found so far, {out} result
+ * file, {t} threads, {limit} time limit in seconds and {i} task number
+ */
+char* applyTemplate(const char* template, const char* mps, const struct
+        window* window, const char* cuts, const char* out, int threads,
+        unsigned long limit, unsigned long task)
+{
+    const char* names[8] = {"{mps}", "{min}", "{max}", "{cuts}", "{out}",
+        "{t}", "{limit}", "{i}"};
+    char numbers[5][32];
+    sprintf(numbers[0], "%lu", window->min);
+    sprintf(numbers[1], "%lu", window->max);
+    sprintf(numbers[2], "%d", threads);
+    sprintf(numbers[3], "%lu", window->unlimited ? TIME_LIMIT_UNLIM : limit);
+    sprintf(numbers[4], "%lu", task);
+    const char* values[8] = {mps, numbers[0], numbers[1], cuts, out,
+        numbers[2], numbers[3], numbers[4]};
+    struct command cmd = {NULL, 0, 0};
+    appendText(&cmd, "", 0);
+    const char* c = template;
+    while (*c != '\0')
+    {
+        int i;
+        for (i = 0; i < 8 && strncmp(c, names[i], strlen(names[i])); i++);
+        if (i < 8)
+        {
+            appendText(&cmd, values[i], strlen(values[i]));
+            c += strlen(names[i]);
+        }
+        else
+        {
+            appendText(&cmd, c, 1);
+            c++;
+        }
+    }
+    return cmd.text;
+}
+
+/*
+ * run a command by the shell with stdout and stderr written to logfile
+ */
+pid_t launch(const char* command, const char* logfile)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int fd = open(logfile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execl("/bin/sh", "sh", "-c", command, (char*) NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+/*
+ * number of EFMs of a MPS or LP file: highest lambda column l<n> declared
+ * binary in the MPS file or bounded by 0 <= l<n> <= 1 in the LP file
+ */
+unsigned long getEfmCount(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        quitError("Error in opening input file\n", LTCS_ERROR_FILE);
+    }
+    unsigned long efm_count = 0;
+    char* line = NULL;
+    size_t len = 0;
+    while (getline(&line, &len, file) != -1)
+    {
+        unsigned long efm = 0;
+        char* ptr = strstr(line, " BV bnd ");
+        if (ptr == line)
+        {
+            for (ptr += 8; *ptr == ' '; ptr++);
+            if (*ptr == 'l')
+            {
+                efm = strtoul(ptr + 1, NULL, 10);
+            }
+        }
+        else if (NULL != (ptr = strstr(line, "0 <= l")))
+        {
+            efm = strtoul(ptr + 6, NULL, 10);
+        }
+        if (efm > efm_count)
+        {
+            efm_count = efm;
+        }
+    }
+    free(line);
+    fclose(file);
+    return efm_count;
+}
+
+/*
+ * add a solution to the list, return 0 if it was found before
+ */
+int addSet(struct set_list* list, char* set, unsigned long cardinality,
+        size_t bytes)
+{
+    unsigned long ul;
+    for (ul = 0; ul < list->count; ul++) {
+        if (!memcmp(list->sets[ul], set, bytes))
+        {
+            free(set);
+            return 0;
+        }
+    }
+    if (list->count == list->capacity)
+    {
+        list->capacity = 2 * list->capacity + 64;
+        list->sets = realloc(list->sets, list->capacity * sizeof(char*));
+        list->cardinality = realloc(list->cardinality, list->capacity *
+                sizeof(unsigned long));
+        if (NULL == list->sets || NULL == list->cardinality)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    list->sets[list->count] = set;
+    list->cardinality[list->count] = cardinality;
+    list->count++;
+    return 1;
+}
+
+/*
+ * add a window to the queue
+ */
+void pushWindow(struct window** queue, unsigned long* count, unsigned long*
+        capacity, unsigned long min, unsigned long max, int unlimited)
+{
+    if (*count == *capacity)
+    {
+        *capacity = 2 * *capacity + 16;
+        *queue = realloc(*queue, *capacity * sizeof(struct window));
+        if (NULL == *queue)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+    }
+    (*queue)[*count].min = min;
+    (*queue)[*count].max = max;
+    (*queue)[*count].unlimited = unlimited;
+    (*count)++;
+}
+
+/*
+ * take the window with the highest maximum from the queue: solutions of high
+ * cardinality first, they are the cuts of the lower windows
+ */
+struct window popWindow(struct window* queue, unsigned long* count)
+{
+    unsigned long best = 0;
+    unsigned long ul;
+    for (ul = 1; ul < *count; ul++) {
+        if (queue[ul].max > queue[best].max)
+        {
+            best = ul;
+        }
+    }
+    struct window window = queue[best];
+    queue[best] = queue[--(*count)];
+    return window;
+}
+
+/*
+ * write the solutions found so far to the cut file of a worker
+ */
+void writeCuts(const char* filename, struct set_list* list, unsigned long
+        efm_count)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file)
+    {
+        quitError("Error in opening cut file\n", LTCS_ERROR_FILE);
+    }
+    unsigned long ul;
+    for (ul = 0; ul < list->count; ul++) {
+        ltcsWriteSet(file, list->sets[ul], efm_count, 1);
+    }
+    if (ferror(file) || fclose(file) != 0)
+    {
+        quitError("Error in writing cut file\n", LTCS_ERROR_FILE);
+    }
+}
+
+/*
+ * read the result file of a solver: "optimal <cardinality>" and a line of
+ * lambda values, "infeasible" or "timeout"; return 'o', 'i' or 't'
+ */
+char readResult(const char* filename, unsigned long efm_count, char** set,
+        unsigned long* cardinality)
+{
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        quitError("Error in opening result file of solver\n", LTCS_ERROR_FILE);
+    }
+    char* line = NULL;
+    size_t len = 0;
+    char status = '\0';
+    if (getline(&line, &len, file) != -1)
+    {
+        if (!strncmp(line, "optimal", 7))
+        {
+            status = 'o';
+        }
+        else if (!strncmp(line, "infeasible", 10))
+        {
+            status = 'i';
+        }
+        else if (!strncmp(line, "timeout", 7))
+        {
+            status = 't';
+        }
+    }
+    if (status == 'o')
+    {
+        *set = calloc(1, BITNSLOTS(efm_count) + 1);
+        if (NULL == *set)
+        {
+            quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+        }
+        *cardinality = 0;
+        unsigned long ul = 0;
+        if (getline(&line, &len, file) != -1)
+        {
+            char* saveptr;
+            char* ptr;
+            for (ptr = strtok_r(line, ",\n\t ", &saveptr); NULL != ptr &&
+                    ul < efm_count; ptr = strtok_r(NULL, ",\n\t ",
+                        &saveptr)) {
+                if (atof(ptr) > 0.5)
+                {
+                    BITSET(*set, ul);
+                    (*cardinality)++;
+                }
+                ul++;
+            }
+        }
+        if (ul != efm_count)
+        {
+            status = '\0';
+            free(*set);
+        }
+    }
+    free(line);
+    fclose(file);
+    if (status == '\0')
+    {
+        fprintf(stderr, "%s: no result of %lu lambda values\n", filename,
+                efm_count);
+        quitError("Error in result file of solver\n", LTCS_ERROR_FILE);
+    }
+    return status;
+}
+
+/*
+ * sort sets by cardinality (descending)
+ */
+const unsigned long* sort_cardinality;
+int compareCardinality(const void* a, const void* b)
+{
+    unsigned long x = sort_cardinality[*(const unsigned long*) a];
+    unsigned long y = sort_cardinality[*(const unsigned long*) b];
+    if (x != y)
+    {
+        return x > y ? -1 : 1;
+    }
+    return *(const unsigned long*) a < *(const unsigned long*) b ? -1 : 1;
+}
+
+/*
+ * check if set a is a subset of set b
+ */
+int isSubset(const char* a, const char* b, size_t bytes)
+{
+    size_t i;
+    for (i = 0; i < bytes; i++) {
+        if (a[i] & ~b[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * write the solutions that are no subset of another solution (a window may
+ * find a set before the superset of a higher window), return their number
+ */
+unsigned long writeMaximalSets(FILE* file, struct set_list* list, unsigned
+        long efm_count, int csv)
+{
+    size_t bytes = BITNSLOTS(efm_count);
+    unsigned long* order = malloc((list->count + 1) * sizeof(unsigned long));
+    unsigned long* kept = malloc((list->count + 1) * sizeof(unsigned long));
+    if (NULL == order || NULL == kept)
+    {
+        quitError("Not enough free memory\n", LTCS_ERROR_RAM);
+    }
+    unsigned long ul, k;
+    for (ul = 0; ul < list->count; ul++) {
+        order[ul] = ul;
+    }
+    sort_cardinality = list->cardinality;
+    qsort(order, list->count, sizeof(unsigned long), compareCardinality);
+    unsigned long kept_count = 0;
+    for (ul = 0; ul < list->count; ul++) {
+        const char* set = list->sets[order[ul]];
+        for (k = 0; k < kept_count && !isSubset(set, list->sets[kept[k]],
+                    bytes); k++);
+        if (k == kept_count)
+        {
+            kept[kept_count++] = order[ul];
+            ltcsWriteSet(file, set, efm_count, csv);
+        }
+    }
+    free(order);
+    free(kept);
+    return kept_count;
+}
+
+/*
+ * find all solutions of the MILP of ltcstool_clever.pl (findAllSolutions)
+ * with concurrent solver processes: the range of the objective is split into
+ * disjoint windows, every solve gets the solutions found so far as cuts, a
+ * window is solved again below every solution until it is infeasible and a
+ * window that timed out is split for the idle workers
+ */
+int main (int argc, char *argv[])
+{
+    char time_string[TIME_STRING_SIZE];
+    //================================================== 
+    // define arguments and usage
+    char *optv[MAX_ARGS] = { "-i", "-e", "-n", "-t", "-w", "-s", "-d", "-x",
+        "-o", "-c" };
+    char *optd[MAX_ARGS] = {"MILP file (MPS of ltcsMilp or ltcsDecompose, LP of ltcstool_clever.pl)",
+                            "number of EFMs [default: highest lambda column of the MILP file]",
+                            "number of concurrent solvers [default: 1]",
+                            "number of threads of all solvers [default: number of solvers]",
+                            "number of initial windows [default: number of solvers]",
+                            "time limit of a solve in seconds [default: 600]",
+                            "working directory for cut, result and log files [default: ltcs_windows]",
+                            "solver command template: {mps} MILP file, {min} and {max} objective window, {cuts} solutions found so far, {out} result file, {t} threads, {limit} time limit, {i} number of the solve",
+                            "output file of the maximal solutions [default: solutions.out]",
+                            "print solutions in csv format [yes/no; default: yes]"};
+    char *optr[MAX_ARGS];
+    char *description = "Find all solutions of the MILP of ltcstool_clever.pl "
+        "with concurrent\nsolver processes on disjoint windows of the "
+        "objective";
+    char *usg = "\n   ltcsWindows -i model.mps -n 4 -t 16 -x \"perl "
+        "scripts/ltcstool_window.pl -i {mps} -a {min} -b {max} -c {cuts} -f "
+        "{out} -t {t} -x {limit}\"";
+    // end define arguments and usage
+    //================================================== 
+
+    //================================================== 
+    // read arguments
+    readArgs(argc, argv, MAX_ARGS, optv, optr);
+    if ( !optr[ARG_INPUT] || !optr[ARG_TEMPLATE] )
+    {
+        usage(description, usg, MAX_ARGS, optv, optd);
+        quitError("Missing argument\n", LTCS_ERROR_ARGS);
+    }
+    int workers = optr[ARG_WORKERS] ? atoi(optr[ARG_WORKERS]) : 1;
+    int threads = optr[ARG_THREADS] ? atoi(optr[ARG_THREADS]) : workers;
+    int windows = optr[ARG_WINDOWS] ? atoi(optr[ARG_WINDOWS]) : workers;
+    long limit = optr[ARG_LIMIT] ? atol(optr[ARG_LIMIT]) : 600;
+    if (workers < 1 || threads < 1 || windows < 1 || limit < 1)
+    {
+        quitError("number of solvers, threads, windows and time limit must "
+                "be greater than 0\n", LTCS_ERROR_ARGS);
+    }
+    // the threads are divided among the solvers
+    int solver_threads = threads / workers > 0 ? threads / workers : 1;
+    unsigned long efm_count = optr[ARG_EFMS] ? strtoul(optr[ARG_EFMS], NULL,
+            10) : getEfmCount(optr[ARG_INPUT]);
+    if (efm_count == 0)
+    {
+        quitError("No EFMs in MILP file\n", LTCS_ERROR_EFM);
+    }
+    char* dir = optr[ARG_DIR] ? optr[ARG_DIR] : "ltcs_windows";
+    char* output = optr[ARG_OUTPUT] ? optr[ARG_OUTPUT] : "solutions.out";
+    int csv_out = optr[ARG_CSV_OUT] && !strcmp(optr[ARG_CSV_OUT], "no") ? 0 :
+        1;
+    if (mkdir(dir, 0755) != 0 && access(dir, W_OK) != 0)
+    {
+        quitError("Error in creating working directory\n", LTCS_ERROR_FILE);
+    }
+    // end read arguments
+    //================================================== 
+
+    printf("Start: %s\n", getTime(time_string));
+    printf("\n");
+    printf("Input:            %s\n", optr[ARG_INPUT]);
+    printf("EFMs:             %lu\n", efm_count);
+    printf("Output:           %s\n", output);
+    printf("Solvers:          %d (%d threads each)\n", workers,
+            solver_threads);
+    printf("Time limit:       %ld\n", limit);
+    printf("Directory:        %s\n", dir);
+    printf("Template:         %s\n", optr[ARG_TEMPLATE]);
+    printf("\n");
+    fflush(stdout);
+
+    //================================================== 
+    // split the objective into windows
+    struct window* queue = NULL;
+    unsigned long queue_count = 0;
+    unsigned long queue_capacity = 0;
+    unsigned long width = (efm_count + windows - 1) / windows;
+    unsigned long max;
+    for (max = efm_count; max > 0; max = max > width ? max - width : 0) {
+        pushWindow(&queue, &queue_count, &queue_capacity, max > width ? max -
+                width + 1 : 1, max, 0);
+    }
+    // end split the objective
+    //================================================== 
+
+    //================================================== 
+    // solve windows
+    struct worker pool[workers];
+    memset(pool, 0, sizeof(pool));
+    struct set_list list = {NULL, NULL, 0, 0};
+    size_t bytes = BITNSLOTS(efm_count);
+    char cuts[strlen(dir) + 32];
+    char out[strlen(dir) + 32];
+    char logfile[strlen(dir) + 32];
+    unsigned long tasks = 0;
+    unsigned long timeouts = 0;
+    int running = 0;
+    int w;
+    while (queue_count > 0 || running > 0)
+    {
+        for (w = 0; w < workers && queue_count > 0; w++) {
+            if (pool[w].pid > 0)
+            {
+                continue;
+            }
+            // every solve gets all solutions found so far
+            sprintf(cuts, "%s/worker%d.cuts", dir, w + 1);
+            sprintf(out, "%s/worker%d.out", dir, w + 1);
+            writeCuts(cuts, &list, efm_count);
+            unlink(out);
+            pool[w].window = popWindow(queue, &queue_count);
+            pool[w].task = ++tasks;
+            char* command = applyTemplate(optr[ARG_TEMPLATE], optr[ARG_INPUT],
+                    &pool[w].window, cuts, out, solver_threads, limit,
+                    pool[w].task);
+            sprintf(logfile, "%s/solve%lu.log", dir, pool[w].task);
+            printf("%s solve %lu: window %lu-%lu, %lu cuts\n", getTime(time_string),
+                    pool[w].task, pool[w].window.min, pool[w].window.max,
+                    list.count);
+            fflush(stdout);
+            pool[w].pid = launch(command, logfile);
+            free(command);
+            if (pool[w].pid < 0)
+            {
+                quitError("Error in starting solver\n", LTCS_ERROR_ARGS);
+            }
+            running++;
+        }
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            quitError("Error in waiting for solver\n", LTCS_ERROR_ARGS);
+        }
+        for (w = 0; w < workers && pool[w].pid != pid; w++);
+        if (w == workers)
+        {
+            continue;
+        }
+        pool[w].pid = 0;
+        running--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "solve %lu failed, see %s/solve%lu.log\n",
+                    pool[w].task, dir, pool[w].task);
+            quitError("Error in solving MILP\n", LTCS_ERROR_ARGS);
+        }
+        struct window window = pool[w].window;
+        sprintf(out, "%s/worker%d.out", dir, w + 1);
+        char* set = NULL;
+        unsigned long cardinality = 0;
+        char result = readResult(out, efm_count, &set, &cardinality);
+        if (result == 'o')
+        {
+            printf("%s solve %lu: solution of cardinality %lu\n", getTime(time_string),
+                    pool[w].task, cardinality);
+            if (!addSet(&list, set, cardinality, bytes))
+            {
+                quitError("Solver found a solution twice, are the cuts "
+                        "used?\n", LTCS_ERROR_ARGS);
+            }
+            // further solutions of the window are not larger
+            if (cardinality >= window.min)
+            {
+                pushWindow(&queue, &queue_count, &queue_capacity, window.min,
+                        cardinality < window.max ? cardinality : window.max,
+                        window.unlimited);
+            }
+        }
+        else if (result == 't')
+        {
+            timeouts++;
+            printf("%s solve %lu: time limit reached\n", getTime(time_string),
+                    pool[w].task);
+            if (window.min < window.max)
+            {
+                // idle workers take over the halves of the window
+                unsigned long mid = window.min + (window.max - window.min) /
+                    2;
+                pushWindow(&queue, &queue_count, &queue_capacity, mid + 1,
+                        window.max, 0);
+                pushWindow(&queue, &queue_count, &queue_capacity, window.min,
+                        mid, 0);
+            }
+            else if (!window.unlimited)
+            {
+                pushWindow(&queue, &queue_count, &queue_capacity, window.min,
+                        window.max, 1);
+            }
+            else
+            {
+                quitError("Could not find solution within time limit\n",
+                        LTCS_ERROR_ARGS);
+            }
+        }
+        fflush(stdout);
+    }
+    printf("%s all windows solved\n", getTime(time_string));
+    // end solve windows
+    //================================================== 
+
+    //================================================== 
+    // write maximal solutions
+    FILE* fileout = fopen(output, "w");
+    if (!fileout)
+    {
+        quitError("Error in opening output file\n", LTCS_ERROR_FILE);
+    }
+    unsigned long maximal = writeMaximalSets(fileout, &list, efm_count,
+            csv_out);
+    if (ferror(fileout) || fclose(fileout) != 0)
+    {
+        quitError("Error in writing output file\n", LTCS_ERROR_FILE);
+    }
+    // end write maximal solutions
+    //================================================== 
+
+    printf("\n");
+    printf("Nr of solves:         %lu\n", tasks);
+    printf("Nr of time limits:    %lu\n", timeouts);
+    printf("Nr of solutions:      %lu\n", list.count);
+    printf("Nr of maximal sets:   %lu\n", maximal);
+    printf("\n");
+    printf("End: %s\n", getTime(time_string));
+    unsigned long ul;
+    for (ul = 0; ul < list.count; ul++) {
+        free(list.sets[ul]);
+    }
+    free(list.sets);
+    free(list.cardinality);
+    free(queue);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+#
+# run the tests of ltcsCalculator: every test program in obj (built by
+# make test) and every test script in tests
+#
+# usage: run_tests.sh [test ...]
+#   runs only the given tests (e.g. testIndexWidth testDecompose.sh)
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+TESTS="$*"
+if [ -z "$TESTS" ]; then
+    TESTS=$(cd "$DIR/obj" && ls test* 2>/dev/null | grep -v "\.o$")
+    TESTS="$TESTS $(cd "$DIR/tests" && ls test*.sh 2>/dev/null)"
+fi
+
+failed=0
+for t in $TESTS; do
+    case $t in
+        *.sh) "$DIR/tests/$t" ;;
+        *) "$DIR/obj/$t" ;;
+    esac
+    if [ $? -ne 0 ]; then
+        echo "$t: FAILED"
+        failed=$((failed+1))
+    fi
+done
+if [ $failed -gt 0 ]; then
+    echo "$failed tests failed"
+    exit 1
+fi
+echo "all tests passed"
@@ -0,0 +1,40 @@
+#!/bin/bash
+#
+# anytime search on the example EFMs (with internal loops) and on a synthetic
+# EFM set of genEfms: every written set has to be an LTCS of the full
+# calculation and no set may be written twice
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 2000 -r 30 -d 0.3 -c 0.3 -s 1 -o "$TMP/gen.efms" \
+    > /dev/null || exit 1
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" \
+        -l "$TMP/$name.loops" -t 2 > "$TMP/$name.log" || exit 1
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.any" \
+        -l "$TMP/$name.loops" -t 4 --time-budget 1 > "$TMP/$name.alog" \
+        || exit 1
+    if [ ! -s "$TMP/$name.any" ]; then
+        echo "testAnytime: no set found for $name"
+        exit 1
+    fi
+    if [ -n "$(sort "$TMP/$name.any" | uniq -d)" ]; then
+        echo "testAnytime: set of $name written more than once"
+        exit 1
+    fi
+    if [ -n "$(comm -23 <(sort "$TMP/$name.any") <(sort "$TMP/$name.out"))" ]
+    then
+        echo "testAnytime: set of $name is no LTCS"
+        exit 1
+    fi
+    echo "testAnytime: $name ok ($(grep -c "" "$TMP/$name.any") LTCS)"
+done <<< "$CASES"
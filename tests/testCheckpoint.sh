@@ -0,0 +1,74 @@
+#!/bin/bash
+#
+# checkpoint of ltcstool_clever.pl and ltcstool_hotstart_clever.pl (module
+# scripts/LtcsCheckpoint.pm, no CPLEX needed): windows and solutions written
+# to a checkpoint have to be read back, a record cut off by an interrupted run
+# has to be removed so that the run can append and resume, and a checkpoint
+# of another base lp file or EFM count has to be rejected
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+perl -I"$DIR/scripts" -MLtcsCheckpoint -e '
+my ($dir) = @ARGV;
+my $base = "$dir/temp_0.lp";
+my $ckp = "$dir/run.ckp";
+my $efm_nr = 21;
+my @bits = ("101100111000111100001", "010011000111000011110",
+    "111111111111111111111");
+sub fail { print "testCheckpoint: $_[0]\n"; exit 1; }
+sub check {
+    my ($what, $count, $window) = @_;
+    my ($solutions, $last) = readCheckpoint($ckp, $base, $efm_nr);
+    fail("$what: ".scalar(@{$solutions})." solutions instead of $count")
+        unless scalar(@{$solutions}) == $count;
+    for (my $i = 0; $i < $count; $i++) {
+        fail("$what: solution ".($i + 1)." differs")
+            unless $solutions->[$i] eq $bits[$i];
+    }
+    fail("$what: last window differs")
+        unless defined($last) and join(",", @{$last}) eq $window;
+}
+
+open(my $fh, ">", $base) or die;
+print $fh "Maximize\n obj: l1 + l2 + l3\nEnd\n";
+close($fh);
+
+createCheckpoint($ckp, $base, $efm_nr);
+appendCheckpoint($ckp, checkpointWindow(1, $efm_nr, 20));
+appendCheckpoint($ckp, checkpointSolution(12, $bits[0]));
+appendCheckpoint($ckp, checkpointWindow(1, 12, 11));
+appendCheckpoint($ckp, checkpointSolution(10, $bits[1]));
+check("written", 2, "1,12,11");
+
+# interrupted while writing a window and while writing a solution
+my $size = -s $ckp;
+appendCheckpoint($ckp, substr(checkpointWindow(1, 10, 9), 0, 7));
+check("cut window", 2, "1,12,11");
+fail("cut window not removed") unless -s $ckp == $size;
+appendCheckpoint($ckp, substr(checkpointSolution(21, $bits[2]), 0, 6));
+check("cut solution", 2, "1,12,11");
+fail("cut solution not removed") unless -s $ckp == $size;
+
+# resume after the cut record
+appendCheckpoint($ckp, checkpointWindow(1, 10, 9));
+appendCheckpoint($ckp, checkpointSolution(21, $bits[2]));
+check("resumed", 3, "1,10,9");
+
+# other base lp file, other number of EFMs, no checkpoint
+open($fh, ">>", $base) or die;
+print $fh "\\ SOL_1\n";
+close($fh);
+fail("checkpoint of another lp file accepted")
+    if eval { readCheckpoint($ckp, $base, $efm_nr); 1 };
+fail("wrong message for another lp file: $@")
+    unless $@ =~ /does not belong/;
+createCheckpoint($ckp, $base, $efm_nr);
+fail("checkpoint of another EFM count accepted")
+    if eval { readCheckpoint($ckp, $base, $efm_nr + 1); 1 };
+fail("lp file accepted as checkpoint")
+    if eval { readCheckpoint($base, $base, $efm_nr); 1 };
+print "testCheckpoint: ok\n";
+' "$TMP"
@@ -0,0 +1,38 @@
+#!/bin/bash
+#
+# runs ltcsCoordinator with 1, 2, 3 and 5 shards on the example EFMs (with
+# internal loops) and on a synthetic EFM set of genEfms; the merged LTCS have
+# to equal the LTCS of a single calcLtcs run
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 2000 -r 30 -d 0.3 -c 0.3 -s 1 -o "$TMP/gen.efms" \
+    -f "$TMP/gen.rfile" > /dev/null || exit 1
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" \
+        -l "$TMP/$name.loops" -t 2 > "$TMP/$name.log" || exit 1
+    for n in 1 2 3 5; do
+        "$DIR/bin/ltcsCoordinator" -i "$efms" $args -n $n -t 2 \
+            -o "$TMP/$name$n.out" -l "$TMP/$name$n.loops" \
+            -d "$TMP/shards_$name$n" > "$TMP/$name$n.log" || exit 1
+        if ! cmp -s <(sort "$TMP/$name.out") <(sort "$TMP/$name$n.out"); then
+            echo "testCoordinator: LTCS of $name with $n shards differ"
+            exit 1
+        fi
+        if [ -e "$TMP/$name.loops" ] && ! cmp -s "$TMP/$name.loops" \
+                "$TMP/$name$n.loops"; then
+            echo "testCoordinator: loops of $name with $n shards differ"
+            exit 1
+        fi
+    done
+    echo "testCoordinator: $name ok ($(grep -c "" "$TMP/$name.out") LTCS)"
+done <<< "$CASES"
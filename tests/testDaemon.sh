@@ -0,0 +1,49 @@
+#!/bin/bash
+#
+# ltcsDaemon with a client that connects but does not send its request: other
+# clients have to be answered at once, the LTCS of a compute request have to
+# equal those of calcLtcs and the silent client gets a timeout
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'kill $DAEMON 2> /dev/null; rm -rf "$TMP"' EXIT
+
+"$DIR/bin/calcLtcs" -i "$EX/efms.txt" -s "$EX/sfile" -o "$TMP/ltcs.out" \
+    -l "$TMP/loops.out" > "$TMP/calcLtcs.log" || exit 1
+
+"$DIR/bin/ltcsDaemon" -s "$TMP/sock" -t 2 -r 3 > "$TMP/daemon.log" &
+DAEMON=$!
+for i in $(seq 50); do
+    [ -S "$TMP/sock" ] && break
+    sleep 0.1
+done
+
+perl -MIO::Socket::UNIX -e '$s = IO::Socket::UNIX->new(Peer => $ARGV[0])
+    or die; print <$s>' "$TMP/sock" > "$TMP/silent.out" &
+SILENT=$!
+sleep 0.5
+
+start=$(date +%s%N)
+"$DIR/bin/ltcsClient" "$TMP/sock" compute efm="$EX/efms.txt" \
+    sfile="$EX/sfile" output=- > "$TMP/compute.out" || exit 1
+elapsed=$(( ($(date +%s%N) - start) / 1000000 ))
+if [ $elapsed -ge 2000 ]; then
+    echo "testDaemon: request took $elapsed ms while a client was silent"
+    exit 1
+fi
+if ! cmp -s <(sort "$TMP/ltcs.out") <(grep "^[01]" "$TMP/compute.out" |
+        sort); then
+    echo "testDaemon: LTCS of the daemon differ from calcLtcs"
+    exit 1
+fi
+
+wait $SILENT
+if ! grep -q "error request timeout" "$TMP/silent.out"; then
+    echo "testDaemon: silent client got no timeout"
+    exit 1
+fi
+"$DIR/bin/ltcsClient" "$TMP/sock" shutdown > /dev/null || exit 1
+wait $DAEMON || exit 1
+echo "testDaemon: ok ($elapsed ms while a client was silent)"
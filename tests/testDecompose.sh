@@ -0,0 +1,28 @@
+#!/bin/bash
+#
+# runs ltcsDecompose on the example model with the solver stub, which accepts
+# every LTCS as a whole; the merged feasible sets have to equal the LTCS of
+# calcLtcs for the reversibility of the model
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/perlScripts
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/ltcsSbml" -i "$EX/model.xml" -o "$EX/rfile.txt" -s "$TMP/sfile" \
+    -v "$TMP/rvfile" -r "$TMP/rfile" > "$TMP/sbml.log" || exit 1
+"$DIR/bin/calcLtcs" -i "$EX/modes.example" -v "$TMP/rvfile" \
+    -o "$TMP/ltcs.out" > "$TMP/calcLtcs.log" || exit 1
+for n in 1 3; do
+    "$DIR/bin/ltcsDecompose" -s "$EX/model.xml" -r "$EX/rfile.txt" \
+        -e "$EX/modes.example" -c "$EX/conc.csv" -g "$EX/dfg.txt" -o M_h_c \
+        -t 2 -n $n -d "$TMP/milps$n" -l "$TMP/feasible$n.out" \
+        -x "perl $DIR/scripts/ltcstool_stub.pl -i {mps} -s {n} -f {sol}" \
+        > "$TMP/decompose$n.log" || exit 1
+    if ! cmp -s <(sort "$TMP/ltcs.out") <(sort "$TMP/feasible$n.out"); then
+        echo "testDecompose: feasible sets of $n solvers differ from LTCS"
+        exit 1
+    fi
+done
+echo "testDecompose: ok ($(grep -c "" "$TMP/ltcs.out") LTCS)"
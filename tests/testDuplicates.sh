@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# splitting different sets can give equal sets; the filter has to keep only
+# one of them, with the fixed-width kernels (up to 512 EFMs) as well as with
+# the general ones. The telemetry of the filter stage has to report removed
+# duplicates, otherwise the case is not tested
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# case name, number of EFMs of genEfms
+CASES="fixed 300
+general 2000"
+
+while read -r name count; do
+    "$DIR/bin/genEfms" -n $count -r 30 -d 0.3 -c 0.3 -s 1 \
+        -o "$TMP/$name.efms" > /dev/null || exit 1
+    "$DIR/bin/calcLtcs" -i "$TMP/$name.efms" -o "$TMP/$name.out" -t 2 \
+        --telemetry "$TMP/$name.json" > "$TMP/$name.log" || exit 1
+    removed=$(grep '"stage":"filter"' "$TMP/$name.json" | \
+        sed 's/.*"duplicates":\([0-9]*\).*/\1/')
+    if [ -z "$removed" ] || [ "$removed" -eq 0 ]; then
+        echo "testDuplicates: no duplicates removed for $name"
+        exit 1
+    fi
+    if [ -n "$(sort "$TMP/$name.out" | uniq -d)" ]; then
+        echo "testDuplicates: LTCS of $name written more than once"
+        exit 1
+    fi
+    echo "testDuplicates: $name ok ($removed duplicates removed)"
+done <<< "$CASES"
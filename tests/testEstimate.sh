@@ -0,0 +1,43 @@
+#!/bin/bash
+#
+# estimates of calcLtcs --estimate on synthetic EFM sets of genEfms: the
+# number of LTCS and the frontier of the last iteration of a full calculation
+# have to lie in the 95% confidence intervals (the random descents use fixed
+# seeds, so the result does not change between runs)
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# case name, arguments of genEfms
+CASES="seed1 -n 500 -s 1
+seed3 -n 500 -s 3
+large -n 2000 -s 1"
+
+while read -r name args; do
+    "$DIR/bin/genEfms" $args -r 30 -d 0.3 -c 0.3 -o "$TMP/$name.efms" \
+        > /dev/null || exit 1
+    "$DIR/bin/calcLtcs" -i "$TMP/$name.efms" -o "$TMP/$name.out" -t 2 \
+        --telemetry "$TMP/$name.json" > "$TMP/$name.log" || exit 1
+    "$DIR/bin/calcLtcs" -i "$TMP/$name.efms" -o "$TMP/$name.csv" -t 4 \
+        --estimate 20000 > "$TMP/$name.elog" || exit 1
+    ltcs=$(grep -c "" "$TMP/$name.out")
+    frontier=$(grep '"type":"stage".*"stage":"split"' "$TMP/$name.json" | \
+        sed 's/.*"frontier":\([0-9]*\).*/\1/')
+    read -r low high <<< "$(sed -n \
+        's/^Estimated LTCS:.*(95% ci \([0-9]*\) - \([0-9]*\)).*/\1 \2/p' \
+        "$TMP/$name.elog")"
+    if [ -z "$low" ] || [ "$ltcs" -lt "$low" ] || [ "$ltcs" -gt "$high" ]
+    then
+        echo "testEstimate: $ltcs LTCS of $name not in [$low, $high]"
+        exit 1
+    fi
+    IFS=, read -r it est flow fhigh <<< "$(tail -n 1 "$TMP/$name.csv")"
+    if [ -z "$frontier" ] || [ "$frontier" -lt "$flow" ] || \
+            [ "$frontier" -gt "$fhigh" ]; then
+        echo "testEstimate: frontier $frontier of $name not in [$flow, $fhigh]"
+        exit 1
+    fi
+    echo "testEstimate: $name ok ($ltcs LTCS in [$low, $high])"
+done <<< "$CASES"
@@ -0,0 +1,57 @@
+#!/bin/bash
+#
+# LP check of ltcsDecompose (-f yes) on the example model with the
+# concentration of one metabolite fixed at its maximum or of all metabolites
+# fixed (geometric mean of the range, the MILP of the only feasible set has
+# no DrG row), so that LTCS are split: the feasible sets have to equal those of testFeasible.expected (EFM
+# numbers, checked once by adding every other EFM of their LTCS) for 1 and 4
+# threads, and each set alone has to pass the LP check without a split
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/perlScripts
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# LP check of EFM file $1 with concentrations $2 and $3 threads to $4.out
+decompose() {
+    "$DIR/bin/ltcsDecompose" -s "$EX/model.xml" -r "$EX/rfile.txt" -e "$1" \
+        -c "$2" -g "$EX/dfg.txt" -o M_h_c -t $3 -n 1 -d "$4_milps" \
+        -l "$4.out" -f yes \
+        -x "perl $DIR/scripts/ltcstool_stub.pl -i {mps} -s {n} -f {sol}" \
+        > "$4.log"
+}
+
+for met in M_glyc3p_c M_e4p_c all; do
+    awk -F';' -v met=$met 'BEGIN {OFS=";"} met == "all" {$3 = sqrt($3 * $4);
+        $4 = $3} $1 == met {$3 = $4} {print}' "$EX/conc.csv" > "$TMP/$met.csv"
+    for t in 1 4; do
+        decompose "$EX/modes.example" "$TMP/$met.csv" $t "$TMP/$met$t" \
+            || exit 1
+    done
+    if ! cmp -s <(sort "$TMP/${met}1.out") <(sort "$TMP/${met}4.out"); then
+        echo "testFeasible: feasible sets of $met differ for 1 and 4 threads"
+        exit 1
+    fi
+    awk -F, -v met=$met '{s = ""; for (i = 1; i <= NF; i++) if ($i == 1)
+        s = s (s == "" ? "" : ",") i; print met, s}' "$TMP/${met}1.out" | \
+        sort > "$TMP/$met.sets"
+    grep "^$met " "$DIR/tests/testFeasible.expected" | sort > "$TMP/$met.exp"
+    if ! cmp -s "$TMP/$met.sets" "$TMP/$met.exp"; then
+        echo "testFeasible: feasible sets of $met differ from expected sets"
+        exit 1
+    fi
+    k=0
+    while read -r name efms; do
+        k=$((k+1))
+        awk -v efms=$efms 'BEGIN {n = split(efms, e, ","); for (i = 1; i <= n;
+            i++) use[e[i]] = 1} NR in use' "$EX/modes.example" \
+            > "$TMP/set$k.efms"
+        decompose "$TMP/set$k.efms" "$TMP/$met.csv" 1 "$TMP/set$k" || exit 1
+        if ! grep -q " 1 LTCS feasible, 0 split" "$TMP/set$k.log"; then
+            echo "testFeasible: feasible set $k of $met fails the LP check"
+            exit 1
+        fi
+    done < "$TMP/$met.sets"
+    echo "testFeasible: $met ok ($k feasible sets)"
+done
@@ -0,0 +1,45 @@
+#!/bin/bash
+#
+# fixed-width kernels on the example EFMs (with internal loops) and on
+# synthetic EFM sets of genEfms around every width of 64, 128, 256 and 512
+# bits: the telemetry has to show the expected width, the LTCS have to equal
+# those of the generic kernel (forced by a memory limit) and a run with four
+# threads has to write them in the order of a run with one thread
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# case name, 64 bit words of a set, EFM file, further arguments of calcLtcs
+CASES="example 1 $EX/efms.txt -s $EX/sfile -v $EX/rvfile"
+for n in 64 65 128 129 256 257 512; do
+    "$DIR/bin/genEfms" -n $n -r 30 -d 0.3 -c 0.3 -s 2 -o "$TMP/gen$n.efms" \
+        > /dev/null || exit 1
+    CASES="$CASES
+gen$n $(( n <= 64 ? 1 : n <= 128 ? 2 : n <= 256 ? 4 : 8 )) $TMP/gen$n.efms"
+done
+
+while read -r name words efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.generic" -t 1 \
+        --memory-limit 100000 > "$TMP/$name.glog" || exit 1
+    for t in 1 4; do
+        "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.t$t" -t $t \
+            --telemetry "$TMP/$name.t$t.json" > "$TMP/$name.t$t.log" || exit 1
+        if ! grep '"type":"stage".*"stage":"split"' "$TMP/$name.t$t.json" | \
+                grep -q "\"words\":$words}"; then
+            echo "testFixed: $name with $t threads not split with $words words"
+            exit 1
+        fi
+    done
+    if ! cmp -s <(sort "$TMP/$name.t1") <(sort "$TMP/$name.generic"); then
+        echo "testFixed: LTCS of $name differ from the generic kernel"
+        exit 1
+    fi
+    if ! cmp -s "$TMP/$name.t1" "$TMP/$name.t4"; then
+        echo "testFixed: order of the LTCS of $name differs with 4 threads"
+        exit 1
+    fi
+    echo "testFixed: $name ok ($words words, $(grep -c "" "$TMP/$name.t1") LTCS)"
+done <<< "$CASES"
@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// Author: Matthias Gerstl
+// Email: matthias.gerstl@acib.at
+// Company: Austrian Centre of Industrial Biotechnology (ACIB)
+// Web: http://www.acib.at Copyright
+// (C) 2015 Published unter GNU Public License V3
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * checks the size and index arithmetic of the EFM matrices for more than 2^31
+ * EFMs without loading that many: chunk and bit helpers are called with large
+ * counts, the EFM count of a sparse text file is estimated and rows are taken
+ * from a loader whose position is moved behind 2^31
+ */
+
+#include <unistd.h>
+
+#include "../src/ltcsIntern.h"
+
+int failures = 0;
+
+void check(int condition, const char* what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+void checkHelpers()
+{
+    unsigned long big = 1UL << 31;
+    check(ltcs_getBitsize(big) == big / 8, "ltcs_getBitsize(2^31)");
+    check(ltcs_getBitsize(big + 1) == big / 8 + 1, "ltcs_getBitsize(2^31+1)");
+    check(ltcs_getBitsize(2 * (big + 3)) == (big + 3) / 4 + 1,
+            "ltcs_getBitsize(2*(2^31+3))");
+    check(ltcs_getBitsize(1UL << 40) == 1UL << 37, "ltcs_getBitsize(2^40)");
+    check(ltcs_getChunkCount(big) == big / MATRIX_CHUNK,
+            "ltcs_getChunkCount(2^31)");
+    check(ltcs_getChunkCount(big + 1) == big / MATRIX_CHUNK + 1,
+            "ltcs_getChunkCount(2^31+1)");
+    check(ltcs_getChunkCount(1UL << 33) == (1UL << 33) / MATRIX_CHUNK,
+            "ltcs_getChunkCount(2^33)");
+    check(ltcs_getChunkRows(0, big + 1) == MATRIX_CHUNK,
+            "ltcs_getChunkRows(0, 2^31+1)");
+    check(ltcs_getChunkRows(big / MATRIX_CHUNK - 1, big + 1) == MATRIX_CHUNK,
+            "ltcs_getChunkRows of the chunk before 2^31");
+    check(ltcs_getChunkRows(big / MATRIX_CHUNK, big + 1) == 1,
+            "ltcs_getChunkRows of the chunk after 2^31");
+    check(ltcs_getChunkRows(ltcs_getChunkCount(3 * big + 5) - 1, 3 * big + 5)
+            == 5, "ltcs_getChunkRows of the last chunk of 3*2^31+5");
+
+    unsigned long ix = big + 13;
+    check(BITSLOT(ix) == big / 8 + 1, "BITSLOT(2^31+13)");
+    check(BITMASK(ix) == 1 << 5, "BITMASK(2^31+13)");
+    // second bit of reaction r in the full matrix
+    unsigned long rx = big + 2;
+    check(BITSLOT(2*rx+1) == big / 4, "BITSLOT(2*(2^31+2)+1)");
+    check(BITMASK(2*rx+1) == 1 << 5, "BITMASK(2*(2^31+2)+1)");
+}
+
+/*
+ * a sparse text file as long as 2^31+10 copies of its first line
+ */
+void checkEstimate()
+{
+    char filename[] = "/tmp/testIndexWidthXXXXXX";
+    int fd = mkstemp(filename);
+    FILE* file = fd < 0 ? NULL : fdopen(fd, "w+");
+    if (NULL == file)
+    {
+        check(0, "temporary file for ltcs_estimateEfmCount");
+        return;
+    }
+    unlink(filename);
+    const char* line = "1.0 0.0 -1.0 0.5 0.0 0.0 -2.0\n";
+    long len = strlen(line);
+    unsigned long lines = (1UL << 31) + 10;
+    fputs(line, file);
+    fflush(file);
+    if (ftruncate(fd, len * lines) != 0)
+    {
+        printf("skipped ltcs_estimateEfmCount: no sparse file of %lu bytes\n",
+                len * lines);
+        fclose(file);
+        return;
+    }
+    fseek(file, len, SEEK_SET);
+    unsigned long estimate = ltcs_estimateEfmCount(file);
+    check(estimate > 1UL << 31 && estimate >= lines,
+            "ltcs_estimateEfmCount of a file with 2^31+10 lines");
+    fclose(file);
+
+    ltcs_context* ctx = ltcsCreateContext();
+    struct efm_loader loader;
+    check(ltcs_startLoading(ctx, 4, &loader) == LTCS_OK, "ltcs_startLoading");
+    if (ltcs_reserveLoading(ctx, &loader, estimate) != LTCS_OK)
+    {
+        printf("skipped loader rows: %s", ltcsGetErrorMessage(ctx));
+        ltcs_abortLoading(&loader, LTCS_OK);
+        ltcsFreeContext(ctx);
+        return;
+    }
+    check(loader.capacity == estimate, "capacity reserved for the estimate");
+
+    // continue loading at EFM 2^31 as if all EFMs before had been loaded
+    // without their chunks
+    unsigned long first = 1UL << 31;
+    unsigned long uc;
+    for (uc = 0; uc < first / MATRIX_CHUNK; uc++) {
+        loader.chunks[uc] = NULL;
+    }
+    loader.chunk_count = first / MATRIX_CHUNK;
+    loader.mat_ix = first;
+    char signs[1] = {0};
+    BITSET(signs, 0);
+    BITSET(signs, 3);
+    BITSET(signs, 5);
+    check(ltcs_loadEfmSigns(ctx, &loader, signs, 0) == LTCS_OK,
+            "ltcs_loadEfmSigns at 2^31");
+    check(ltcs_loadEfmSigns(ctx, &loader, signs, 1) == LTCS_OK,
+            "ltcs_loadEfmSigns of a loop at 2^31+1");
+    check(ltcs_loadEfmSigns(ctx, &loader, signs, 0) == LTCS_OK,
+            "ltcs_loadEfmSigns at 2^31+2");
+    check(loader.mat_ix == first + 3 && loader.chunk_count == first /
+            MATRIX_CHUNK + 1, "loader position behind 2^31");
+    char* chunk = loader.chunks[first / MATRIX_CHUNK];
+    check(NULL != chunk && chunk[0] == signs[0] && chunk[2 *
+            loader.row_bytes] == signs[0], "rows of the chunk after 2^31");
+    check(!BITTEST(loader.loops, first) && BITTEST(loader.loops, first + 1)
+            && !BITTEST(loader.loops, first + 2), "loops after 2^31");
+    ltcs_abortLoading(&loader, LTCS_OK);
+    ltcsFreeContext(ctx);
+}
+
+int main(int argc, char *argv[])
+{
+    checkHelpers();
+    checkEstimate();
+    if (failures > 0)
+    {
+        fprintf(stderr, "testIndexWidth: %d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("testIndexWidth: ok\n");
+    return EXIT_SUCCESS;
+}
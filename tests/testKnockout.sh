@@ -0,0 +1,40 @@
+#!/bin/bash
+#
+# knockout scan of all reactions on the example EFMs (with internal loops) and
+# on a synthetic EFM set of genEfms: the LTCS of each knockout have to equal
+# those of a calcLtcs run on the EFMs that do not use the reaction
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 1000 -r 20 -d 0.3 -c 0.3 -s 2 -o "$TMP/gen.efms" \
+    > /dev/null || exit 1
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" -t 2 \
+        --knockout all > "$TMP/$name.log" || exit 1
+    reactions=$(head -n 1 "$efms" | awk '{print NF}')
+    for r in $(seq $reactions); do
+        awk -v r=$r '$r > 1e-10 || $r < -1e-10 {next} {print}' "$efms" \
+            > "$TMP/$name.ko$r.efms"
+        if [ ! -s "$TMP/$name.ko$r.efms" ]; then
+            # no EFM is left without the reaction
+            continue
+        fi
+        "$DIR/bin/calcLtcs" -i "$TMP/$name.ko$r.efms" $args \
+            -o "$TMP/$name.ko$r.expected" > "$TMP/$name.ko$r.log" || exit 1
+        if ! cmp -s <(sort "$TMP/$name.out.ko$r") \
+                <(sort "$TMP/$name.ko$r.expected"); then
+            echo "testKnockout: LTCS of $name without reaction $r differ"
+            exit 1
+        fi
+    done
+    echo "testKnockout: $name ok ($reactions knockouts)"
+done <<< "$CASES"
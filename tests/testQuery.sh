@@ -0,0 +1,130 @@
+#!/bin/bash
+#
+# queries of ltcsQuery on the index of the example EFMs (with internal loops)
+# and of a synthetic EFM set of genEfms: the answers have to equal those
+# calculated directly from the EFM signs, the loops and the LTCS written by
+# calcLtcs (half of the queries are subsets of an LTCS, the others random
+# sets of EFMs)
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 300 -r 20 -d 0.3 -c 0.3 -s 1 -o "$TMP/gen.efms" \
+    > /dev/null || exit 1
+
+# random queries: consistent, contains and extend for sets of 1 to 4 EFMs
+QUERIES='
+BEGIN {FS = ","; srand(seed)}
+{ltcs[NR] = $0}
+END {
+    split("consistent contains extend", types, " ")
+    for (q = 0; q < 300; q++) {
+        size = 1 + int(rand() * 4)
+        set = ""
+        if (q % 2) {
+            n = split(ltcs[1 + int(rand() * NR)], bits, ",")
+            for (i = 0; i < size; i++) {
+                do {e = 1 + int(rand() * n)} while (bits[e] != 1)
+                set = set (i ? "," : "") e
+            }
+        } else {
+            n = split(ltcs[1], bits, ",")
+            for (i = 0; i < size; i++) {
+                set = set (i ? "," : "") (1 + int(rand() * n))
+            }
+        }
+        print types[1 + q % 3], set
+    }
+}'
+
+# answers from the EFM file, the loops and the LTCS
+ANSWERS='
+FILENAME == efms {
+    for (r = 1; r <= NF; r++) {
+        sign[FNR, r] = $r > 1e-10 ? 1 : ($r < -1e-10 ? -1 : 0)
+    }
+    rx = NF
+    next
+}
+FILENAME == loopfile {
+    n = split($0, bits, ",")
+    for (e = 1; e <= n; e++) loop[e] = bits[e] == 1
+    next
+}
+FILENAME == ltcsfile {
+    ltcs_count = FNR
+    efm_count = split($0, bits, ",")
+    size[FNR] = 0
+    for (e = 1; e <= efm_count; e++) {
+        member[FNR, e] = bits[e] == 1
+        size[FNR] += member[FNR, e]
+    }
+    next
+}
+{
+    n = split($2, set, ",")
+    if ($1 == "consistent") {
+        ok = 1
+        for (r = 1; r <= rx; r++) {
+            pos = neg = 0
+            for (i = 1; i <= n; i++) {
+                pos += sign[set[i], r] > 0
+                neg += sign[set[i], r] < 0
+            }
+            if (pos && neg) ok = 0
+        }
+        for (i = 1; i <= n; i++) if (loop[set[i]]) ok = 0
+        print ok ? "yes" : "no"
+        next
+    }
+    count = 0
+    list = ""
+    best = 0
+    for (l = 1; l <= ltcs_count; l++) {
+        ok = 1
+        for (i = 1; i <= n; i++) if (!member[l, set[i]]) ok = 0
+        if (ok) {
+            list = list (count ? "," : "") l
+            count++
+            if (!best || size[l] > size[best]) best = l
+        }
+    }
+    if ($1 == "contains") {
+        print count "\t" list
+    } else if (!best) {
+        print "none"
+    } else {
+        list = ""
+        for (e = 1; e <= efm_count; e++) {
+            if (member[best, e]) list = list (list == "" ? "" : ",") e
+        }
+        print best "\t" size[best] "\t" list
+    }
+}'
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" -t 2 \
+        -l "$TMP/$name.loops" --index "$TMP/$name.idx" \
+        > "$TMP/$name.log" || exit 1
+    touch "$TMP/$name.loops"
+    awk -v seed=1 "$QUERIES" "$TMP/$name.out" > "$TMP/$name.queries"
+    "$DIR/bin/ltcsQuery" -x "$TMP/$name.idx" -q "$TMP/$name.queries" \
+        -o "$TMP/$name.answers" > "$TMP/$name.qlog" 2>&1 || exit 1
+    awk -v efms="$efms" -v loopfile="$TMP/$name.loops" \
+        -v ltcsfile="$TMP/$name.out" "$ANSWERS" "$efms" "$TMP/$name.loops" \
+        "$TMP/$name.out" "$TMP/$name.queries" > "$TMP/$name.expected"
+    if ! cmp -s "$TMP/$name.answers" "$TMP/$name.expected"; then
+        echo "testQuery: answers of $name differ"
+        diff "$TMP/$name.answers" "$TMP/$name.expected" | head -n 6
+        exit 1
+    fi
+    echo "testQuery: $name ok ($(grep -c "" "$TMP/$name.queries") queries," \
+        "$(grep -c "^yes" "$TMP/$name.answers") consistent)"
+done <<< "$CASES"
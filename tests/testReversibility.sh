@@ -0,0 +1,55 @@
+#!/bin/bash
+#
+# changes of the reversibility of a state with --reversibility on the example
+# EFMs (with internal loops) and on a synthetic EFM set of genEfms: reactions
+# become irreversible, reversible and both at once, every step starts from the
+# state saved by the previous one; the LTCS have to equal those of a
+# full calcLtcs run with the new reversibility file
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 1000 -r 20 -d 0.3 -c 0.5 -s 6 -o "$TMP/gen.efms" \
+    -v "$TMP/synthetic.rv0" > /dev/null || exit 1
+# the first two reversible reactions become irreversible, then they are
+# reversible again and the third one becomes irreversible, then all reactions
+# are reversible
+awk '{n = 0; for (r = 1; r <= NF; r++) if ($r == 1 && n++ < 2) $r = 0;
+    print}' "$TMP/synthetic.rv0" > "$TMP/synthetic.rv1"
+awk '{n = 0; for (r = 1; r <= NF; r++) if ($r == 1 && n++ == 2) $r = 0;
+    print}' "$TMP/synthetic.rv0" > "$TMP/synthetic.rv2"
+awk '{for (r = 1; r <= NF; r++) $r = 1; print}' "$TMP/synthetic.rv0" \
+    > "$TMP/synthetic.rv3"
+cp "$EX/rvfile" "$TMP/example.rv0"
+echo "0 0 0 0 0 1 1 1 1 1" > "$TMP/example.rv1"
+echo "1 1 1 0 1 1 1 1 0 1" > "$TMP/example.rv2"
+cp "$EX/rvfile" "$TMP/example.rv3"
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -v "$TMP/$name.rv0" -t 2 \
+        -o "$TMP/$name.out0" --save-state "$TMP/$name.state0" \
+        > "$TMP/$name.log0" || exit 1
+    counts=$(grep -c "" "$TMP/$name.out0")
+    for step in 1 2 3; do
+        "$DIR/bin/calcLtcs" --state "$TMP/$name.state$((step-1))" -t 2 \
+            --reversibility "$TMP/$name.rv$step" -o "$TMP/$name.out$step" \
+            --save-state "$TMP/$name.state$step" > "$TMP/$name.log$step" \
+            || exit 1
+        "$DIR/bin/calcLtcs" -i "$efms" $args -v "$TMP/$name.rv$step" \
+            -o "$TMP/$name.expected$step" > "$TMP/$name.elog$step" || exit 1
+        if ! cmp -s <(sort "$TMP/$name.out$step") \
+                <(sort "$TMP/$name.expected$step"); then
+            echo "testReversibility: LTCS of $name after step $step differ"
+            exit 1
+        fi
+        counts="$counts, $(grep -c "" "$TMP/$name.out$step")"
+    done
+    echo "testReversibility: $name ok ($counts LTCS)"
+done <<< "$CASES"
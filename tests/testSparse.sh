@@ -0,0 +1,59 @@
+#!/bin/bash
+#
+# sparse stoichiometric matrices for the example EFMs and for a synthetic EFM
+# set of genEfms with a random matrix: the matrix written as MatrixMarket file
+# and as triplet list (in a different order of the entries) has to give the
+# same LTCS and internal loops as the dense file, parsed by one and by four
+# threads
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 1000 -r 20 -d 0.3 -c 0.3 -s 5 -o "$TMP/gen.efms" \
+    > /dev/null || exit 1
+# 12 metabolites, every entry is used with probability 0.2
+awk 'BEGIN {srand(5); for (m = 0; m < 12; m++) {line = "";
+    for (r = 0; r < 20; r++) {v = rand() < 0.2 ? int(rand() * 5) - 2 : 0;
+    line = line (r ? "\t" : "") v} print line}}' > "$TMP/gen.sfile"
+
+# case name, EFM file, dense stoichiometric matrix, further arguments
+CASES="example $EX/efms.txt $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms $TMP/gen.sfile"
+
+while read -r name efms sfile args; do
+    awk '{for (r = 1; r <= NF; r++) if ($r != 0) print NR, r, $r}' "$sfile" \
+        > "$TMP/$name.entries"
+    read -r rows cols <<< "$(awk '{print NR, NF}' "$sfile" | tail -n 1)"
+    {
+        echo "%%MatrixMarket matrix coordinate real general"
+        echo "% $name"
+        echo "$rows $cols $(grep -c "" "$TMP/$name.entries")"
+        cat "$TMP/$name.entries"
+    } > "$TMP/$name.mtx"
+    sort -k 2,2n -k 1,1nr "$TMP/$name.entries" > "$TMP/$name.triplets"
+    "$DIR/bin/calcLtcs" -i "$efms" -s "$sfile" $args -o "$TMP/$name.out" \
+        -l "$TMP/$name.loops" > "$TMP/$name.log" || exit 1
+    for format in mtx triplets; do
+        option=
+        [ $format = triplets ] && option="--sfile-format triplets"
+        for t in 1 4; do
+            "$DIR/bin/calcLtcs" -i "$efms" -s "$TMP/$name.$format" $option \
+                $args -t $t -o "$TMP/$name.$format$t.out" \
+                -l "$TMP/$name.$format$t.loops" \
+                > "$TMP/$name.$format$t.log" || exit 1
+            if ! cmp -s <(sort "$TMP/$name.out") \
+                    <(sort "$TMP/$name.$format$t.out") || \
+                    ! cmp -s "$TMP/$name.loops" "$TMP/$name.$format$t.loops"
+            then
+                echo "testSparse: $name as $format with $t threads differs"
+                exit 1
+            fi
+        done
+    done
+    loops=$(grep "Nr of internal loops" "$TMP/$name.log" | awk '{print $NF}')
+    echo "testSparse: $name ok ($(grep -c "" "$TMP/$name.out") LTCS," \
+        "$loops internal loops)"
+done <<< "$CASES"
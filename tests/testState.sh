@@ -0,0 +1,49 @@
+#!/bin/bash
+#
+# incremental calculation with --save-state and --state: the EFMs of the
+# example (with internal loops) and of a synthetic EFM set of genEfms are
+# appended in two and in three parts; the LTCS have to equal those of a
+# single calcLtcs run on all EFMs
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 2000 -r 30 -d 0.3 -c 0.3 -s 1 -o "$TMP/gen.efms" \
+    > /dev/null || exit 1
+
+# case name, EFM file, further arguments of calcLtcs
+CASES="example $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic $TMP/gen.efms"
+
+while read -r name efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" -t 2 \
+        > "$TMP/$name.log" || exit 1
+    total=$(grep -c "" "$efms")
+    for parts in 2 3; do
+        split -n l/$parts -d "$efms" "$TMP/$name$parts.part"
+        first=1
+        for part in "$TMP/$name$parts".part*; do
+            if [ $first -eq 1 ]; then
+                "$DIR/bin/calcLtcs" -i "$part" $args -o "$TMP/$name$parts.out" \
+                    -t 2 --save-state "$TMP/$name$parts.state" \
+                    > "$TMP/$name$parts.log" || exit 1
+                first=0
+            else
+                "$DIR/bin/calcLtcs" -i "$part" -o "$TMP/$name$parts.out" \
+                    -t 2 --state "$TMP/$name$parts.state" \
+                    --save-state "$TMP/$name$parts.next" \
+                    >> "$TMP/$name$parts.log" || exit 1
+                mv "$TMP/$name$parts.next" "$TMP/$name$parts.state"
+            fi
+        done
+        if ! cmp -s <(sort "$TMP/$name.out") <(sort "$TMP/$name$parts.out")
+        then
+            echo "testState: LTCS of $name appended in $parts parts differ"
+            exit 1
+        fi
+    done
+    echo "testState: $name ok ($total EFMs, $(grep -c "" "$TMP/$name.out") LTCS)"
+done <<< "$CASES"
@@ -0,0 +1,40 @@
+#!/bin/bash
+#
+# threshold sweep on the example EFMs (with internal loops) and on a synthetic
+# EFM set of genEfms whose entries are scaled down to 1e-8: the LTCS of each
+# threshold have to equal those of a calcLtcs run with this zero threshold
+# (thresholds without an entry between them reuse the LTCS of the previous
+# threshold, 1e-10 and 1e-9 in the synthetic case)
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 1000 -r 20 -d 0.3 -c 0.3 -s 3 -o "$TMP/gen.txt" \
+    > /dev/null || exit 1
+awk 'BEGIN {OFS = "\t"} {for (i = 1; i <= NF; i++) $i *= 10^-((NR*7+i*3)%9);
+    print}' "$TMP/gen.txt" > "$TMP/gen.efms"
+
+# case name, thresholds, EFM file, further arguments of calcLtcs
+CASES="example 1.5,1e-10,0.5 $EX/efms.txt -s $EX/sfile -v $EX/rvfile
+synthetic 1e-3,1e-10,1e-9,1e-6,0.1 $TMP/gen.efms"
+
+while read -r name thresholds efms args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" -t 2 \
+        --sweep $thresholds > "$TMP/$name.log" || exit 1
+    n=0
+    distinct=$(for f in "$TMP/$name".out.z*; do sort "$f" | md5sum; done |
+        sort -u | grep -c "")
+    for z in $(tr ',' '\n' <<< "$thresholds" | sort -g); do
+        n=$((n+1))
+        "$DIR/bin/calcLtcs" -i "$efms" $args -z $z -o "$TMP/$name.$n" \
+            > "$TMP/$name.$n.log" || exit 1
+        if ! cmp -s <(sort "$TMP/$name.out.z$n") <(sort "$TMP/$name.$n"); then
+            echo "testSweep: LTCS of $name for threshold $z differ"
+            exit 1
+        fi
+    done
+    echo "testSweep: $name ok ($n thresholds, $distinct distinct results)"
+done <<< "$CASES"
@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# global symbols of the library: libltcs.so only exports the functions of
+# ltcs.h, libltcs.a in addition only the internal functions prefixed with
+# ltcs_, so programs linking the library keep all other names
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+API=$(sed -n 's/^LTCS_API .*[ *]\(ltcs[A-Za-z]*\)(.*/\1/p' "$DIR/src/ltcs.h" |
+    sort -u)
+
+symbols() {
+    nm -g --defined-only "$@" 2> /dev/null | awk 'NF == 3 {print $3}' |
+        sort -u
+}
+
+other=$(comm -23 <(symbols -D "$DIR/lib/libltcs.so" | grep -v "^_") \
+    <(echo "$API"))
+if [ -n "$other" ]; then
+    echo "testSymbols: libltcs.so exports functions not in ltcs.h:" $other
+    exit 1
+fi
+other=$(comm -23 <(symbols "$DIR/lib/libltcs.a" | grep -v "^ltcs_") \
+    <(echo "$API"))
+if [ -n "$other" ]; then
+    echo "testSymbols: libltcs.a exports names without prefix:" $other
+    exit 1
+fi
+echo "testSymbols: ok ($(echo "$API" | grep -c "") functions of ltcs.h," \
+    "$(symbols "$DIR/lib/libltcs.a" | grep -c "^ltcs_") internal)"
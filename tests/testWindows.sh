@@ -0,0 +1,87 @@
+#!/bin/bash
+#
+# runs ltcsWindows with the mock solver on the LTCS of the example EFMs: the
+# maximal solutions have to equal the LTCS for 1, 2 and 4 solvers, every
+# window that reached the time limit has to be taken over by its halves (or
+# solved again without limit) and every solve has to get the solutions found
+# before as SOL_n cuts; without cuts the run has to fail
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+MOCK="perl $DIR/scripts/ltcstool_window_mock.pl -i {mps} -a {min} -b {max}"
+MOCK="$MOCK -f {out} -x {limit} -w 60 -u 95"
+
+"$DIR/bin/calcLtcs" -i "$DIR/examples/perlScripts/modes.example" \
+    -o "$TMP/ltcs.out" > "$TMP/calcLtcs.log" || exit 1
+EFMS=$(head -1 "$TMP/ltcs.out" | awk -F, '{print NF}')
+for n in 1 2 4; do
+    "$DIR/bin/ltcsWindows" -i "$TMP/ltcs.out" -e $EFMS -n $n -w 4 -s 60 \
+        -d "$TMP/windows$n" -o "$TMP/solutions$n.out" \
+        -x "$MOCK -c {cuts} -t {t}" > "$TMP/windows$n.log" || exit 1
+    if ! cmp -s <(sort "$TMP/ltcs.out") <(sort "$TMP/solutions$n.out"); then
+        echo "testWindows: maximal solutions of $n solvers differ from LTCS"
+        exit 1
+    fi
+    # windows of the timed out solves have to be solved again: split in
+    # halves or a single cardinality without time limit
+    if ! awk '
+        / solve [0-9]+: window / {
+            sub(",", "", $6); split($6, w, "-"); min[$4+0] = w[1]; max[$4+0] = w[2];
+            solved[w[1] "-" w[2]] = solved[w[1] "-" w[2]] " " $4+0;
+        }
+        / time limit reached/ {
+            timeouts++; s = $4+0; a = min[s]; b = max[s];
+            mid = a + int((b - a) / 2);
+            pending[s] = a < b ? a "-" mid " " mid+1 "-" b : a "-" b;
+        }
+        END {
+            for (s in pending) {
+                n = split(pending[s], halves, " ");
+                for (i = 1; i <= n; i++) {
+                    m = split(solved[halves[i]], tasks, " ");
+                    for (k = 1; k <= m && tasks[k] <= s+0; k++);
+                    if (k > m) {
+                        print "window " halves[i] " of solve " s " not taken over";
+                        exit 1;
+                    }
+                }
+            }
+            if (timeouts == 0) { print "no time limit reached"; exit 1; }
+        }' "$TMP/windows$n.log"; then
+        echo "testWindows: time limits of $n solvers not handled"
+        exit 1
+    fi
+    if ! grep -q "time limit: *31536000" "$TMP/windows$n"/solve*.log; then
+        echo "testWindows: no window of $n solvers solved without time limit"
+        exit 1
+    fi
+    # the cuts of every solve are all solutions found before its start
+    if ! awk -v dir="$TMP/windows$n" '
+        / solution of cardinality / { found++ }
+        / solve [0-9]+: window / {
+            if ($7 != found) { print "solve " $4 " got " $7 " cuts"; exit 1 }
+            log_file = dir "/solve" ($4+0) ".log";
+            while ((getline line < log_file) > 0) {
+                if (line ~ /^solution cuts:/) { split(line, c, ":"); cuts = c[2]+0 }
+            }
+            close(log_file);
+            if (cuts != found) { print "solver of " $4 " read " cuts " cuts"; exit 1 }
+            shared += found > 0;
+        }
+        END { if (shared == 0) { print "no cuts shared"; exit 1 } }
+        ' "$TMP/windows$n.log"; then
+        echo "testWindows: SOL_n cuts of $n solvers not shared"
+        exit 1
+    fi
+done
+# solvers that ignore the cuts find solutions twice
+if "$DIR/bin/ltcsWindows" -i "$TMP/ltcs.out" -e $EFMS -n 2 -w 4 -s 60 \
+        -d "$TMP/nocuts" -o "$TMP/nocuts.out" -x "$MOCK" \
+        > "$TMP/nocuts.log" 2>&1; then
+    echo "testWindows: solvers without cuts not detected"
+    exit 1
+fi
+echo "testWindows: ok ($(grep -c "" "$TMP/ltcs.out") sets)"
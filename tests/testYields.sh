@@ -0,0 +1,44 @@
+#!/bin/bash
+#
+# EFM filters while loading on the example EFMs (with internal loops) and on a
+# synthetic EFM set of genEfms: the LTCS with --yields, --include-efms and
+# --exclude-efms have to equal those of a calcLtcs run on the EFMs selected
+# beforehand with awk
+#
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+EX=$DIR/examples/generalLtcs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+"$DIR/bin/genEfms" -n 1000 -r 20 -d 0.3 -c 0.3 -s 4 -o "$TMP/gen.efms" \
+    -f "$TMP/gen.rfile" > /dev/null || exit 1
+printf "R5 > -2\nR13 < 3\n" > "$TMP/gen.yields"
+printf "R5 = 0\n" > "$TMP/zero.yields"
+printf "1-3\n9,12-14\n" > "$TMP/example.list"
+
+# case name, EFM file, awk condition of the selected EFMs, filter arguments
+# and further arguments of calcLtcs
+CASES="example-include $EX/efms.txt NR<=3||NR==9||(NR>=12&&NR<=14) --include-efms $TMP/example.list -s $EX/sfile -v $EX/rvfile
+example-exclude $EX/efms.txt NR>20 --exclude-efms 1-20 -s $EX/sfile -v $EX/rvfile
+yields $TMP/gen.efms \$5>=-2&&\$13<=3 --yields $TMP/gen.yields -r $TMP/gen.rfile
+zero $TMP/gen.efms \$5==0 --yields $TMP/zero.yields -r $TMP/gen.rfile
+include $TMP/gen.efms NR<=300||(NR>=701&&NR<=900) --include-efms 1-300,701-900
+exclude $TMP/gen.efms NR%3!=0 --exclude-efms $(seq -s, 3 3 1000)
+combined $TMP/gen.efms NR>=101&&NR<=900&&NR!=500&&\$5>=-2&&\$13<=3 --include-efms 101-900 --exclude-efms 500 --yields $TMP/gen.yields -r $TMP/gen.rfile"
+
+while read -r name efms condition args; do
+    "$DIR/bin/calcLtcs" -i "$efms" $args -o "$TMP/$name.out" -t 2 \
+        > "$TMP/$name.log" || exit 1
+    awk "$condition" "$efms" > "$TMP/$name.efms"
+    # the filter arguments are replaced by the selected EFMs
+    other=$(sed 's/--[a-z-]* [^ ]*//g' <<< "$args")
+    "$DIR/bin/calcLtcs" -i "$TMP/$name.efms" $other -o "$TMP/$name.expected" \
+        > "$TMP/$name.elog" || exit 1
+    if ! cmp -s <(sort "$TMP/$name.out") <(sort "$TMP/$name.expected"); then
+        echo "testYields: LTCS of $name differ"
+        exit 1
+    fi
+    echo "testYields: $name ok ($(grep -c "" "$TMP/$name.efms") EFMs," \
+        "$(grep -c "" "$TMP/$name.out") LTCS)"
+done <<< "$CASES"